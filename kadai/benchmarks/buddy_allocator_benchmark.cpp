@@ -0,0 +1,119 @@
+// バディアロケータクラスのベンチマーク
+
+#include "buddy_allocator.h"
+#include "free_list_allocator.h"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace {
+    constexpr uint64_t minBlockSize = 64 * 1024;        // D3D12 のバッファの配置単位
+    constexpr uint64_t heapSize = 256 * 1024 * 1024;    // GPU メモリアロケータのヒープ程度のサイズ
+    constexpr uint64_t maxRequestSize = 4 * 1024 * 1024;  // 一つのバッファの最大サイズ
+    constexpr size_t   requestCount = 4096;             // 事前に作っておく要求の数
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	バッファのサイズの並びを作る
+     * 小さいバッファが多くなるように、サイズの 2 の対数を一様に選ぶ
+     * @return	サイズの並び
+     */
+    [[nodiscard]] std::vector<uint64_t> makeRequests() {
+        std::mt19937_64 random(42);
+        std::uniform_real_distribution<double> exponent(8.0, 22.0);  // 256 B ～ 4 MiB
+        std::vector<uint64_t> sizes(requestCount);
+        for (auto& size : sizes) {
+            size = std::min<uint64_t>(static_cast<uint64_t>(std::exp2(exponent(random))), maxRequestSize);
+        }
+        return sizes;
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	確保と解放を交互に繰り返す（常に一定数のバッファが生きている状態）
+     * 引数は生かしておくバッファの数
+     */
+    void buddyChurn(benchmark::State& state) {
+        const auto liveCount = static_cast<size_t>(state.range(0));
+        const auto requests = makeRequests();
+        BuddyAllocator allocator;
+        allocator.initialize(heapSize, minBlockSize);
+
+        std::vector<uint64_t> live(liveCount, BuddyAllocator::invalidOffset);
+        size_t next = 0;
+        for (auto _ : state) {
+            auto& slot = live[next % liveCount];
+            if (slot != BuddyAllocator::invalidOffset) {
+                allocator.free(slot);
+            }
+            slot = allocator.allocate(requests[next % requestCount], minBlockSize);
+            benchmark::DoNotOptimize(slot);
+            ++next;
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+        state.counters["fragmentation"] = allocator.fragmentation();
+        state.counters["failed"] = static_cast<double>(allocator.statistics().failedAllocationCount_);
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	buddyChurn と同じ要求をフリーリストアロケータで処理する（比較用）
+     * 引数は生かしておくバッファの数
+     */
+    void freeListChurn(benchmark::State& state) {
+        const auto liveCount = static_cast<size_t>(state.range(0));
+        const auto requests = makeRequests();
+        FreeListAllocator allocator;
+        allocator.initialize(heapSize);
+
+        struct Slot {
+            uint64_t offset_ = FreeListAllocator::invalidOffset;
+            uint64_t size_{};
+        };
+        std::vector<Slot> live(liveCount);
+        size_t next = 0;
+        uint64_t failed = 0;
+        for (auto _ : state) {
+            auto& slot = live[next % liveCount];
+            if (slot.offset_ != FreeListAllocator::invalidOffset) {
+                allocator.free(slot.offset_, slot.size_);
+            }
+            slot.size_ = requests[next % requestCount];
+            slot.offset_ = allocator.allocate(slot.size_, minBlockSize);
+            failed += slot.offset_ == FreeListAllocator::invalidOffset ? 1 : 0;
+            benchmark::DoNotOptimize(slot.offset_);
+            ++next;
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+        state.counters["failed"] = static_cast<double>(failed);
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	最小ブロックで全体を埋めてから全て解放する（分割と結合の最悪に近い場合）
+     */
+    void buddyFillAndDrain(benchmark::State& state) {
+        BuddyAllocator allocator;
+        allocator.initialize(heapSize, minBlockSize);
+        std::vector<uint64_t> offsets;
+        offsets.reserve(heapSize / minBlockSize);
+
+        for (auto _ : state) {
+            offsets.clear();
+            for (uint64_t i = 0; i < heapSize / minBlockSize; ++i) {
+                offsets.push_back(allocator.allocate(minBlockSize));
+            }
+            for (const auto offset : offsets) {
+                allocator.free(offset);
+            }
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * (heapSize / minBlockSize) * 2));
+    }
+}  // namespace
+
+BENCHMARK(buddyChurn)->Arg(16)->Arg(64)->Arg(256);
+BENCHMARK(freeListChurn)->Arg(16)->Arg(64)->Arg(256);
+BENCHMARK(buddyFillAndDrain);
@@ -0,0 +1,84 @@
+// 視錐台カリングクラスのベンチマーク
+// スカラー・SSE・AVX2 の判定を、同じ境界球の配列で比べる
+
+#include "frustum_culling.h"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace {
+    constexpr float boxExtent = 50.0f;  // 箱型の視錐台の x, y の範囲（±）
+    constexpr float nearZ = 1.0f;       // 箱型の視錐台の近い面
+    constexpr float farZ = 100.0f;      // 箱型の視錐台の遠い面
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	視錐台の内外に半分ずつ程度掛かるように、境界球を乱数で並べる
+     * @param	count	境界球の数
+     * @param	values	中心 xyz、拡大率 xyz、半径の順の配列
+     */
+    void makeSpheres(size_t count, std::vector<float> (&values)[7]) {
+        std::mt19937 random(1);
+        std::uniform_real_distribution<float> lateral(-60.0f, 60.0f);
+        std::uniform_real_distribution<float> depth(-10.0f, 120.0f);
+        std::uniform_real_distribution<float> scale(0.5f, 2.0f);
+        std::uniform_real_distribution<float> radius(0.5f, 3.0f);
+        for (auto& value : values) {
+            value.resize(count);
+        }
+        for (size_t i = 0; i < count; ++i) {
+            values[0][i] = lateral(random);
+            values[1][i] = lateral(random);
+            values[2][i] = depth(random);
+            values[3][i] = scale(random);
+            values[4][i] = scale(random);
+            values[5][i] = scale(random);
+            values[6][i] = radius(random);
+        }
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	境界球の配列を視錐台で判定して、見える位置を詰める
+     * 引数は境界球の数で、一秒あたりの判定数を報告する
+     */
+    template <TransformBatch::Path path>
+    void cullSpheres(benchmark::State& state) {
+        if (path == TransformBatch::Path::avx2 && TransformBatch::bestPath() != TransformBatch::Path::avx2) {
+            state.SkipWithError("AVX2 is not available on this CPU");
+            return;
+        }
+
+        const auto count = static_cast<size_t>(state.range(0));
+        std::vector<float> values[7];
+        makeSpheres(count, values);
+        const FrustumCulling::Bounds bounds = {
+            values[0].data(), values[1].data(), values[2].data(),
+            values[3].data(), values[4].data(), values[5].data(),
+            values[6].data(),
+        };
+        const FrustumCulling::Frustum frustum = { {
+            { 1.0f, 0.0f, 0.0f, boxExtent },   // 左
+            { -1.0f, 0.0f, 0.0f, boxExtent },  // 右
+            { 0.0f, 1.0f, 0.0f, boxExtent },   // 下
+            { 0.0f, -1.0f, 0.0f, boxExtent },  // 上
+            { 0.0f, 0.0f, 1.0f, -nearZ },      // 近
+            { 0.0f, 0.0f, -1.0f, farZ },       // 遠
+        } };
+
+        std::vector<uint32_t> visible(count);
+        size_t visibleCount = 0;
+        for (auto _ : state) {
+            visibleCount = FrustumCulling::cull(frustum, bounds, count, visible.data(), path);
+            benchmark::DoNotOptimize(visible.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * count));
+        state.counters["visible"] = static_cast<double>(visibleCount) / static_cast<double>(count);
+    }
+}  // namespace
+
+BENCHMARK_TEMPLATE(cullSpheres, TransformBatch::Path::scalar)->Arg(100'000)->Arg(1'000'000);
+BENCHMARK_TEMPLATE(cullSpheres, TransformBatch::Path::sse)->Arg(100'000)->Arg(1'000'000);
+BENCHMARK_TEMPLATE(cullSpheres, TransformBatch::Path::avx2)->Arg(100'000)->Arg(1'000'000);
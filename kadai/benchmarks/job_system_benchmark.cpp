@@ -0,0 +1,95 @@
+// ジョブシステムクラスのベンチマーク
+// スレッドの数を変えて、同じ仕事がどれだけ速くなるかと、ジョブ一つあたりのコストを計測する
+// 呼び出し元のスレッドは待つ間もジョブを実行するので、CPU 時間ではなく経過時間で比べる
+
+#include "job_system.h"
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace {
+    constexpr size_t itemCount = 64 * 1024;   // parallelFor で処理する数
+    constexpr size_t minItemsPerJob = 256;    // 一つのジョブに含める最小の数
+    constexpr size_t emptyJobCount = 1024;    // 一度に積む空のジョブの数
+    constexpr size_t chainLength = 256;       // 依存関係で繋ぐジョブの数
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	行列の計算程度の重さの処理を parallelFor で分けて実行する
+     * 引数はスレッドの数で、一秒あたりの処理数を報告する
+     */
+    void parallelForScaling(benchmark::State& state) {
+        JobSystem jobSystem;
+        if (!jobSystem.create(static_cast<uint32_t>(state.range(0)))) {
+            state.SkipWithError("failed to create the job system");
+            return;
+        }
+
+        std::vector<float> values(itemCount);
+        for (auto _ : state) {
+            JobSystem::Counter counter;
+            jobSystem.parallelFor(itemCount, minItemsPerJob, [&values](size_t begin, size_t end) {
+                for (auto i = begin; i < end; ++i) {
+                    auto value = static_cast<float>(i);
+                    for (int k = 0; k < 16; ++k) {
+                        value = std::sqrt(value * 1.5f + 1.0f);
+                    }
+                    values[i] = value;
+                }
+            }, counter);
+            jobSystem.wait(counter);
+            benchmark::DoNotOptimize(values.data());
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * itemCount));
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	何もしないジョブを積んで完了を待つ
+     * 引数はスレッドの数で、一秒あたりのジョブ数を報告する（キューとカウンターのコスト）
+     */
+    void emptyJobs(benchmark::State& state) {
+        JobSystem jobSystem;
+        if (!jobSystem.create(static_cast<uint32_t>(state.range(0)))) {
+            state.SkipWithError("failed to create the job system");
+            return;
+        }
+
+        for (auto _ : state) {
+            JobSystem::Counter counter;
+            for (size_t i = 0; i < emptyJobCount; ++i) {
+                jobSystem.run([] {}, counter);
+            }
+            jobSystem.wait(counter);
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * emptyJobCount));
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	前のジョブの完了を待つジョブを一列に繋いで実行する
+     * 引数はスレッドの数で、一秒あたりのジョブ数を報告する（継続を積み直すコスト）
+     */
+    void dependencyChain(benchmark::State& state) {
+        JobSystem jobSystem;
+        if (!jobSystem.create(static_cast<uint32_t>(state.range(0)))) {
+            state.SkipWithError("failed to create the job system");
+            return;
+        }
+
+        for (auto _ : state) {
+            std::vector<JobSystem::Counter> counters(chainLength);
+            jobSystem.run([] {}, counters[0]);
+            for (size_t i = 1; i < chainLength; ++i) {
+                jobSystem.run([] {}, counters[i], counters[i - 1]);
+            }
+            jobSystem.wait(counters.back());
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * chainLength));
+    }
+}  // namespace
+
+BENCHMARK(parallelForScaling)->RangeMultiplier(2)->Range(1, 16)->UseRealTime();
+BENCHMARK(emptyJobs)->RangeMultiplier(2)->Range(1, 16)->UseRealTime();
+BENCHMARK(dependencyChain)->RangeMultiplier(2)->Range(1, 16)->UseRealTime();
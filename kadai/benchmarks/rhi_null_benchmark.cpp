@@ -0,0 +1,91 @@
+// ヌルデバイスクラスを使ったシーン描画パスのベンチマーク
+// GPU もドライバも使わないので、描画の記録と提出にかかる CPU コストだけを計測できる
+
+#include "rhi_null.h"
+#include "scene_pass.h"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace {
+    constexpr uint32_t width = 1280;              // バックバッファの幅
+    constexpr uint32_t height = 720;              // バックバッファの高さ
+    constexpr uint32_t bufferCount = 2;           // バックバッファの数
+    constexpr uint32_t latency = 2;               // GPU が遅れるシグナルの数
+    constexpr uint64_t bufferSize = 1024 * 1024;  // 各バッファのサイズ
+    constexpr uint32_t pipelineCount = 4;         // 描画で使い分けるパイプラインの数
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	一フレーム分の描画の記録と提出を繰り返す
+     * 引数は描画の数と、パイプラインを切り替える間隔（描画数）
+     */
+    void recordScenePass(benchmark::State& state) {
+        const auto drawCount = static_cast<uint32_t>(state.range(0));
+        const auto batchSize = static_cast<uint32_t>(state.range(1));
+
+        RhiNullDevice device;
+        if (!device.create(width, height, bufferCount, latency)) {
+            state.SkipWithError("failed to create the null device");
+            return;
+        }
+        auto camera = device.createBuffer(RhiHeapType::upload, 256);
+        auto instances = device.createBuffer(RhiHeapType::upload, bufferSize);
+        auto vertices = device.createBuffer(RhiHeapType::gpu, bufferSize);
+        auto indices = device.createBuffer(RhiHeapType::gpu, bufferSize);
+        auto fence = device.createFence();
+        auto commandList = device.createCommandList(RhiQueueType::graphics);
+
+        std::vector<RhiNullPipeline> pipelines;
+        for (uint32_t i = 0; i < pipelineCount; ++i) {
+            pipelines.emplace_back(i);
+        }
+        std::vector<ScenePass::Draw> draws(drawCount);
+        for (uint32_t i = 0; i < drawCount; ++i) {
+            draws[i] = { &pipelines[(i / batchSize) % pipelineCount], 36, 0, 0, i, 1 };
+        }
+
+        ScenePass::Frame frame;
+        frame.viewport_ = { 0.0f, 0.0f, static_cast<float>(width), static_cast<float>(height) };
+        frame.scissor_ = { 0, 0, static_cast<int32_t>(width), static_cast<int32_t>(height) };
+        frame.camera_ = camera->gpuAddress();
+        frame.instances_ = instances->gpuAddress();
+        frame.vertexBuffer_ = { vertices->gpuAddress(), static_cast<uint32_t>(bufferSize), 28 };
+        frame.indexBuffer_ = { indices->gpuAddress(), static_cast<uint32_t>(bufferSize), 2 };
+
+        auto& queue = device.queue(RhiQueueType::graphics);
+        RhiCommandList* const lists[] = { commandList.get() };
+        uint64_t fenceValue = 0;
+        for (auto _ : state) {
+            // 一つのコマンドリストを使い回すので、前のフレームの完了を待つ
+            fence->wait(fenceValue);
+
+            auto& swapChain = device.swapChain();
+            auto& backBuffer = swapChain.backBuffer(swapChain.currentIndex());
+            frame.renderTarget_ = &backBuffer;
+
+            commandList->reset();
+            commandList->barrier(backBuffer, RhiState::present, RhiState::renderTarget);
+            ScenePass::record(*commandList, frame, draws);
+            commandList->barrier(backBuffer, RhiState::renderTarget, RhiState::present);
+            commandList->close();
+            queue.execute(lists);
+            queue.signal(*fence, ++fenceValue);
+            swapChain.present(0);
+        }
+        device.flush();
+
+        const auto statistics = device.statistics();
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * drawCount));
+        state.counters["pipelineChanges"] = benchmark::Counter(static_cast<double>(statistics.pipelineChangeCount_), benchmark::Counter::kAvgIterations);
+        state.counters["errors"] = static_cast<double>(statistics.errorCount_ + statistics.lifetimeErrorCount_);
+    }
+}  // namespace
+
+BENCHMARK(recordScenePass)
+    ->ArgNames({ "draws", "batch" })
+    ->Args({ 1000, 1000 })
+    ->Args({ 10000, 10000 })
+    ->Args({ 10000, 16 })
+    ->Args({ 10000, 1 });
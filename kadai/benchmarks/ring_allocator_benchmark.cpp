@@ -0,0 +1,34 @@
+// リングアロケータクラスのベンチマーク
+
+#include "ring_allocator.h"
+#include <benchmark/benchmark.h>
+#include <cstdint>
+
+namespace {
+    constexpr uint64_t capacity = 64 * 1024 * 1024;  // アップロードリングと同じ程度のサイズ
+    constexpr uint64_t constantAlignment = 256;      // 定数バッファのアライメント
+    constexpr uint64_t framesInFlight = 2;           // GPU が遅れるフレーム数
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	一フレーム分の確保と、GPU が終えたフレームの解放を繰り返す
+     * 引数はフレーム毎の確保数で、一秒あたりの確保数を報告する
+     */
+    void allocatePerFrame(benchmark::State& state) {
+        const auto allocationsPerFrame = static_cast<uint64_t>(state.range(0));
+        RingAllocator allocator;
+        allocator.initialize(capacity);
+
+        uint64_t fenceValue = 0;
+        for (auto _ : state) {
+            for (uint64_t i = 0; i < allocationsPerFrame; ++i) {
+                benchmark::DoNotOptimize(allocator.allocate(192, constantAlignment));
+            }
+            allocator.finishFrame(++fenceValue);
+            allocator.release(fenceValue > framesInFlight ? fenceValue - framesInFlight : 0);
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * allocationsPerFrame));
+    }
+}  // namespace
+
+BENCHMARK(allocatePerFrame)->Arg(1)->Arg(64)->Arg(1024)->Arg(16384);
@@ -0,0 +1,72 @@
+// ワールド行列の一括計算クラスのベンチマーク
+// スカラー・SSE・AVX2 の計算を、同じ入力の配列で比べる
+
+#include "transform_batch.h"
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace {
+    constexpr size_t matrixSize = 16;  // 行列一つの float の数
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	乱数で入力を作る（回転は単位クォータニオン）
+     * @param	count	オブジェクトの数
+     * @param	values	座標 xyz、回転 xyzw、拡大率 xyz の順の配列
+     */
+    void makeTransforms(size_t count, std::vector<float> (&values)[10]) {
+        std::mt19937 random(1);
+        std::uniform_real_distribution<float> distribution(-3.0f, 3.0f);
+        for (auto& value : values) {
+            value.resize(count);
+        }
+        for (size_t i = 0; i < count; ++i) {
+            float q[4] = { distribution(random), distribution(random), distribution(random), distribution(random) };
+            const auto length = std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+            for (size_t k = 0; k < 3; ++k) {
+                values[k][i] = distribution(random) * 10.0f;
+                values[7 + k][i] = distribution(random);
+            }
+            for (size_t k = 0; k < 4; ++k) {
+                values[3 + k][i] = q[k] / length;
+            }
+        }
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	全てのオブジェクトのワールド行列を隙間なく並べて書き込む
+     * 引数はオブジェクトの数で、一秒あたりの行列数を報告する
+     */
+    template <TransformBatch::Path path>
+    void composeMatrices(benchmark::State& state) {
+        if (path == TransformBatch::Path::avx2 && TransformBatch::bestPath() != TransformBatch::Path::avx2) {
+            state.SkipWithError("AVX2 is not available on this CPU");
+            return;
+        }
+
+        const auto count = static_cast<size_t>(state.range(0));
+        std::vector<float> values[10];
+        makeTransforms(count, values);
+        const TransformBatch::Source source = {
+            values[0].data(), values[1].data(), values[2].data(),
+            values[3].data(), values[4].data(), values[5].data(), values[6].data(),
+            values[7].data(), values[8].data(), values[9].data(),
+        };
+
+        std::vector<float> matrices(count * matrixSize);
+        for (auto _ : state) {
+            TransformBatch::compose(source, count, matrices.data(), matrixSize * sizeof(float), path);
+            benchmark::DoNotOptimize(matrices.data());
+            benchmark::ClobberMemory();
+        }
+        state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * count));
+    }
+}  // namespace
+
+BENCHMARK_TEMPLATE(composeMatrices, TransformBatch::Path::scalar)->Arg(1'000)->Arg(1'000'000);
+BENCHMARK_TEMPLATE(composeMatrices, TransformBatch::Path::sse)->Arg(1'000)->Arg(1'000'000);
+BENCHMARK_TEMPLATE(composeMatrices, TransformBatch::Path::avx2)->Arg(1'000)->Arg(1'000'000);
@@ -13,10 +13,22 @@ namespace {
      * @return	
      */
     LRESULT CALLBACK WindowProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam) {
+        auto* window = reinterpret_cast<Window*>(GetWindowLongPtrA(hwnd, GWLP_USERDATA));
         switch (msg) {
         case WM_DESTROY:  // EBhEꂽƂ
             PostQuitMessage(0);
             return 0;
+        case WM_SIZE:  // TCYςƂ
+            if (window) {
+                window->onResize(wParam, LOWORD(lParam), HIWORD(lParam));
+            }
+            return 0;
+        case WM_ENTERSIZEMOVE:  // hbOł̃TCYύXn܂Ƃ
+        case WM_EXITSIZEMOVE:   // hbOł̃TCYύXIƂ
+            if (window) {
+                window->onSizeMove(msg == WM_ENTERSIZEMOVE);
+            }
+            return 0;
         }
         return DefWindowProc(hwnd, msg, wParam, lParam);
     }
@@ -26,8 +38,8 @@ namespace {
 /**
  * @brief	EBhE̐
  * @param	instance	CX^Xnh
- * @param	width		
- * @param	height		c
+ * @param	width		`̈̉
+ * @param	height		`̈̏c
  * @param	name		EBhE
  * @return	̐
  */
@@ -47,14 +59,18 @@ namespace {
     
     RegisterClassA(&wc);
 
+    // g܂߂EBhẼTCY߁A`̈悪w肵TCYɂȂ悤ɂ
+    RECT rect{ 0, 0, width, height };
+    AdjustWindowRect(&rect, WS_OVERLAPPEDWINDOW, FALSE);
+
     handle_ = CreateWindowA(
         wc.lpszClassName,
         wc.lpszClassName,
         WS_OVERLAPPEDWINDOW,
         CW_USEDEFAULT,
         CW_USEDEFAULT,
-        width,
-        height,
+        rect.right - rect.left,
+        rect.bottom - rect.top,
         nullptr,
         nullptr,
         instance,
@@ -65,14 +81,17 @@ namespace {
         return E_FAIL;
     }
 
-    // EChE̕\
-    ShowWindow(handle_, SW_SHOW);
-    UpdateWindow(handle_);
-
     // EBhẼTCYۑ
     witdh_ = width;
     height_ = height;
 
+    // EBhEvV[W炱̃CX^XQƂł悤ɂ
+    SetWindowLongPtrA(handle_, GWLP_USERDATA, reinterpret_cast<LONG_PTR>(this));
+
+    // EChE̕\
+    ShowWindow(handle_, SW_SHOW);
+    UpdateWindow(handle_);
+
     return S_OK;
 }
 
@@ -118,4 +137,52 @@ namespace {
  */
 [[nodiscard]] std::pair<int, int> Window::size() const noexcept {
     return { witdh_, height_ };
-}
\ No newline at end of file
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	m肵TCY̕ύXo
+ * hbOŏ͊m肵ĂȂ̂ŎoȂ
+ * O񂩂牽xύXĂĂAŌ̃TCYxԂ
+ * @param	width	ύX̉
+ * @param	height	ύX̏c
+ * @return	TCYςĂ true
+ */
+[[nodiscard]] bool Window::consumeResize(int& width, int& height) noexcept {
+    if (!resized_ || sizing_ || minimized_) {
+        return false;
+    }
+    resized_ = false;
+    width = witdh_;
+    height = height_;
+    return true;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	TCYςɃEBhEvV[WĂ΂
+ * @param	type	WM_SIZE ̎ށiSIZE_MINIMIZED Ȃǁj
+ * @param	width	`̈̉
+ * @param	height	`̈̏c
+ */
+void Window::onResize(WPARAM type, int width, int height) noexcept {
+    // ŏƃTCY 0 ɂȂ̂ŁAɖ߂܂ňȑÕTCŶ܂܂ɂ
+    minimized_ = type == SIZE_MINIMIZED;
+    if (minimized_ || width <= 0 || height <= 0) {
+        return;
+    }
+    if (width != witdh_ || height != height_) {
+        witdh_ = width;
+        height_ = height;
+        resized_ = true;
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	hbOɂTCY̕ύXn܂EIɃEBhEvV[WĂ΂
+ * @param	sizing	hbOȂ true
+ */
+void Window::onSizeMove(bool sizing) noexcept {
+    sizing_ = sizing;
+}
@@ -8,6 +8,7 @@
 //---------------------------------------------------------------------------------
 /**
  * @brief	EBhENX
+ * TCY̕ύX̓EBhEvV[WŎ󂯎AhbOI܂ł܂Ƃ߂Ă consumeResize Ŏo
  */
 class Window final {
 public:
@@ -27,8 +28,8 @@ public:
     /**
      * @brief	EBhE̐
      * @param	instance	CX^Xnh
-     * @param	width		
-     * @param	height		c
+     * @param	width		`̈̉
+     * @param	height		`̈̏c
      * @param	name		EBhE
      * @return	̐
      */
@@ -50,13 +51,43 @@ public:
     //---------------------------------------------------------------------------------
     /**
      * @brief	EBhẼTCY擾
-     * @return@EBhẼTCY (, c)
+     * @return@`̈̃TCY (, c)
      */
     [[nodiscard]] std::pair<int, int> size() const noexcept;
 
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	m肵TCY̕ύXo
+     * hbOŏ͊m肵ĂȂ̂ŎoȂ
+     * O񂩂牽xύXĂĂAŌ̃TCYxԂ
+     * @param	width	ύX̉
+     * @param	height	ύX̏c
+     * @return	TCYςĂ true
+     */
+    [[nodiscard]] bool consumeResize(int& width, int& height) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	TCYςɃEBhEvV[WĂ΂
+     * @param	type	WM_SIZE ̎ށiSIZE_MINIMIZED Ȃǁj
+     * @param	width	`̈̉
+     * @param	height	`̈̏c
+     */
+    void onResize(WPARAM type, int width, int height) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	hbOɂTCY̕ύXn܂EIɃEBhEvV[WĂ΂
+     * @param	sizing	hbOȂ true
+     */
+    void onSizeMove(bool sizing) noexcept;
+
 
 private:
     HWND handle_{};  /// EBhEnh
     int  witdh_{};   /// EBhẺ
     int  height_{};  /// EBhȄc
+    bool resized_{};    /// oĂȂTCY̕ύX邩
+    bool sizing_{};     /// hbOŃTCYύX
+    bool minimized_{};  /// ŏ
 };
@@ -0,0 +1,209 @@
+﻿// ベンチマーククラス
+
+#include "benchmark.h"
+#include "entity_store.h"
+#include "object.h"
+#include "parallel_recorder.h"
+#include "rhi_d3d12.h"
+#include <algorithm>
+#include <chrono>
+#include <random>
+
+namespace {
+    constexpr size_t minEntitiesPerJob = 4096;  // 一つのジョブで更新する最小のエンティティ数
+    constexpr float  cullingSpread = 20.0f;     // カリングの計測でオブジェクトを散らばらせる範囲（原点からの各軸の距離）
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	処理を繰り返して一回分の時間の中央値を求める
+     * 最初の一回はキャッシュを温めるために計測しない
+     * @param	repeatCount	繰り返す回数
+     * @param	function	計測する処理
+     * @return	一回分の時間の中央値（ミリ秒）
+     */
+    template <typename Function>
+    [[nodiscard]] double measure(uint32_t repeatCount, Function&& function) noexcept {
+        function();
+
+        std::vector<double> milliseconds;
+        milliseconds.reserve(repeatCount);
+        for (uint32_t i = 0; i < repeatCount; ++i) {
+            const auto start = std::chrono::steady_clock::now();
+            function();
+            const auto elapsed = std::chrono::steady_clock::now() - start;
+            milliseconds.push_back(std::chrono::duration<double, std::milli>(elapsed).count());
+        }
+        if (milliseconds.empty()) {
+            return 0.0;
+        }
+        std::nth_element(milliseconds.begin(), milliseconds.begin() + milliseconds.size() / 2, milliseconds.end());
+        return milliseconds[milliseconds.size() / 2];
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	計測結果を作る
+     * @param	count			処理した数
+     * @param	milliseconds	一回分の時間（ミリ秒）
+     * @return	計測結果
+     */
+    [[nodiscard]] Benchmark::Result makeResult(uint32_t count, double milliseconds) noexcept {
+        return { count, milliseconds, milliseconds > 0.0 ? count * 1000.0 / milliseconds : 0.0 };
+    }
+}  // namespace
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	オブジェクトの更新（動かす処理）の時間を計る
+ * @param	counts		エンティティの数の並び
+ * @param	repeatCount	それぞれの数で繰り返す回数
+ * @param	results		数毎の計測結果
+ */
+void Benchmark::entityUpdate(std::span<const uint32_t> counts, uint32_t repeatCount, std::vector<Result>& results) noexcept {
+    results.clear();
+    EntityStore entities;
+    for (const auto count : counts) {
+        entities.clear();
+        entities.reserve(count);
+        for (uint32_t i = 0; i < count; ++i) {
+            (void)Object::create(entities);
+        }
+
+        const auto milliseconds = measure(repeatCount, [&] { Object::update(entities); });
+        results.push_back(makeResult(count, milliseconds));
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	ジョブシステムで分割したオブジェクトの更新の時間を計る
+ * entityUpdate と比べると、スレッドを増やした分だけ速くなっているかが分かる
+ * @param	jobSystem		更新に使うジョブシステム
+ * @param	counts			エンティティの数の並び
+ * @param	repeatCount		それぞれの数で繰り返す回数
+ * @param	results			数毎の計測結果
+ */
+void Benchmark::parallelEntityUpdate(JobSystem& jobSystem, std::span<const uint32_t> counts, uint32_t repeatCount, std::vector<Result>& results) noexcept {
+    results.clear();
+    EntityStore entities;
+    for (const auto count : counts) {
+        entities.clear();
+        entities.reserve(count);
+        for (uint32_t i = 0; i < count; ++i) {
+            (void)Object::create(entities);
+        }
+
+        const auto milliseconds = measure(repeatCount, [&] {
+            JobSystem::Counter counter;
+            jobSystem.parallelFor(count, minEntitiesPerJob, [&entities](size_t begin, size_t end) { Object::update(entities, begin, end); }, counter);
+            jobSystem.wait(counter);
+        });
+        results.push_back(makeResult(count, milliseconds));
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	ワールド行列の一括計算の時間を計る
+ * インスタンスバッファと同じ間隔で書き込むので、一秒あたりの数はそのまま一秒あたりに計算できる行列の数になる
+ * @param	counts		エンティティの数の並び
+ * @param	repeatCount	それぞれの数で繰り返す回数
+ * @param	path		計算に使う命令セット
+ * @param	results		数毎の計測結果
+ */
+void Benchmark::transformBatch(std::span<const uint32_t> counts, uint32_t repeatCount, TransformBatch::Path path, std::vector<Result>& results) noexcept {
+    results.clear();
+    EntityStore entities;
+    std::vector<Object::ConstBufferData> destination;
+    for (const auto count : counts) {
+        entities.clear();
+        entities.reserve(count);
+        for (uint32_t i = 0; i < count; ++i) {
+            (void)Object::create(entities);
+        }
+        Object::update(entities);
+        destination.resize(count);
+
+        const auto source = TransformBatch::source(entities);
+        const auto milliseconds = measure(repeatCount, [&] {
+            TransformBatch::compose(source, count, destination.data(), sizeof(Object::ConstBufferData), path);
+        });
+        results.push_back(makeResult(count, milliseconds));
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	視錐台カリングの時間を計る
+ * オブジェクトは原点の周りに散らばらせるので、一部だけが視錐台に入る
+ * @param	frustum		判定に使う視錐台
+ * @param	counts		エンティティの数の並び
+ * @param	repeatCount	それぞれの数で繰り返す回数
+ * @param	path		判定に使う命令セット
+ * @param	results		数毎の計測結果
+ */
+void Benchmark::frustumCulling(const FrustumCulling::Frustum& frustum, std::span<const uint32_t> counts, uint32_t repeatCount, TransformBatch::Path path, std::vector<Result>& results) noexcept {
+    results.clear();
+    EntityStore entities;
+    std::vector<uint32_t> visible;
+    for (const auto count : counts) {
+        entities.clear();
+        entities.reserve(count);
+        for (uint32_t i = 0; i < count; ++i) {
+            (void)Object::create(entities);
+        }
+
+        // 毎回同じ配置になるように乱数の種は固定する
+        std::minstd_rand random(count);
+        std::uniform_real_distribution<float> position(-cullingSpread, cullingSpread);
+        for (const auto component : { EntityStore::Component::positionX, EntityStore::Component::positionY, EntityStore::Component::positionZ }) {
+            for (auto& value : entities.values(component)) {
+                value = position(random);
+            }
+        }
+
+        const auto milliseconds = measure(repeatCount, [&] { FrustumCulling::cull(frustum, entities, visible, path); });
+        results.push_back(makeResult(count, milliseconds));
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	描画コマンドの並列記録の時間を計る
+ * 同じ描画を数だけ並べ、指定したスレッド数の ParallelRecorder で記録する（コマンドリストは提出しない）
+ * スレッド数を変えて呼ぶと、記録スレッドを増やした分だけ速くなっているかが分かる
+ * @param	device				コマンドリストを作るデバイス
+ * @param	threadCount			記録スレッドの数（呼び出し元のスレッドを含む）
+ * @param	minDrawsPerChunk	一つの記録スレッドに割り当てる最小の描画数
+ * @param	frame				全ての描画で共通の設定
+ * @param	draw				並べる描画
+ * @param	counts				描画の数の並び
+ * @param	repeatCount			それぞれの数で繰り返す回数
+ * @param	results				数毎の計測結果
+ */
+void Benchmark::parallelRecording(const Device& device, UINT threadCount, size_t minDrawsPerChunk, const ScenePass::Frame& frame, const ScenePass::Draw& draw, std::span<const uint32_t> counts, uint32_t repeatCount, std::vector<Result>& results) noexcept {
+    results.clear();
+
+    // 提出しないのでコマンドリストは一組だけで毎回使い回す
+    ParallelRecorder recorder;
+    if (!recorder.create(device, threadCount, 1)) {
+        return;
+    }
+
+    std::vector<ScenePass::Draw>    draws;
+    std::vector<ID3D12CommandList*> commandLists;
+    const ParallelRecorder::RecordFunction record = [&](const CommandList& commandList, size_t begin, size_t end) {
+        RhiD3D12CommandList rhiCommandList{};
+        rhiCommandList.attach(commandList);
+        ScenePass::record(rhiCommandList, frame, std::span(draws).subspan(begin, end - begin));
+    };
+    for (const auto count : counts) {
+        draws.assign(count, draw);
+
+        const auto milliseconds = measure(repeatCount, [&] {
+            commandLists.clear();
+            recorder.record(0, draws.size(), minDrawsPerChunk, record, commandLists);
+        });
+        results.push_back(makeResult(count, milliseconds));
+    }
+}
@@ -0,0 +1,99 @@
+﻿// ベンチマーククラス
+
+#pragma once
+
+#include "device.h"
+#include "frustum_culling.h"
+#include "job_system.h"
+#include "scene_pass.h"
+#include "transform_batch.h"
+#include <cstdint>
+#include <span>
+#include <vector>
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	ベンチマーククラス
+ * CPU で行うフレームの処理を、処理する数を変えながら繰り返して時間を計る
+ * 結果は一回分の時間の中央値と、一秒あたりに処理できる数で返す
+ * インスタンスは作らない
+ */
+class Benchmark final {
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	計測結果
+     */
+    struct Result {
+        uint32_t count_{};         /// 処理した数
+        double   milliseconds_{};  /// 一回分の時間の中央値（ミリ秒）
+        double   perSecond_{};     /// 一秒あたりに処理できる数
+    };
+
+    static constexpr uint32_t defaultCounts[] = { 1'000, 10'000, 100'000, 1'000'000 };  /// 既定で計測する数
+    static constexpr uint32_t defaultRepeatCount = 20;                                   /// 既定の繰り返す回数
+    static constexpr uint32_t defaultDrawCounts[] = { 100, 1'000, 10'000 };              /// 記録の計測で既定で使う描画の数
+
+public:
+    Benchmark() = delete;
+    ~Benchmark() = delete;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	オブジェクトの更新（動かす処理）の時間を計る
+     * @param	counts		エンティティの数の並び
+     * @param	repeatCount	それぞれの数で繰り返す回数
+     * @param	results		数毎の計測結果
+     */
+    static void entityUpdate(std::span<const uint32_t> counts, uint32_t repeatCount, std::vector<Result>& results) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	ジョブシステムで分割したオブジェクトの更新の時間を計る
+     * entityUpdate と比べると、スレッドを増やした分だけ速くなっているかが分かる
+     * @param	jobSystem		更新に使うジョブシステム
+     * @param	counts			エンティティの数の並び
+     * @param	repeatCount		それぞれの数で繰り返す回数
+     * @param	results			数毎の計測結果
+     */
+    static void parallelEntityUpdate(JobSystem& jobSystem, std::span<const uint32_t> counts, uint32_t repeatCount, std::vector<Result>& results) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	ワールド行列の一括計算の時間を計る
+     * インスタンスバッファと同じ間隔で書き込むので、一秒あたりの数はそのまま一秒あたりに計算できる行列の数になる
+     * @param	counts		エンティティの数の並び
+     * @param	repeatCount	それぞれの数で繰り返す回数
+     * @param	path		計算に使う命令セット
+     * @param	results		数毎の計測結果
+     */
+    static void transformBatch(std::span<const uint32_t> counts, uint32_t repeatCount, TransformBatch::Path path, std::vector<Result>& results) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	視錐台カリングの時間を計る
+     * オブジェクトは原点の周りに散らばらせるので、一部だけが視錐台に入る
+     * @param	frustum		判定に使う視錐台
+     * @param	counts		エンティティの数の並び
+     * @param	repeatCount	それぞれの数で繰り返す回数
+     * @param	path		判定に使う命令セット
+     * @param	results		数毎の計測結果
+     */
+    static void frustumCulling(const FrustumCulling::Frustum& frustum, std::span<const uint32_t> counts, uint32_t repeatCount, TransformBatch::Path path, std::vector<Result>& results) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	描画コマンドの並列記録の時間を計る
+     * 同じ描画を数だけ並べ、指定したスレッド数の ParallelRecorder で記録する（コマンドリストは提出しない）
+     * スレッド数を変えて呼ぶと、記録スレッドを増やした分だけ速くなっているかが分かる
+     * @param	device				コマンドリストを作るデバイス
+     * @param	threadCount			記録スレッドの数（呼び出し元のスレッドを含む）
+     * @param	minDrawsPerChunk	一つの記録スレッドに割り当てる最小の描画数
+     * @param	frame				全ての描画で共通の設定
+     * @param	draw				並べる描画
+     * @param	counts				描画の数の並び
+     * @param	repeatCount			それぞれの数で繰り返す回数
+     * @param	results				数毎の計測結果
+     */
+    static void parallelRecording(const Device& device, UINT threadCount, size_t minDrawsPerChunk, const ScenePass::Frame& frame, const ScenePass::Draw& draw, std::span<const uint32_t> counts, uint32_t repeatCount, std::vector<Result>& results) noexcept;
+};
@@ -0,0 +1,176 @@
+﻿// バディアロケータクラス
+
+#include "buddy_allocator.h"
+#include <cassert>
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	アロケータを初期化する
+ * @param	capacity		管理する範囲のサイズ（minBlockSize の 2 の累乗倍）
+ * @param	minBlockSize	最小ブロックのサイズ（2 の累乗）
+ */
+void BuddyAllocator::initialize(uint64_t capacity, uint64_t minBlockSize) noexcept {
+    assert(minBlockSize != 0 && (minBlockSize & (minBlockSize - 1)) == 0 && "最小ブロックサイズが 2 の累乗ではありません");
+    assert(capacity >= minBlockSize && "範囲が最小ブロックサイズより小さいです");
+
+    minBlockSize_ = minBlockSize;
+    maxOrder_ = 0;
+    while (blockSize(maxOrder_ + 1) <= capacity) {
+        ++maxOrder_;
+    }
+    assert(blockSize(maxOrder_) == capacity && "範囲が最小ブロックサイズの 2 の累乗倍ではありません");
+
+    freeLists_.assign(maxOrder_ + 1, {});
+    freeLists_[maxOrder_].insert(0);
+    allocations_.clear();
+
+    statistics_ = {};
+    statistics_.capacity_ = blockSize(maxOrder_);
+    statistics_.largestFreeBlock_ = statistics_.capacity_;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	範囲を確保する
+ * @param	size		確保するサイズ
+ * @param	alignment	アライメント（2 の累乗）
+ * @return	確保した範囲のオフセット、空きが無い場合は invalidOffset
+ */
+[[nodiscard]] uint64_t BuddyAllocator::allocate(uint64_t size, uint64_t alignment) noexcept {
+    assert(alignment != 0 && (alignment & (alignment - 1)) == 0 && "アライメントが 2 の累乗ではありません");
+
+    // ブロックは自身のサイズでアライメントされているので、アライメント以上のブロックを使えばよい
+    const auto requested = size < alignment ? alignment : size;
+    if (size == 0 || requested > statistics_.capacity_) {
+        ++statistics_.failedAllocationCount_;
+        return invalidOffset;
+    }
+
+    const auto order = orderOf(requested);
+
+    // 要求を満たす最小の空きブロックを探す
+    auto found = order;
+    while (found <= maxOrder_ && freeLists_[found].empty()) {
+        ++found;
+    }
+    if (found > maxOrder_) {
+        ++statistics_.failedAllocationCount_;
+        return invalidOffset;
+    }
+
+    const auto offset = *freeLists_[found].begin();
+    freeLists_[found].erase(freeLists_[found].begin());
+
+    // 大きすぎるブロックは半分に分け、後ろ半分を空きブロックに戻す
+    while (found > order) {
+        --found;
+        freeLists_[found].insert(offset + blockSize(found));
+    }
+
+    allocations_.emplace(offset, Block{ order, size });
+
+    statistics_.usedSize_ += blockSize(order);
+    statistics_.requestedSize_ += size;
+    statistics_.peakUsedSize_ = statistics_.usedSize_ > statistics_.peakUsedSize_ ? statistics_.usedSize_ : statistics_.peakUsedSize_;
+    ++statistics_.allocationCount_;
+    ++statistics_.totalAllocationCount_;
+    return offset;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	範囲を解放する
+ * @param	offset	allocate で確保したオフセット
+ */
+void BuddyAllocator::free(uint64_t offset) noexcept {
+    const auto it = allocations_.find(offset);
+    if (it == allocations_.end()) {
+        assert(false && "確保されていないオフセットの解放です");
+        return;
+    }
+
+    auto order = it->second.order_;
+    statistics_.usedSize_ -= blockSize(order);
+    statistics_.requestedSize_ -= it->second.requestedSize_;
+    --statistics_.allocationCount_;
+    allocations_.erase(it);
+
+    // 相方のブロックも空いていれば結合して一つ上の次数に戻す
+    auto blockOffset = offset;
+    while (order < maxOrder_) {
+        const auto buddyOffset = blockOffset ^ blockSize(order);
+        const auto buddy = freeLists_[order].find(buddyOffset);
+        if (buddy == freeLists_[order].end()) {
+            break;
+        }
+        freeLists_[order].erase(buddy);
+        blockOffset = blockOffset < buddyOffset ? blockOffset : buddyOffset;
+        ++order;
+    }
+    freeLists_[order].insert(blockOffset);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	統計情報を取得する
+ * @return	統計情報
+ */
+[[nodiscard]] BuddyAllocator::Statistics BuddyAllocator::statistics() const noexcept {
+    auto statistics = statistics_;
+    statistics.largestFreeBlock_ = 0;
+    for (auto order = maxOrder_ + 1; order-- > 0;) {
+        if (!freeLists_[order].empty()) {
+            statistics.largestFreeBlock_ = blockSize(order);
+            break;
+        }
+    }
+    return statistics;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	断片化の度合いを取得する
+ * 空き領域のうち、最も大きい空きブロックに含まれない割合
+ * @return	0（断片化なし）～ 1
+ */
+[[nodiscard]] float BuddyAllocator::fragmentation() const noexcept {
+    const auto statistics = this->statistics();
+    const auto freeSize = statistics.capacity_ - statistics.usedSize_;
+    if (freeSize == 0) {
+        return 0.0f;
+    }
+    return 1.0f - static_cast<float>(statistics.largestFreeBlock_) / static_cast<float>(freeSize);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	ブロックが一つも確保されていないか調べる
+ * @return	空なら true
+ */
+[[nodiscard]] bool BuddyAllocator::empty() const noexcept {
+    return allocations_.empty();
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	サイズを収められる最小のブロックの次数を求める
+ * @param	size	サイズ
+ * @return	次数（ブロックサイズ = minBlockSize << 次数）
+ */
+[[nodiscard]] uint32_t BuddyAllocator::orderOf(uint64_t size) const noexcept {
+    uint32_t order = 0;
+    while (blockSize(order) < size) {
+        ++order;
+    }
+    return order;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	次数からブロックのサイズを求める
+ * @param	order	次数
+ * @return	ブロックのサイズ
+ */
+[[nodiscard]] uint64_t BuddyAllocator::blockSize(uint32_t order) const noexcept {
+    return minBlockSize_ << order;
+}
@@ -0,0 +1,127 @@
+﻿// バディアロケータクラス
+
+#pragma once
+
+#include <cstdint>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	バディアロケータクラス
+ * 範囲を 2 の累乗サイズのブロックに分割して管理し、GPU リソースには依存しない
+ * ブロックは自身のサイズでアライメントされ、解放時に隣の相方（バディ）と結合する
+ */
+class BuddyAllocator final {
+public:
+    static constexpr uint64_t invalidOffset = UINT64_MAX;  /// 確保失敗を表すオフセット
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	統計情報
+     */
+    struct Statistics {
+        uint64_t capacity_{};              /// 管理している範囲のサイズ
+        uint64_t usedSize_{};              /// 使用中のサイズ（ブロック単位）
+        uint64_t peakUsedSize_{};          /// 使用中のサイズの最大値
+        uint64_t requestedSize_{};         /// 要求されたサイズの合計（切り上げ前）
+        uint64_t largestFreeBlock_{};      /// 最も大きい空きブロックのサイズ
+        uint64_t allocationCount_{};       /// 確保中のブロック数
+        uint64_t totalAllocationCount_{};  /// これまでの確保の回数
+        uint64_t failedAllocationCount_{}; /// 確保に失敗した回数
+    };
+
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    コンストラクタ
+     */
+    BuddyAllocator() = default;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    デストラクタ
+     */
+    ~BuddyAllocator() = default;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	アロケータを初期化する
+     * @param	capacity		管理する範囲のサイズ（minBlockSize の 2 の累乗倍）
+     * @param	minBlockSize	最小ブロックのサイズ（2 の累乗）
+     */
+    void initialize(uint64_t capacity, uint64_t minBlockSize) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	範囲を確保する
+     * @param	size		確保するサイズ
+     * @param	alignment	アライメント（2 の累乗）
+     * @return	確保した範囲のオフセット、空きが無い場合は invalidOffset
+     */
+    [[nodiscard]] uint64_t allocate(uint64_t size, uint64_t alignment = 1) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	範囲を解放する
+     * @param	offset	allocate で確保したオフセット
+     */
+    void free(uint64_t offset) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	統計情報を取得する
+     * @return	統計情報
+     */
+    [[nodiscard]] Statistics statistics() const noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	断片化の度合いを取得する
+     * 空き領域のうち、最も大きい空きブロックに含まれない割合
+     * @return	0（断片化なし）～ 1
+     */
+    [[nodiscard]] float fragmentation() const noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	ブロックが一つも確保されていないか調べる
+     * @return	空なら true
+     */
+    [[nodiscard]] bool empty() const noexcept;
+
+private:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	サイズを収められる最小のブロックの次数を求める
+     * @param	size	サイズ
+     * @return	次数（ブロックサイズ = minBlockSize << 次数）
+     */
+    [[nodiscard]] uint32_t orderOf(uint64_t size) const noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	次数からブロックのサイズを求める
+     * @param	order	次数
+     * @return	ブロックのサイズ
+     */
+    [[nodiscard]] uint64_t blockSize(uint32_t order) const noexcept;
+
+private:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	確保中のブロック
+     */
+    struct Block {
+        uint32_t order_{};          /// ブロックの次数
+        uint64_t requestedSize_{};  /// 要求されたサイズ
+    };
+
+private:
+    std::vector<std::set<uint64_t>>       freeLists_{};     /// 次数毎の空きブロック（オフセット順）
+    std::unordered_map<uint64_t, Block>   allocations_{};   /// 確保中のブロック（オフセット → ブロック）
+    uint64_t                              minBlockSize_{};  /// 最小ブロックのサイズ
+    uint32_t                              maxOrder_{};      /// 最大の次数（範囲全体）
+    Statistics                            statistics_{};    /// 統計情報
+};
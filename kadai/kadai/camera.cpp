@@ -7,13 +7,17 @@ namespace {
     // 萔
     constexpr float eyeMoveSpeed_ = 0.06f;  // Jړx
     constexpr float destTargetToView_ = -5.0f;  // _J܂ł̋
+    constexpr float fovAngleY_ = DirectX::XM_PIDIV4;  // p45x
+    constexpr float nearZ_ = 0.1f;    // jANbv
+    constexpr float farZ_ = 100.0f;   // t@[Nbv
 }  // namespace
 
 //---------------------------------------------------------------------------------
 /**
  * @brief    J
+ * @param	aspectRatio	AXyNgi / cj
  */
-void Camera::initialize() noexcept {
+void Camera::initialize(float aspectRatio) noexcept {
     // J̈ʒuݒ
     position_ = DirectX::XMFLOAT3(0.0f, 0.0f, destTargetToView_);
     // J̒_ݒ
@@ -22,12 +26,16 @@ void Camera::initialize() noexcept {
     up_ = DirectX::XMFLOAT3(0.0f, 1.0f, 0.0f);
 
     // vWFNVs̐ݒ
-    projection_ = DirectX::XMMatrixPerspectiveFovLH(
-        DirectX::XM_PIDIV4,  // p45x
-        1280.0f / 720.0f,    // AXyNg
-        0.1f,                // jANbv
-        100.0f               // t@[Nbv
-    );
+    setAspectRatio(aspectRatio);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief    AXyNgύXăvWFNVs蒼
+ * @param	aspectRatio	AXyNgi / cj
+ */
+void Camera::setAspectRatio(float aspectRatio) noexcept {
+    projection_ = DirectX::XMMatrixPerspectiveFovLH(fovAngleY_, aspectRatio, nearZ_, farZ_);
 }
 
 //---------------------------------------------------------------------------------
@@ -36,8 +36,16 @@ public:
     //---------------------------------------------------------------------------------
     /**
      * @brief    J
+     * @param	aspectRatio	AXyNgi / cj
      */
-    void initialize() noexcept;
+    void initialize(float aspectRatio) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    AXyNgύXăvWFNVs蒼
+     * @param	aspectRatio	AXyNgi / cj
+     */
+    void setAspectRatio(float aspectRatio) noexcept;
 
     //---------------------------------------------------------------------------------
     /**
@@ -0,0 +1,603 @@
+﻿// コマンドのキャプチャと再生クラス
+
+#include "command_capture.h"
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstring>
+
+namespace {
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	ストリームの読み出し位置
+     * 範囲外を読もうとすると以降は全て失敗する
+     */
+    class StreamReader final {
+    public:
+        //---------------------------------------------------------------------------------
+        /**
+         * @brief    コンストラクタ
+         * @param	data	読むバイト列
+         */
+        explicit StreamReader(std::span<const uint8_t> data) noexcept
+            : data_(data) {
+        }
+
+        //---------------------------------------------------------------------------------
+        /**
+         * @brief	値を読む
+         * @param	value	読んだ値
+         * @return	読めた場合は true
+         */
+        template <class T>
+        [[nodiscard]] bool read(T& value) noexcept {
+            const auto bytes = readBytes(sizeof(T));
+            if (bytes.empty()) {
+                return false;
+            }
+            std::memcpy(&value, bytes.data(), sizeof(T));
+            return true;
+        }
+
+        //---------------------------------------------------------------------------------
+        /**
+         * @brief	バイト列を読む
+         * @param	size	読むサイズ
+         * @return	読んだバイト列、読めない場合は空
+         */
+        [[nodiscard]] std::span<const uint8_t> readBytes(size_t size) noexcept {
+            if (failed_ || size == 0 || data_.size() - offset_ < size) {
+                failed_ = true;
+                return {};
+            }
+            const auto bytes = data_.subspan(offset_, size);
+            offset_ += size;
+            return bytes;
+        }
+
+        //---------------------------------------------------------------------------------
+        /**
+         * @brief	最後まで読んだかを調べる
+         * @return	最後まで読んだ場合は true
+         */
+        [[nodiscard]] bool finished() const noexcept {
+            return offset_ == data_.size();
+        }
+
+    private:
+        std::span<const uint8_t> data_{};    /// 読むバイト列
+        size_t                   offset_{};  /// 読み出し位置
+        bool                     failed_{};  /// 範囲外を読もうとしたか
+    };
+}  // namespace
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	記録したコマンドを全て破棄する
+ * 確保済みの領域は次のキャプチャで再利用する
+ */
+void CommandStream::clear() noexcept {
+    data_.clear();
+    resources_.clear();
+    pipelines_.clear();
+    commandCount_ = 0;
+    uploadSize_ = 0;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	コマンドが無いかを調べる
+ * @return	無ければ true
+ */
+[[nodiscard]] bool CommandStream::empty() const noexcept {
+    return commandCount_ == 0;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	記録したコマンドの数を取得する
+ * @return	コマンドの数
+ */
+[[nodiscard]] uint32_t CommandStream::commandCount() const noexcept {
+    return commandCount_;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	記録したバイト列を取得する
+ * @return	バイト列
+ */
+[[nodiscard]] std::span<const uint8_t> CommandStream::bytes() const noexcept {
+    return data_;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	記録した定数データの合計サイズを取得する
+ * @return	合計サイズ
+ */
+[[nodiscard]] uint64_t CommandStream::uploadSize() const noexcept {
+    return uploadSize_;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	バイト列を書き込む
+ * @param	data	書き込むデータ
+ * @param	size	書き込むサイズ
+ */
+void CommandStream::writeBytes(const void* data, size_t size) noexcept {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    data_.insert(data_.end(), bytes, bytes + size);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	コマンドの種類を書き込む
+ * @param	command	コマンドの種類
+ */
+void CommandStream::writeCommand(Command command) noexcept {
+    write(command);
+    ++commandCount_;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	リソースを表に登録して番号を取得する
+ * @param	resource	リソース
+ * @return	表の番号
+ */
+[[nodiscard]] uint16_t CommandStream::resourceIndex(RhiResource& resource) noexcept {
+    // 一フレームで参照するリソースは少ないので線形に探す
+    const auto it = std::find(resources_.begin(), resources_.end(), &resource);
+    if (it != resources_.end()) {
+        return static_cast<uint16_t>(it - resources_.begin());
+    }
+    assert(resources_.size() < UINT16_MAX && "参照するリソースが多すぎます");
+    resources_.push_back(&resource);
+    return static_cast<uint16_t>(resources_.size() - 1);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	パイプラインを表に登録して番号を取得する
+ * @param	pipeline	パイプライン
+ * @return	表の番号
+ */
+[[nodiscard]] uint16_t CommandStream::pipelineIndex(const RhiPipeline& pipeline) noexcept {
+    const auto it = std::find(pipelines_.begin(), pipelines_.end(), &pipeline);
+    if (it != pipelines_.end()) {
+        return static_cast<uint16_t>(it - pipelines_.begin());
+    }
+    assert(pipelines_.size() < UINT16_MAX && "参照するパイプラインが多すぎます");
+    pipelines_.push_back(&pipeline);
+    return static_cast<uint16_t>(pipelines_.size() - 1);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief    コンストラクタ
+ * @param	stream	記録先のストリーム
+ * @param	target	コマンドの転送先（記録だけする場合は nullptr）
+ */
+CaptureCommandList::CaptureCommandList(CommandStream& stream, RhiCommandList* target) noexcept
+    : stream_(&stream), target_(target) {
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	記録を開始する
+ * ストリームには記録しない（再生側で開始と終了を行う）
+ */
+void CaptureCommandList::reset() noexcept {
+    if (target_) {
+        target_->reset();
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	記録を終了する
+ * ストリームには記録しない（再生側で開始と終了を行う）
+ */
+void CaptureCommandList::close() noexcept {
+    if (target_) {
+        target_->close();
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	リソースのステート遷移を記録する
+ * @param	resource	対象のリソース
+ * @param	before		遷移前のステート
+ * @param	after		遷移後のステート
+ */
+void CaptureCommandList::barrier(RhiResource& resource, RhiResourceState before, RhiResourceState after) noexcept {
+    stream_->writeCommand(CommandStream::Command::barrier);
+    stream_->write(stream_->resourceIndex(resource));
+    stream_->write(before);
+    stream_->write(after);
+    if (target_) {
+        target_->barrier(resource, before, after);
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	描画先を設定する
+ * @param	target	描画先
+ */
+void CaptureCommandList::setRenderTarget(RhiTexture& target) noexcept {
+    stream_->writeCommand(CommandStream::Command::setRenderTarget);
+    stream_->write(stream_->resourceIndex(target));
+    if (target_) {
+        target_->setRenderTarget(target);
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	描画先をクリアする
+ * @param	target	描画先
+ * @param	color	クリア色
+ */
+void CaptureCommandList::clearRenderTarget(RhiTexture& target, const float (&color)[4]) noexcept {
+    stream_->writeCommand(CommandStream::Command::clearRenderTarget);
+    stream_->write(stream_->resourceIndex(target));
+    stream_->write(color);
+    if (target_) {
+        target_->clearRenderTarget(target, color);
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	ビューポートを設定する
+ * @param	viewport	ビューポート
+ */
+void CaptureCommandList::setViewport(const RhiViewport& viewport) noexcept {
+    stream_->writeCommand(CommandStream::Command::setViewport);
+    stream_->write(viewport);
+    if (target_) {
+        target_->setViewport(viewport);
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	シザー矩形を設定する
+ * @param	rect	シザー矩形
+ */
+void CaptureCommandList::setScissor(const RhiRect& rect) noexcept {
+    stream_->writeCommand(CommandStream::Command::setScissor);
+    stream_->write(rect);
+    if (target_) {
+        target_->setScissor(rect);
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	パイプラインを設定する
+ * @param	pipeline	パイプライン
+ */
+void CaptureCommandList::setPipeline(const RhiPipeline& pipeline) noexcept {
+    stream_->writeCommand(CommandStream::Command::setPipeline);
+    stream_->write(stream_->pipelineIndex(pipeline));
+    if (target_) {
+        target_->setPipeline(pipeline);
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	定数バッファを設定する
+ * @param	parameterIndex	ルートパラメータの番号
+ * @param	address			定数バッファの GPU アドレス
+ */
+void CaptureCommandList::setConstantBuffer(uint32_t parameterIndex, RhiGpuAddress address) noexcept {
+    stream_->writeCommand(CommandStream::Command::setConstantBuffer);
+    stream_->write(static_cast<uint8_t>(parameterIndex));
+    stream_->write(address);
+    if (target_) {
+        target_->setConstantBuffer(parameterIndex, address);
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	シェーダリソースを設定する
+ * @param	parameterIndex	ルートパラメータの番号
+ * @param	address			バッファの GPU アドレス
+ */
+void CaptureCommandList::setShaderResource(uint32_t parameterIndex, RhiGpuAddress address) noexcept {
+    stream_->writeCommand(CommandStream::Command::setShaderResource);
+    stream_->write(static_cast<uint8_t>(parameterIndex));
+    stream_->write(address);
+    if (target_) {
+        target_->setShaderResource(parameterIndex, address);
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	ルート定数を設定する
+ * @param	parameterIndex	ルートパラメータの番号
+ * @param	value			値
+ * @param	offset			32bit 単位の位置
+ */
+void CaptureCommandList::setConstant(uint32_t parameterIndex, uint32_t value, uint32_t offset) noexcept {
+    stream_->writeCommand(CommandStream::Command::setConstant);
+    stream_->write(static_cast<uint8_t>(parameterIndex));
+    stream_->write(static_cast<uint8_t>(offset));
+    stream_->write(value);
+    if (target_) {
+        target_->setConstant(parameterIndex, value, offset);
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	頂点バッファを設定する
+ * @param	view	頂点バッファビュー
+ */
+void CaptureCommandList::setVertexBuffer(const RhiVertexBufferView& view) noexcept {
+    stream_->writeCommand(CommandStream::Command::setVertexBuffer);
+    stream_->write(view);
+    if (target_) {
+        target_->setVertexBuffer(view);
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	インデックスバッファを設定する
+ * @param	view	インデックスバッファビュー
+ */
+void CaptureCommandList::setIndexBuffer(const RhiIndexBufferView& view) noexcept {
+    stream_->writeCommand(CommandStream::Command::setIndexBuffer);
+    stream_->write(view);
+    if (target_) {
+        target_->setIndexBuffer(view);
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	インデックス付きのインスタンス描画を行う
+ * @param	indexCount		インスタンス毎のインデックス数
+ * @param	instanceCount	インスタンスの数
+ * @param	startIndex		先頭インデックスの位置
+ * @param	baseVertex		インデックスに加える頂点の位置
+ * @param	startInstance	インスタンス番号の開始値
+ */
+void CaptureCommandList::drawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex, int32_t baseVertex, uint32_t startInstance) noexcept {
+    stream_->writeCommand(CommandStream::Command::drawIndexedInstanced);
+    stream_->write(indexCount);
+    stream_->write(instanceCount);
+    stream_->write(startIndex);
+    stream_->write(baseVertex);
+    stream_->write(startInstance);
+    if (target_) {
+        target_->drawIndexedInstanced(indexCount, instanceCount, startIndex, baseVertex, startInstance);
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	定数データの書き込みを記録する
+ * 書き込み自体は呼び出し側で済ませておく
+ * @param	address	書き込んだ GPU アドレス
+ * @param	data	書き込んだデータ
+ */
+void CaptureCommandList::upload(RhiGpuAddress address, std::span<const uint8_t> data) noexcept {
+    if (data.empty()) {
+        return;
+    }
+    stream_->writeCommand(CommandStream::Command::upload);
+    stream_->write(address);
+    stream_->write(static_cast<uint32_t>(data.size()));
+    stream_->writeBytes(data.data(), data.size());
+    stream_->uploadSize_ += data.size();
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	ストリームのコマンドを発行する
+ * コマンドリストは記録中であること
+ * @param	stream		再生するストリーム
+ * @param	commandList	発行先のコマンドリスト
+ * @param	upload		定数データの書き込みに使う関数（空なら書き込まない）
+ * @return	ストリームが壊れていたり書き込めなかった場合は false
+ */
+[[nodiscard]] bool CommandReplayer::replay(const CommandStream& stream, RhiCommandList& commandList, const UploadFunction& upload) noexcept {
+    StreamReader reader(stream.bytes());
+
+    // 表の番号から参照先を引く（範囲外なら壊れたストリーム）
+    const auto resource = [&](RhiResource*& output) {
+        uint16_t index = 0;
+        if (!reader.read(index) || index >= stream.resources_.size()) {
+            return false;
+        }
+        output = stream.resources_[index];
+        return true;
+    };
+
+    for (uint32_t i = 0; i < stream.commandCount_; ++i) {
+        CommandStream::Command command{};
+        if (!reader.read(command)) {
+            return false;
+        }
+
+        switch (command) {
+            case CommandStream::Command::barrier: {
+                RhiResource*     target = nullptr;
+                RhiResourceState before = 0;
+                RhiResourceState after = 0;
+                if (!resource(target) || !reader.read(before) || !reader.read(after)) {
+                    return false;
+                }
+                commandList.barrier(*target, before, after);
+                break;
+            }
+            case CommandStream::Command::setRenderTarget: {
+                // 描画先として記録したリソースはテクスチャなので、そのまま戻せる
+                RhiResource* target = nullptr;
+                if (!resource(target)) {
+                    return false;
+                }
+                commandList.setRenderTarget(*static_cast<RhiTexture*>(target));
+                break;
+            }
+            case CommandStream::Command::clearRenderTarget: {
+                RhiResource* target = nullptr;
+                float        color[4]{};
+                if (!resource(target) || !reader.read(color)) {
+                    return false;
+                }
+                commandList.clearRenderTarget(*static_cast<RhiTexture*>(target), color);
+                break;
+            }
+            case CommandStream::Command::setViewport: {
+                RhiViewport viewport{};
+                if (!reader.read(viewport)) {
+                    return false;
+                }
+                commandList.setViewport(viewport);
+                break;
+            }
+            case CommandStream::Command::setScissor: {
+                RhiRect rect{};
+                if (!reader.read(rect)) {
+                    return false;
+                }
+                commandList.setScissor(rect);
+                break;
+            }
+            case CommandStream::Command::setPipeline: {
+                uint16_t index = 0;
+                if (!reader.read(index) || index >= stream.pipelines_.size()) {
+                    return false;
+                }
+                commandList.setPipeline(*stream.pipelines_[index]);
+                break;
+            }
+            case CommandStream::Command::setConstantBuffer:
+            case CommandStream::Command::setShaderResource: {
+                uint8_t       parameterIndex = 0;
+                RhiGpuAddress address = 0;
+                if (!reader.read(parameterIndex) || !reader.read(address)) {
+                    return false;
+                }
+                if (command == CommandStream::Command::setConstantBuffer) {
+                    commandList.setConstantBuffer(parameterIndex, address);
+                } else {
+                    commandList.setShaderResource(parameterIndex, address);
+                }
+                break;
+            }
+            case CommandStream::Command::setConstant: {
+                uint8_t  parameterIndex = 0;
+                uint8_t  offset = 0;
+                uint32_t value = 0;
+                if (!reader.read(parameterIndex) || !reader.read(offset) || !reader.read(value)) {
+                    return false;
+                }
+                commandList.setConstant(parameterIndex, value, offset);
+                break;
+            }
+            case CommandStream::Command::setVertexBuffer: {
+                RhiVertexBufferView view{};
+                if (!reader.read(view)) {
+                    return false;
+                }
+                commandList.setVertexBuffer(view);
+                break;
+            }
+            case CommandStream::Command::setIndexBuffer: {
+                RhiIndexBufferView view{};
+                if (!reader.read(view)) {
+                    return false;
+                }
+                commandList.setIndexBuffer(view);
+                break;
+            }
+            case CommandStream::Command::drawIndexedInstanced: {
+                uint32_t indexCount = 0;
+                uint32_t instanceCount = 0;
+                uint32_t startIndex = 0;
+                int32_t  baseVertex = 0;
+                uint32_t startInstance = 0;
+                if (!reader.read(indexCount) || !reader.read(instanceCount) || !reader.read(startIndex) || !reader.read(baseVertex) || !reader.read(startInstance)) {
+                    return false;
+                }
+                commandList.drawIndexedInstanced(indexCount, instanceCount, startIndex, baseVertex, startInstance);
+                break;
+            }
+            case CommandStream::Command::upload: {
+                RhiGpuAddress address = 0;
+                uint32_t      size = 0;
+                if (!reader.read(address) || !reader.read(size)) {
+                    return false;
+                }
+                const auto data = reader.readBytes(size);
+                if (data.empty()) {
+                    return false;
+                }
+                if (upload && !upload(address, data)) {
+                    return false;
+                }
+                break;
+            }
+            default:
+                return false;
+        }
+    }
+
+    return reader.finished();
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	ストリームを繰り返し再生して時間を計る
+ * 一回毎に記録、提出、GPU の完了待ちまでを行うので、呼ぶ前に GPU の処理を全て終えておくこと
+ * @param	stream			再生するストリーム
+ * @param	device			コマンドリストとフェンスを作成するデバイス
+ * @param	repeatCount		繰り返す回数
+ * @param	upload			定数データの書き込みに使う関数（空なら書き込まない）
+ * @param	milliseconds	一回毎の記録から完了までの時間（ミリ秒）
+ * @return	全て再生できた場合は true
+ */
+[[nodiscard]] bool CommandReplayer::benchmark(const CommandStream& stream, RhiDevice& device, uint32_t repeatCount, const UploadFunction& upload, std::vector<double>& milliseconds) noexcept {
+    milliseconds.clear();
+
+    auto commandList = device.createCommandList(RhiQueueType::graphics);
+    auto fence = device.createFence();
+    if (!commandList || !fence) {
+        assert(false && "再生用のコマンドリストかフェンスの作成に失敗しました");
+        return false;
+    }
+
+    auto& queue = device.queue(RhiQueueType::graphics);
+    RhiCommandList* const commandLists[] = { commandList.get() };
+    milliseconds.reserve(repeatCount);
+    for (uint32_t i = 0; i < repeatCount; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+
+        commandList->reset();
+        const auto replayed = replay(stream, *commandList, upload);
+        commandList->close();
+        if (!replayed) {
+            return false;
+        }
+        queue.execute(commandLists);
+        queue.signal(*fence, i + 1);
+        fence->wait(i + 1);
+
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        milliseconds.push_back(std::chrono::duration<double, std::milli>(elapsed).count());
+    }
+
+    return true;
+}
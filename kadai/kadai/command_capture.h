@@ -0,0 +1,231 @@
+﻿// コマンドのキャプチャと再生クラス
+
+#pragma once
+
+#include "rhi.h"
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	コマンドストリームクラス
+ * 一フレーム分のコマンドを詰めたバイト列
+ * コマンドは 1 バイトの種類の後に引数を続け、リソースとパイプラインはストリーム内の表の番号で参照する
+ * 定数データの書き込みは中身ごと記録するので、再生すると毎回同じ内容で描画できる
+ * リソースとパイプラインはポインタで持つので、再生はキャプチャしたものが生きている間に同じプロセスで行う
+ */
+class CommandStream final {
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	コマンドの種類
+     */
+    enum class Command : uint8_t {
+        barrier,               /// リソースのステート遷移
+        setRenderTarget,       /// 描画先の設定
+        clearRenderTarget,     /// 描画先のクリア
+        setViewport,           /// ビューポートの設定
+        setScissor,            /// シザー矩形の設定
+        setPipeline,           /// パイプラインの設定
+        setConstantBuffer,     /// 定数バッファの設定
+        setShaderResource,     /// シェーダリソースの設定
+        setConstant,           /// ルート定数の設定
+        setVertexBuffer,       /// 頂点バッファの設定
+        setIndexBuffer,        /// インデックスバッファの設定
+        drawIndexedInstanced,  /// インデックス付きのインスタンス描画
+        upload,                /// 定数データの書き込み
+    };
+
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    コンストラクタ
+     */
+    CommandStream() = default;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    デストラクタ
+     */
+    ~CommandStream() = default;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	記録したコマンドを全て破棄する
+     * 確保済みの領域は次のキャプチャで再利用する
+     */
+    void clear() noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	コマンドが無いかを調べる
+     * @return	無ければ true
+     */
+    [[nodiscard]] bool empty() const noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	記録したコマンドの数を取得する
+     * @return	コマンドの数
+     */
+    [[nodiscard]] uint32_t commandCount() const noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	記録したバイト列を取得する
+     * @return	バイト列
+     */
+    [[nodiscard]] std::span<const uint8_t> bytes() const noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	記録した定数データの合計サイズを取得する
+     * @return	合計サイズ
+     */
+    [[nodiscard]] uint64_t uploadSize() const noexcept;
+
+private:
+    friend class CaptureCommandList;
+    friend class CommandReplayer;
+    friend class CommandStreamTestAccess;  // テストで途中で切れたり壊れたりしたストリームを作る
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	値をそのまま書き込む
+     * @param	value	書き込む値
+     */
+    template <class T>
+    void write(const T& value) noexcept {
+        static_assert(std::is_trivially_copyable_v<T>, "そのまま書き込めない型です");
+        writeBytes(&value, sizeof(T));
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	バイト列を書き込む
+     * @param	data	書き込むデータ
+     * @param	size	書き込むサイズ
+     */
+    void writeBytes(const void* data, size_t size) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	コマンドの種類を書き込む
+     * @param	command	コマンドの種類
+     */
+    void writeCommand(Command command) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	リソースを表に登録して番号を取得する
+     * @param	resource	リソース
+     * @return	表の番号
+     */
+    [[nodiscard]] uint16_t resourceIndex(RhiResource& resource) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	パイプラインを表に登録して番号を取得する
+     * @param	pipeline	パイプライン
+     * @return	表の番号
+     */
+    [[nodiscard]] uint16_t pipelineIndex(const RhiPipeline& pipeline) noexcept;
+
+private:
+    std::vector<uint8_t>            data_{};          /// コマンドのバイト列
+    std::vector<RhiResource*>       resources_{};     /// 参照したリソースの表
+    std::vector<const RhiPipeline*> pipelines_{};     /// 参照したパイプラインの表
+    uint32_t                        commandCount_{};  /// コマンドの数
+    uint64_t                        uploadSize_{};    /// 定数データの合計サイズ
+};
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	キャプチャ用のコマンドリスト
+ * 受け取ったコマンドをストリームに記録し、転送先があればそのまま転送する
+ * 定数データはコマンドリストを通らないので、書き込んだ側が upload で中身を記録する
+ */
+class CaptureCommandList final : public RhiCommandList {
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    コンストラクタ
+     * @param	stream	記録先のストリーム
+     * @param	target	コマンドの転送先（記録だけする場合は nullptr）
+     */
+    explicit CaptureCommandList(CommandStream& stream, RhiCommandList* target = nullptr) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    デストラクタ
+     */
+    ~CaptureCommandList() override = default;
+
+    void reset() noexcept override;
+    void close() noexcept override;
+    void barrier(RhiResource& resource, RhiResourceState before, RhiResourceState after) noexcept override;
+    void setRenderTarget(RhiTexture& target) noexcept override;
+    void clearRenderTarget(RhiTexture& target, const float (&color)[4]) noexcept override;
+    void setViewport(const RhiViewport& viewport) noexcept override;
+    void setScissor(const RhiRect& rect) noexcept override;
+    void setPipeline(const RhiPipeline& pipeline) noexcept override;
+    void setConstantBuffer(uint32_t parameterIndex, RhiGpuAddress address) noexcept override;
+    void setShaderResource(uint32_t parameterIndex, RhiGpuAddress address) noexcept override;
+    void setConstant(uint32_t parameterIndex, uint32_t value, uint32_t offset) noexcept override;
+    void setVertexBuffer(const RhiVertexBufferView& view) noexcept override;
+    void setIndexBuffer(const RhiIndexBufferView& view) noexcept override;
+    void drawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex, int32_t baseVertex, uint32_t startInstance) noexcept override;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	定数データの書き込みを記録する
+     * 書き込み自体は呼び出し側で済ませておく
+     * @param	address	書き込んだ GPU アドレス
+     * @param	data	書き込んだデータ
+     */
+    void upload(RhiGpuAddress address, std::span<const uint8_t> data) noexcept;
+
+private:
+    CommandStream*  stream_{};  /// 記録先のストリーム
+    RhiCommandList* target_{};  /// コマンドの転送先
+};
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	コマンドの再生クラス
+ * キャプチャしたストリームを別のコマンドリストに発行し直す
+ * アニメーションなどの状態に左右されず同じコマンドを繰り返せるので、提出処理の変更前後の計測に使う
+ */
+class CommandReplayer final {
+public:
+    /// 定数データを GPU アドレスに書き込む関数（書き込めなければ false を返す）
+    using UploadFunction = std::function<bool(RhiGpuAddress address, std::span<const uint8_t> data)>;
+
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	ストリームのコマンドを発行する
+     * コマンドリストは記録中であること
+     * @param	stream		再生するストリーム
+     * @param	commandList	発行先のコマンドリスト
+     * @param	upload		定数データの書き込みに使う関数（空なら書き込まない）
+     * @return	ストリームが壊れていたり書き込めなかった場合は false
+     */
+    [[nodiscard]] static bool replay(const CommandStream& stream, RhiCommandList& commandList, const UploadFunction& upload) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	ストリームを繰り返し再生して時間を計る
+     * 一回毎に記録、提出、GPU の完了待ちまでを行うので、呼ぶ前に GPU の処理を全て終えておくこと
+     * @param	stream			再生するストリーム
+     * @param	device			コマンドリストとフェンスを作成するデバイス
+     * @param	repeatCount		繰り返す回数
+     * @param	upload			定数データの書き込みに使う関数（空なら書き込まない）
+     * @param	milliseconds	一回毎の記録から完了までの時間（ミリ秒）
+     * @return	全て再生できた場合は true
+     */
+    [[nodiscard]] static bool benchmark(const CommandStream& stream, RhiDevice& device, uint32_t repeatCount, const UploadFunction& upload, std::vector<double>& milliseconds) noexcept;
+};
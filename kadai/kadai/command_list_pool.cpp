@@ -0,0 +1,78 @@
+﻿// コマンドリストプールクラス
+
+#include "command_list_pool.h"
+#include <cassert>
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	コマンドリストプールを作成する
+ * @param	device		デバイスクラスのインスタンス
+ * @param	threadCount	記録スレッドの数
+ * @param	frameCount	同時に処理するフレームの数
+ * @return	生成の成否
+ */
+[[nodiscard]] bool CommandListPool::create(const Device& device, UINT threadCount, UINT frameCount) noexcept {
+    threadCount_ = threadCount;
+    frameCount_ = frameCount;
+
+    // 要素は作成後に移動しないので、サイズを確定してから生成する
+    const auto count = static_cast<size_t>(threadCount) * frameCount;
+    commandAllocators_ = std::vector<CommandAllocator>(count);
+    commandLists_ = std::vector<CommandList>(count);
+
+    for (size_t i = 0; i < count; ++i) {
+        if (!commandAllocators_[i].create(device, D3D12_COMMAND_LIST_TYPE_DIRECT)) {
+            return false;
+        }
+        if (!commandLists_[i].create(device, commandAllocators_[i])) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	記録を始めるためにアロケータとコマンドリストをリセットする
+ * 対象フレームの GPU 処理が完了してから呼び出すこと
+ * @param	threadIndex	記録スレッドの番号
+ * @param	frameIndex	フレームの番号
+ */
+void CommandListPool::reset(UINT threadIndex, UINT frameIndex) noexcept {
+    const auto index = slot(threadIndex, frameIndex);
+    commandAllocators_[index].reset();
+    commandLists_[index].reset(commandAllocators_[index]);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	コマンドリストを取得する
+ * @param	threadIndex	記録スレッドの番号
+ * @param	frameIndex	フレームの番号
+ * @return	コマンドリストクラスのインスタンス
+ */
+[[nodiscard]] const CommandList& CommandListPool::get(UINT threadIndex, UINT frameIndex) const noexcept {
+    return commandLists_[slot(threadIndex, frameIndex)];
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	記録スレッドの数を取得する
+ * @return	記録スレッドの数
+ */
+[[nodiscard]] UINT CommandListPool::threadCount() const noexcept {
+    return threadCount_;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	配列上の位置を計算する
+ * @param	threadIndex	記録スレッドの番号
+ * @param	frameIndex	フレームの番号
+ * @return	配列上の位置
+ */
+[[nodiscard]] size_t CommandListPool::slot(UINT threadIndex, UINT frameIndex) const noexcept {
+    assert(threadIndex < threadCount_ && frameIndex < frameCount_ && "不正なコマンドリストの番号です");
+    return static_cast<size_t>(frameIndex) * threadCount_ + threadIndex;
+}
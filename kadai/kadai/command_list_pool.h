@@ -0,0 +1,80 @@
+﻿// コマンドリストプールクラス
+
+#pragma once
+
+#include "device.h"
+#include "command_allocator.h"
+#include "command_list.h"
+#include <vector>
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	コマンドリストプールクラス
+ * 記録スレッド毎・処理中フレーム毎にコマンドアロケータとコマンドリストの組を持つ
+ * スレッド毎に別のアロケータを使うので、同期なしで並列に記録できる
+ */
+class CommandListPool final {
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    コンストラクタ
+     */
+    CommandListPool() = default;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    デストラクタ
+     */
+    ~CommandListPool() = default;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	コマンドリストプールを作成する
+     * @param	device		デバイスクラスのインスタンス
+     * @param	threadCount	記録スレッドの数
+     * @param	frameCount	同時に処理するフレームの数
+     * @return	生成の成否
+     */
+    [[nodiscard]] bool create(const Device& device, UINT threadCount, UINT frameCount) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	記録を始めるためにアロケータとコマンドリストをリセットする
+     * 対象フレームの GPU 処理が完了してから呼び出すこと
+     * @param	threadIndex	記録スレッドの番号
+     * @param	frameIndex	フレームの番号
+     */
+    void reset(UINT threadIndex, UINT frameIndex) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	コマンドリストを取得する
+     * @param	threadIndex	記録スレッドの番号
+     * @param	frameIndex	フレームの番号
+     * @return	コマンドリストクラスのインスタンス
+     */
+    [[nodiscard]] const CommandList& get(UINT threadIndex, UINT frameIndex) const noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	記録スレッドの数を取得する
+     * @return	記録スレッドの数
+     */
+    [[nodiscard]] UINT threadCount() const noexcept;
+
+private:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	配列上の位置を計算する
+     * @param	threadIndex	記録スレッドの番号
+     * @param	frameIndex	フレームの番号
+     * @return	配列上の位置
+     */
+    [[nodiscard]] size_t slot(UINT threadIndex, UINT frameIndex) const noexcept;
+
+private:
+    std::vector<CommandAllocator> commandAllocators_{};  /// コマンドアロケータ
+    std::vector<CommandList>      commandLists_{};       /// コマンドリスト
+    UINT                          threadCount_{};        /// 記録スレッドの数
+    UINT                          frameCount_{};         /// 同時に処理するフレームの数
+};
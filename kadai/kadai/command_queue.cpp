@@ -19,12 +19,13 @@ CommandQueue::~CommandQueue() {
 /**
  * @brief	R}hL[̐
  * @param	device	foCXNX̃CX^X
+ * @param	type	R}hXg̃^Cv
  * @return	 true
  */
-[[nodiscard]] bool CommandQueue::create(const Device& device) noexcept {
+[[nodiscard]] bool CommandQueue::create(const Device& device, D3D12_COMMAND_LIST_TYPE type) noexcept {
     // R}hL[̐ݒ
     D3D12_COMMAND_QUEUE_DESC desc{};
-    desc.Type = D3D12_COMMAND_LIST_TYPE_DIRECT;       // _CNgR}hL[
+    desc.Type = type;                                     // `p̓_CNgA]p̓Rs[
     desc.Priority = D3D12_COMMAND_QUEUE_PRIORITY_NORMAL;  // ʏDx
     desc.Flags = D3D12_COMMAND_QUEUE_FLAG_NONE;        // ʃtOȂ
     desc.NodeMask = 0;                                    // GPU ͂ЂƂ̂ݎgp
@@ -26,9 +26,10 @@ public:
     /**
      * @brief	R}hL[̐
      * @param	device	foCXNX̃CX^X
+     * @param	type	R}hXg̃^Cv
      * @return	̐
      */
-    [[nodiscard]] bool create(const Device& device) noexcept;
+    [[nodiscard]] bool create(const Device& device, D3D12_COMMAND_LIST_TYPE type = D3D12_COMMAND_LIST_TYPE_DIRECT) noexcept;
 
     //---------------------------------------------------------------------------------
     /**
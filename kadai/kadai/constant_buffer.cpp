@@ -1,102 +0,0 @@
-
-#include "constant_buffer.h"
-#include <cassert>
-
-//---------------------------------------------------------------------------------
-/**
- * @brief    fXgN^
- */
-    ConstantBuffer::~ConstantBuffer() {
-    if (constantBuffer_) {
-        constantBuffer_->Release();
-        constantBuffer_ = nullptr;
-    }
-}
-
-//---------------------------------------------------------------------------------
-/**
- * @brief	RX^gobt@̍쐬
- * @param	device			foCXNX̃CX^X
- * @param	heap			o^̃fBXNv^q[ṽCX^X
- * @param	bufferSize		RX^gobt@̃TCY
- * @param	descriptorIndex	fBXNv^̓o^CfbNX
- * @return	̐
- */
-[[nodiscard]] bool ConstantBuffer::create(const Device& device, const DescriptorHeap& heap, UINT bufferSize, UINT descriptorIndex) noexcept {
-    // ACgς݃TCY̌vZ
-    const auto size = (sizeof(bufferSize) + 255) & ~255;
-
-    // obt@\[X̍쐬
-    D3D12_HEAP_PROPERTIES heapProps{};
-    heapProps.Type = D3D12_HEAP_TYPE_UPLOAD;
-    D3D12_RESOURCE_DESC resourceDesc{};
-    resourceDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
-    resourceDesc.Width = size;
-    resourceDesc.Height = 1;
-    resourceDesc.DepthOrArraySize = 1;
-    resourceDesc.MipLevels = 1;
-    resourceDesc.Format = DXGI_FORMAT_UNKNOWN;
-    resourceDesc.SampleDesc.Count = 1;
-    resourceDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
-
-    const auto res = device.get()->CreateCommittedResource(
-        &heapProps,
-        D3D12_HEAP_FLAG_NONE,
-        &resourceDesc,
-        D3D12_RESOURCE_STATE_GENERIC_READ,
-        nullptr,
-        IID_PPV_ARGS(&constantBuffer_));
-    if (FAILED(res)) {
-        assert(false && "RX^gobt@̍쐬Ɏs܂");
-        return false;
-    }
-
-    // r[̍쐬
-    auto heapType = heap.getType();
-    if (heapType != D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV) {
-        assert(false && "fBXNv^q[ṽ^Cv CBV_SRV_UAV ł͂܂");
-        false;
-    }
-
-    // RX^gobt@r[̐ݒ
-    D3D12_CONSTANT_BUFFER_VIEW_DESC cbvDesc{};
-    cbvDesc.BufferLocation = constantBuffer_->GetGPUVirtualAddress();
-    cbvDesc.SizeInBytes = size;
-
-    // fBXNv^̃TCY擾
-    UINT cbvDescriptorSize = device.get()->GetDescriptorHandleIncrementSize(heap.getType());
-
-    // fBXNv^q[v̊Jnnh擾
-    D3D12_CPU_DESCRIPTOR_HANDLE cpuHandle = heap.get()->GetCPUDescriptorHandleForHeapStart();
-    // w肳ꂽCfbNXnhi߂
-    cpuHandle.ptr += descriptorIndex * cbvDescriptorSize;
-
-    // RX^gobt@r[ƃnh֘At
-    device.get()->CreateConstantBufferView(&cbvDesc, cpuHandle);
-
-    // GPU pfBXNv^nhۑ
-    gpuHandle_ = heap.get()->GetGPUDescriptorHandleForHeapStart();
-    // w肳ꂽCfbNXnhi߂
-    gpuHandle_.ptr += descriptorIndex * cbvDescriptorSize;
-
-    return true;
-}
-
-//---------------------------------------------------------------------------------
-/**
- * @brief	RX^gobt@擾
- * @return	RX^gobt@̃|C^
- */
-[[nodiscard]] ID3D12Resource* ConstantBuffer::constantBuffer() const noexcept {
-    assert(constantBuffer_ && "RX^gobt@쐬ł");
-    return constantBuffer_;
-}
-
-//---------------------------------------------------------------------------------
-/**
- * @brief	GPU pfBXNv^nh擾
- * @return	GPU pfBXNv^nh
- */
-[[nodiscard]] D3D12_GPU_DESCRIPTOR_HANDLE ConstantBuffer::getGpuDescriptorHandle() const noexcept {
-    return gpuHandle_;
-}
\ No newline at end of file
@@ -1,55 +0,0 @@
-// RX^gobt@NX
-
-#pragma once
-
-#include "device.h"
-#include "descriptor_heap.h"
-
-//---------------------------------------------------------------------------------
-/**
- * @brief	RX^gobt@NX
- */
-class ConstantBuffer final {
-public:
-    //---------------------------------------------------------------------------------
-    /**
-     * @brief    RXgN^
-     */
-    ConstantBuffer() = default;
-
-    //---------------------------------------------------------------------------------
-    /**
-     * @brief    fXgN^
-     */
-    ~ConstantBuffer();
-
-    //---------------------------------------------------------------------------------
-    /**
-     * @brief	RX^gobt@̍쐬
-     * @param	device			foCXNX̃CX^X
-     * @param	heap			o^̃fBXNv^q[ṽCX^X
-     * @param	bufferSize		RX^gobt@̃TCY
-     * @param	descriptorIndex	fBXNv^̓o^CfbNX
-     * @return	̐
-     */
-    [[nodiscard]] bool create(const Device& device, const DescriptorHeap& heap, UINT bufferSize, UINT descriptorIndex) noexcept;
-
-
-    //---------------------------------------------------------------------------------
-    /**
-     * @brief	RX^gobt@擾
-     * @return	RX^gobt@̃|C^
-     */
-    [[nodiscard]] ID3D12Resource* constantBuffer() const noexcept;
-
-    //---------------------------------------------------------------------------------
-    /**
-     * @brief	GPU pfBXNv^nh擾
-     * @return	GPU pfBXNv^nh
-     */
-    [[nodiscard]] D3D12_GPU_DESCRIPTOR_HANDLE getGpuDescriptorHandle() const noexcept;
-
-private:
-    ID3D12Resource* constantBuffer_{};  /// RX^gobt@
-    D3D12_GPU_DESCRIPTOR_HANDLE gpuHandle_{};       /// GPU pfBXNv^nh
-};
@@ -0,0 +1,104 @@
+﻿// 遅延解放クラス
+
+#include "deferred_release.h"
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief    デストラクタ
+ * プログラム終了時には GPU の処理は終わっているので、残りを全て解放する
+ */
+DeferredRelease::~DeferredRelease() {
+    releaseAll();
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	オブジェクトの解放を予約する
+ * 現在記録中のフレームが完了した時点で解放する
+ * @param	object	解放するオブジェクト（nullptr の場合は何もしない）
+ */
+void DeferredRelease::enqueue(IUnknown* object) noexcept {
+    if (!object) {
+        return;
+    }
+
+    std::lock_guard lock(mutex_);
+    entries_.push_back({ object, nullptr, frameFenceValue_ });
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	解放処理を予約する
+ * COM オブジェクト以外（ヒープ内の領域など）の解放に使う
+ * 現在記録中のフレームが完了した時点で呼び出す
+ * @param	function	解放処理
+ */
+void DeferredRelease::enqueue(std::function<void()> function) noexcept {
+    if (!function) {
+        return;
+    }
+
+    std::lock_guard lock(mutex_);
+    entries_.push_back({ nullptr, std::move(function), frameFenceValue_ });
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	現在記録中のフレームのフェンス値を設定する
+ * @param	fenceValue	記録中のフレームの完了時にシグナルされるフェンス値
+ */
+void DeferredRelease::setFrameFenceValue(UINT64 fenceValue) noexcept {
+    std::lock_guard lock(mutex_);
+    frameFenceValue_ = fenceValue;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	GPU の処理が完了したフレームで予約されたオブジェクトを解放する
+ * @param	completedFenceValue	GPU が到達済みのフェンス値
+ */
+void DeferredRelease::release(UINT64 completedFenceValue) noexcept {
+    std::lock_guard lock(mutex_);
+
+    // フェンス値は単調に増えるので、先頭から完了済みのものだけ解放すればよい
+    while (!entries_.empty() && entries_.front().fenceValue_ <= completedFenceValue) {
+        releaseEntry(entries_.front());
+        entries_.pop_front();
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	予約されている全てのオブジェクトを解放する
+ * GPU の処理が全て完了していることを呼び出し側で保証すること
+ */
+void DeferredRelease::releaseAll() noexcept {
+    std::lock_guard lock(mutex_);
+    for (auto& entry : entries_) {
+        releaseEntry(entry);
+    }
+    entries_.clear();
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	エントリを解放する
+ * @param	entry	解放するエントリ
+ */
+void DeferredRelease::releaseEntry(Entry& entry) noexcept {
+    if (entry.object_) {
+        entry.object_->Release();
+    } else {
+        entry.function_();
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	解放待ちのオブジェクト数を取得する
+ * @return	解放待ちのオブジェクト数
+ */
+[[nodiscard]] size_t DeferredRelease::pendingCount() const noexcept {
+    std::lock_guard lock(mutex_);
+    return entries_.size();
+}
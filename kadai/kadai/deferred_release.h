@@ -0,0 +1,111 @@
+﻿// 遅延解放クラス
+
+#pragma once
+
+#include <Windows.h>
+#include <deque>
+#include <functional>
+#include <mutex>
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	遅延解放クラス
+ * GPU が参照している可能性のあるオブジェクトの解放を、フェンス値が進むまで遅らせる
+ * シングルトンパターンで作成する
+ */
+class DeferredRelease final {
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	インスタンスの取得
+     * @return	インスタンスの参照
+     */
+    static DeferredRelease& instance() noexcept {
+        static DeferredRelease instance;
+        return instance;
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	オブジェクトの解放を予約する
+     * 現在記録中のフレームが完了した時点で解放する
+     * @param	object	解放するオブジェクト（nullptr の場合は何もしない）
+     */
+    void enqueue(IUnknown* object) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	解放処理を予約する
+     * COM オブジェクト以外（ヒープ内の領域など）の解放に使う
+     * 現在記録中のフレームが完了した時点で呼び出す
+     * @param	function	解放処理
+     */
+    void enqueue(std::function<void()> function) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	現在記録中のフレームのフェンス値を設定する
+     * @param	fenceValue	記録中のフレームの完了時にシグナルされるフェンス値
+     */
+    void setFrameFenceValue(UINT64 fenceValue) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	GPU の処理が完了したフレームで予約されたオブジェクトを解放する
+     * @param	completedFenceValue	GPU が到達済みのフェンス値
+     */
+    void release(UINT64 completedFenceValue) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	予約されている全てのオブジェクトを解放する
+     * GPU の処理が全て完了していることを呼び出し側で保証すること
+     */
+    void releaseAll() noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	解放待ちのオブジェクト数を取得する
+     * @return	解放待ちのオブジェクト数
+     */
+    [[nodiscard]] size_t pendingCount() const noexcept;
+
+private:
+    // シングルトンパターンにするため、コンストラクタとデストラクタを private にする
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    コンストラクタ
+     */
+    DeferredRelease() = default;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    デストラクタ
+     * プログラム終了時には GPU の処理は終わっているので、残りを全て解放する
+     */
+    ~DeferredRelease();
+
+private:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	解放待ちのオブジェクト
+     */
+    struct Entry {
+        IUnknown*             object_{};      /// 解放するオブジェクト
+        std::function<void()> function_{};    /// 解放処理（オブジェクト以外の場合）
+        UINT64                fenceValue_{};  /// 解放してよくなるフェンス値
+    };
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	エントリを解放する
+     * @param	entry	解放するエントリ
+     */
+    static void releaseEntry(Entry& entry) noexcept;
+
+private:
+    mutable std::mutex mutex_{};            /// 別スレッドからの解放予約に備えた排他制御
+    std::deque<Entry>  entries_{};          /// 解放待ちのオブジェクト（フェンス値の昇順）
+    UINT64             frameFenceValue_{};  /// 現在記録中のフレームのフェンス値
+};
@@ -1,6 +1,7 @@
 // fBXNv^[q[vNX
 
 #include "descriptor_heap.h"
+#include "deferred_release.h"
 #include <cassert>
 
 //---------------------------------------------------------------------------------
@@ -8,6 +9,9 @@
  * @brief    fXgN^
  */
 DescriptorHeap::~DescriptorHeap() {
+    // ҂̒ɂ̃q[v̗̈Ԃ̂̂ŁAq[vɑSĉ
+    DeferredRelease::instance().releaseAll();
+
     // fBXNv^q[v̉
     if (heap_) {
         heap_->Release();
@@ -32,6 +36,7 @@ DescriptorHeap::~DescriptorHeap() {
     heapDesc.Flags = shaderVisible ? D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE : D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
 
     type_ = type;  // q[ṽ^Cvۑ
+    shaderVisible_ = shaderVisible;
 
     // fBXNv^q[v̐
     HRESULT hr = device.get()->CreateDescriptorHeap(&heapDesc, IID_PPV_ARGS(&heap_));
@@ -40,9 +45,78 @@ DescriptorHeap::~DescriptorHeap() {
         return false;
     }
 
+    // nȟvZɎgl͖₢킹ɕۑĂ
+    incrementSize_ = device.get()->GetDescriptorHandleIncrementSize(type);
+    cpuStart_ = heap_->GetCPUDescriptorHandleForHeapStart();
+    if (shaderVisible) {
+        gpuStart_ = heap_->GetGPUDescriptorHandleForHeapStart();
+    }
+
+    allocator_.initialize(numDescriptors);
+
     return true;
 }
 
+//---------------------------------------------------------------------------------
+/**
+ * @brief	fBXNv^mۂ
+ * @param	count	AĊmۂ鐔
+ * @param	handle	mۂfBXNv^
+ * @return	mۂ̐
+ */
+[[nodiscard]] bool DescriptorHeap::allocate(UINT count, Handle& handle) noexcept {
+    const auto index = allocator_.allocate(count);
+    if (index == FreeListAllocator::invalidOffset) {
+        assert(false && "fBXNv^q[v̗eʂsĂ܂");
+        return false;
+    }
+
+    handle = makeHandle(static_cast<UINT>(index), count);
+    return true;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	fBXNv^
+ * GPU Qƒ̉\̂ŁAėp̓t[̊ɂȂ
+ * @param	handle	fBXNv^iĂяo͋ɂȂj
+ */
+void DescriptorHeap::free(Handle& handle) noexcept {
+    if (handle.count_ == 0) {
+        return;
+    }
+
+    DeferredRelease::instance().enqueue([this, index = handle.index_, count = handle.count_] {
+        allocator_.free(index, count);
+    });
+    handle = {};
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	ԍ CPU pfBXNv^nh߂
+ * @param	index	q[v̔ԍ
+ * @return	CPU pfBXNv^nh
+ */
+[[nodiscard]] D3D12_CPU_DESCRIPTOR_HANDLE DescriptorHeap::cpuHandle(UINT index) const noexcept {
+    auto handle = cpuStart_;
+    handle.ptr += static_cast<SIZE_T>(index) * incrementSize_;
+    return handle;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	ԍ GPU pfBXNv^nh߂
+ * @param	index	q[v̔ԍ
+ * @return	GPU pfBXNv^nh
+ */
+[[nodiscard]] D3D12_GPU_DESCRIPTOR_HANDLE DescriptorHeap::gpuHandle(UINT index) const noexcept {
+    assert(shaderVisible_ && "VF[_[猩Ȃq[v GPU nh͎g܂");
+    auto handle = gpuStart_;
+    handle.ptr += static_cast<UINT64>(index) * incrementSize_;
+    return handle;
+}
+
 //---------------------------------------------------------------------------------
 /**
  * @brief	fBXNv^q[v擾
@@ -67,4 +141,31 @@ DescriptorHeap::~DescriptorHeap() {
         assert(false && "fBXNv^q[vł");
     }
     return type_;
-}
\ No newline at end of file
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	fBXNv^̃TCY擾
+ * @return	fBXNv^̃TCY
+ */
+[[nodiscard]] UINT DescriptorHeap::incrementSize() const noexcept {
+    return incrementSize_;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	ԍfBXNv^
+ * @param	index	q[v̔ԍ
+ * @param	count	AĊmۂ
+ * @return	fBXNv^
+ */
+[[nodiscard]] DescriptorHeap::Handle DescriptorHeap::makeHandle(UINT index, UINT count) const noexcept {
+    Handle handle{};
+    handle.cpu_ = cpuHandle(index);
+    if (shaderVisible_) {
+        handle.gpu_ = gpuHandle(index);
+    }
+    handle.index_ = index;
+    handle.count_ = count;
+    return handle;
+}
@@ -3,12 +3,26 @@
 #pragma once
 
 #include "device.h"
+#include "free_list_allocator.h"
 
 //---------------------------------------------------------------------------------
 /**
  * @brief	fBXNv^q[vNX
+ * q[vŜt[XgŊǗAfBXNv^ԍ̎wȂɊmہE
  */
 class DescriptorHeap final {
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	mۂfBXNv^
+     */
+    struct Handle {
+        D3D12_CPU_DESCRIPTOR_HANDLE cpu_{};    /// CPU pfBXNv^nh
+        D3D12_GPU_DESCRIPTOR_HANDLE gpu_{};    /// GPU pfBXNv^nhiVF[_[猩q[v̂݁j
+        UINT                        index_{};  /// q[v̔ԍ
+        UINT                        count_{};  /// AĊmۂ
+    };
+
 public:
     //---------------------------------------------------------------------------------
     /**
@@ -33,6 +47,39 @@ public:
      */
     [[nodiscard]] bool create(const Device& device, D3D12_DESCRIPTOR_HEAP_TYPE type, UINT numDescriptors, bool shaderVisible = false) noexcept;
 
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	fBXNv^mۂ
+     * @param	count	AĊmۂ鐔
+     * @param	handle	mۂfBXNv^
+     * @return	mۂ̐
+     */
+    [[nodiscard]] bool allocate(UINT count, Handle& handle) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	fBXNv^
+     * GPU Qƒ̉\̂ŁAėp̓t[̊ɂȂ
+     * @param	handle	fBXNv^iĂяo͋ɂȂj
+     */
+    void free(Handle& handle) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	ԍ CPU pfBXNv^nh߂
+     * @param	index	q[v̔ԍ
+     * @return	CPU pfBXNv^nh
+     */
+    [[nodiscard]] D3D12_CPU_DESCRIPTOR_HANDLE cpuHandle(UINT index) const noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	ԍ GPU pfBXNv^nh߂
+     * @param	index	q[v̔ԍ
+     * @return	GPU pfBXNv^nh
+     */
+    [[nodiscard]] D3D12_GPU_DESCRIPTOR_HANDLE gpuHandle(UINT index) const noexcept;
+
     //---------------------------------------------------------------------------------
     /**
      * @brief	fBXNv^q[v擾
@@ -47,7 +94,31 @@ public:
      */
     [[nodiscard]] D3D12_DESCRIPTOR_HEAP_TYPE getType() const noexcept;
 
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	fBXNv^̃TCY擾
+     * @return	fBXNv^̃TCY
+     */
+    [[nodiscard]] UINT incrementSize() const noexcept;
+
+private:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	ԍfBXNv^
+     * @param	index	q[v̔ԍ
+     * @param	count	AĊmۂ
+     * @return	fBXNv^
+     */
+    [[nodiscard]] Handle makeHandle(UINT index, UINT count) const noexcept;
+
 private:
     ID3D12DescriptorHeap* heap_{};  /// fBXNv^q[v
     D3D12_DESCRIPTOR_HEAP_TYPE type_{};  /// q[ṽ^Cv
+
+    D3D12_CPU_DESCRIPTOR_HANDLE cpuStart_{};       /// 擪 CPU pfBXNv^nh
+    D3D12_GPU_DESCRIPTOR_HANDLE gpuStart_{};       /// 擪 GPU pfBXNv^nh
+    UINT                        incrementSize_{};  /// fBXNv^̃TCYi쐬Ɉx擾j
+    bool                        shaderVisible_{};  /// VF[_[ANZX\ǂ
+
+    FreeListAllocator allocator_{};  /// fBXNv^̗̈Ǘ
 };
@@ -0,0 +1,81 @@
+﻿// 動的解像度の制御クラス
+
+#include "dynamic_resolution.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	制御の設定を変更する
+ * 倍率は新しい上限と下限の範囲に収める
+ * @param	settings	制御の設定
+ */
+void DynamicResolution::setSettings(const Settings& settings) noexcept {
+    assert(settings.minScale_ > 0.0f && settings.minScale_ <= settings.maxScale_ && "倍率の範囲が不正です");
+    assert(settings.lowerThreshold_ <= settings.upperThreshold_ && "変更しない幅が不正です");
+    settings_ = settings;
+    scale_ = std::clamp(scale_, settings_.minScale_, settings_.maxScale_);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	制御の設定を取得する
+ * @return	制御の設定
+ */
+[[nodiscard]] const DynamicResolution::Settings& DynamicResolution::settings() const noexcept {
+    return settings_;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	計測した GPU 時間から倍率を更新する
+ * @param	gpuMilliseconds	計測した GPU のフレーム時間（ミリ秒）
+ * @return	更新後の倍率
+ */
+[[nodiscard]] float DynamicResolution::update(double gpuMilliseconds) noexcept {
+    if (gpuMilliseconds <= 0.0 || settings_.targetTime_ <= 0.0) {
+        return scale_;
+    }
+
+    // 一フレームだけの揺れに反応しないよう、平滑化した時間で判断する
+    filteredTime_ = hasSample_ ? filteredTime_ + (gpuMilliseconds - filteredTime_) * settings_.smoothing_ : gpuMilliseconds;
+    hasSample_ = true;
+
+    // 目標の前後の幅に収まっている間は倍率を変えない
+    const auto ratio = filteredTime_ / settings_.targetTime_;
+    double rate = 0.0;
+    if (ratio > settings_.upperThreshold_) {
+        rate = settings_.decreaseRate_;  // 目標を超えたら早めに下げる
+    } else if (ratio < settings_.lowerThreshold_) {
+        rate = settings_.increaseRate_;  // 余裕がある時はゆっくり上げる
+    } else {
+        return scale_;
+    }
+
+    // 幅の中央の時間になる倍率を求め、そこへ少しずつ近づける
+    const auto aim = (settings_.lowerThreshold_ + settings_.upperThreshold_) * 0.5;
+    const auto desired = scale_ * std::sqrt(aim / ratio);
+    const auto next = scale_ + (desired - scale_) * rate;
+    scale_ = std::clamp(static_cast<float>(next), settings_.minScale_, settings_.maxScale_);
+    return scale_;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	倍率を取得する
+ * @return	描画解像度の倍率
+ */
+[[nodiscard]] float DynamicResolution::scale() const noexcept {
+    return scale_;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	計測の履歴を破棄して倍率を上限に戻す
+ */
+void DynamicResolution::reset() noexcept {
+    scale_ = settings_.maxScale_;
+    filteredTime_ = 0.0;
+    hasSample_ = false;
+}
@@ -0,0 +1,86 @@
+﻿// 動的解像度の制御クラス
+
+#pragma once
+
+#include <cstdint>
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	動的解像度の制御クラス
+ * 計測した GPU のフレーム時間を目標時間と比べて、描画解像度の倍率（縦横それぞれ）を決める
+ * GPU 時間は描画するピクセル数（倍率の二乗）に比例するとみなし、目標に収まる倍率へ少しずつ近づける
+ * 目標の前後に変更しない幅（ヒステリシス）を持たせ、フレーム毎に解像度が揺れないようにする
+ * 時間は呼び出し側が渡すので、GPU が無くても同じように動く
+ */
+class DynamicResolution final {
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	制御の設定
+     */
+    struct Settings {
+        double targetTime_ = 14.0;      /// 目標の GPU 時間（ミリ秒）
+        float  minScale_ = 0.5f;        /// 倍率の下限
+        float  maxScale_ = 1.0f;        /// 倍率の上限
+        double lowerThreshold_ = 0.85;  /// 目標時間に対してこの割合を下回ったら倍率を上げる
+        double upperThreshold_ = 1.0;   /// 目標時間に対してこの割合を上回ったら倍率を下げる
+        double smoothing_ = 0.25;       /// 計測した時間の平滑化（指数移動平均）の追従の速さ
+        double increaseRate_ = 0.05;    /// 倍率を上げる時に目標の倍率へ近づける割合
+        double decreaseRate_ = 0.3;     /// 倍率を下げる時に目標の倍率へ近づける割合
+    };
+
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    コンストラクタ
+     */
+    DynamicResolution() = default;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    デストラクタ
+     */
+    ~DynamicResolution() = default;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	制御の設定を変更する
+     * 倍率は新しい上限と下限の範囲に収める
+     * @param	settings	制御の設定
+     */
+    void setSettings(const Settings& settings) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	制御の設定を取得する
+     * @return	制御の設定
+     */
+    [[nodiscard]] const Settings& settings() const noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	計測した GPU 時間から倍率を更新する
+     * @param	gpuMilliseconds	計測した GPU のフレーム時間（ミリ秒）
+     * @return	更新後の倍率
+     */
+    [[nodiscard]] float update(double gpuMilliseconds) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	倍率を取得する
+     * @return	描画解像度の倍率
+     */
+    [[nodiscard]] float scale() const noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	計測の履歴を破棄して倍率を上限に戻す
+     */
+    void reset() noexcept;
+
+private:
+    Settings settings_{};      /// 制御の設定
+    float    scale_ = 1.0f;    /// 描画解像度の倍率
+    double   filteredTime_{};  /// 平滑化した GPU 時間（ミリ秒）
+    bool     hasSample_{};     /// 平滑化した時間があるか
+};
@@ -0,0 +1,203 @@
+﻿// エンティティストアクラス
+
+#include "entity_store.h"
+#include <cassert>
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	エンティティの数の分だけ配列を確保しておく
+ * @param	capacity	エンティティの数
+ */
+void EntityStore::reserve(size_t capacity) noexcept {
+    for (auto& values : values_) {
+        values.reserve(capacity);
+    }
+#if defined(_WIN32)
+    colors_.reserve(capacity);
+#endif
+    entities_.reserve(capacity);
+    denseIndices_.reserve(capacity);
+    generations_.reserve(capacity);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	エンティティを追加する
+ * 座標は原点、回転は無し、拡大率と境界球の半径は 1、色は白で作成する
+ * @return	追加したエンティティのハンドル
+ */
+[[nodiscard]] Entity EntityStore::add() noexcept {
+    // 削除されたスロットがあれば再利用する（世代は削除時に進めてある）
+    uint32_t slot = 0;
+    if (!freeSlots_.empty()) {
+        slot = freeSlots_.back();
+        freeSlots_.pop_back();
+    } else {
+        slot = static_cast<uint32_t>(generations_.size());
+        generations_.push_back(0);
+        denseIndices_.push_back(invalidIndex);
+    }
+
+    // 新しいエンティティは配列の末尾に置く
+    const Entity entity{ slot, generations_[slot] };
+    denseIndices_[slot] = static_cast<uint32_t>(entities_.size());
+    entities_.push_back(entity);
+
+    for (uint32_t i = 0; i < static_cast<uint32_t>(Component::count); ++i) {
+        values_[i].push_back(0.0f);
+    }
+    values_[static_cast<size_t>(Component::rotationW)].back() = 1.0f;
+    values_[static_cast<size_t>(Component::scaleX)].back() = 1.0f;
+    values_[static_cast<size_t>(Component::scaleY)].back() = 1.0f;
+    values_[static_cast<size_t>(Component::scaleZ)].back() = 1.0f;
+    values_[static_cast<size_t>(Component::radius)].back() = 1.0f;
+
+#if defined(_WIN32)
+    colors_.emplace_back(1.0f, 1.0f, 1.0f, 1.0f);
+#endif
+    return entity;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	エンティティを削除する
+ * 末尾のエンティティが削除した位置に移動する
+ * @param	entity	削除するエンティティ
+ * @return	削除できたら true（既に削除されていたら false）
+ */
+bool EntityStore::remove(Entity entity) noexcept {
+    const auto index = indexOf(entity);
+    if (index == invalidIndex) {
+        return false;
+    }
+
+    // 末尾の要素を削除する位置に移し、配列を詰めたままにする
+    const auto last = static_cast<uint32_t>(entities_.size() - 1);
+    if (index != last) {
+        for (auto& values : values_) {
+            values[index] = values[last];
+        }
+#if defined(_WIN32)
+        colors_[index] = colors_[last];
+#endif
+        entities_[index] = entities_[last];
+        denseIndices_[entities_[index].index_] = index;
+    }
+    for (auto& values : values_) {
+        values.pop_back();
+    }
+#if defined(_WIN32)
+    colors_.pop_back();
+#endif
+    entities_.pop_back();
+
+    // 世代を進めて、残っているハンドルを無効にする
+    denseIndices_[entity.index_] = invalidIndex;
+    generations_[entity.index_]++;
+    freeSlots_.push_back(entity.index_);
+    return true;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	全てのエンティティを削除する
+ * 以前のハンドルは全て無効になる
+ */
+void EntityStore::clear() noexcept {
+    for (const auto& entity : entities_) {
+        denseIndices_[entity.index_] = invalidIndex;
+        generations_[entity.index_]++;
+        freeSlots_.push_back(entity.index_);
+    }
+    for (auto& values : values_) {
+        values.clear();
+    }
+#if defined(_WIN32)
+    colors_.clear();
+#endif
+    entities_.clear();
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	エンティティが生きているか
+ * @param	entity	エンティティ
+ * @return	生きていれば true
+ */
+[[nodiscard]] bool EntityStore::isAlive(Entity entity) const noexcept {
+    return indexOf(entity) != invalidIndex;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	エンティティの配列の位置を取得する
+ * 削除で位置が変わるので、配列を触る直前に取得する
+ * @param	entity	エンティティ
+ * @return	配列の位置、生きていない場合は invalidIndex
+ */
+[[nodiscard]] uint32_t EntityStore::indexOf(Entity entity) const noexcept {
+    if (entity.index_ >= generations_.size() || generations_[entity.index_] != entity.generation_) {
+        return invalidIndex;
+    }
+    return denseIndices_[entity.index_];
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	生きているエンティティの数を取得する
+ * @return	エンティティの数
+ */
+[[nodiscard]] uint32_t EntityStore::size() const noexcept {
+    return static_cast<uint32_t>(entities_.size());
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	float のコンポーネントの配列を取得する
+ * @param	component	コンポーネントの種類
+ * @return	エンティティの数の長さの配列
+ */
+[[nodiscard]] std::span<float> EntityStore::values(Component component) noexcept {
+    assert(component < Component::count && "コンポーネントの種類が不正です");
+    return values_[static_cast<size_t>(component)];
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	float のコンポーネントの配列を取得する
+ * @param	component	コンポーネントの種類
+ * @return	エンティティの数の長さの配列
+ */
+[[nodiscard]] std::span<const float> EntityStore::values(Component component) const noexcept {
+    assert(component < Component::count && "コンポーネントの種類が不正です");
+    return values_[static_cast<size_t>(component)];
+}
+
+#if defined(_WIN32)
+//---------------------------------------------------------------------------------
+/**
+ * @brief	色の配列を取得する
+ * @return	エンティティの数の長さの配列
+ */
+[[nodiscard]] std::span<DirectX::XMFLOAT4> EntityStore::colors() noexcept {
+    return colors_;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	色の配列を取得する
+ * @return	エンティティの数の長さの配列
+ */
+[[nodiscard]] std::span<const DirectX::XMFLOAT4> EntityStore::colors() const noexcept {
+    return colors_;
+}
+#endif
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	配列の位置毎のエンティティのハンドルを取得する
+ * @return	エンティティの数の長さの配列
+ */
+[[nodiscard]] std::span<const Entity> EntityStore::entities() const noexcept {
+    return entities_;
+}
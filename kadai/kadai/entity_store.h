@@ -0,0 +1,163 @@
+﻿// エンティティストアクラス
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// 色は DirectXMath の型で持つので、ヘッドレスビルドではコンポーネントの配列とハンドルだけを使う
+#if defined(_WIN32)
+#include <DirectXMath.h>
+#endif
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	エンティティのハンドル
+ * スロットの番号と世代の組で、削除されたエンティティのハンドルを使っても別のエンティティを指さない
+ */
+struct Entity {
+    uint32_t index_ = UINT32_MAX;  /// スロットの番号
+    uint32_t generation_{};        /// スロットの世代（削除される度に増える）
+
+    [[nodiscard]] bool operator==(const Entity&) const noexcept = default;
+};
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	エンティティストアクラス
+ * エンティティのコンポーネントを種類毎の連続した配列（Structure of Arrays）に詰めて持つ
+ * 生きているエンティティは常に配列の先頭から隙間なく並ぶので、更新は配列を先頭から順に処理するだけでよい
+ * 削除は末尾の要素を空いた位置に移して詰める（swap-and-pop）ので、追加も削除も O(1) になる
+ * 要素の位置は削除で変わるので、エンティティを保持する側はハンドルを持つ
+ */
+class EntityStore final {
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	float のコンポーネントの種類
+     * 座標・回転（クォータニオン）・拡大率を成分毎に分けて持ち、SIMD でまとめて処理できるようにする
+     */
+    enum class Component : uint8_t {
+        positionX,
+        positionY,
+        positionZ,
+        rotationX,
+        rotationY,
+        rotationZ,
+        rotationW,
+        scaleX,
+        scaleY,
+        scaleZ,
+        radius,  /// 境界球の半径（拡大率を掛ける前）
+        phase,   /// アニメーション用の変数
+        count,
+    };
+
+    static constexpr uint32_t invalidIndex = UINT32_MAX;  /// 生きていないエンティティの配列の位置
+
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    コンストラクタ
+     */
+    EntityStore() = default;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    デストラクタ
+     */
+    ~EntityStore() = default;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	エンティティの数の分だけ配列を確保しておく
+     * @param	capacity	エンティティの数
+     */
+    void reserve(size_t capacity) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	エンティティを追加する
+     * 座標は原点、回転は無し、拡大率と境界球の半径は 1、色は白で作成する
+     * @return	追加したエンティティのハンドル
+     */
+    [[nodiscard]] Entity add() noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	エンティティを削除する
+     * 末尾のエンティティが削除した位置に移動する
+     * @param	entity	削除するエンティティ
+     * @return	削除できたら true（既に削除されていたら false）
+     */
+    bool remove(Entity entity) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	全てのエンティティを削除する
+     * 以前のハンドルは全て無効になる
+     */
+    void clear() noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	エンティティが生きているか
+     * @param	entity	エンティティ
+     * @return	生きていれば true
+     */
+    [[nodiscard]] bool isAlive(Entity entity) const noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	エンティティの配列の位置を取得する
+     * 削除で位置が変わるので、配列を触る直前に取得する
+     * @param	entity	エンティティ
+     * @return	配列の位置、生きていない場合は invalidIndex
+     */
+    [[nodiscard]] uint32_t indexOf(Entity entity) const noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	生きているエンティティの数を取得する
+     * @return	エンティティの数
+     */
+    [[nodiscard]] uint32_t size() const noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	float のコンポーネントの配列を取得する
+     * @param	component	コンポーネントの種類
+     * @return	エンティティの数の長さの配列
+     */
+    [[nodiscard]] std::span<float> values(Component component) noexcept;
+    [[nodiscard]] std::span<const float> values(Component component) const noexcept;
+
+#if defined(_WIN32)
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	色の配列を取得する
+     * @return	エンティティの数の長さの配列
+     */
+    [[nodiscard]] std::span<DirectX::XMFLOAT4> colors() noexcept;
+    [[nodiscard]] std::span<const DirectX::XMFLOAT4> colors() const noexcept;
+#endif
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	配列の位置毎のエンティティのハンドルを取得する
+     * @return	エンティティの数の長さの配列
+     */
+    [[nodiscard]] std::span<const Entity> entities() const noexcept;
+
+private:
+    std::array<std::vector<float>, static_cast<size_t>(Component::count)> values_{};  /// float のコンポーネントの配列
+#if defined(_WIN32)
+    std::vector<DirectX::XMFLOAT4>   colors_{};        /// 色の配列
+#endif
+    std::vector<Entity>              entities_{};      /// 配列の位置毎のエンティティ
+    std::vector<uint32_t>            denseIndices_{};  /// スロット毎の配列の位置
+    std::vector<uint32_t>            generations_{};   /// スロット毎の世代
+    std::vector<uint32_t>            freeSlots_{};     /// 空いているスロットの番号
+};
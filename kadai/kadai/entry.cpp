@@ -16,6 +16,8 @@
 #include "root_signature.h"
 #include "shader.h"
 #include "pipline_state_object.h"
+#include "pipeline_cache.h"
+#include "shader_permutation.h"
 
 // CN[h
 #include "triangle_polygon.h"
@@ -26,144 +28,627 @@
 #include "camera.h"
 #include "square_polygon.h"
 #include "object.h"
-#include "constant_buffer.h"
+#include "upload_ring.h"
+#include "instance_buffer.h"
+#include "render_graph.h"
+#include "parallel_recorder.h"
+#include "deferred_release.h"
+#include "mesh_pool.h"
+#include "upload_manager.h"
+#include "gpu_memory_allocator.h"
+#include "rhi_d3d12.h"
+#include "scene_pass.h"
+#include "command_capture.h"
+#include "profiler.h"
+#include "gpu_profiler.h"
+#include "frame_statistics.h"
+#include "frame_pacer.h"
+#include "dynamic_resolution.h"
+#include "entity_store.h"
+#include "benchmark.h"
+#include "job_system.h"
+#include "frustum_culling.h"
+#include "input.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+namespace {
+    constexpr UINT   defaultFramesInFlight = 2;          // ɏt[̊l
+    constexpr UINT   maxFramesInFlight = 4;              // ɏt[̏
+    constexpr UINT64 uploadRingSize = 4 * 1024 * 1024;  // 萔f[^pAbv[hOobt@̃TCY
+    constexpr size_t triangleInstanceCount = 1;          // Op`̃CX^X
+    constexpr size_t squareInstanceCount = 1;            // lp`̃CX^X
+    constexpr UINT   meshPoolVertexCapacity = 64 * 1024; // bVv[Ɋi[ł钸_
+    constexpr UINT   meshPoolIndexCapacity = 192 * 1024; // bVv[Ɋi[łCfbNX
+    constexpr UINT64 gpuHeapSize = 16 * 1024 * 1024;     // GPU AP[^xɊmۂq[ṽTCY
+    constexpr UINT64 uploadStagingSize = 1024 * 1024;    // ]pꎞobt@̃TCY
+    constexpr UINT   maxRecordThreadCount = 8;           // R}hL^Xbh̍ő吔
+    constexpr size_t minDrawItemsPerChunk = 64;          // ̋L^XbhɊ蓖Ăŏ̕`搔
+    constexpr size_t minEntitiesPerJob = 4096;           // ̃WuōXVŏ̃GeBeB
+    constexpr const wchar_t* pipelineCacheFileName = L"pipeline_cache.bin";  // pCvCLbṼt@C
+    constexpr ShaderKey sceneShaderKey = ShaderFeature::instancing | ShaderFeature::vertexColor;  // |S̕`ɎgVF[_̃oG[V
+    constexpr uint16_t captureKey = VK_F9;     // t[̃R}hLv`čĐL[
+    constexpr uint32_t replayCount = 100;      // Lv`t[Đ
+    constexpr uint16_t profileExportKey = VK_F10;  // L^Ԃg[Xt@CɏoL[
+    constexpr const wchar_t* profileFileName = L"profile.json";  // g[Xt@C̖Oichrome://tracing  Perfetto ŊJj
+    constexpr uint16_t statisticsKey = VK_F11;  // t[Ԃ̓vɏo͂L[
+    constexpr uint64_t statisticsInterval = 10'000'000'000;  // t[Ԃ̓vo͂Ԋuiimbj
+    constexpr const wchar_t* statisticsFileName = L"frame_statistics.csv";  // t[Ԃ̓vǋLt@C̖O
+    constexpr UINT     maxFrameLatency = 1;     // Present słt[iȂقǓ͒xZj
+    constexpr uint16_t latencyModeKey = VK_F8;  // x[h؂ւL[
+    constexpr uint64_t spinWaitTime = 1'000'000;  // Sleep g킸ɑ҂c莞ԁiimbASleep ̐xe߁j
+    constexpr uint16_t dynamicResolutionKey = VK_F7;  // I𑜓x؂ւL[
+    constexpr double   gpuBudgetRatio = 0.9;          // tbVԊû GPU ̖ڕWԂɂ銄
+    constexpr uint16_t benchmarkKey = VK_F6;          // CPU ̏̃x`}[NsL[
+    constexpr UINT     benchmarkRecordThreadCounts[] = { 1, 2, 4, 8 };  // L^̃x`}[NŎL^Xbh̐
+}  // namespace
 
 class Application final {
 public:
     Application() = default;
-    ~Application() = default;
+    ~Application() {
+        // IO GPU ̏Sđ҂A҂̃\[X
+        if (nextFenceValue_ > 1) {
+            fenceInstance_.wait(nextFenceValue_ - 1);
+        }
+        DeferredRelease::instance().releaseAll();
+    }
 
-    [[nodiscard]] bool initialize(HINSTANCE instance) noexcept {
+    [[nodiscard]] bool initialize(HINSTANCE instance, UINT framesInFlight) noexcept {
         if (S_OK != windowInstance_.create(instance, 1280, 720, "MyApp")) return false;
         if (!dxgiInstance_.setDisplayAdapter()) return false;
         if (!deviceInstance_.create(dxgiInstance_)) return false;
         if (!commandQueueInstance_.create(deviceInstance_)) return false;
-        if (!swapChainInstance_.create(dxgiInstance_, windowInstance_, commandQueueInstance_)) return false;
+        if (!swapChainInstance_.create(dxgiInstance_, windowInstance_, commandQueueInstance_, maxFrameLatency)) return false;
 
-        if (!descriptorHeapInstance_.create(deviceInstance_, D3D12_DESCRIPTOR_HEAP_TYPE_RTV, swapChainInstance_.getDesc().BufferCount)) return false;
+        // TCY̕ύXō蒼r[͌Âr[̉it[̊j҂Ɋmۂ̂ŁAgpӂ
+        if (!descriptorHeapInstance_.create(deviceInstance_, D3D12_DESCRIPTOR_HEAP_TYPE_RTV, swapChainInstance_.getDesc().BufferCount * 2)) return false;
         if (!renderTargetInstance_.createBackBuffer(deviceInstance_, swapChainInstance_, descriptorHeapInstance_)) return false;
 
-        if (!commandAllocatorInstance_[0].create(deviceInstance_, D3D12_COMMAND_LIST_TYPE_DIRECT)) return false;
-        if (!commandAllocatorInstance_[1].create(deviceInstance_, D3D12_COMMAND_LIST_TYPE_DIRECT)) return false;
+        // ɏt[̓obNobt@Ƃ͓ƗɌ߂
+        // ₷ CPU  GPU ̕xオɓ͒xLт
+        framesInFlight_ = framesInFlight;
+        commandAllocatorInstances_ = std::vector<CommandAllocator>(framesInFlight_);
+        frameFenceValues_.assign(framesInFlight_, 0);
+        for (auto& commandAllocator : commandAllocatorInstances_) {
+            if (!commandAllocator.create(deviceInstance_, D3D12_COMMAND_LIST_TYPE_DIRECT)) return false;
+        }
+
+        if (!commandListInstance_.create(deviceInstance_, commandAllocatorInstances_[0])) return false;
+        if (!postCommandListInstance_.create(deviceInstance_, commandAllocatorInstances_[0])) return false;
+
+        // t[̍XV̓WuɕđSẴRAŎs
+        if (!jobSystem_.create(std::max(std::thread::hardware_concurrency(), 1u))) return false;
+
+        // `R}h̕L^
+        const auto recordThreadCount = std::clamp(std::thread::hardware_concurrency(), 1u, maxRecordThreadCount);
+        if (!parallelRecorderInstance_.create(deviceInstance_, recordThreadCount, framesInFlight_)) return false;
 
-        if (!commandListInstance_.create(deviceInstance_, commandAllocatorInstance_[0])) return false;
         if (!fenceInstance_.create(deviceInstance_)) return false;
 
-        // |S
-        if (!trianglePolygonInstance_.create(deviceInstance_)) return false;
-        if (!squarePolygonInstance_.create(deviceInstance_)) return false; // ŃG[oȂϐmF
+        // obt@͑傫ȃq[vɂ܂Ƃ߂Ĕzu
+        if (!gpuMemoryAllocatorInstance_.create(deviceInstance_, gpuHeapSize)) return false;
+
+        // GPU ̋Ԃ̓t[̃\[Xėp鎞ɉ̂ŁAt[̌ʂ
+        Profiler::instance().setThreadName("Main");
+        statisticsStartTime_ = Profiler::now();
+        statisticsReportTime_ = statisticsStartTime_;
+        if (!gpuProfilerInstance_.create(deviceInstance_, commandQueueInstance_, gpuMemoryAllocatorInstance_, framesInFlight_)) return false;
+        DeferredRelease::instance().setFrameFenceValue(nextFenceValue_);
 
+        // `̋L^̓obNGhɈˑȂC^[tF[Xʂčs
+        if (!rhiDeviceInstance_.create(deviceInstance_, commandQueueInstance_, swapChainInstance_, renderTargetInstance_, gpuMemoryAllocatorInstance_)) return false;
+
+        // |S
+        // SbV̒_ƃCfbNX͈̃bVv[ɂ܂Ƃ߂
+        // f[^̓Rs[L[ GPU [J̃֓]A`L[͏߂Ďgɂ҂
+        if (!uploadManagerInstance_.create(deviceInstance_, gpuMemoryAllocatorInstance_, uploadStagingSize)) return false;
+        if (!meshPoolInstance_.create(gpuMemoryAllocatorInstance_, meshPoolVertexCapacity, meshPoolIndexCapacity)) return false;
+        if (!trianglePolygonInstance_.create(meshPoolInstance_, uploadManagerInstance_)) return false;
+        if (!squarePolygonInstance_.create(meshPoolInstance_, uploadManagerInstance_)) return false; // ŃG[oȂϐmF
+        uploadManagerInstance_.submit();
+
+        // pCvCXe[g͗vW߂Ăɍ쐬ARpCʂ̓t@CɎcĎ̋N𑬂
+        if (!pipelineCacheInstance_.create(deviceInstance_, dxgiInstance_, pipelineCacheFileName)) return false;
         if (!rootSignatureInstance_.create(deviceInstance_)) return false;
-        if (!shaderInstance_.create(deviceInstance_)) return false;
-        if (!piplineStateObjectInstance_.create(deviceInstance_, shaderInstance_, rootSignatureInstance_)) return false;
 
-        cameraInstance_.initialize();
+        // gVF[_̃oG[Vo^AoG[VɃVF[_ƃpCvCXe[g
+        shaderVariants_.add(sceneShaderKey);
+        shaderInstances_ = std::vector<Shader>(shaderVariants_.size());
+        piplineStateObjectInstances_ = std::vector<PiplineStateObject>(shaderVariants_.size());
+        for (uint32_t i = 0; i < shaderVariants_.size(); ++i) {
+            if (!shaderInstances_[i].create(deviceInstance_, shaderVariants_.key(i))) return false;
+            if (!piplineStateObjectInstances_[i].create(shaderInstances_[i], rootSignatureInstance_, pipelineCacheInstance_)) return false;
+        }
+        if (!pipelineCacheInstance_.build(recordThreadCount)) return false;
+        (void)pipelineCacheInstance_.save();  // ۑłȂĂRpCȂ̂ős
 
-        // fBXNv^q[v (CBVp)
-        if (!constantBufferDescriptorHeapInstance_.create(deviceInstance_, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, 3, true)) return false;
+        // pCvCXe[g͍쐬Ɋm肷̂ŁAŃoG[ṼpCvCɂ܂Ƃ߂
+        pipelines_.clear();
+        for (const auto& piplineStateObject : piplineStateObjectInstances_) {
+            pipelines_.emplace_back(piplineStateObject.get(), rootSignatureInstance_.get());
+        }
 
-        // 萔obt@쐬
-        if (!cameraConstantBufferInstance_.create(deviceInstance_, constantBufferDescriptorHeapInstance_, sizeof(Camera::ConstBufferData), 0)) return false;
-        if (!trianglePolygonConstantBufferInstance_.create(deviceInstance_, constantBufferDescriptorHeapInstance_, sizeof(TrianglePolygon::ConstBufferData), 1)) return false;
+        const auto [width, height] = windowInstance_.size();
+        cameraInstance_.initialize(static_cast<float>(width) / static_cast<float>(height));
+
+        // bVgIuWFNg͂܂Ƃ߂ăCX^X`悷
+        // IuWFNg̃f[^̓bṼGeBeBXgAɘAĕׂ
+        triangleEntities_.reserve(triangleInstanceCount);
+        for (size_t i = 0; i < triangleInstanceCount; ++i) {
+            (void)Object::create(triangleEntities_);
+        }
+        squareEntities_.reserve(squareInstanceCount);
+        for (size_t i = 0; i < squareInstanceCount; ++i) {
+            (void)Object::create(squareEntities_);
+        }
 
-        // lp`p (NX\̖mFĂ)
-        if (!squarePolygonConstantBufferInstance_.create(deviceInstance_, constantBufferDescriptorHeapInstance_, sizeof(SquarePolygon::ConstBufferData), 2)) return false;
+        // 萔f[^pAbv[hOobt@쐬
+        if (!uploadRingInstance_.create(gpuMemoryAllocatorInstance_, uploadRingSize)) return false;
 
         return true;
     }
 
-    void loop() noexcept {
-        while (windowInstance_.messageLoop()) {
-            cameraInstance_.update();
-            triangleObjectInstance_.update();
-            squareObjectInstance_.update();
+    [[nodiscard]] bool loop() noexcept {
+        while (true) {
+            // ͂̓t[n߂钼Oɓǂ
+            const auto frameStartTime = waitFrameStart();
+            if (!windowInstance_.messageLoop()) {
+                return true;
+            }
+
+            // hbO̕ύX͂܂Ƃ߂āAm肵TCYňx蒼
+            int width = 0;
+            int height = 0;
+            if (windowInstance_.consumeResize(width, height) && !resize(width, height)) {
+                return false;
+            }
+
+            const ProfileScope frameScope("frame");
+            const auto frameBeginTime = Profiler::now();
+
+            if (keyTriggered(latencyModeKey, latencyModeKeyDown_)) {
+                const auto lowLatency = framePacer_.mode() != FramePacer::Mode::lowLatency;
+                framePacer_.setMode(lowLatency ? FramePacer::Mode::lowLatency : FramePacer::Mode::throughput);
+                OutputDebugStringA(lowLatency ? "FramePacer: low latency\n" : "FramePacer: throughput\n");
+            }
+            if (keyTriggered(dynamicResolutionKey, dynamicResolutionKeyDown_)) {
+                dynamicResolutionEnabled_ = !dynamicResolutionEnabled_;
+                dynamicResolution_.reset();
+                OutputDebugStringA(dynamicResolutionEnabled_ ? "DynamicResolution: on\n" : "DynamicResolution: off\n");
+            }
+
+            // L[t[Lv`
+            captureRequested_ = keyTriggered(captureKey, captureKeyDown_);
+            if (keyTriggered(profileExportKey, profileKeyDown_)) {
+                (void)Profiler::instance().exportChromeTrace(profileFileName);  // oȂĂv͑
+            }
+
+            {
+                const ProfileScope scope("update");
+
+                // IuWFNg̍XV[J[ɔCĂԂɃJXVAc͑҂Ȃ`
+                JobSystem::Counter updateCounter;
+                for (auto* entities : { &triangleEntities_, &squareEntities_ }) {
+                    jobSystem_.parallelFor(entities->size(), minEntitiesPerJob,
+                        [entities](size_t begin, size_t end) { Object::update(*entities, begin, end); }, updateCounter);
+                }
+                cameraInstance_.update();
+
+                // ̓J̍XVŌ܂̂ŁAJO̓IuWFNg̍XV̊ɃWuƂđ
+                const auto frustum = FrustumCulling::extractFrustum(DirectX::XMMatrixMultiply(cameraInstance_.viewMatrix(), cameraInstance_.projection()));
+                JobSystem::Counter cullCounter;
+                jobSystem_.run([&] { FrustumCulling::cull(frustum, triangleEntities_, visibleTriangles_); }, cullCounter, updateCounter);
+                jobSystem_.run([&] { FrustumCulling::cull(frustum, squareEntities_, visibleSquares_); }, cullCounter, updateCounter);
+                jobSystem_.wait(cullCounter);
+            }
 
             const auto backBufferIndex = swapChainInstance_.get()->GetCurrentBackBufferIndex();
+            const auto frameIndex = static_cast<UINT>(frameCount_ % framesInFlight_);
+
+            // t[\[Xg framesInFlight_ Õt[̊҂
+            uint64_t waitTime = 0;
+            if (frameFenceValues_[frameIndex] != 0) {
+                const ProfileScope scope("waitFrame");
+                const auto waitBeginTime = Profiler::now();
+                fenceInstance_.wait(frameFenceValues_[frameIndex]);
+                waitTime = Profiler::now() - waitBeginTime;
+            }
+            gpuProfilerInstance_.beginFrame(frameIndex);
+            updateRenderResolution();
+
+            // GPU gIt[̒萔f[^̈Ɖ҂̃\[X
+            const auto completedFenceValue = fenceInstance_.get()->GetCompletedValue();
+            uploadRingInstance_.release(completedFenceValue);
+            DeferredRelease::instance().release(completedFenceValue);
+            meshPoolInstance_.release(completedFenceValue);
+
+            commandAllocatorInstances_[frameIndex].reset();
+            commandListInstance_.reset(commandAllocatorInstances_[frameIndex]);
+            recordingList_ = &commandListInstance_;
+            submitLists_.clear();
+            uploadWaitFenceValue_ = 0;
+            const auto gpuFrameScope = gpuProfilerInstance_.begin(commandListInstance_, "frame");
+
+            {
+                const ProfileScope scope("record");
+
+                // _[Ot̍\z
+                // pXg\[XƃXe[g錾Ă΁AKvȃoA̓Ot܂Ƃ߂ČvZ
+                renderGraphInstance_.reset();
+                graphResources_.clear();
+
+                const auto backBuffer = renderGraphInstance_.importResource(D3D12_RESOURCE_STATE_PRESENT, D3D12_RESOURCE_STATE_PRESENT);
+                graphResources_.push_back(renderTargetInstance_.get(backBufferIndex));
+
+                const auto scenePass = renderGraphInstance_.addPass([this, backBufferIndex, frameIndex] { drawScene(backBufferIndex, frameIndex); });
+                renderGraphInstance_.write(scenePass, backBuffer, D3D12_RESOURCE_STATE_RENDER_TARGET);
+
+                renderGraphInstance_.compile();
+                for (const auto& pass : renderGraphInstance_.compiledPasses()) {
+                    flushBarriers(pass.barriers_);
+                    renderGraphInstance_.execute(pass.pass_);
+                }
+                flushBarriers(renderGraphInstance_.finalBarriers());
+
+                // GPU ̌vʂ̓t[̍Ō̃R}hXgŉ
+                gpuProfilerInstance_.end(*recordingList_, gpuFrameScope);
+                gpuProfilerInstance_.endFrame(*recordingList_);
+                recordingList_->get()->Close();
+                submitLists_.push_back(recordingList_->get());
+            }
+
+            {
+                const ProfileScope scope("submit");
 
-            if (frameFenceValue_[backBufferIndex] != 0) {
-                fenceInstance_.wait(frameFenceValue_[backBufferIndex]);
-            }
-
-            commandAllocatorInstance_[backBufferIndex].reset();
-            commandListInstance_.reset(commandAllocatorInstance_[backBufferIndex]);
-
-            auto pToRT = resourceBarrier(renderTargetInstance_.get(backBufferIndex), D3D12_RESOURCE_STATE_PRESENT, D3D12_RESOURCE_STATE_RENDER_TARGET);
-            commandListInstance_.get()->ResourceBarrier(1, &pToRT);
-
-            D3D12_CPU_DESCRIPTOR_HANDLE handles[] = { renderTargetInstance_.getCpuDescriptorHandle(deviceInstance_, descriptorHeapInstance_, backBufferIndex) };
-            commandListInstance_.get()->OMSetRenderTargets(1, handles, false, nullptr);
-
-            const float clearColor[] = { 0.2f, 0.2f, 0.2f, 1.0f };
-            commandListInstance_.get()->ClearRenderTargetView(handles[0], clearColor, 0, nullptr);
-
-            commandListInstance_.get()->SetPipelineState(piplineStateObjectInstance_.get());
-            commandListInstance_.get()->SetGraphicsRootSignature(rootSignatureInstance_.get());
-
-            const auto [w, h] = windowInstance_.size();
-            D3D12_VIEWPORT viewport{};
-            viewport.TopLeftX = 0.0f; viewport.TopLeftY = 0.0f;
-            viewport.Width = static_cast<float>(w); viewport.Height = static_cast<float>(h);
-            viewport.MinDepth = 0.0f; viewport.MaxDepth = 1.0f;
-            commandListInstance_.get()->RSSetViewports(1, &viewport);
-
-            D3D12_RECT scissorRect{};
-            scissorRect.left = 0; scissorRect.top = 0;
-            scissorRect.right = w; scissorRect.bottom = h;
-            commandListInstance_.get()->RSSetScissorRects(1, &scissorRect);
-
-            ID3D12DescriptorHeap* p[] = { constantBufferDescriptorHeapInstance_.get() };
-            commandListInstance_.get()->SetDescriptorHeaps(1, p);
-
-            // J
-            Camera::ConstBufferData cameraData{
-                DirectX::XMMatrixTranspose(cameraInstance_.viewMatrix()),
-                DirectX::XMMatrixTranspose(cameraInstance_.projection()),
-            };
-            UINT8* pCameraData{};
-            cameraConstantBufferInstance_.constantBuffer()->Map(0, nullptr, reinterpret_cast<void**>(&pCameraData));
-            memcpy_s(pCameraData, sizeof(cameraData), &cameraData, sizeof(cameraData));
-            cameraConstantBufferInstance_.constantBuffer()->Unmap(0, nullptr);
-            commandListInstance_.get()->SetGraphicsRootDescriptorTable(0, cameraConstantBufferInstance_.getGpuDescriptorHandle());
-
-            // Op`
-            TrianglePolygon::ConstBufferData triangleData{
-                DirectX::XMMatrixTranspose(triangleObjectInstance_.world()),
-                triangleObjectInstance_.color() };
-            UINT8* pTriangleData{};
-            trianglePolygonConstantBufferInstance_.constantBuffer()->Map(0, nullptr, reinterpret_cast<void**>(&pTriangleData));
-            memcpy_s(pTriangleData, sizeof(triangleData), &triangleData, sizeof(triangleData));
-            trianglePolygonConstantBufferInstance_.constantBuffer()->Unmap(0, nullptr);
-            commandListInstance_.get()->SetGraphicsRootDescriptorTable(1, trianglePolygonConstantBufferInstance_.getGpuDescriptorHandle());
-            trianglePolygonInstance_.draw(commandListInstance_);
-
-            // lp`
-            SquarePolygon::ConstBufferData squareData{
-                DirectX::XMMatrixTranspose(squareObjectInstance_.world()),
-                squareObjectInstance_.color()
-            };
-            UINT8* pSquareData{};
-            squarePolygonConstantBufferInstance_.constantBuffer()->Map(0, nullptr, reinterpret_cast<void**>(&pSquareData));
-            memcpy_s(pSquareData, sizeof(squareData), &squareData, sizeof(squareData));
-            squarePolygonConstantBufferInstance_.constantBuffer()->Unmap(0, nullptr);
-            commandListInstance_.get()->SetGraphicsRootDescriptorTable(1, squarePolygonConstantBufferInstance_.getGpuDescriptorHandle());
-            squarePolygonInstance_.draw(commandListInstance_.get());
-
-            auto rtToP = resourceBarrier(renderTargetInstance_.get(backBufferIndex), D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PRESENT);
-            commandListInstance_.get()->ResourceBarrier(1, &rtToP);
-
-            commandListInstance_.get()->Close();
-
-            ID3D12CommandList* ppCommandLists[] = { commandListInstance_.get() };
-            commandQueueInstance_.get()->ExecuteCommandLists(_countof(ppCommandLists), ppCommandLists);
-
-            swapChainInstance_.get()->Present(1, 0);
+                // `悷郁bV̓]IĂȂ΁A`L[ GPU ő҂
+                uploadManagerInstance_.waitOnQueue(commandQueueInstance_, uploadWaitFenceValue_);
+
+                // L^R}hXgԒʂɈxŒo
+                commandQueueInstance_.get()->ExecuteCommandLists(static_cast<UINT>(submitLists_.size()), submitLists_.data());
+            }
+
+            {
+                const ProfileScope scope("present");
+                // `悵͈͂\ŃEBhEŜɊg傷
+                (void)swapChainInstance_.setSourceSize(renderWidth_, renderHeight_);
+                swapChainInstance_.get()->Present(1, 0);
+            }
+            recordFrameTimes(frameBeginTime, waitTime);
+            framePacer_.endFrame(frameStartTime, lastPresentTime_);
 
             commandQueueInstance_.get()->Signal(fenceInstance_.get(), nextFenceValue_);
-            frameFenceValue_[backBufferIndex] = nextFenceValue_;
+            frameFenceValues_[frameIndex] = nextFenceValue_;
+            uploadRingInstance_.finishFrame(nextFenceValue_);
             nextFenceValue_++;
+            frameCount_++;
+
+            // ȍ~ɉ\񂳂ꂽ\[X͎̃t[̊܂ŕێ
+            DeferredRelease::instance().setFrameFenceValue(nextFenceValue_);
+
+            if (captureRequested_) {
+                replayCapture();
+            }
+
+            if (keyTriggered(benchmarkKey, benchmarkKeyDown_)) {
+                runBenchmarks();
+            }
+
+            // 莞Ԗi܂̓L[jɓvo͂ďWv蒼
+            if (keyTriggered(statisticsKey, statisticsKeyDown_) || lastPresentTime_ - statisticsReportTime_ >= statisticsInterval) {
+                reportFrameStatistics();
+            }
         }
     }
 
+    [[nodiscard]] bool resize(int width, int height) noexcept {
+        const ProfileScope scope("resize");
+
+        // `L[ɐς񂾃t[̊҂i]L[͎̏~߂Ȃj
+        fenceInstance_.wait(nextFenceValue_ - 1);
+
+        // ҂t[܂łŉ\񂳂ꂽ\[X́A蒼̑OɎ
+        DeferredRelease::instance().release(nextFenceValue_ - 1);
+
+        // obNobt@QƂĂ̂SĎĂTCYς
+        frameCapture_.clear();
+        graphResources_.clear();
+        renderTargetInstance_.releaseBackBuffer(descriptorHeapInstance_);
+
+        // obNobt@܂܂ł͕`𑱂Ȃ̂ŁAs烋[v𔲂ďI
+        if (!swapChainInstance_.resize(static_cast<UINT>(width), static_cast<UINT>(height))) return false;
+        if (!renderTargetInstance_.createBackBuffer(deviceInstance_, swapChainInstance_, descriptorHeapInstance_)) return false;
+        rhiDeviceInstance_.attachSwapChain(swapChainInstance_, renderTargetInstance_);
+
+        cameraInstance_.setAspectRatio(static_cast<float>(width) / static_cast<float>(height));
+        return true;
+    }
+
+    void updateRenderResolution() noexcept {
+        auto scale = 1.0f;
+        if (dynamicResolutionEnabled_) {
+            // ڕW GPU Ԃ̓tbVԊuɗ]TcԂɂ
+            auto settings = dynamicResolution_.settings();
+            settings.targetTime_ = static_cast<double>(framePacer_.refreshInterval()) / 1'000'000.0 * gpuBudgetRatio;
+            dynamicResolution_.setSettings(settings);
+
+            // GPU Ԃ͐t[Oɉ̂̂ŁA䑤ŕĎg
+            double gpuTime = 0.0;
+            scale = gpuProfilerInstance_.latestDuration("frame", gpuTime) ? dynamicResolution_.update(gpuTime) : dynamicResolution_.scale();
+        }
+
+        const auto [width, height] = windowInstance_.size();
+        renderWidth_ = std::max(static_cast<UINT>(width * scale), 1u);
+        renderHeight_ = std::max(static_cast<UINT>(height * scale), 1u);
+    }
+
+    [[nodiscard]] uint64_t waitFrameStart() noexcept {
+        const ProfileScope scope("waitLatency");
+
+        // ҋ@\ȃXbv`FCŃobNobt@󂭂̂҂AGPU ̊҂Ŏ~܂Ȃ悤ɂ
+        // ҂^CAEgĂiŏȂǁjt[͐i߂
+        (void)swapChainInstance_.waitForFrame();
+        const auto startTime = framePacer_.beginFrame(Profiler::now());
+
+        // x[hł́A̐ɊԂɍ܂œ͂̓ǂݍ݂x点
+        for (auto now = Profiler::now(); now < startTime; now = Profiler::now()) {
+            if (startTime - now > spinWaitTime) {
+                std::this_thread::sleep_for(std::chrono::nanoseconds(startTime - now - spinWaitTime));
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        return startTime;
+    }
+
+    void recordFrameTimes(uint64_t frameBeginTime, uint64_t waitTime) noexcept {
+        constexpr auto toMilliseconds = [](uint64_t nanoseconds) { return static_cast<double>(nanoseconds) / 1'000'000.0; };
+
+        // CPU ̏Ԃɂ GPU ̊҂܂߂Ȃi҂͕ʂɋL^j
+        const auto presentTime = Profiler::now();
+        frameStatistics_.record(FrameStatistics::Metric::cpuFrame, toMilliseconds(presentTime - frameBeginTime - waitTime));
+        frameStatistics_.record(FrameStatistics::Metric::fenceWait, toMilliseconds(waitTime));
+        if (lastPresentTime_ != 0) {
+            frameStatistics_.record(FrameStatistics::Metric::presentInterval, toMilliseconds(presentTime - lastPresentTime_));
+        }
+        lastPresentTime_ = presentTime;
+    }
+
+    void reportFrameStatistics() noexcept {
+        const auto time = static_cast<double>(lastPresentTime_ - statisticsStartTime_) / 1'000'000'000.0;
+        for (uint32_t i = 0; i < static_cast<uint32_t>(FrameStatistics::Metric::count); ++i) {
+            const auto metric = static_cast<FrameStatistics::Metric>(i);
+            const auto summary = frameStatistics_.summary(metric);
+            char message[256];
+            sprintf_s(message, "FrameStatistics %.1f s %s: %u frames, average %.3f ms, p50 %.3f ms, p95 %.3f ms, p99 %.3f ms, max %.3f ms, %u stutters\n",
+                time, FrameStatistics::name(metric), summary.count_, summary.average_,
+                summary.p50_, summary.p95_, summary.p99_, summary.max_, summary.stutters_);
+            OutputDebugStringA(message);
+        }
+        (void)frameStatistics_.appendCsv(statisticsFileName, time);  // oȂĂv͑
+
+        frameStatistics_.reset();
+        statisticsReportTime_ = lastPresentTime_;
+    }
+
+    void drawScene(UINT backBufferIndex, UINT frameIndex) noexcept {
+        const auto rtvHandle = renderTargetInstance_.getCpuDescriptorHandle(backBufferIndex);
+
+        const auto gpuSceneScope = gpuProfilerInstance_.begin(*recordingList_, "scene");
+
+        const float clearColor[] = { 0.2f, 0.2f, 0.2f, 1.0f };
+        recordingList_->get()->ClearRenderTargetView(rtvHandle, clearColor, 0, nullptr);
+
+        // Abv[hOobt@̓XbhZ[tł͂Ȃ̂ŁAf[^݂̏͋L^Oɂ̃Xbhōς܂
+
+        // J
+        Camera::ConstBufferData cameraData{
+            DirectX::XMMatrixTranspose(cameraInstance_.viewMatrix()),
+            DirectX::XMMatrixTranspose(cameraInstance_.projection()),
+        };
+        UploadRing::Allocation cameraAllocation{};
+        if (!uploadRingInstance_.allocate(sizeof(cameraData), fenceInstance_, cameraAllocation)) {
+            return;
+        }
+        memcpy_s(cameraAllocation.cpuAddress_, sizeof(cameraData), &cameraData, sizeof(cameraData));
+
+        drawItems_.clear();
+
+        // t[̑SCX^X̃f[^̃obt@ɑċl߂
+        // `斈ɂ̓obt@̊Jnʒu[g萔œn
+        const EntityStore* const objectGroups[] = {
+            &triangleEntities_,  // Op`
+            &squareEntities_,    // lp`
+        };
+        const std::span<const uint32_t> visibleGroups[] = {
+            visibleTriangles_,
+            visibleSquares_,
+        };
+        const Mesh* meshes[] = {
+            &trianglePolygonInstance_.mesh(),
+            &squarePolygonInstance_.mesh(),
+        };
+
+        // ̊ÕIuWFNg̓CX^Xf[^`Ȃ
+        if (frameInstances_.pack(uploadRingInstance_, fenceInstance_, objectGroups, visibleGroups)) {
+            const auto* pipeline = &pipelines_[shaderVariants_.find(sceneShaderKey)];
+            UINT instanceOffset = 0;
+            for (size_t i = 0; i < _countof(objectGroups); ++i) {
+                const auto instanceCount = static_cast<UINT>(visibleGroups[i].size());
+                if (instanceCount > 0) {
+                    const auto& mesh = *meshes[i];
+                    drawItems_.push_back({ pipeline, mesh.indexCount_, mesh.startIndex_, static_cast<int32_t>(mesh.baseVertex_), instanceOffset, instanceCount });
+                    uploadWaitFenceValue_ = std::max(uploadWaitFenceValue_, mesh.readyFenceValue_);
+                }
+                instanceOffset += instanceCount;
+            }
+        }
+
+        // SĂ̋L^Xbhŋʂ̐ݒ
+        // I𑜓xł̓obNobt@̍̈ꕔɕ`悷
+        const auto w = static_cast<int>(renderWidth_);
+        const auto h = static_cast<int>(renderHeight_);
+        sceneFrame_.renderTarget_ = &rhiDeviceInstance_.swapChain().backBuffer(backBufferIndex);
+        sceneFrame_.viewport_ = { 0.0f, 0.0f, static_cast<float>(w), static_cast<float>(h), 0.0f, 1.0f };
+        sceneFrame_.scissor_ = { 0, 0, w, h };
+        sceneFrame_.camera_ = cameraAllocation.gpuAddress_;
+        sceneFrame_.instances_ = drawItems_.empty() ? 0 : frameInstances_.gpuAddress();
+        sceneFrame_.vertexBuffer_ = meshPoolInstance_.vertexBufferView();
+        sceneFrame_.indexBuffer_ = meshPoolInstance_.indexBufferView();
+
+        if (captureRequested_) {
+            captureScene(cameraAllocation.gpuAddress_, cameraData, clearColor, objectGroups, visibleGroups);
+        }
+
+        // ܂ł̃R}hɒoɕׁA`͋L^XbhɕċL^
+        recordingList_->get()->Close();
+        submitLists_.push_back(recordingList_->get());
+
+        parallelRecorderInstance_.record(frameIndex, drawItems_.size(), minDrawItemsPerChunk,
+            [&](const CommandList& commandList, size_t begin, size_t end) {
+                recordDrawItems(commandList, begin, end);
+            },
+            submitLists_);
+
+        // ȍ~̃R}h͌㑱̃R}hXgɋL^
+        postCommandListInstance_.reset(commandAllocatorInstances_[frameIndex]);
+        recordingList_ = &postCommandListInstance_;
+
+        // L^Xbh̃R}hXg͊ԂɒôŁAI͌㑱̃R}hXgɋL^
+        gpuProfilerInstance_.end(*recordingList_, gpuSceneScope);
+    }
+
+    void recordDrawItems(const CommandList& commandList, size_t begin, size_t end) noexcept {
+        // L^̒g̓obNGhɈˑȂV[`pXɔC
+        RhiD3D12CommandList rhiCommandList{};
+        rhiCommandList.attach(commandList);
+        ScenePass::record(rhiCommandList, sceneFrame_, std::span(drawItems_).subspan(begin, end - begin));
+    }
+
+    void captureScene(RhiGpuAddress cameraAddress, const Camera::ConstBufferData& cameraData, const float (&clearColor)[4], std::span<const EntityStore* const> objectGroups, std::span<const std::span<const uint32_t>> visibleGroups) noexcept {
+        // L^XbhŝƓR}hA萔f[^ƃ_[Ot̃oA܂߂ċL^
+        frameCapture_.clear();
+        CaptureCommandList capture(frameCapture_);
+        auto& backBuffer = *sceneFrame_.renderTarget_;
+
+        capture.upload(cameraAddress, std::span(reinterpret_cast<const uint8_t*>(&cameraData), sizeof(cameraData)));
+        if (!drawItems_.empty()) {
+            // Abv[hq[v͓ǂݏoAe CPU ō蒼ċL^
+            captureInstances_.resize(frameInstances_.count());
+            InstanceBuffer::write(objectGroups, visibleGroups, captureInstances_.data());
+            capture.upload(frameInstances_.gpuAddress(), std::span(reinterpret_cast<const uint8_t*>(captureInstances_.data()), captureInstances_.size() * sizeof(Object::ConstBufferData)));
+        }
+
+        capture.barrier(backBuffer, RhiState::present, RhiState::renderTarget);
+        capture.clearRenderTarget(backBuffer, clearColor);
+        ScenePass::record(capture, sceneFrame_, drawItems_);
+        capture.barrier(backBuffer, RhiState::renderTarget, RhiState::present);
+    }
+
+    void replayCapture() noexcept {
+        const ProfileScope scope("replay");
+
+        // GPU ̏SďIĂALv`t[JԂoĎԂv
+        // 萔f[^̓Lv`t[̗̈ɏ̂ŁÄ̗悪Oɍs
+        fenceInstance_.wait(nextFenceValue_ - 1);
+        const auto upload = [this](RhiGpuAddress address, std::span<const uint8_t> data) {
+            auto* destination = uploadRingInstance_.cpuAddress(address, data.size());
+            if (!destination) {
+                return false;
+            }
+            memcpy_s(destination, data.size(), data.data(), data.size());
+            return true;
+        };
+        if (!CommandReplayer::benchmark(frameCapture_, rhiDeviceInstance_, replayCount, upload, replayTimes_) || replayTimes_.empty()) {
+            assert(false && "Lv`R}h̍ĐɎs܂");
+            return;
+        }
+
+        std::sort(replayTimes_.begin(), replayTimes_.end());
+        double total = 0.0;
+        for (const auto time : replayTimes_) {
+            total += time;
+        }
+        char message[256];
+        sprintf_s(message, "Replay: %u commands, %llu bytes uploaded, %zu runs, min %.3f ms, median %.3f ms, max %.3f ms, average %.3f ms\n",
+            frameCapture_.commandCount(), static_cast<unsigned long long>(frameCapture_.uploadSize()), replayTimes_.size(),
+            replayTimes_.front(), replayTimes_[replayTimes_.size() / 2], replayTimes_.back(), total / replayTimes_.size());
+        OutputDebugStringA(message);
+    }
+
+    void runBenchmarks() noexcept {
+        const ProfileScope scope("benchmark");
+
+        // `Ƃ͊֌WȂAςȂ CPU ̏v
+        Benchmark::entityUpdate(Benchmark::defaultCounts, Benchmark::defaultRepeatCount, benchmarkResults_);
+        logBenchmark("EntityUpdate", benchmarkResults_);
+        Benchmark::parallelEntityUpdate(jobSystem_, Benchmark::defaultCounts, Benchmark::defaultRepeatCount, benchmarkResults_);
+        logBenchmark("EntityUpdate(JobSystem)", benchmarkResults_);
+
+        Benchmark::transformBatch(Benchmark::defaultCounts, Benchmark::defaultRepeatCount, TransformBatch::Path::scalar, benchmarkResults_);
+        logBenchmark("TransformBatch(scalar)", benchmarkResults_);
+        Benchmark::transformBatch(Benchmark::defaultCounts, Benchmark::defaultRepeatCount, TransformBatch::Path::sse, benchmarkResults_);
+        logBenchmark("TransformBatch(SSE)", benchmarkResults_);
+        if (TransformBatch::bestPath() == TransformBatch::Path::avx2) {
+            Benchmark::transformBatch(Benchmark::defaultCounts, Benchmark::defaultRepeatCount, TransformBatch::Path::avx2, benchmarkResults_);
+            logBenchmark("TransformBatch(AVX2)", benchmarkResults_);
+        }
+
+        // ̃J̎Ŕ肷
+        const auto frustum = FrustumCulling::extractFrustum(DirectX::XMMatrixMultiply(cameraInstance_.viewMatrix(), cameraInstance_.projection()));
+        Benchmark::frustumCulling(frustum, Benchmark::defaultCounts, Benchmark::defaultRepeatCount, TransformBatch::Path::scalar, benchmarkResults_);
+        logBenchmark("FrustumCulling(scalar)", benchmarkResults_);
+        Benchmark::frustumCulling(frustum, Benchmark::defaultCounts, Benchmark::defaultRepeatCount, TransformBatch::bestPath(), benchmarkResults_);
+        logBenchmark("FrustumCulling(SIMD)", benchmarkResults_);
+
+        // Õt[ƓݒŎlp`̕`ׁAL^Xbh̐ςȂL^v
+        if (sceneFrame_.renderTarget_) {
+            const auto& mesh = squarePolygonInstance_.mesh();
+            const ScenePass::Draw draw{ &pipelines_[shaderVariants_.find(sceneShaderKey)], mesh.indexCount_, mesh.startIndex_, static_cast<int32_t>(mesh.baseVertex_), 0, 1 };
+            for (const auto threadCount : benchmarkRecordThreadCounts) {
+                Benchmark::parallelRecording(deviceInstance_, threadCount, minDrawItemsPerChunk, sceneFrame_, draw, Benchmark::defaultDrawCounts, Benchmark::defaultRepeatCount, benchmarkResults_);
+                char name[64];
+                sprintf_s(name, "ParallelRecorder(%u threads)", threadCount);
+                logBenchmark(name, benchmarkResults_);
+            }
+        }
+    }
+
+    static void logBenchmark(const char* name, const std::vector<Benchmark::Result>& results) noexcept {
+        for (const auto& result : results) {
+            char message[256];
+            sprintf_s(message, "Benchmark %s: %u items, %.3f ms, %.1f M items/s\n",
+                name, result.count_, result.milliseconds_, result.perSecond_ / 1'000'000.0);
+            OutputDebugStringA(message);
+        }
+    }
+
+    [[nodiscard]] static bool keyTriggered(uint16_t key, bool& wasDown) noexcept {
+        // uԂ̃t[ true Ԃ
+        const auto down = Input::instance().getKey(key);
+        const auto triggered = down && !wasDown;
+        wasDown = down;
+        return triggered;
+    }
+
+    void flushBarriers(const std::vector<RenderGraph::Barrier>& barriers) noexcept {
+        if (barriers.empty()) {
+            return;
+        }
+
+        // pXPʂł܂Ƃ߂Ĉx ResourceBarrier Ŕs
+        barrierBuffer_.clear();
+        for (const auto& barrier : barriers) {
+            barrierBuffer_.push_back(resourceBarrier(graphResources_[barrier.resource_],
+                static_cast<D3D12_RESOURCE_STATES>(barrier.before_), static_cast<D3D12_RESOURCE_STATES>(barrier.after_)));
+        }
+        recordingList_->get()->ResourceBarrier(static_cast<UINT>(barrierBuffer_.size()), barrierBuffer_.data());
+    }
+
     D3D12_RESOURCE_BARRIER resourceBarrier(ID3D12Resource* resource, D3D12_RESOURCE_STATES from, D3D12_RESOURCE_STATES to) noexcept {
         D3D12_RESOURCE_BARRIER barrier{};
         barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
@@ -183,35 +668,86 @@ private:
     SwapChain          swapChainInstance_{};
     DescriptorHeap     descriptorHeapInstance_{};
     RenderTarget       renderTargetInstance_{};
-    CommandAllocator   commandAllocatorInstance_[2]{};
+    UINT                          framesInFlight_{};              // ɏt[
+    std::vector<CommandAllocator> commandAllocatorInstances_{};   // t[̃R}hAP[^
     CommandList        commandListInstance_{};
+    CommandList        postCommandListInstance_{};  // L^̌ɑR}hp
+    CommandList*       recordingList_{};            // ݋L^̃R}hXg
+    ParallelRecorder   parallelRecorderInstance_{};
+    JobSystem          jobSystem_{};                // t[̍XVɎsWuVXe
+    std::vector<ID3D12CommandList*> submitLists_{};  // oɕׂR}hXg
+    std::vector<ScenePass::Draw>    drawItems_{};    // L^Xbhɕz`惊Xg
+    ScenePass::Frame                sceneFrame_{};   // SĂ̋L^Xbhŋʂ̐ݒ
+    InstanceBuffer                  frameInstances_{};  // t[̑SCX^X̃f[^
+    CommandStream                   frameCapture_{};       // Lv`t[̃R}h
+    std::vector<Object::ConstBufferData> captureInstances_{};  // Lv`t[̃CX^Xf[^
+    std::vector<double>             replayTimes_{};        // Đ񖈂̎ԁi~bj
+    bool                            captureRequested_{};   // ̃t[Lv`邩
+    bool                            captureKeyDown_{};     // Õt[ŃLv`̃L[Ă
+    bool                            profileKeyDown_{};     // Õt[ŏõL[Ă
+    FrameStatistics                 frameStatistics_{};       // t[Ԃ̓v
+    uint64_t                        statisticsStartTime_{};   // v̎̊iimbj
+    uint64_t                        statisticsReportTime_{};  // O񓝌vo͂iimbj
+    uint64_t                        lastPresentTime_{};       // Õt[ Present Ԃiimbj
+    bool                            statisticsKeyDown_{};     // Õt[œṽL[Ă
+    std::vector<Benchmark::Result>  benchmarkResults_{};      // x`}[Ňv
+    bool                            benchmarkKeyDown_{};      // Õt[Ńx`}[ÑL[Ă
+    FramePacer                      framePacer_{};            // t[n߂鎞̐
+    bool                            latencyModeKeyDown_{};    // Õt[Œx[h̃L[Ă
+    DynamicResolution               dynamicResolution_{};         // `𑜓x̔{̐
+    bool                            dynamicResolutionEnabled_{};  // I𑜓xgi͖AF7 Ő؂ւj
+    bool                            dynamicResolutionKeyDown_{};  // Õt[œI𑜓x̃L[Ă
+    UINT                            renderWidth_{};               // ̃t[̕`𑜓x̉
+    UINT                            renderHeight_{};              // ̃t[̕`𑜓x̏c
     Fence              fenceInstance_{};
-    UINT64             frameFenceValue_[2]{};
+    GpuMemoryAllocator gpuMemoryAllocatorInstance_{};  // obt@gNXɐ錾Aɔj悤ɂ
+    RhiD3D12Device     rhiDeviceInstance_{};          // `̋L^ɎgobNGh
+    GpuProfiler        gpuProfilerInstance_{};        // pX GPU Ԃ̌v
+    std::vector<UINT64> frameFenceValues_{};  // t[̊҂tFXl
     UINT64             nextFenceValue_ = 1;
+    UINT64             frameCount_{};         // Jnt[̐
 
     RootSignature      rootSignatureInstance_{};
-    Shader             shaderInstance_{};
-    PiplineStateObject piplineStateObjectInstance_{};
-    DescriptorHeap     constantBufferDescriptorHeapInstance_{};
-
+    ShaderVariantRegistry           shaderVariants_{};               // gVF[_̃oG[V
+    std::vector<Shader>             shaderInstances_{};              // oG[ṼVF[_
+    std::vector<PiplineStateObject> piplineStateObjectInstances_{};  // oG[ṼpCvCXe[g
+    std::vector<RhiD3D12Pipeline>   pipelines_{};                    // oG[ṼpCvCipCvCXe[gƃ[gVOl`̑gj
+    PipelineCache      pipelineCacheInstance_{};
+    UploadRing         uploadRingInstance_{};
+
+    RenderGraph                         renderGraphInstance_{};
+    std::vector<ID3D12Resource*>        graphResources_{};  // _[Ot̃\[Xʎq\[Xւ̑Ή
+    std::vector<D3D12_RESOURCE_BARRIER> barrierBuffer_{};   // ܂Ƃ߂ĔsoA̍Ɨ̈
+
+    UploadManager      uploadManagerInstance_{};
+    MeshPool           meshPoolInstance_{};
+    UINT64             uploadWaitFenceValue_{};  // ̃t[ő҂Kv̂]̃tFXl
     TrianglePolygon    trianglePolygonInstance_{};
-    Object             triangleObjectInstance_{};
-    ConstantBuffer     trianglePolygonConstantBufferInstance_{};
+    EntityStore        triangleEntities_{};  // Op`ŕ`悷IuWFNg
+    std::vector<uint32_t> visibleTriangles_{};  // ɓOp`̔z̈ʒu
 
     // NX QuadPolygon Ȃ̂ SquarePolygon Ȃ̂ӂĂ
     // ł͂Ȃ̍Ō̃R[hɍ킹 SquarePolygon ɂĂ܂
     SquarePolygon      squarePolygonInstance_{};
-    Object             squareObjectInstance_{};
-    ConstantBuffer     squarePolygonConstantBufferInstance_{};
+    EntityStore        squareEntities_{};    // lp`ŕ`悷IuWFNg
+    std::vector<uint32_t> visibleSquares_{};  // ɓlp`̔z̈ʒu
 
     Camera             cameraInstance_{};
-    ConstantBuffer     cameraConstantBufferInstance_{};
 };
 
 int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int nCmdShow) {
+    // R}hCœɏt[wł
+    auto framesInFlight = defaultFramesInFlight;
+    if (lpCmdLine && *lpCmdLine) {
+        const auto value = std::atoi(lpCmdLine);
+        if (value > 0) {
+            framesInFlight = std::min(static_cast<UINT>(value), maxFramesInFlight);
+        }
+    }
+
     Application app;
-    if (!app.initialize(hInstance)) return -1;
-    app.loop();
+    if (!app.initialize(hInstance, framesInFlight)) return -1;
+    if (!app.loop()) return -1;
     return 0;
 }
 
@@ -28,7 +28,8 @@ Fence::~Fence() {
 		return false;
 	}
 	// GPU p̃Cxgnh쐬
-	waitGpuEvent_ = CreateEvent(nullptr, false, false, TEXT("WAIT_GPU"));
+	// tFXɕʂ̃Cxgg߁AO͕tȂ
+	waitGpuEvent_ = CreateEvent(nullptr, false, false, nullptr);
 	if (!waitGpuEvent_) {
 		assert(false && "GPU p̃Cxgnh̍쐬Ɏs܂");
 		return false;
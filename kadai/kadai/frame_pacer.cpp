@@ -0,0 +1,105 @@
+﻿// フレームの開始時刻を決めるクラス
+
+#include "frame_pacer.h"
+#include <algorithm>
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	遅延の制御方法を設定する
+ * @param	mode	遅延の制御方法
+ */
+void FramePacer::setMode(Mode mode) noexcept {
+    mode_ = mode;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	遅延の制御方法を取得する
+ * @return	遅延の制御方法
+ */
+[[nodiscard]] FramePacer::Mode FramePacer::mode() const noexcept {
+    return mode_;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	フレームを始められるようになった時刻を渡し、入力を読む時刻を決める
+ * 前回からの間隔でリフレッシュ間隔の推定と、前のフレームが間に合ったかの判定も行う
+ * @param	readyTime	スワップチェインの待ちが返った時刻（ナノ秒）
+ * @return	入力を読んでフレームを始める時刻（ナノ秒）
+ */
+[[nodiscard]] uint64_t FramePacer::beginFrame(uint64_t readyTime) noexcept {
+    if (lastReadyTime_ != 0 && readyTime > lastReadyTime_) {
+        const auto interval = readyTime - lastReadyTime_;
+        if (interval > static_cast<uint64_t>(refreshInterval_ * missThreshold)) {
+            // 垂直同期を一回以上逃したので、余裕を倍に増やす（リフレッシュ間隔の半分まで）
+            missedFrames_++;
+            margin_ = std::min(margin_ * 2, refreshInterval_ / 2);
+        } else if (interval < refreshInterval_) {
+            // 待ちの間隔はリフレッシュ間隔より短くならないので、短い間隔はすぐに採用する（待ちの揺れに備え半分まで）
+            // 推定が長いままだと遅らせ過ぎて毎回垂直同期を逃し、その間隔をリフレッシュ間隔と誤って学習してしまう
+            refreshInterval_ = std::max(interval, refreshInterval_ / 2);
+        } else {
+            // 間に合っている間はリフレッシュ間隔を追従させ、余裕を少しずつ戻す
+            refreshInterval_ += (interval - refreshInterval_) / 16;
+            margin_ = std::max(margin_ - margin_ / 64, minMargin);
+        }
+    }
+    lastReadyTime_ = readyTime;
+
+    // 処理時間をまだ計測していないフレームは遅らせない
+    if (mode_ == Mode::throughput || predictedWork_ == 0) {
+        return readyTime;
+    }
+
+    // 待ちが返るのはおおよそ垂直同期の直後なので、次の垂直同期までに処理が終わる一番遅い時刻から始める
+    const auto budget = predictedWork_ + margin_;
+    if (budget >= refreshInterval_) {
+        return readyTime;
+    }
+    return readyTime + (refreshInterval_ - budget);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	フレームの処理が終わった時刻を渡す
+ * @param	startTime	入力を読んでフレームを始めた時刻（ナノ秒）
+ * @param	presentTime	Present が返った時刻（ナノ秒）
+ */
+void FramePacer::endFrame(uint64_t startTime, uint64_t presentTime) noexcept {
+    const auto work = presentTime > startTime ? presentTime - startTime : 0;
+
+    // 長くなった時はすぐに合わせ、短くなった時はゆっくり下げる（ピークを保持する）
+    if (work > predictedWork_) {
+        predictedWork_ = work;
+    } else {
+        predictedWork_ -= (predictedWork_ - work) / 32;
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	推定したリフレッシュ間隔を取得する
+ * @return	リフレッシュ間隔（ナノ秒）
+ */
+[[nodiscard]] uint64_t FramePacer::refreshInterval() const noexcept {
+    return refreshInterval_;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	予測したフレームの処理時間を取得する
+ * @return	処理時間（ナノ秒）
+ */
+[[nodiscard]] uint64_t FramePacer::predictedWork() const noexcept {
+    return predictedWork_;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	次の垂直同期に間に合わなかったフレームの数を取得する
+ * @return	フレームの数
+ */
+[[nodiscard]] uint64_t FramePacer::missedFrames() const noexcept {
+    return missedFrames_;
+}
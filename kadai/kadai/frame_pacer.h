@@ -0,0 +1,101 @@
+﻿// フレームの開始時刻を決めるクラス
+
+#pragma once
+
+#include <cstdint>
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	フレームの開始時刻を決めるクラス
+ * 待機可能なスワップチェインの待ちが返ってから、入力を読むまでの待ち時間を決める
+ * 低遅延モードでは直近のフレームの処理時間から次の垂直同期に間に合う一番遅い時刻を予測し、そこまで入力の読み込みを遅らせる
+ * 時刻は全て呼び出し側が渡すので、シミュレーションした Present の時計でも同じように動く
+ */
+class FramePacer final {
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	遅延の制御方法
+     */
+    enum class Mode : uint8_t {
+        throughput,  /// 待ちが返ったらすぐにフレームを始める
+        lowLatency,  /// 次の垂直同期に間に合う範囲でフレームの開始を遅らせる
+    };
+
+    static constexpr uint64_t defaultRefreshInterval = 16'666'667;  /// リフレッシュ間隔の初期値（ナノ秒、60Hz）
+    static constexpr uint64_t minMargin = 1'000'000;                /// 予測の誤差に備える余裕の最小値（ナノ秒）
+    static constexpr double   missThreshold = 1.5;                  /// リフレッシュ間隔の何倍を超えたら間に合わなかったとみなすか
+
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    コンストラクタ
+     */
+    FramePacer() = default;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    デストラクタ
+     */
+    ~FramePacer() = default;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	遅延の制御方法を設定する
+     * @param	mode	遅延の制御方法
+     */
+    void setMode(Mode mode) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	遅延の制御方法を取得する
+     * @return	遅延の制御方法
+     */
+    [[nodiscard]] Mode mode() const noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	フレームを始められるようになった時刻を渡し、入力を読む時刻を決める
+     * 前回からの間隔でリフレッシュ間隔の推定と、前のフレームが間に合ったかの判定も行う
+     * @param	readyTime	スワップチェインの待ちが返った時刻（ナノ秒）
+     * @return	入力を読んでフレームを始める時刻（ナノ秒）
+     */
+    [[nodiscard]] uint64_t beginFrame(uint64_t readyTime) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	フレームの処理が終わった時刻を渡す
+     * @param	startTime	入力を読んでフレームを始めた時刻（ナノ秒）
+     * @param	presentTime	Present が返った時刻（ナノ秒）
+     */
+    void endFrame(uint64_t startTime, uint64_t presentTime) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	推定したリフレッシュ間隔を取得する
+     * @return	リフレッシュ間隔（ナノ秒）
+     */
+    [[nodiscard]] uint64_t refreshInterval() const noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	予測したフレームの処理時間を取得する
+     * @return	処理時間（ナノ秒）
+     */
+    [[nodiscard]] uint64_t predictedWork() const noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	次の垂直同期に間に合わなかったフレームの数を取得する
+     * @return	フレームの数
+     */
+    [[nodiscard]] uint64_t missedFrames() const noexcept;
+
+private:
+    Mode     mode_ = Mode::lowLatency;                    /// 遅延の制御方法
+    uint64_t refreshInterval_ = defaultRefreshInterval;  /// 推定したリフレッシュ間隔（ナノ秒）
+    uint64_t predictedWork_{};                           /// 予測したフレームの処理時間（ナノ秒）
+    uint64_t margin_ = minMargin;                        /// 予測の誤差に備える余裕（ナノ秒）
+    uint64_t lastReadyTime_{};                           /// 前回スワップチェインの待ちが返った時刻（ナノ秒）
+    uint64_t missedFrames_{};                            /// 間に合わなかったフレームの数
+};
@@ -0,0 +1,148 @@
+﻿// フレーム時間の統計クラス
+
+#include "frame_statistics.h"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <fstream>
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	時間を記録する
+ * @param	metric			時間の種類
+ * @param	milliseconds	時間（ミリ秒）
+ */
+void FrameStatistics::record(Metric metric, double milliseconds) noexcept {
+    assert(metric < Metric::count && "時間の種類が不正です");
+    auto& track = tracks_[static_cast<size_t>(metric)];
+    milliseconds = std::max(milliseconds, 0.0);
+
+    // 直近の平均より極端に長いフレームをスタッターとする
+    // 平均がまだ決まっていない最初のフレームは判定しない
+    // GPU の完了待ちは 0 に近い時間が続くので、平均との比では僅かな待ちまでスタッターになる。フレームの時間と間隔だけを判定する
+    const auto detectsStutter = metric == Metric::cpuFrame || metric == Metric::presentInterval;
+    if (detectsStutter && track.count_ != 0 && milliseconds > track.recent_ * stutterRatio) {
+        track.stutters_++;
+    }
+    track.recent_ = track.count_ == 0 ? milliseconds : track.recent_ + (milliseconds - track.recent_) * smoothing;
+
+    const auto bin = std::min(static_cast<uint32_t>(milliseconds / binWidth), binCount - 1);
+    track.bins_[bin]++;
+    track.count_++;
+    track.total_ += milliseconds;
+    track.max_ = std::max(track.max_, milliseconds);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	記録した時間を集計する
+ * パーセンタイルはヒストグラムの区間の上端で返すので、誤差は binWidth 以内になる
+ * @param	metric	時間の種類
+ * @return	集計結果
+ */
+[[nodiscard]] FrameStatistics::Summary FrameStatistics::summary(Metric metric) const noexcept {
+    assert(metric < Metric::count && "時間の種類が不正です");
+    const auto& track = tracks_[static_cast<size_t>(metric)];
+
+    Summary summary{};
+    summary.count_ = track.count_;
+    if (track.count_ == 0) {
+        return summary;
+    }
+    summary.average_ = track.total_ / track.count_;
+    summary.p50_ = percentile(track, 0.50);
+    summary.p95_ = percentile(track, 0.95);
+    summary.p99_ = percentile(track, 0.99);
+    summary.max_ = track.max_;
+    summary.stutters_ = track.stutters_;
+    return summary;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	記録した時間を全て破棄する
+ */
+void FrameStatistics::reset() noexcept {
+    for (auto& track : tracks_) {
+        track = Track{};
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	集計結果を CSV ファイルに追記する
+ * ファイルが空の時は先に見出しの行を書き込む
+ * @param	path	ファイルのパス
+ * @param	time	集計した時刻（起動からの秒数）
+ * @return	書き込みの成否
+ */
+[[nodiscard]] bool FrameStatistics::appendCsv(const std::filesystem::path& path, double time) const noexcept {
+    std::error_code error;
+    const auto empty = !std::filesystem::exists(path, error) || std::filesystem::file_size(path, error) == 0;
+
+    std::ofstream file(path, std::ios::app);
+    if (!file) {
+        assert(false && "統計のファイルを開けませんでした");
+        return false;
+    }
+
+    if (empty) {
+        file << "time,metric,count,average_ms,p50_ms,p95_ms,p99_ms,max_ms,stutters\n";
+    }
+    for (uint32_t i = 0; i < static_cast<uint32_t>(Metric::count); ++i) {
+        const auto metric = static_cast<Metric>(i);
+        const auto result = summary(metric);
+        file << time << ',' << name(metric) << ',' << result.count_ << ','
+             << result.average_ << ',' << result.p50_ << ',' << result.p95_ << ',' << result.p99_ << ','
+             << result.max_ << ',' << result.stutters_ << '\n';
+    }
+
+    if (!file) {
+        assert(false && "統計のファイルの書き込みに失敗しました");
+        return false;
+    }
+    return true;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	時間の種類の名前を取得する
+ * @param	metric	時間の種類
+ * @return	名前
+ */
+[[nodiscard]] const char* FrameStatistics::name(Metric metric) noexcept {
+    switch (metric) {
+        case Metric::cpuFrame:
+            return "cpu_frame";
+        case Metric::presentInterval:
+            return "present_interval";
+        case Metric::fenceWait:
+            return "fence_wait";
+        default:
+            return "unknown";
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	パーセンタイルを求める
+ * @param	track		記録
+ * @param	percentile	求める割合（0 〜 1）
+ * @return	時間（ミリ秒）
+ */
+[[nodiscard]] double FrameStatistics::percentile(const Track& track, double percentile) noexcept {
+    // 小さい方から数えて、割合に達した区間の上端を返す
+    const auto target = std::max<uint64_t>(static_cast<uint64_t>(std::ceil(percentile * track.count_)), 1);
+    uint64_t count = 0;
+    for (uint32_t bin = 0; bin < binCount; ++bin) {
+        count += track.bins_[bin];
+        if (count >= target) {
+            // 最後の区間は上限が無いので最大値を返し、他の区間も実際の最大値を超えないようにする
+            if (bin == binCount - 1) {
+                return track.max_;
+            }
+            return std::min((bin + 1) * binWidth, track.max_);
+        }
+    }
+    return track.max_;
+}
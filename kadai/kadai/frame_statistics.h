@@ -0,0 +1,128 @@
+﻿// フレーム時間の統計クラス
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	フレーム時間の統計クラス
+ * フレーム毎の時間を固定幅のヒストグラムに集計し、パーセンタイルとスタッター（引っかかり）の回数を求める
+ * 平均の FPS では一瞬の引っかかりが埋もれてしまうので、p95 / p99 と最大値で評価する
+ * 記録の度にメモリを確保しないので、毎フレーム呼んでも負荷は小さい
+ */
+class FrameStatistics final {
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	計測する時間の種類
+     */
+    enum class Metric : uint8_t {
+        cpuFrame,         /// CPU がフレームの処理に使った時間（GPU の完了待ちを除く）
+        presentInterval,  /// Present から次の Present までの間隔
+        fenceWait,        /// GPU の完了を待った時間
+        count,
+    };
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	集計結果
+     */
+    struct Summary {
+        uint32_t count_{};     /// 記録した回数
+        double   average_{};   /// 平均（ミリ秒）
+        double   p50_{};       /// 50 パーセンタイル（ミリ秒）
+        double   p95_{};       /// 95 パーセンタイル（ミリ秒）
+        double   p99_{};       /// 99 パーセンタイル（ミリ秒）
+        double   max_{};       /// 最大値（ミリ秒）
+        uint32_t stutters_{};  /// スタッターと判定した回数（GPU の完了待ちは判定しないので常に 0）
+    };
+
+    static constexpr double   binWidth = 0.05;      /// ヒストグラムの一区間の幅（ミリ秒）
+    static constexpr uint32_t binCount = 2000;      /// ヒストグラムの区間の数（これを超える時間は最後の区間に入れる）
+    static constexpr double   stutterRatio = 2.0;   /// 直近の平均の何倍を超えたらスタッターとするか
+    static constexpr double   smoothing = 0.1;      /// 直近の平均（指数移動平均）の追従の速さ
+
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    コンストラクタ
+     */
+    FrameStatistics() = default;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    デストラクタ
+     */
+    ~FrameStatistics() = default;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	時間を記録する
+     * @param	metric			時間の種類
+     * @param	milliseconds	時間（ミリ秒）
+     */
+    void record(Metric metric, double milliseconds) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	記録した時間を集計する
+     * パーセンタイルはヒストグラムの区間の上端で返すので、誤差は binWidth 以内になる
+     * @param	metric	時間の種類
+     * @return	集計結果
+     */
+    [[nodiscard]] Summary summary(Metric metric) const noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	記録した時間を全て破棄する
+     */
+    void reset() noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	集計結果を CSV ファイルに追記する
+     * ファイルが空の時は先に見出しの行を書き込む
+     * @param	path	ファイルのパス
+     * @param	time	集計した時刻（起動からの秒数）
+     * @return	書き込みの成否
+     */
+    [[nodiscard]] bool appendCsv(const std::filesystem::path& path, double time) const noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	時間の種類の名前を取得する
+     * @param	metric	時間の種類
+     * @return	名前
+     */
+    [[nodiscard]] static const char* name(Metric metric) noexcept;
+
+private:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	一つの時間の種類の記録
+     */
+    struct Track {
+        std::array<uint32_t, binCount> bins_{};      /// 区間毎の回数
+        uint32_t                       count_{};     /// 記録した回数
+        double                         total_{};     /// 合計（ミリ秒）
+        double                         max_{};       /// 最大値（ミリ秒）
+        double                         recent_{};    /// 直近の平均（ミリ秒）
+        uint32_t                       stutters_{};  /// スタッターと判定した回数
+    };
+
+private:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	パーセンタイルを求める
+     * @param	track		記録
+     * @param	percentile	求める割合（0 〜 1）
+     * @return	時間（ミリ秒）
+     */
+    [[nodiscard]] static double percentile(const Track& track, double percentile) noexcept;
+
+private:
+    std::array<Track, static_cast<size_t>(Metric::count)> tracks_{};  /// 時間の種類毎の記録
+};
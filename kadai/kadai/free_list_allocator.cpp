@@ -0,0 +1,129 @@
+﻿// フリーリストアロケータクラス
+
+#include "free_list_allocator.h"
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	アロケータを初期化する
+ * @param	capacity	管理する範囲のサイズ
+ */
+void FreeListAllocator::initialize(uint64_t capacity) noexcept {
+    freeBlocks_.clear();
+    capacity_ = capacity;
+    freeSize_ = capacity;
+    if (capacity > 0) {
+        freeBlocks_.emplace(0, capacity);
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	範囲を確保する
+ * 先頭から順に探し、最初に収まった空き範囲から切り出す
+ * @param	size		確保するサイズ
+ * @param	alignment	アライメント（2 の累乗）
+ * @return	確保した範囲のオフセット、空きが無い場合は invalidOffset
+ */
+[[nodiscard]] uint64_t FreeListAllocator::allocate(uint64_t size, uint64_t alignment) noexcept {
+    assert(alignment != 0 && (alignment & (alignment - 1)) == 0 && "アライメントが 2 の累乗ではありません");
+
+    if (size == 0 || size > freeSize_) {
+        return invalidOffset;
+    }
+
+    for (auto it = freeBlocks_.begin(); it != freeBlocks_.end(); ++it) {
+        const auto [blockOffset, blockSize] = *it;
+        const auto offset = (blockOffset + alignment - 1) & ~(alignment - 1);
+        const auto padding = offset - blockOffset;
+        if (padding + size > blockSize) {
+            continue;
+        }
+
+        // 空き範囲を確保した範囲の前後に分割する
+        freeBlocks_.erase(it);
+        if (padding > 0) {
+            freeBlocks_.emplace(blockOffset, padding);
+        }
+        const auto rest = blockSize - padding - size;
+        if (rest > 0) {
+            freeBlocks_.emplace(offset + size, rest);
+        }
+
+        freeSize_ -= size;
+        return offset;
+    }
+
+    return invalidOffset;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	範囲を解放する
+ * @param	offset	allocate で確保したオフセット
+ * @param	size	allocate で指定したサイズ
+ */
+void FreeListAllocator::free(uint64_t offset, uint64_t size) noexcept {
+    if (size == 0) {
+        return;
+    }
+    assert(offset + size <= capacity_ && "管理範囲外の解放です");
+
+    auto next = freeBlocks_.lower_bound(offset);
+    assert((next == freeBlocks_.end() || offset + size <= next->first) && "二重解放です");
+
+    auto begin = offset;
+    auto end = offset + size;
+
+    // 直前の空き範囲と隣接していれば結合する
+    if (next != freeBlocks_.begin()) {
+        const auto prev = std::prev(next);
+        assert(prev->first + prev->second <= offset && "二重解放です");
+        if (prev->first + prev->second == offset) {
+            begin = prev->first;
+            freeBlocks_.erase(prev);
+        }
+    }
+
+    // 直後の空き範囲と隣接していれば結合する
+    if (next != freeBlocks_.end() && next->first == end) {
+        end += next->second;
+        freeBlocks_.erase(next);
+    }
+
+    freeBlocks_.emplace(begin, end - begin);
+    freeSize_ += size;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	空いているサイズの合計を取得する
+ * @return	空いているサイズ
+ */
+[[nodiscard]] uint64_t FreeListAllocator::freeSize() const noexcept {
+    return freeSize_;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	最も大きい空き範囲のサイズを取得する
+ * @return	最も大きい空き範囲のサイズ
+ */
+[[nodiscard]] uint64_t FreeListAllocator::largestFreeBlock() const noexcept {
+    uint64_t largest = 0;
+    for (const auto& [offset, size] : freeBlocks_) {
+        largest = std::max(largest, size);
+    }
+    return largest;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	管理している範囲のサイズを取得する
+ * @return	範囲のサイズ
+ */
+[[nodiscard]] uint64_t FreeListAllocator::capacity() const noexcept {
+    return capacity_;
+}
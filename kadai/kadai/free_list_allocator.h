@@ -0,0 +1,81 @@
+﻿// フリーリストアロケータクラス
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	フリーリストアロケータクラス
+ * バッファ上の範囲のみを管理し、GPU リソースには依存しない
+ * 空き範囲をオフセット順に保持し、解放時に隣接する空き範囲と結合する
+ */
+class FreeListAllocator final {
+public:
+    static constexpr uint64_t invalidOffset = UINT64_MAX;  /// 確保失敗を表すオフセット
+
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    コンストラクタ
+     */
+    FreeListAllocator() = default;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    デストラクタ
+     */
+    ~FreeListAllocator() = default;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	アロケータを初期化する
+     * @param	capacity	管理する範囲のサイズ
+     */
+    void initialize(uint64_t capacity) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	範囲を確保する
+     * 先頭から順に探し、最初に収まった空き範囲から切り出す
+     * @param	size		確保するサイズ
+     * @param	alignment	アライメント（2 の累乗）
+     * @return	確保した範囲のオフセット、空きが無い場合は invalidOffset
+     */
+    [[nodiscard]] uint64_t allocate(uint64_t size, uint64_t alignment = 1) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	範囲を解放する
+     * @param	offset	allocate で確保したオフセット
+     * @param	size	allocate で指定したサイズ
+     */
+    void free(uint64_t offset, uint64_t size) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	空いているサイズの合計を取得する
+     * @return	空いているサイズ
+     */
+    [[nodiscard]] uint64_t freeSize() const noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	最も大きい空き範囲のサイズを取得する
+     * @return	最も大きい空き範囲のサイズ
+     */
+    [[nodiscard]] uint64_t largestFreeBlock() const noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	管理している範囲のサイズを取得する
+     * @return	範囲のサイズ
+     */
+    [[nodiscard]] uint64_t capacity() const noexcept;
+
+private:
+    std::map<uint64_t, uint64_t> freeBlocks_{};  /// 空き範囲（オフセット → サイズ）
+    uint64_t                     capacity_{};    /// 管理する範囲のサイズ
+    uint64_t                     freeSize_{};    /// 空いているサイズの合計
+};
@@ -0,0 +1,261 @@
+﻿// 視錐台カリングクラス
+
+#include "frustum_culling.h"
+#include <algorithm>
+#include <cmath>
+#include <immintrin.h>
+
+// MSVC は命令セットの指定が無くても AVX2 の組み込み関数を使えるが、GCC / Clang は関数毎に許可が要る
+#if defined(__GNUC__) || defined(__clang__)
+#define FRUSTUM_CULLING_AVX2 __attribute__((target("avx2")))
+#else
+#define FRUSTUM_CULLING_AVX2
+#endif
+
+namespace {
+    constexpr size_t planeCount = 6;  // 視錐台の平面の数
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	平面を正規化して書き込む
+     * @param	a		平面の a
+     * @param	b		平面の b
+     * @param	c		平面の c
+     * @param	d		平面の d
+     * @param	plane	法線の長さを 1 にした平面の書き込み先
+     */
+    void normalizePlane(float a, float b, float c, float d, float (&plane)[4]) noexcept {
+        const auto length = std::sqrt(a * a + b * b + c * c);
+        const auto inverse = length > 0.0f ? 1.0f / length : 0.0f;
+        plane[0] = a * inverse;
+        plane[1] = b * inverse;
+        plane[2] = c * inverse;
+        plane[3] = d * inverse;
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	一つの境界球を判定する
+     * @param	frustum	視錐台
+     * @param	bounds	境界球の配列
+     * @param	i		境界球の位置
+     * @return	視錐台に掛かっていれば true
+     */
+    [[nodiscard]] bool isVisible(const FrustumCulling::Frustum& frustum, const FrustumCulling::Bounds& bounds, size_t i) noexcept {
+        const auto scaleX = std::fabs(bounds.scaleX_[i]);
+        const auto scaleY = std::fabs(bounds.scaleY_[i]);
+        const auto scaleZ = std::fabs(bounds.scaleZ_[i]);
+
+        // std::max は NaN の位置で結果が変わるので、どの軸の NaN も SIMD 版と同じく見えないものとして扱う
+        if (std::isnan(scaleX) || std::isnan(scaleY) || std::isnan(scaleZ)) {
+            return false;
+        }
+        const auto radius = bounds.radius_[i] * std::max(scaleX, std::max(scaleY, scaleZ));
+        for (const auto& plane : frustum.planes_) {
+            // SIMD 版と同じ順で足すので、平面に接する球の判定も一致する
+            const auto distance = (plane[0] * bounds.centerX_[i] + plane[1] * bounds.centerY_[i]) + (plane[2] * bounds.centerZ_[i] + plane[3]);
+
+            // SIMD 版と同じく、比較できない値（NaN）も見えないものとして扱う
+            if (!(distance >= -radius)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	4 個ずつ SSE で判定する
+     * 見える位置は分岐せずに書き込み、見える場合だけ書き込み位置を進める
+     * @param	frustum			視錐台
+     * @param	bounds			境界球の配列
+     * @param	begin			判定を始める位置
+     * @param	count			境界球の数
+     * @param	visible			見える境界球の位置の書き込み先
+     * @param	visibleCount	見える境界球の数（書き込んだ分だけ増やす）
+     * @return	判定し終えた位置（端数は判定しない）
+     */
+    [[nodiscard]] size_t cullSse(const FrustumCulling::Frustum& frustum, const FrustumCulling::Bounds& bounds, size_t begin, size_t count, uint32_t* visible, size_t& visibleCount) noexcept {
+        __m128 planes[planeCount][4];
+        for (size_t p = 0; p < planeCount; ++p) {
+            planes[p][0] = _mm_set1_ps(frustum.planes_[p][0]);
+            planes[p][1] = _mm_set1_ps(frustum.planes_[p][1]);
+            planes[p][2] = _mm_set1_ps(frustum.planes_[p][2]);
+            planes[p][3] = _mm_set1_ps(frustum.planes_[p][3]);
+        }
+        const auto absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+
+        auto written = visibleCount;
+        auto i = begin;
+        for (; i + 4 <= count; i += 4) {
+            const auto x = _mm_loadu_ps(bounds.centerX_ + i);
+            const auto y = _mm_loadu_ps(bounds.centerY_ + i);
+            const auto z = _mm_loadu_ps(bounds.centerZ_ + i);
+            const auto sx = _mm_and_ps(_mm_loadu_ps(bounds.scaleX_ + i), absMask);
+            const auto sy = _mm_and_ps(_mm_loadu_ps(bounds.scaleY_ + i), absMask);
+            const auto sz = _mm_and_ps(_mm_loadu_ps(bounds.scaleZ_ + i), absMask);
+            const auto radius = _mm_mul_ps(_mm_loadu_ps(bounds.radius_ + i), _mm_max_ps(sx, _mm_max_ps(sy, sz)));
+            const auto negativeRadius = _mm_sub_ps(_mm_setzero_ps(), radius);
+
+            // 全ての平面で内側への距離が -半径 以上なら見える（_mm_max_ps は NaN を落とすので、拡大率の NaN は別に除く）
+            auto inside = _mm_and_ps(_mm_cmpord_ps(sx, sy), _mm_cmpord_ps(sz, sz));
+            for (const auto& plane : planes) {
+                const auto distance = _mm_add_ps(
+                    _mm_add_ps(_mm_mul_ps(plane[0], x), _mm_mul_ps(plane[1], y)),
+                    _mm_add_ps(_mm_mul_ps(plane[2], z), plane[3]));
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negativeRadius));
+            }
+
+            const auto mask = static_cast<uint32_t>(_mm_movemask_ps(inside));
+            for (uint32_t lane = 0; lane < 4; ++lane) {
+                visible[written] = static_cast<uint32_t>(i + lane);
+                written += (mask >> lane) & 1;
+            }
+        }
+        visibleCount = written;
+        return i;
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	8 個ずつ AVX2 で判定する
+     * @param	frustum			視錐台
+     * @param	bounds			境界球の配列
+     * @param	count			境界球の数
+     * @param	visible			見える境界球の位置の書き込み先
+     * @param	visibleCount	見える境界球の数（書き込んだ分だけ増やす）
+     * @return	判定し終えた位置（端数は判定しない）
+     */
+    [[nodiscard]] FRUSTUM_CULLING_AVX2 size_t cullAvx2(const FrustumCulling::Frustum& frustum, const FrustumCulling::Bounds& bounds, size_t count, uint32_t* visible, size_t& visibleCount) noexcept {
+        __m256 planes[planeCount][4];
+        for (size_t p = 0; p < planeCount; ++p) {
+            planes[p][0] = _mm256_set1_ps(frustum.planes_[p][0]);
+            planes[p][1] = _mm256_set1_ps(frustum.planes_[p][1]);
+            planes[p][2] = _mm256_set1_ps(frustum.planes_[p][2]);
+            planes[p][3] = _mm256_set1_ps(frustum.planes_[p][3]);
+        }
+        const auto absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+
+        auto written = visibleCount;
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            const auto x = _mm256_loadu_ps(bounds.centerX_ + i);
+            const auto y = _mm256_loadu_ps(bounds.centerY_ + i);
+            const auto z = _mm256_loadu_ps(bounds.centerZ_ + i);
+            const auto sx = _mm256_and_ps(_mm256_loadu_ps(bounds.scaleX_ + i), absMask);
+            const auto sy = _mm256_and_ps(_mm256_loadu_ps(bounds.scaleY_ + i), absMask);
+            const auto sz = _mm256_and_ps(_mm256_loadu_ps(bounds.scaleZ_ + i), absMask);
+            const auto radius = _mm256_mul_ps(_mm256_loadu_ps(bounds.radius_ + i), _mm256_max_ps(sx, _mm256_max_ps(sy, sz)));
+            const auto negativeRadius = _mm256_sub_ps(_mm256_setzero_ps(), radius);
+
+            auto inside = _mm256_and_ps(_mm256_cmp_ps(sx, sy, _CMP_ORD_Q), _mm256_cmp_ps(sz, sz, _CMP_ORD_Q));
+            for (const auto& plane : planes) {
+                const auto distance = _mm256_add_ps(
+                    _mm256_add_ps(_mm256_mul_ps(plane[0], x), _mm256_mul_ps(plane[1], y)),
+                    _mm256_add_ps(_mm256_mul_ps(plane[2], z), plane[3]));
+                inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, negativeRadius, _CMP_GE_OQ));
+            }
+
+            const auto mask = static_cast<uint32_t>(_mm256_movemask_ps(inside));
+            for (uint32_t lane = 0; lane < 8; ++lane) {
+                visible[written] = static_cast<uint32_t>(i + lane);
+                written += (mask >> lane) & 1;
+            }
+        }
+        visibleCount = written;
+        return i;
+    }
+}  // namespace
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	ビュー射影行列から視錐台を取り出す
+ * @param	viewProjection	ビュー行列 * 射影行列（行ベクトルに右から掛ける形の m[行][列]）
+ * @return	視錐台
+ */
+[[nodiscard]] FrustumCulling::Frustum FrustumCulling::extractFrustum(const float (&viewProjection)[4][4]) noexcept {
+    // 行ベクトルに右から掛けるので、クリップ座標の各成分は行列の列との内積になる
+    // Direct3D のクリップ空間は -w <= x, y <= w、0 <= z <= w
+    const auto& m = viewProjection;
+    Frustum frustum{};
+    normalizePlane(m[0][3] + m[0][0], m[1][3] + m[1][0], m[2][3] + m[2][0], m[3][3] + m[3][0], frustum.planes_[0]);  // 左
+    normalizePlane(m[0][3] - m[0][0], m[1][3] - m[1][0], m[2][3] - m[2][0], m[3][3] - m[3][0], frustum.planes_[1]);  // 右
+    normalizePlane(m[0][3] + m[0][1], m[1][3] + m[1][1], m[2][3] + m[2][1], m[3][3] + m[3][1], frustum.planes_[2]);  // 下
+    normalizePlane(m[0][3] - m[0][1], m[1][3] - m[1][1], m[2][3] - m[2][1], m[3][3] - m[3][1], frustum.planes_[3]);  // 上
+    normalizePlane(m[0][2], m[1][2], m[2][2], m[3][2], frustum.planes_[4]);                                          // 近
+    normalizePlane(m[0][3] - m[0][2], m[1][3] - m[1][2], m[2][3] - m[2][2], m[3][3] - m[3][2], frustum.planes_[5]);  // 遠
+    return frustum;
+}
+
+#if defined(_WIN32)
+//---------------------------------------------------------------------------------
+/**
+ * @brief	ビュー射影行列から視錐台を取り出す
+ * @param	viewProjection	ビュー行列 * 射影行列
+ * @return	視錐台
+ */
+[[nodiscard]] FrustumCulling::Frustum XM_CALLCONV FrustumCulling::extractFrustum(DirectX::FXMMATRIX viewProjection) noexcept {
+    DirectX::XMFLOAT4X4 m{};
+    DirectX::XMStoreFloat4x4(&m, viewProjection);
+    return extractFrustum(m.m);
+}
+#endif
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	エンティティストアの配列を境界球にする
+ * @param	entities	エンティティストア
+ * @return	境界球の配列
+ */
+[[nodiscard]] FrustumCulling::Bounds FrustumCulling::bounds(const EntityStore& entities) noexcept {
+    using Component = EntityStore::Component;
+    return {
+        entities.values(Component::positionX).data(),
+        entities.values(Component::positionY).data(),
+        entities.values(Component::positionZ).data(),
+        entities.values(Component::scaleX).data(),
+        entities.values(Component::scaleY).data(),
+        entities.values(Component::scaleZ).data(),
+        entities.values(Component::radius).data(),
+    };
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	視錐台に掛かる境界球の位置を詰めて書き込む
+ * @param	frustum		視錐台
+ * @param	bounds		境界球の配列
+ * @param	count		境界球の数
+ * @param	visible		見える境界球の位置の書き込み先（count 個以上の大きさ）
+ * @param	path		判定に使う命令セット
+ * @return	見える境界球の数
+ */
+[[nodiscard]] size_t FrustumCulling::cull(const Frustum& frustum, const Bounds& bounds, size_t count, uint32_t* visible, TransformBatch::Path path) noexcept {
+    size_t visibleCount = 0;
+    size_t done = 0;
+    if (path == TransformBatch::Path::avx2) {
+        done = cullAvx2(frustum, bounds, count, visible, visibleCount);
+    }
+    if (path != TransformBatch::Path::scalar) {
+        done = cullSse(frustum, bounds, done, count, visible, visibleCount);
+    }
+    for (auto i = done; i < count; ++i) {
+        if (isVisible(frustum, bounds, i)) {
+            visible[visibleCount++] = static_cast<uint32_t>(i);
+        }
+    }
+    return visibleCount;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	視錐台に掛かるエンティティの配列の位置を求める
+ * @param	frustum		視錐台
+ * @param	entities	エンティティストア
+ * @param	visible		見えるエンティティの配列の位置（昇順）
+ * @param	path		判定に使う命令セット
+ */
+void FrustumCulling::cull(const Frustum& frustum, const EntityStore& entities, std::vector<uint32_t>& visible, TransformBatch::Path path) noexcept {
+    visible.resize(entities.size());
+    visible.resize(cull(frustum, bounds(entities), entities.size(), visible.data(), path));
+}
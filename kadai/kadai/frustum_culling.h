@@ -0,0 +1,100 @@
+﻿// 視錐台カリングクラス
+
+#pragma once
+
+#include "entity_store.h"
+#include "transform_batch.h"
+
+// ヘッドレスビルドでは DirectXMath が無いので、行列は float の配列で受け取る
+#if defined(_WIN32)
+#include <DirectXMath.h>
+#endif
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	視錐台カリングクラス
+ * ビュー行列と射影行列を掛けた行列から視錐台の 6 平面を取り出し、境界球が視錐台に掛かるオブジェクトの位置だけを詰めて返す
+ * 境界球は成分毎に分かれた配列のまま SIMD でまとめて判定する（命令セットは TransformBatch と同じものを使う）
+ * インスタンスは作らない
+ */
+class FrustumCulling final {
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	視錐台
+     * 平面は (a, b, c, d) の順の float 4 個で、法線 (a, b, c) は内向きかつ長さ 1 なので、ax + by + cz + d が内側への距離になる
+     */
+    struct Frustum {
+        float planes_[6][4]{};  /// 左・右・下・上・近・遠の平面
+    };
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	境界球の配列
+     * 半径は拡大率の各軸の絶対値の最大を掛けたものを使う
+     */
+    struct Bounds {
+        const float* centerX_{};  /// 中心の x
+        const float* centerY_{};  /// 中心の y
+        const float* centerZ_{};  /// 中心の z
+        const float* scaleX_{};   /// 拡大率の x
+        const float* scaleY_{};   /// 拡大率の y
+        const float* scaleZ_{};   /// 拡大率の z
+        const float* radius_{};   /// 拡大前の半径
+    };
+
+public:
+    FrustumCulling() = delete;
+    ~FrustumCulling() = delete;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	ビュー射影行列から視錐台を取り出す
+     * @param	viewProjection	ビュー行列 * 射影行列（行ベクトルに右から掛ける形の m[行][列]）
+     * @return	視錐台
+     */
+    [[nodiscard]] static Frustum extractFrustum(const float (&viewProjection)[4][4]) noexcept;
+
+#if defined(_WIN32)
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	ビュー射影行列から視錐台を取り出す
+     * @param	viewProjection	ビュー行列 * 射影行列
+     * @return	視錐台
+     */
+    [[nodiscard]] static Frustum XM_CALLCONV extractFrustum(DirectX::FXMMATRIX viewProjection) noexcept;
+#endif
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	エンティティストアの配列を境界球にする
+     * @param	entities	エンティティストア
+     * @return	境界球の配列
+     */
+    [[nodiscard]] static Bounds bounds(const EntityStore& entities) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	視錐台に掛かる境界球の位置を詰めて書き込む
+     * @param	frustum		視錐台
+     * @param	bounds		境界球の配列
+     * @param	count		境界球の数
+     * @param	visible		見える境界球の位置の書き込み先（count 個以上の大きさ）
+     * @param	path		判定に使う命令セット
+     * @return	見える境界球の数
+     */
+    [[nodiscard]] static size_t cull(const Frustum& frustum, const Bounds& bounds, size_t count, uint32_t* visible, TransformBatch::Path path = TransformBatch::bestPath()) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	視錐台に掛かるエンティティの配列の位置を求める
+     * @param	frustum		視錐台
+     * @param	entities	エンティティストア
+     * @param	visible		見えるエンティティの配列の位置（昇順）
+     * @param	path		判定に使う命令セット
+     */
+    static void cull(const Frustum& frustum, const EntityStore& entities, std::vector<uint32_t>& visible, TransformBatch::Path path = TransformBatch::bestPath()) noexcept;
+};
@@ -0,0 +1,282 @@
+﻿// GPU メモリアロケータクラス
+
+#include "gpu_memory_allocator.h"
+#include "deferred_release.h"
+#include <cassert>
+
+namespace {
+    constexpr UINT64 placementAlignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;  // バッファを配置するアライメント（64KB）
+
+    // 管理するヒープの種類
+    constexpr D3D12_HEAP_TYPE heapTypes[] = {
+        D3D12_HEAP_TYPE_DEFAULT,
+        D3D12_HEAP_TYPE_UPLOAD,
+        D3D12_HEAP_TYPE_READBACK,
+    };
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	バッファのリソース設定を作成する
+     * @param	size	バッファのサイズ
+     * @return	リソース設定
+     */
+    D3D12_RESOURCE_DESC bufferDesc(UINT64 size) noexcept {
+        D3D12_RESOURCE_DESC resourceDesc{};
+        resourceDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
+        resourceDesc.Alignment = 0;
+        resourceDesc.Width = size;
+        resourceDesc.Height = 1;
+        resourceDesc.DepthOrArraySize = 1;
+        resourceDesc.MipLevels = 1;
+        resourceDesc.Format = DXGI_FORMAT_UNKNOWN;
+        resourceDesc.SampleDesc.Count = 1;
+        resourceDesc.SampleDesc.Quality = 0;
+        resourceDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
+        resourceDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+        return resourceDesc;
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	ヒープの設定を作成する
+     * @param	heapType	ヒープの種類
+     * @return	ヒープの設定
+     */
+    D3D12_HEAP_PROPERTIES heapProperties(D3D12_HEAP_TYPE heapType) noexcept {
+        D3D12_HEAP_PROPERTIES heapProperty{};
+        heapProperty.Type = heapType;
+        heapProperty.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
+        heapProperty.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
+        heapProperty.CreationNodeMask = 1;
+        heapProperty.VisibleNodeMask = 1;
+        return heapProperty;
+    }
+}  // namespace
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief    デストラクタ
+ * 破棄する時は GPU の処理が全て完了していること
+ */
+GpuMemoryAllocator::~GpuMemoryAllocator() {
+    // 解放待ちの中にこのアロケータの領域を返すものがあるので、ヒープより先に全て解放する
+    DeferredRelease::instance().releaseAll();
+
+    for (auto& pool : pools_) {
+        for (auto& heap : pool.heaps_) {
+            assert(heap.allocator_.empty() && "解放されていないリソースがあります");
+            heap.heap_->Release();
+            heap.heap_ = nullptr;
+        }
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	アロケータを作成する
+ * @param	device		デバイスクラスのインスタンス
+ * @param	heapSize	一つのヒープのサイズ（64KB の 2 の累乗倍）
+ * @return	生成の成否
+ */
+[[nodiscard]] bool GpuMemoryAllocator::create(const Device& device, UINT64 heapSize) noexcept {
+    if (heapSize < placementAlignment || (heapSize & (heapSize - 1)) != 0) {
+        assert(false && "ヒープのサイズは 64KB の 2 の累乗倍にしてください");
+        return false;
+    }
+
+    device_ = &device;
+    heapSize_ = heapSize;
+
+    // ヒープは必要になった時に確保する
+    pools_.clear();
+    for (const auto heapType : heapTypes) {
+        pools_.push_back({ heapType });
+    }
+    return true;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	バッファを作成する
+ * @param	heapType		ヒープの種類
+ * @param	size			バッファのサイズ
+ * @param	initialState	初期ステート
+ * @param	allocation		作成したリソース
+ * @return	生成の成否
+ */
+[[nodiscard]] bool GpuMemoryAllocator::createBuffer(D3D12_HEAP_TYPE heapType, UINT64 size, D3D12_RESOURCE_STATES initialState, Allocation& allocation) noexcept {
+    auto* pool = findPool(heapType);
+    if (!pool) {
+        assert(false && "対応していないヒープの種類です");
+        return false;
+    }
+
+    const auto resourceDesc = bufferDesc(size);
+    const auto alignedSize = (size + placementAlignment - 1) & ~(placementAlignment - 1);
+
+    allocation = {};
+    allocation.heapType_ = heapType;
+
+    // ヒープより大きいリソースは個別に確保する
+    if (alignedSize > heapSize_) {
+        const auto heapProperty = heapProperties(heapType);
+        const auto res = device_->get()->CreateCommittedResource(
+            &heapProperty,
+            D3D12_HEAP_FLAG_NONE,
+            &resourceDesc,
+            initialState,
+            nullptr,
+            IID_PPV_ARGS(&allocation.resource_));
+        if (FAILED(res)) {
+            assert(false && "バッファの作成に失敗しました");
+            return false;
+        }
+        allocation.heapIndex_ = committedHeapIndex;
+        ++pool->committedCount_;
+        ++pool->totalAllocationCount_;
+        return true;
+    }
+
+    // 空きのあるヒープを探し、どこにも無ければヒープを追加する
+    auto offset = BuddyAllocator::invalidOffset;
+    UINT heapIndex = 0;
+    for (; heapIndex < pool->heaps_.size(); ++heapIndex) {
+        offset = pool->heaps_[heapIndex].allocator_.allocate(alignedSize, placementAlignment);
+        if (offset != BuddyAllocator::invalidOffset) {
+            break;
+        }
+    }
+    if (offset == BuddyAllocator::invalidOffset) {
+        if (!addHeap(*pool)) {
+            return false;
+        }
+        heapIndex = static_cast<UINT>(pool->heaps_.size() - 1);
+        offset = pool->heaps_[heapIndex].allocator_.allocate(alignedSize, placementAlignment);
+    }
+
+    auto& heap = pool->heaps_[heapIndex];
+    const auto res = device_->get()->CreatePlacedResource(
+        heap.heap_,
+        offset,
+        &resourceDesc,
+        initialState,
+        nullptr,
+        IID_PPV_ARGS(&allocation.resource_));
+    if (FAILED(res)) {
+        heap.allocator_.free(offset);
+        assert(false && "バッファの配置に失敗しました");
+        return false;
+    }
+
+    allocation.heapIndex_ = heapIndex;
+    allocation.offset_ = offset;
+
+    // ヒープ内の使用量はバディアロケータが持っているので、最大値だけをここで記録する
+    UINT64 usedSize = 0;
+    for (const auto& poolHeap : pool->heaps_) {
+        usedSize += poolHeap.allocator_.statistics().usedSize_;
+    }
+    pool->peakUsedSize_ = usedSize > pool->peakUsedSize_ ? usedSize : pool->peakUsedSize_;
+    ++pool->totalAllocationCount_;
+    return true;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	リソースを解放する
+ * GPU が参照中の可能性があるので、リソースと領域はフレームの完了後に解放する
+ * @param	allocation	解放するリソース（呼び出し後は空になる）
+ */
+void GpuMemoryAllocator::free(Allocation& allocation) noexcept {
+    if (!allocation.resource_) {
+        return;
+    }
+
+    DeferredRelease::instance().enqueue([this, allocation] {
+        allocation.resource_->Release();
+
+        auto* pool = findPool(allocation.heapType_);
+        if (allocation.heapIndex_ == committedHeapIndex) {
+            --pool->committedCount_;
+        } else {
+            pool->heaps_[allocation.heapIndex_].allocator_.free(allocation.offset_);
+        }
+    });
+    allocation = {};
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	統計情報を取得する
+ * @param	heapType	ヒープの種類
+ * @return	統計情報
+ */
+[[nodiscard]] GpuMemoryAllocator::Statistics GpuMemoryAllocator::statistics(D3D12_HEAP_TYPE heapType) const noexcept {
+    Statistics statistics{};
+    for (const auto& pool : pools_) {
+        if (pool.type_ != heapType) {
+            continue;
+        }
+
+        UINT64 largestFreeBlock = 0;
+        for (const auto& heap : pool.heaps_) {
+            const auto heapStatistics = heap.allocator_.statistics();
+            statistics.reservedSize_ += heapStatistics.capacity_;
+            statistics.usedSize_ += heapStatistics.usedSize_;
+            statistics.requestedSize_ += heapStatistics.requestedSize_;
+            statistics.allocationCount_ += heapStatistics.allocationCount_;
+            largestFreeBlock = heapStatistics.largestFreeBlock_ > largestFreeBlock ? heapStatistics.largestFreeBlock_ : largestFreeBlock;
+        }
+        statistics.heapCount_ = pool.heaps_.size();
+        statistics.peakUsedSize_ = pool.peakUsedSize_;
+        statistics.allocationCount_ += pool.committedCount_;
+        statistics.totalAllocationCount_ = pool.totalAllocationCount_;
+        statistics.committedCount_ = pool.committedCount_;
+
+        const auto freeSize = statistics.reservedSize_ - statistics.usedSize_;
+        if (freeSize > 0) {
+            statistics.fragmentation_ = 1.0f - static_cast<float>(largestFreeBlock) / static_cast<float>(freeSize);
+        }
+    }
+    return statistics;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	ヒープの種類に対応するヒープ群を取得する
+ * @param	heapType	ヒープの種類
+ * @return	ヒープ群、対応していない種類の場合は nullptr
+ */
+[[nodiscard]] GpuMemoryAllocator::HeapPool* GpuMemoryAllocator::findPool(D3D12_HEAP_TYPE heapType) noexcept {
+    for (auto& pool : pools_) {
+        if (pool.type_ == heapType) {
+            return &pool;
+        }
+    }
+    return nullptr;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	ヒープを追加する
+ * @param	pool	追加先のヒープ群
+ * @return	追加の成否
+ */
+[[nodiscard]] bool GpuMemoryAllocator::addHeap(HeapPool& pool) noexcept {
+    D3D12_HEAP_DESC heapDesc{};
+    heapDesc.SizeInBytes = heapSize_;
+    heapDesc.Properties = heapProperties(pool.type_);
+    heapDesc.Alignment = placementAlignment;
+    heapDesc.Flags = D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS;  // バッファ専用にしておけばどのリソースヒープ階層でも使える
+
+    Heap heap{};
+    const auto res = device_->get()->CreateHeap(&heapDesc, IID_PPV_ARGS(&heap.heap_));
+    if (FAILED(res)) {
+        assert(false && "ヒープの作成に失敗しました");
+        return false;
+    }
+    heap.allocator_.initialize(heapSize_, placementAlignment);
+
+    pool.heaps_.push_back(std::move(heap));
+    return true;
+}
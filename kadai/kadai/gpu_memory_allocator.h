@@ -0,0 +1,139 @@
+﻿// GPU メモリアロケータクラス
+
+#pragma once
+
+#include "device.h"
+#include "buddy_allocator.h"
+#include <vector>
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	GPU メモリアロケータクラス
+ * ヒープの種類毎に大きな ID3D12Heap を確保しておき、その中にバッファを配置（Placed）する
+ * ヒープ内の領域はバディアロケータで管理する
+ */
+class GpuMemoryAllocator final {
+public:
+    static constexpr UINT committedHeapIndex = UINT_MAX;  /// ヒープに収まらず個別に確保したことを表すヒープ番号
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	確保したリソース
+     */
+    struct Allocation {
+        ID3D12Resource* resource_{};   /// リソース
+        D3D12_HEAP_TYPE heapType_{};   /// ヒープの種類
+        UINT            heapIndex_{};  /// 配置したヒープの番号
+        UINT64          offset_{};     /// ヒープ内のオフセット
+    };
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	ヒープの種類毎の統計情報
+     */
+    struct Statistics {
+        UINT64 heapCount_{};             /// 確保したヒープの数
+        UINT64 reservedSize_{};          /// 確保したヒープのサイズの合計
+        UINT64 usedSize_{};              /// 使用中のサイズ（ブロック単位）
+        UINT64 peakUsedSize_{};          /// 使用中のサイズの最大値
+        UINT64 requestedSize_{};         /// 要求されたサイズの合計
+        UINT64 allocationCount_{};       /// 確保中のリソースの数
+        UINT64 totalAllocationCount_{};  /// これまでの確保の回数
+        UINT64 committedCount_{};        /// ヒープに収まらず個別に確保したリソースの数
+        float  fragmentation_{};         /// 断片化の度合い（空き領域のうち最大ブロックに含まれない割合）
+    };
+
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    コンストラクタ
+     */
+    GpuMemoryAllocator() = default;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    デストラクタ
+     * 破棄する時は GPU の処理が全て完了していること
+     */
+    ~GpuMemoryAllocator();
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	アロケータを作成する
+     * @param	device		デバイスクラスのインスタンス
+     * @param	heapSize	一つのヒープのサイズ（64KB の 2 の累乗倍）
+     * @return	生成の成否
+     */
+    [[nodiscard]] bool create(const Device& device, UINT64 heapSize) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	バッファを作成する
+     * @param	heapType		ヒープの種類
+     * @param	size			バッファのサイズ
+     * @param	initialState	初期ステート
+     * @param	allocation		作成したリソース
+     * @return	生成の成否
+     */
+    [[nodiscard]] bool createBuffer(D3D12_HEAP_TYPE heapType, UINT64 size, D3D12_RESOURCE_STATES initialState, Allocation& allocation) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	リソースを解放する
+     * GPU が参照中の可能性があるので、リソースと領域はフレームの完了後に解放する
+     * @param	allocation	解放するリソース（呼び出し後は空になる）
+     */
+    void free(Allocation& allocation) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	統計情報を取得する
+     * @param	heapType	ヒープの種類
+     * @return	統計情報
+     */
+    [[nodiscard]] Statistics statistics(D3D12_HEAP_TYPE heapType) const noexcept;
+
+private:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	ヒープ
+     */
+    struct Heap {
+        ID3D12Heap*    heap_{};       /// ヒープ
+        BuddyAllocator allocator_{};  /// ヒープ内の領域管理
+    };
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	ヒープの種類毎のヒープ群
+     */
+    struct HeapPool {
+        D3D12_HEAP_TYPE   type_{};                  /// ヒープの種類
+        std::vector<Heap> heaps_{};                 /// 確保したヒープ
+        UINT64            peakUsedSize_{};          /// 使用中のサイズの最大値
+        UINT64            committedCount_{};        /// 個別に確保したリソースの数
+        UINT64            totalAllocationCount_{};  /// これまでの確保の回数
+    };
+
+private:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	ヒープの種類に対応するヒープ群を取得する
+     * @param	heapType	ヒープの種類
+     * @return	ヒープ群、対応していない種類の場合は nullptr
+     */
+    [[nodiscard]] HeapPool* findPool(D3D12_HEAP_TYPE heapType) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	ヒープを追加する
+     * @param	pool	追加先のヒープ群
+     * @return	追加の成否
+     */
+    [[nodiscard]] bool addHeap(HeapPool& pool) noexcept;
+
+private:
+    const Device*         device_{};    /// デバイス
+    UINT64                heapSize_{};  /// 一つのヒープのサイズ
+    std::vector<HeapPool> pools_{};     /// ヒープの種類毎のヒープ群
+};
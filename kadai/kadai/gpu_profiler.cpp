@@ -0,0 +1,233 @@
+﻿// GPU プロファイラクラス
+
+#include "gpu_profiler.h"
+#include "profiler.h"
+#include <cassert>
+#include <cstring>
+
+namespace {
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	カウンタの値をナノ秒に直す
+     * 桁あふれしないよう、秒と端数に分けて計算する
+     * @param	ticks		カウンタの値
+     * @param	frequency	カウンタの周波数
+     * @return	ナノ秒
+     */
+    [[nodiscard]] UINT64 ticksToNanoseconds(UINT64 ticks, UINT64 frequency) noexcept {
+        constexpr UINT64 nanosecondsPerSecond = 1000000000;
+        return ticks / frequency * nanosecondsPerSecond + ticks % frequency * nanosecondsPerSecond / frequency;
+    }
+}  // namespace
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief    デストラクタ
+ */
+GpuProfiler::~GpuProfiler() {
+    if (readback_.resource_) {
+        memoryAllocator_->free(readback_);
+    }
+    if (queryHeap_) {
+        queryHeap_->Release();
+        queryHeap_ = nullptr;
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	クエリヒープと読み戻し用のバッファを作成する
+ * @param	device			デバイスクラスのインスタンス
+ * @param	commandQueue	計測するコマンドキュー
+ * @param	memoryAllocator	読み戻し用のバッファを確保する GPU メモリアロケータ
+ * @param	frameCount		同時に処理するフレームの数
+ * @return	生成の成否
+ */
+[[nodiscard]] bool GpuProfiler::create(const Device& device, const CommandQueue& commandQueue, GpuMemoryAllocator& memoryAllocator, UINT frameCount) noexcept {
+    commandQueue_ = commandQueue.get();
+    memoryAllocator_ = &memoryAllocator;
+    frames_.assign(frameCount, Frame{});
+
+    // 区間毎に開始と終了の二つのクエリを使う
+    const auto queryCount = frameCount * maxScopesPerFrame * 2;
+    D3D12_QUERY_HEAP_DESC heapDesc{};
+    heapDesc.Type = D3D12_QUERY_HEAP_TYPE_TIMESTAMP;
+    heapDesc.Count = queryCount;
+    heapDesc.NodeMask = 0;
+    if (FAILED(device.get()->CreateQueryHeap(&heapDesc, IID_PPV_ARGS(&queryHeap_)))) {
+        assert(false && "タイムスタンプのクエリヒープの作成に失敗しました");
+        return false;
+    }
+
+    if (!memoryAllocator.createBuffer(D3D12_HEAP_TYPE_READBACK, sizeof(UINT64) * queryCount, D3D12_RESOURCE_STATE_COPY_DEST, readback_)) {
+        assert(false && "タイムスタンプの読み戻し用バッファの作成に失敗しました");
+        return false;
+    }
+
+    if (FAILED(commandQueue_->GetTimestampFrequency(&gpuFrequency_))) {
+        assert(false && "タイムスタンプの周波数の取得に失敗しました");
+        return false;
+    }
+    LARGE_INTEGER cpuFrequency{};
+    QueryPerformanceFrequency(&cpuFrequency);
+    cpuFrequency_ = static_cast<UINT64>(cpuFrequency.QuadPart);
+
+    return true;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	フレームの計測を開始する
+ * 前回同じ番号のフレームで計測した結果を回収するので、そのフレームの完了を待ってから呼ぶ
+ * @param	frameIndex	フレームの番号
+ */
+void GpuProfiler::beginFrame(UINT frameIndex) noexcept {
+    assert(frameIndex < frames_.size() && "フレームの番号が範囲外です");
+    collect(frameIndex);
+
+    frameIndex_ = frameIndex;
+    frames_[frameIndex] = Frame{};
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	区間の開始を記録する
+ * @param	commandList	記録するコマンドリスト
+ * @param	name		区間の名前（文字列リテラル）
+ * @return	区間の番号、区間が多すぎる場合は invalidScope
+ */
+[[nodiscard]] UINT GpuProfiler::begin(const CommandList& commandList, const char* name) noexcept {
+    if (!queryHeap_) {
+        return invalidScope;
+    }
+    auto& frame = frames_[frameIndex_];
+    if (frame.scopeCount_ >= maxScopesPerFrame) {
+        return invalidScope;
+    }
+
+    const auto scope = frame.scopeCount_++;
+    frame.names_[scope] = name;
+    const auto query = (frameIndex_ * maxScopesPerFrame + scope) * 2;
+    commandList.get()->EndQuery(queryHeap_, D3D12_QUERY_TYPE_TIMESTAMP, query);
+    return scope;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	区間の終了を記録する
+ * 同じキューに提出するコマンドリストなら、開始と別のコマンドリストでもよい
+ * @param	commandList	記録するコマンドリスト
+ * @param	scope		begin で取得した区間の番号
+ */
+void GpuProfiler::end(const CommandList& commandList, UINT scope) noexcept {
+    if (scope == invalidScope) {
+        return;
+    }
+    auto& frame = frames_[frameIndex_];
+    assert(scope < frame.scopeCount_ && !frame.ended_[scope] && "区間の番号が不正です");
+
+    frame.ended_[scope] = true;
+    const auto query = (frameIndex_ * maxScopesPerFrame + scope) * 2 + 1;
+    commandList.get()->EndQuery(queryHeap_, D3D12_QUERY_TYPE_TIMESTAMP, query);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	フレームの計測を終了し、クエリの結果を読み戻し用のバッファへ解決する
+ * フレームの最後に提出するコマンドリストに記録する
+ * @param	commandList	記録するコマンドリスト
+ */
+void GpuProfiler::endFrame(const CommandList& commandList) noexcept {
+    auto& frame = frames_[frameIndex_];
+    if (!queryHeap_ || frame.scopeCount_ == 0) {
+        return;
+    }
+
+    // 終了していない区間のクエリは解決すると不定値になるので、ここで閉じておく
+    for (UINT scope = 0; scope < frame.scopeCount_; ++scope) {
+        if (!frame.ended_[scope]) {
+            end(commandList, scope);
+        }
+    }
+
+    const auto firstQuery = frameIndex_ * maxScopesPerFrame * 2;
+    commandList.get()->ResolveQueryData(queryHeap_, D3D12_QUERY_TYPE_TIMESTAMP, firstQuery, frame.scopeCount_ * 2, readback_.resource_, sizeof(UINT64) * firstQuery);
+    frame.resolved_ = true;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	解決済みの結果を CPU の時間軸に直して記録する
+ * @param	frameIndex	フレームの番号
+ */
+void GpuProfiler::collect(UINT frameIndex) noexcept {
+    const auto& frame = frames_[frameIndex];
+    if (!frame.resolved_) {
+        return;
+    }
+
+    const auto firstQuery = frameIndex * maxScopesPerFrame * 2;
+    const D3D12_RANGE readRange{ sizeof(UINT64) * firstQuery, sizeof(UINT64) * (firstQuery + frame.scopeCount_ * 2) };
+    UINT64* timestamps = nullptr;
+    if (FAILED(readback_.resource_->Map(0, &readRange, reinterpret_cast<void**>(&timestamps)))) {
+        assert(false && "タイムスタンプの読み戻し用バッファのマップに失敗しました");
+        return;
+    }
+
+    // 区間の時間は GPU のカウンタの差だけで求まるので、時間軸を直せなくても残しておく
+    latestScopeCount_ = 0;
+    for (UINT scope = 0; scope < frame.scopeCount_; ++scope) {
+        const auto begin = timestamps[firstQuery + scope * 2];
+        const auto end = timestamps[firstQuery + scope * 2 + 1];
+        if (end < begin) {
+            continue;
+        }
+        latestNames_[latestScopeCount_] = frame.names_[scope];
+        latestDurations_[latestScopeCount_] = ticksToNanoseconds(end - begin, gpuFrequency_);
+        latestScopeCount_++;
+    }
+
+    // 同じ瞬間の GPU と CPU のカウンタを取得し、GPU の時刻を CPU の時間軸に直す
+    UINT64 gpuCalibration = 0;
+    UINT64 cpuCalibration = 0;
+    if (SUCCEEDED(commandQueue_->GetClockCalibration(&gpuCalibration, &cpuCalibration))) {
+        const auto cpuBase = ticksToNanoseconds(cpuCalibration, cpuFrequency_);
+        const auto toCpuTime = [&](UINT64 gpuTimestamp) {
+            // 回収は数フレーム後なので、計測した時刻は基準より前になる
+            if (gpuTimestamp >= gpuCalibration) {
+                return cpuBase + ticksToNanoseconds(gpuTimestamp - gpuCalibration, gpuFrequency_);
+            }
+            return cpuBase - ticksToNanoseconds(gpuCalibration - gpuTimestamp, gpuFrequency_);
+        };
+
+        for (UINT scope = 0; scope < frame.scopeCount_; ++scope) {
+            const auto begin = timestamps[firstQuery + scope * 2];
+            const auto end = timestamps[firstQuery + scope * 2 + 1];
+            if (end < begin) {
+                continue;
+            }
+            Profiler::instance().recordGpu(frame.names_[scope], toCpuTime(begin), toCpuTime(end));
+        }
+    }
+
+    const D3D12_RANGE writtenRange{ 0, 0 };  // CPU からは書き込まない
+    readback_.resource_->Unmap(0, &writtenRange);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	最後に回収したフレームの区間の時間を取得する
+ * 結果の回収は数フレーム遅れるので、直近のフレームより前の値になる
+ * @param	name			区間の名前
+ * @param	milliseconds	区間の時間（ミリ秒）
+ * @return	区間が見つかれば true
+ */
+[[nodiscard]] bool GpuProfiler::latestDuration(const char* name, double& milliseconds) const noexcept {
+    for (UINT scope = 0; scope < latestScopeCount_; ++scope) {
+        if (std::strcmp(latestNames_[scope], name) == 0) {
+            milliseconds = static_cast<double>(latestDurations_[scope]) / 1'000'000.0;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,124 @@
+﻿// GPU プロファイラクラス
+
+#pragma once
+
+#include "device.h"
+#include "command_list.h"
+#include "command_queue.h"
+#include "gpu_memory_allocator.h"
+#include <d3d12.h>
+#include <vector>
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	GPU プロファイラクラス
+ * 区間の前後にタイムスタンプクエリを発行し、フレームの終わりに読み戻し用のバッファへ解決する
+ * 結果はそのフレームのリソースを再利用する数フレーム後に回収するので、GPU の完了を待たない
+ * 回収した区間は CPU の時間軸に直してから Profiler の GPU トラックに記録する
+ */
+class GpuProfiler final {
+public:
+    static constexpr UINT maxScopesPerFrame = 32;     /// 一フレームで計測できる区間の数
+    static constexpr UINT invalidScope = UINT32_MAX;  /// 計測できなかった区間の番号
+
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    コンストラクタ
+     */
+    GpuProfiler() = default;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    デストラクタ
+     */
+    ~GpuProfiler();
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	クエリヒープと読み戻し用のバッファを作成する
+     * @param	device			デバイスクラスのインスタンス
+     * @param	commandQueue	計測するコマンドキュー
+     * @param	memoryAllocator	読み戻し用のバッファを確保する GPU メモリアロケータ
+     * @param	frameCount		同時に処理するフレームの数
+     * @return	生成の成否
+     */
+    [[nodiscard]] bool create(const Device& device, const CommandQueue& commandQueue, GpuMemoryAllocator& memoryAllocator, UINT frameCount) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	フレームの計測を開始する
+     * 前回同じ番号のフレームで計測した結果を回収するので、そのフレームの完了を待ってから呼ぶ
+     * @param	frameIndex	フレームの番号
+     */
+    void beginFrame(UINT frameIndex) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	区間の開始を記録する
+     * @param	commandList	記録するコマンドリスト
+     * @param	name		区間の名前（文字列リテラル）
+     * @return	区間の番号、区間が多すぎる場合は invalidScope
+     */
+    [[nodiscard]] UINT begin(const CommandList& commandList, const char* name) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	区間の終了を記録する
+     * 同じキューに提出するコマンドリストなら、開始と別のコマンドリストでもよい
+     * @param	commandList	記録するコマンドリスト
+     * @param	scope		begin で取得した区間の番号
+     */
+    void end(const CommandList& commandList, UINT scope) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	フレームの計測を終了し、クエリの結果を読み戻し用のバッファへ解決する
+     * フレームの最後に提出するコマンドリストに記録する
+     * @param	commandList	記録するコマンドリスト
+     */
+    void endFrame(const CommandList& commandList) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	最後に回収したフレームの区間の時間を取得する
+     * 結果の回収は数フレーム遅れるので、直近のフレームより前の値になる
+     * @param	name			区間の名前
+     * @param	milliseconds	区間の時間（ミリ秒）
+     * @return	区間が見つかれば true
+     */
+    [[nodiscard]] bool latestDuration(const char* name, double& milliseconds) const noexcept;
+
+private:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	一つのフレームの区間
+     */
+    struct Frame {
+        const char* names_[maxScopesPerFrame]{};  /// 区間の名前
+        bool        ended_[maxScopesPerFrame]{};  /// 終了を記録したか
+        UINT        scopeCount_{};                /// 区間の数
+        bool        resolved_{};                  /// 結果を解決済みか
+    };
+
+private:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	解決済みの結果を CPU の時間軸に直して記録する
+     * @param	frameIndex	フレームの番号
+     */
+    void collect(UINT frameIndex) noexcept;
+
+private:
+    ID3D12CommandQueue*            commandQueue_{};     /// 計測するコマンドキュー
+    ID3D12QueryHeap*               queryHeap_{};        /// タイムスタンプのクエリヒープ
+    GpuMemoryAllocator*            memoryAllocator_{};  /// 読み戻し用のバッファを確保した GPU メモリアロケータ
+    GpuMemoryAllocator::Allocation readback_{};         /// 読み戻し用のバッファ
+    UINT64                         gpuFrequency_{};     /// GPU のタイムスタンプの周波数
+    UINT64                         cpuFrequency_{};     /// QueryPerformanceCounter の周波数
+    std::vector<Frame>             frames_{};           /// フレーム毎の区間
+    UINT                           frameIndex_{};       /// 計測中のフレームの番号
+    const char*                    latestNames_[maxScopesPerFrame]{};      /// 最後に回収した区間の名前
+    UINT64                         latestDurations_[maxScopesPerFrame]{};  /// 最後に回収した区間の時間（ナノ秒）
+    UINT                           latestScopeCount_{};                    /// 最後に回収した区間の数
+};
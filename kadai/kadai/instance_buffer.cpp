@@ -0,0 +1,156 @@
+﻿// インスタンスバッファクラス
+
+#include "instance_buffer.h"
+#include "transform_batch.h"
+#include <cassert>
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	オブジェクトのデータをアップロードリングバッファに詰める
+ * @param	uploadRing	書き込み先のアップロードリングバッファ
+ * @param	fence		アップロードリングバッファの空き待ちに使うフェンス
+ * @param	objects		描画するオブジェクトのエンティティストア
+ * @return	描画するインスタンスを詰められた場合は true
+ */
+[[nodiscard]] bool InstanceBuffer::pack(UploadRing& uploadRing, const Fence& fence, const EntityStore& objects) noexcept {
+    const EntityStore* const groups[] = { &objects };
+    return pack(uploadRing, fence, groups);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	複数のオブジェクト配列のデータを一つのバッファに続けて詰める
+ * 各配列の開始位置は、それより前の配列の要素数の合計になる
+ * @param	uploadRing	書き込み先のアップロードリングバッファ
+ * @param	fence		アップロードリングバッファの空き待ちに使うフェンス
+ * @param	groups		描画するオブジェクトのエンティティストアの並び
+ * @return	描画するインスタンスを詰められた場合は true
+ */
+[[nodiscard]] bool InstanceBuffer::pack(UploadRing& uploadRing, const Fence& fence, std::span<const EntityStore* const> groups) noexcept {
+    size_t total = 0;
+    for (const auto* objects : groups) {
+        total += objects->size();
+    }
+
+    // アップロードヒープは書き込み専用として先頭から順に書き込む
+    auto* data = allocate(uploadRing, fence, total);
+    if (!data) {
+        return false;
+    }
+    write(groups, data);
+    return true;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	複数のオブジェクト配列のうち、見えるものだけを一つのバッファに続けて詰める
+ * 各配列の開始位置は、それより前の見えるエンティティの数の合計になる
+ * @param	uploadRing	書き込み先のアップロードリングバッファ
+ * @param	fence		アップロードリングバッファの空き待ちに使うフェンス
+ * @param	groups		描画するオブジェクトのエンティティストアの並び
+ * @param	visible		groups と同じ順の、見えるエンティティの配列の位置の並び
+ * @return	描画するインスタンスを詰められた場合は true
+ */
+[[nodiscard]] bool InstanceBuffer::pack(UploadRing& uploadRing, const Fence& fence, std::span<const EntityStore* const> groups, std::span<const std::span<const uint32_t>> visible) noexcept {
+    assert(groups.size() == visible.size() && "見えるエンティティの並びの数が合いません");
+
+    size_t total = 0;
+    for (const auto& indices : visible) {
+        total += indices.size();
+    }
+
+    auto* data = allocate(uploadRing, fence, total);
+    if (!data) {
+        return false;
+    }
+    write(groups, visible, data);
+    return true;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	複数のオブジェクト配列のデータを続けて書き込む
+ * pack と同じ並びになるので、CPU 側に同じ内容を残したい場合（コマンドのキャプチャなど）に使う
+ * @param	groups	描画するオブジェクトのエンティティストアの並び
+ * @param	data	書き込み先（全てのエンティティの数の合計以上の大きさ）
+ */
+void InstanceBuffer::write(std::span<const EntityStore* const> groups, Object::ConstBufferData* data) noexcept {
+    for (const auto* objects : groups) {
+        // ワールド行列は転置済みの形で書き込み先に直接計算する
+        const auto count = objects->size();
+        TransformBatch::compose(TransformBatch::source(*objects), count, &data->world_, sizeof(Object::ConstBufferData));
+
+        const auto colors = objects->colors();
+        for (size_t i = 0; i < count; ++i) {
+            data[i].color_ = colors[i];
+        }
+        data += count;
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	複数のオブジェクト配列のうち、見えるものだけを続けて書き込む
+ * pack と同じ並びになるので、CPU 側に同じ内容を残したい場合（コマンドのキャプチャなど）に使う
+ * @param	groups	描画するオブジェクトのエンティティストアの並び
+ * @param	visible	groups と同じ順の、見えるエンティティの配列の位置の並び
+ * @param	data	書き込み先（見えるエンティティの数の合計以上の大きさ）
+ */
+void InstanceBuffer::write(std::span<const EntityStore* const> groups, std::span<const std::span<const uint32_t>> visible, Object::ConstBufferData* data) noexcept {
+    for (size_t group = 0; group < groups.size(); ++group) {
+        // 見えるものだけを集めて詰めるので、見えないオブジェクトは行列の計算もしない
+        const auto indices = visible[group];
+        TransformBatch::compose(TransformBatch::source(*groups[group]), indices, &data->world_, sizeof(Object::ConstBufferData));
+
+        const auto colors = groups[group]->colors();
+        for (size_t i = 0; i < indices.size(); ++i) {
+            data[i].color_ = colors[indices[i]];
+        }
+        data += indices.size();
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	インスタンスデータの GPU アドレスを取得する
+ * ルート SRV に設定して使う
+ * @return	GPU アドレス
+ */
+[[nodiscard]] RhiGpuAddress InstanceBuffer::gpuAddress() const noexcept {
+    assert(gpuAddress_ && "インスタンスデータが未設定です");
+    return gpuAddress_;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	詰めたインスタンスの数を取得する
+ * @return	インスタンスの数
+ */
+[[nodiscard]] UINT InstanceBuffer::count() const noexcept {
+    return count_;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	インスタンスデータの領域を確保する
+ * @param	uploadRing	書き込み先のアップロードリングバッファ
+ * @param	fence		アップロードリングバッファの空き待ちに使うフェンス
+ * @param	count		インスタンスの数
+ * @return	書き込み先（確保できなかった場合は nullptr）
+ */
+[[nodiscard]] Object::ConstBufferData* InstanceBuffer::allocate(UploadRing& uploadRing, const Fence& fence, size_t count) noexcept {
+    gpuAddress_ = 0;
+    count_ = 0;
+    if (count == 0) {
+        return nullptr;
+    }
+
+    UploadRing::Allocation allocation{};
+    if (!uploadRing.allocate(sizeof(Object::ConstBufferData) * count, fence, allocation)) {
+        return nullptr;
+    }
+
+    gpuAddress_ = allocation.gpuAddress_;
+    count_ = static_cast<UINT>(count);
+    return static_cast<Object::ConstBufferData*>(allocation.cpuAddress_);
+}
@@ -0,0 +1,112 @@
+﻿// インスタンスバッファクラス
+
+#pragma once
+
+#include "rhi.h"
+#include "fence.h"
+#include "object.h"
+#include "upload_ring.h"
+#include <span>
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	インスタンスバッファクラス
+ * 同じメッシュを使うオブジェクトのワールド行列と色を一つのバッファにまとめ、
+ * シェーダーから SV_InstanceID で参照できるようにする
+ */
+class InstanceBuffer final {
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    コンストラクタ
+     */
+    InstanceBuffer() = default;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    デストラクタ
+     */
+    ~InstanceBuffer() = default;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	オブジェクトのデータをアップロードリングバッファに詰める
+     * @param	uploadRing	書き込み先のアップロードリングバッファ
+     * @param	fence		アップロードリングバッファの空き待ちに使うフェンス
+     * @param	objects		描画するオブジェクトのエンティティストア
+     * @return	描画するインスタンスを詰められた場合は true
+     */
+    [[nodiscard]] bool pack(UploadRing& uploadRing, const Fence& fence, const EntityStore& objects) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	複数のオブジェクト配列のデータを一つのバッファに続けて詰める
+     * 各配列の開始位置は、それより前の配列の要素数の合計になる
+     * @param	uploadRing	書き込み先のアップロードリングバッファ
+     * @param	fence		アップロードリングバッファの空き待ちに使うフェンス
+     * @param	groups		描画するオブジェクトのエンティティストアの並び
+     * @return	描画するインスタンスを詰められた場合は true
+     */
+    [[nodiscard]] bool pack(UploadRing& uploadRing, const Fence& fence, std::span<const EntityStore* const> groups) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	複数のオブジェクト配列のうち、見えるものだけを一つのバッファに続けて詰める
+     * 各配列の開始位置は、それより前の見えるエンティティの数の合計になる
+     * @param	uploadRing	書き込み先のアップロードリングバッファ
+     * @param	fence		アップロードリングバッファの空き待ちに使うフェンス
+     * @param	groups		描画するオブジェクトのエンティティストアの並び
+     * @param	visible		groups と同じ順の、見えるエンティティの配列の位置の並び
+     * @return	描画するインスタンスを詰められた場合は true
+     */
+    [[nodiscard]] bool pack(UploadRing& uploadRing, const Fence& fence, std::span<const EntityStore* const> groups, std::span<const std::span<const uint32_t>> visible) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	複数のオブジェクト配列のデータを続けて書き込む
+     * pack と同じ並びになるので、CPU 側に同じ内容を残したい場合（コマンドのキャプチャなど）に使う
+     * @param	groups	描画するオブジェクトのエンティティストアの並び
+     * @param	data	書き込み先（全てのエンティティの数の合計以上の大きさ）
+     */
+    static void write(std::span<const EntityStore* const> groups, Object::ConstBufferData* data) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	複数のオブジェクト配列のうち、見えるものだけを続けて書き込む
+     * pack と同じ並びになるので、CPU 側に同じ内容を残したい場合（コマンドのキャプチャなど）に使う
+     * @param	groups	描画するオブジェクトのエンティティストアの並び
+     * @param	visible	groups と同じ順の、見えるエンティティの配列の位置の並び
+     * @param	data	書き込み先（見えるエンティティの数の合計以上の大きさ）
+     */
+    static void write(std::span<const EntityStore* const> groups, std::span<const std::span<const uint32_t>> visible, Object::ConstBufferData* data) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	インスタンスデータの GPU アドレスを取得する
+     * ルート SRV に設定して使う
+     * @return	GPU アドレス
+     */
+    [[nodiscard]] RhiGpuAddress gpuAddress() const noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	詰めたインスタンスの数を取得する
+     * @return	インスタンスの数
+     */
+    [[nodiscard]] UINT count() const noexcept;
+
+private:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	インスタンスデータの領域を確保する
+     * @param	uploadRing	書き込み先のアップロードリングバッファ
+     * @param	fence		アップロードリングバッファの空き待ちに使うフェンス
+     * @param	count		インスタンスの数
+     * @return	書き込み先（確保できなかった場合は nullptr）
+     */
+    [[nodiscard]] Object::ConstBufferData* allocate(UploadRing& uploadRing, const Fence& fence, size_t count) noexcept;
+
+private:
+    D3D12_GPU_VIRTUAL_ADDRESS gpuAddress_{};  /// インスタンスデータの GPU アドレス
+    UINT                      count_{};       /// インスタンスの数
+};
@@ -0,0 +1,320 @@
+﻿// ジョブシステムクラス
+
+#include "job_system.h"
+#include "profiler.h"
+#include <algorithm>
+#include <cassert>
+
+namespace {
+    thread_local const JobSystem* currentSystem = nullptr;  // 今のスレッドが属するジョブシステム
+    thread_local uint32_t         currentIndex = 0;         // 今のスレッドの番号
+
+    constexpr size_t jobsPerThread = 4;  // parallelFor でスレッド一つあたりに作るジョブの最大数
+}  // namespace
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	関連付けたジョブが全て終わったか
+ * @return	終わっていれば true
+ */
+[[nodiscard]] bool JobSystem::Counter::isDone() noexcept {
+    std::lock_guard lock(mutex_);
+    return pending_ == 0;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief    デストラクタ
+ * キューに残っているジョブは実行しないので、全てのカウンターの完了を待ってから破棄すること
+ */
+JobSystem::~JobSystem() {
+    // ワーカースレッドを終了させる
+    {
+        std::lock_guard lock(sleepMutex_);
+        quit_ = true;
+    }
+    wakeCondition_.notify_all();
+    for (auto& thread : threads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    threads_.clear();
+
+    if (currentSystem == this) {
+        currentSystem = nullptr;
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	ワーカースレッドを作成する
+ * 呼び出し元のスレッドを 0 番のスレッドとして扱う
+ * @param	threadCount	スレッドの数（呼び出し元のスレッドを含む）
+ * @return	生成の成否
+ */
+[[nodiscard]] bool JobSystem::create(uint32_t threadCount) noexcept {
+    if (!queues_.empty()) {
+        assert(false && "ジョブシステムは作成済みです");
+        return false;
+    }
+
+    threadCount = std::max(threadCount, 1u);
+    queues_.reserve(threadCount);
+    for (uint32_t i = 0; i < threadCount; ++i) {
+        queues_.push_back(std::make_unique<WorkQueue>());
+    }
+
+    currentSystem = this;
+    currentIndex = 0;
+
+    // 0 番は呼び出し元のスレッドが担当するので、1 番以降のスレッドを作る
+    threads_.reserve(threadCount - 1);
+    for (uint32_t i = 1; i < threadCount; ++i) {
+        threads_.emplace_back(&JobSystem::workerMain, this, i);
+    }
+
+    return true;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	ジョブを追加する
+ * @param	function	実行する関数
+ * @param	counter		ジョブの完了を数えるカウンター
+ */
+void JobSystem::run(JobFunction function, Counter& counter) noexcept {
+    {
+        std::lock_guard lock(counter.mutex_);
+        ++counter.pending_;
+    }
+    push({ std::move(function), &counter });
+    wake(false);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	別のカウンターの完了後に実行するジョブを追加する
+ * 待っている間はキューに積まないので、どのスレッドも塞がない
+ * @param	function	実行する関数
+ * @param	counter		ジョブの完了を数えるカウンター
+ * @param	dependency	完了を待つカウンター
+ */
+void JobSystem::run(JobFunction function, Counter& counter, Counter& dependency) noexcept {
+    assert(&counter != &dependency && "自分自身の完了は待てません");
+    {
+        std::lock_guard lock(counter.mutex_);
+        ++counter.pending_;
+    }
+
+    // 完了していなければ、完了したスレッドがキューに積む
+    {
+        std::lock_guard lock(dependency.mutex_);
+        if (dependency.pending_ > 0) {
+            dependency.continuations_.push_back({ std::move(function), &counter });
+            return;
+        }
+    }
+    push({ std::move(function), &counter });
+    wake(false);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	[0, count) をいくつかの範囲に分けて並列に処理する
+ * 完了を待たずに戻るので、待つ場合は wait を呼ぶ
+ * @param	count			処理する数
+ * @param	minItemsPerJob	一つのジョブに含める最小の数
+ * @param	function		範囲を処理する関数
+ * @param	counter			ジョブの完了を数えるカウンター
+ */
+void JobSystem::parallelFor(size_t count, size_t minItemsPerJob, RangeFunction function, Counter& counter) noexcept {
+    if (count == 0) {
+        return;
+    }
+
+    // 盗めるようにスレッドの数より多めに分けるが、小さすぎる範囲は作らない
+    const auto maxJobs = static_cast<size_t>(threadCount()) * jobsPerThread;
+    const auto jobs = std::clamp((count + minItemsPerJob - 1) / std::max<size_t>(minItemsPerJob, 1), size_t{ 1 }, maxJobs);
+    const auto chunkSize = (count + jobs - 1) / jobs;
+    const auto chunkCount = (count + chunkSize - 1) / chunkSize;
+    {
+        std::lock_guard lock(counter.mutex_);
+        counter.pending_ += static_cast<uint32_t>(chunkCount);
+    }
+
+    // 関数は全てのジョブで共有する
+    const auto shared = std::make_shared<const RangeFunction>(std::move(function));
+    for (size_t begin = 0; begin < count; begin += chunkSize) {
+        const auto end = std::min(begin + chunkSize, count);
+        push({ [shared, begin, end] { (*shared)(begin, end); }, &counter });
+    }
+    wake(chunkCount > 1);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	カウンターの完了を待つ
+ * 待っている間は呼び出し元のスレッドでもジョブを実行する
+ * @param	counter	完了を待つカウンター
+ */
+void JobSystem::wait(Counter& counter) noexcept {
+    const auto threadIndex = currentThreadIndex();
+    while (!counter.isDone()) {
+        Job job{};
+        if (pop(threadIndex, job)) {
+            execute(job);
+        } else {
+            // 他のスレッドが実行中のジョブの完了を待つ
+            std::this_thread::yield();
+        }
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	スレッドの数を取得する
+ * @return	スレッドの数（呼び出し元のスレッドを含む）
+ */
+[[nodiscard]] uint32_t JobSystem::threadCount() const noexcept {
+    return static_cast<uint32_t>(queues_.size());
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	ワーカースレッドの処理
+ * @param	threadIndex	スレッドの番号
+ */
+void JobSystem::workerMain(uint32_t threadIndex) noexcept {
+    Profiler::instance().setThreadName("JobSystem");
+    currentSystem = this;
+    currentIndex = threadIndex;
+
+    while (true) {
+        Job job{};
+        if (pop(threadIndex, job)) {
+            execute(job);
+            continue;
+        }
+
+        // どのキューも空ならジョブが積まれるまで眠る
+        std::unique_lock lock(sleepMutex_);
+        wakeCondition_.wait(lock, [this] { return quit_ || queuedJobs_.load(std::memory_order_acquire) > 0; });
+        if (quit_) {
+            return;
+        }
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	ジョブをキューに積む
+ * 別のジョブシステムやスレッドから呼ばれた場合は 0 番のキューに積む
+ * @param	job	積むジョブ
+ */
+void JobSystem::push(Job&& job) noexcept {
+    assert(!queues_.empty() && "ジョブシステムが未作成です");
+    auto& queue = *queues_[currentThreadIndex()];
+    {
+        std::lock_guard lock(queue.mutex_);
+        queue.jobs_.push_back(std::move(job));
+    }
+    queuedJobs_.fetch_add(1, std::memory_order_release);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	眠っているワーカースレッドを起こす
+ * @param	all	全て起こす場合は true
+ */
+void JobSystem::wake(bool all) noexcept {
+    if (threads_.empty()) {
+        return;
+    }
+
+    // 眠る直前のスレッドが通知を取りこぼさないように、一度ロックを取ってから通知する
+    {
+        std::lock_guard lock(sleepMutex_);
+    }
+    if (all) {
+        wakeCondition_.notify_all();
+    } else {
+        wakeCondition_.notify_one();
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	実行するジョブを取り出す
+ * 自分のキューの後ろから取り、空なら他のキューの前から盗む
+ * @param	threadIndex	スレッドの番号
+ * @param	job			取り出したジョブ
+ * @return	取り出せた場合は true
+ */
+[[nodiscard]] bool JobSystem::pop(uint32_t threadIndex, Job& job) noexcept {
+    if (queuedJobs_.load(std::memory_order_acquire) == 0) {
+        return false;
+    }
+
+    // 自分のキューは最後に積んだものから取る（キャッシュに残っている可能性が高い）
+    {
+        auto& queue = *queues_[threadIndex];
+        std::lock_guard lock(queue.mutex_);
+        if (!queue.jobs_.empty()) {
+            job = std::move(queue.jobs_.back());
+            queue.jobs_.pop_back();
+            queuedJobs_.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    // 他のキューからは一番古いものを盗む
+    const auto count = threadCount();
+    for (uint32_t i = 1; i < count; ++i) {
+        auto& queue = *queues_[(threadIndex + i) % count];
+        std::lock_guard lock(queue.mutex_);
+        if (!queue.jobs_.empty()) {
+            job = std::move(queue.jobs_.front());
+            queue.jobs_.pop_front();
+            queuedJobs_.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	ジョブを実行してカウンターを減らす
+ * カウンターが完了したら、完了を待っていたジョブをキューに積む
+ * @param	job	実行するジョブ
+ */
+void JobSystem::execute(Job& job) noexcept {
+    job.function_();
+
+    // 完了を確認したスレッドがカウンターを破棄できるように、ロックを外した後はカウンターに触れない
+    std::vector<Job> continuations;
+    {
+        std::lock_guard lock(job.counter_->mutex_);
+        assert(job.counter_->pending_ > 0 && "カウンターの数が合いません");
+        if (--job.counter_->pending_ == 0) {
+            continuations.swap(job.counter_->continuations_);
+        }
+    }
+    if (continuations.empty()) {
+        return;
+    }
+    for (auto& continuation : continuations) {
+        push(std::move(continuation));
+    }
+    wake(continuations.size() > 1);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	今のスレッドの番号を取得する
+ * @return	このジョブシステムのスレッドなら番号、それ以外は 0
+ */
+[[nodiscard]] uint32_t JobSystem::currentThreadIndex() const noexcept {
+    return currentSystem == this ? currentIndex : 0;
+}
@@ -0,0 +1,215 @@
+﻿// ジョブシステムクラス
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	ジョブシステムクラス
+ * スレッド毎にジョブの両端キューを持ち、自分のキューは後ろから、空になったら他のスレッドのキューの前から盗んで実行する
+ * ジョブの完了はカウンターで数え、カウンターの完了を待ってから実行する依存関係も指定できる
+ * 待っている間は呼び出し元のスレッドもジョブを実行するので、ワーカーが少なくても止まらない
+ */
+class JobSystem final {
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	ジョブの関数
+     */
+    using JobFunction = std::function<void()>;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	[begin, end) を処理する関数
+     */
+    using RangeFunction = std::function<void(size_t begin, size_t end)>;
+
+    class Counter;
+
+private:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	キューに積むジョブ
+     */
+    struct Job {
+        JobFunction function_{};  /// 実行する関数
+        Counter*    counter_{};   /// 完了を数えるカウンター
+    };
+
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	ジョブの完了を数えるカウンター
+     * 関連付けたジョブが全て終わると完了になる。完了を待ってから破棄すること
+     */
+    class Counter final {
+    public:
+        //---------------------------------------------------------------------------------
+        /**
+         * @brief    コンストラクタ
+         */
+        Counter() = default;
+
+        //---------------------------------------------------------------------------------
+        /**
+         * @brief    デストラクタ
+         */
+        ~Counter() = default;
+
+        //---------------------------------------------------------------------------------
+        /**
+         * @brief	関連付けたジョブが全て終わったか
+         * @return	終わっていれば true
+         */
+        [[nodiscard]] bool isDone() noexcept;
+
+    private:
+        friend class JobSystem;
+
+        std::mutex       mutex_{};          /// 以下の状態を守るミューテックス
+        uint32_t         pending_{};        /// 終わっていないジョブの数
+        std::vector<Job> continuations_{};  /// 完了を待っているジョブ
+    };
+
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    コンストラクタ
+     */
+    JobSystem() = default;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    デストラクタ
+     * キューに残っているジョブは実行しないので、全てのカウンターの完了を待ってから破棄すること
+     */
+    ~JobSystem();
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	ワーカースレッドを作成する
+     * 呼び出し元のスレッドを 0 番のスレッドとして扱う
+     * @param	threadCount	スレッドの数（呼び出し元のスレッドを含む）
+     * @return	生成の成否
+     */
+    [[nodiscard]] bool create(uint32_t threadCount) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	ジョブを追加する
+     * @param	function	実行する関数
+     * @param	counter		ジョブの完了を数えるカウンター
+     */
+    void run(JobFunction function, Counter& counter) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	別のカウンターの完了後に実行するジョブを追加する
+     * 待っている間はキューに積まないので、どのスレッドも塞がない
+     * @param	function	実行する関数
+     * @param	counter		ジョブの完了を数えるカウンター
+     * @param	dependency	完了を待つカウンター
+     */
+    void run(JobFunction function, Counter& counter, Counter& dependency) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	[0, count) をいくつかの範囲に分けて並列に処理する
+     * 完了を待たずに戻るので、待つ場合は wait を呼ぶ
+     * @param	count			処理する数
+     * @param	minItemsPerJob	一つのジョブに含める最小の数
+     * @param	function		範囲を処理する関数
+     * @param	counter			ジョブの完了を数えるカウンター
+     */
+    void parallelFor(size_t count, size_t minItemsPerJob, RangeFunction function, Counter& counter) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	カウンターの完了を待つ
+     * 待っている間は呼び出し元のスレッドでもジョブを実行する
+     * @param	counter	完了を待つカウンター
+     */
+    void wait(Counter& counter) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	スレッドの数を取得する
+     * @return	スレッドの数（呼び出し元のスレッドを含む）
+     */
+    [[nodiscard]] uint32_t threadCount() const noexcept;
+
+private:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	スレッド毎のジョブのキュー
+     */
+    struct WorkQueue {
+        std::mutex      mutex_{};  /// キューを守るミューテックス
+        std::deque<Job> jobs_{};   /// ジョブ
+    };
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	ワーカースレッドの処理
+     * @param	threadIndex	スレッドの番号
+     */
+    void workerMain(uint32_t threadIndex) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	ジョブをキューに積む
+     * 別のジョブシステムやスレッドから呼ばれた場合は 0 番のキューに積む
+     * @param	job	積むジョブ
+     */
+    void push(Job&& job) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	眠っているワーカースレッドを起こす
+     * @param	all	全て起こす場合は true
+     */
+    void wake(bool all) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	実行するジョブを取り出す
+     * 自分のキューの後ろから取り、空なら他のキューの前から盗む
+     * @param	threadIndex	スレッドの番号
+     * @param	job			取り出したジョブ
+     * @return	取り出せた場合は true
+     */
+    [[nodiscard]] bool pop(uint32_t threadIndex, Job& job) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	ジョブを実行してカウンターを減らす
+     * カウンターが完了したら、完了を待っていたジョブをキューに積む
+     * @param	job	実行するジョブ
+     */
+    void execute(Job& job) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	今のスレッドの番号を取得する
+     * @return	このジョブシステムのスレッドなら番号、それ以外は 0
+     */
+    [[nodiscard]] uint32_t currentThreadIndex() const noexcept;
+
+private:
+    std::vector<std::unique_ptr<WorkQueue>> queues_{};      /// スレッド毎のジョブのキュー
+    std::vector<std::thread>                threads_{};     /// ワーカースレッド
+    std::atomic<uint32_t>                   queuedJobs_{};  /// キューに積まれているジョブの数
+
+    std::mutex              sleepMutex_{};     /// 以下の状態を守るミューテックス
+    std::condition_variable wakeCondition_{};  /// ジョブ追加の通知
+    bool                    quit_{};           /// 終了要求
+};
@@ -0,0 +1,146 @@
+﻿// メッシュプールクラス
+
+#include "mesh_pool.h"
+#include <cassert>
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief    デストラクタ
+ */
+MeshPool::~MeshPool() {
+    // GPU が参照中の可能性があるので、フレームの完了を待ってから解放する
+    if (memoryAllocator_) {
+        memoryAllocator_->free(vertexBuffer_);
+        memoryAllocator_->free(indexBuffer_);
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	メッシュプールを作成する
+ * @param	memoryAllocator	バッファの確保に使う GPU メモリアロケータ
+ * @param	vertexCapacity	格納できる頂点数
+ * @param	indexCapacity	格納できるインデックス数
+ * @return	生成の成否
+ */
+[[nodiscard]] bool MeshPool::create(GpuMemoryAllocator& memoryAllocator, UINT vertexCapacity, UINT indexCapacity) noexcept {
+    const auto vertexBufferSize = static_cast<UINT64>(vertexCapacity) * sizeof(Vertex);
+    const auto indexBufferSize = static_cast<UINT64>(indexCapacity) * sizeof(uint16_t);
+
+    // GPU ローカルの DEFAULT ヒープに置く
+    // バッファは COMMON から暗黙的に昇格するので、コピーキューの書き込みも描画キューの読み込みもバリア無しで行える
+    memoryAllocator_ = &memoryAllocator;
+    if (!memoryAllocator.createBuffer(D3D12_HEAP_TYPE_DEFAULT, vertexBufferSize, D3D12_RESOURCE_STATE_COMMON, vertexBuffer_)) {
+        assert(false && "共有頂点バッファの作成に失敗");
+        return false;
+    }
+    if (!memoryAllocator.createBuffer(D3D12_HEAP_TYPE_DEFAULT, indexBufferSize, D3D12_RESOURCE_STATE_COMMON, indexBuffer_)) {
+        assert(false && "共有インデックスバッファの作成に失敗");
+        return false;
+    }
+
+    // 頂点バッファビューの設定
+    vertexBufferView_.address_ = vertexBuffer_.resource_->GetGPUVirtualAddress();
+    vertexBufferView_.size_ = static_cast<uint32_t>(vertexBufferSize);
+    vertexBufferView_.stride_ = sizeof(Vertex);
+
+    // インデックスバッファビューの設定
+    // インデックスはメッシュ内の頂点番号なので、16bit でも全体の頂点数には制限されない
+    indexBufferView_.address_ = indexBuffer_.resource_->GetGPUVirtualAddress();
+    indexBufferView_.size_ = static_cast<uint32_t>(indexBufferSize);
+    indexBufferView_.indexSize_ = sizeof(uint16_t);
+
+    vertexAllocator_.initialize(vertexCapacity);
+    indexAllocator_.initialize(indexCapacity);
+    pendingRemovals_.clear();
+
+    return true;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	メッシュを追加する
+ * 転送は予約されるだけなので、描画前に uploadManager の submit を呼ぶこと
+ * @param	uploadManager	転送に使うアップロード管理
+ * @param	vertices		頂点データ
+ * @param	indices			インデックスデータ（メッシュ内の頂点番号）
+ * @param	mesh			追加したメッシュの位置情報
+ * @return	追加の成否
+ */
+[[nodiscard]] bool MeshPool::add(UploadManager& uploadManager, std::span<const Vertex> vertices, std::span<const uint16_t> indices, Mesh& mesh) noexcept {
+    if (!vertexBuffer_.resource_ || !indexBuffer_.resource_) {
+        assert(false && "メッシュプールが未作成です");
+        return false;
+    }
+
+    const auto baseVertex = vertexAllocator_.allocate(vertices.size());
+    if (baseVertex == FreeListAllocator::invalidOffset) {
+        assert(false && "メッシュプールの頂点の容量が不足しています");
+        return false;
+    }
+    const auto startIndex = indexAllocator_.allocate(indices.size());
+    if (startIndex == FreeListAllocator::invalidOffset) {
+        vertexAllocator_.free(baseVertex, vertices.size());
+        assert(false && "メッシュプールのインデックスの容量が不足しています");
+        return false;
+    }
+
+    // コピーキューでの転送を予約する
+    if (!uploadManager.upload(vertexBuffer_.resource_, baseVertex * sizeof(Vertex), vertices.data(), vertices.size_bytes()) ||
+        !uploadManager.upload(indexBuffer_.resource_, startIndex * sizeof(uint16_t), indices.data(), indices.size_bytes())) {
+        vertexAllocator_.free(baseVertex, vertices.size());
+        indexAllocator_.free(startIndex, indices.size());
+        return false;
+    }
+
+    mesh.baseVertex_ = static_cast<UINT>(baseVertex);
+    mesh.vertexCount_ = static_cast<UINT>(vertices.size());
+    mesh.startIndex_ = static_cast<UINT>(startIndex);
+    mesh.indexCount_ = static_cast<UINT>(indices.size());
+    mesh.readyFenceValue_ = uploadManager.pendingFenceValue();
+    return true;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	メッシュを削除する
+ * GPU が参照中の可能性があるので、領域はフェンス値に到達してから再利用する
+ * @param	mesh		削除するメッシュ
+ * @param	fenceValue	最後にメッシュを使ったフレームのフェンス値
+ */
+void MeshPool::remove(const Mesh& mesh, UINT64 fenceValue) noexcept {
+    pendingRemovals_.push_back({ mesh, fenceValue });
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	GPU の処理が完了したフレームで削除されたメッシュの領域を再利用できるようにする
+ * @param	completedFenceValue	GPU が到達済みのフェンス値
+ */
+void MeshPool::release(UINT64 completedFenceValue) noexcept {
+    while (!pendingRemovals_.empty() && pendingRemovals_.front().fenceValue_ <= completedFenceValue) {
+        const auto& mesh = pendingRemovals_.front().mesh_;
+        vertexAllocator_.free(mesh.baseVertex_, mesh.vertexCount_);
+        indexAllocator_.free(mesh.startIndex_, mesh.indexCount_);
+        pendingRemovals_.pop_front();
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	共有頂点バッファのビューを取得する
+ * 全メッシュが共有バッファに入っているので、コマンドリスト毎に一度設定すればよい
+ * @return	頂点バッファビュー
+ */
+[[nodiscard]] const RhiVertexBufferView& MeshPool::vertexBufferView() const noexcept {
+    return vertexBufferView_;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	共有インデックスバッファのビューを取得する
+ * @return	インデックスバッファビュー
+ */
+[[nodiscard]] const RhiIndexBufferView& MeshPool::indexBufferView() const noexcept {
+    return indexBufferView_;
+}
@@ -0,0 +1,134 @@
+﻿// メッシュプールクラス
+
+#pragma once
+
+#include "device.h"
+#include "rhi.h"
+#include "free_list_allocator.h"
+#include "upload_manager.h"
+#include "gpu_memory_allocator.h"
+#include <DirectXMath.h>
+#include <cstdint>
+#include <deque>
+#include <span>
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	メッシュの位置情報
+ * メッシュプールの共有バッファ内のどこにデータがあるかだけを持つ軽量なハンドル
+ */
+struct Mesh {
+    UINT baseVertex_{};   /// 先頭頂点の位置
+    UINT vertexCount_{};  /// 頂点数
+    UINT startIndex_{};   /// 先頭インデックスの位置
+    UINT indexCount_{};   /// インデックス数
+
+    UINT64 readyFenceValue_{};  /// 転送の完了を表すフェンス値（アップロード管理のフェンス）
+};
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	メッシュプールクラス
+ * 全メッシュの頂点とインデックスを共有の大きなバッファから切り出して格納する
+ * バッファの設定は一度で済み、描画毎にはオフセットだけを変える
+ * バッファは GPU ローカルの DEFAULT ヒープに置き、データはコピーキューで転送する
+ */
+class MeshPool final {
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    頂点バッファフォーマット
+     */
+    struct Vertex {
+        DirectX::XMFLOAT3 position_{};  /// 頂点座標（x, y, z）
+        DirectX::XMFLOAT4 color_{};     /// 頂点色（r, g, b, a）
+    };
+
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    コンストラクタ
+     */
+    MeshPool() = default;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    デストラクタ
+     */
+    ~MeshPool();
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	メッシュプールを作成する
+     * @param	memoryAllocator	バッファの確保に使う GPU メモリアロケータ
+     * @param	vertexCapacity	格納できる頂点数
+     * @param	indexCapacity	格納できるインデックス数
+     * @return	生成の成否
+     */
+    [[nodiscard]] bool create(GpuMemoryAllocator& memoryAllocator, UINT vertexCapacity, UINT indexCapacity) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	メッシュを追加する
+     * 転送は予約されるだけなので、描画前に uploadManager の submit を呼ぶこと
+     * @param	uploadManager	転送に使うアップロード管理
+     * @param	vertices		頂点データ
+     * @param	indices			インデックスデータ（メッシュ内の頂点番号）
+     * @param	mesh			追加したメッシュの位置情報
+     * @return	追加の成否
+     */
+    [[nodiscard]] bool add(UploadManager& uploadManager, std::span<const Vertex> vertices, std::span<const uint16_t> indices, Mesh& mesh) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	メッシュを削除する
+     * GPU が参照中の可能性があるので、領域はフェンス値に到達してから再利用する
+     * @param	mesh		削除するメッシュ
+     * @param	fenceValue	最後にメッシュを使ったフレームのフェンス値
+     */
+    void remove(const Mesh& mesh, UINT64 fenceValue) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	GPU の処理が完了したフレームで削除されたメッシュの領域を再利用できるようにする
+     * @param	completedFenceValue	GPU が到達済みのフェンス値
+     */
+    void release(UINT64 completedFenceValue) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	共有頂点バッファのビューを取得する
+     * 全メッシュが共有バッファに入っているので、コマンドリスト毎に一度設定すればよい
+     * @return	頂点バッファビュー
+     */
+    [[nodiscard]] const RhiVertexBufferView& vertexBufferView() const noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	共有インデックスバッファのビューを取得する
+     * @return	インデックスバッファビュー
+     */
+    [[nodiscard]] const RhiIndexBufferView& indexBufferView() const noexcept;
+
+private:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	再利用待ちのメッシュ
+     */
+    struct PendingRemoval {
+        Mesh   mesh_{};        /// 削除したメッシュ
+        UINT64 fenceValue_{};  /// 再利用してよくなるフェンス値
+    };
+
+private:
+    GpuMemoryAllocator*            memoryAllocator_{};  /// バッファを確保した GPU メモリアロケータ
+    GpuMemoryAllocator::Allocation vertexBuffer_{};     /// 共有頂点バッファ
+    GpuMemoryAllocator::Allocation indexBuffer_{};      /// 共有インデックスバッファ
+
+    RhiVertexBufferView vertexBufferView_{};  /// 頂点バッファビュー
+    RhiIndexBufferView  indexBufferView_{};   /// インデックスバッファビュー
+
+    FreeListAllocator          vertexAllocator_{};  /// 頂点の領域管理（単位は頂点）
+    FreeListAllocator          indexAllocator_{};   /// インデックスの領域管理（単位はインデックス）
+    std::deque<PendingRemoval> pendingRemovals_{};  /// 再利用待ちのメッシュ
+};
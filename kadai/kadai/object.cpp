@@ -3,32 +3,47 @@
 #include "object.h"
 #include <cmath>
 
+namespace {
+    constexpr float moveSpeed = 0.02f;      // ㉺ɓ
+    constexpr float moveAmplitude = 1.5f;   // ㉺ɓ
+}  // namespace
+
 //---------------------------------------------------------------------------------
 /**
- * @brief	|S̍XV
+ * @brief	IuWFNg쐬
+ * @param	entities	ǉ̃GeBeBXgA
+ * @return	쐬IuWFNg̃nh
  */
-void Object::update() noexcept {
-
-    move_ += 0.02f;
-    world_ = DirectX::XMMatrixTranslation(0.0f, std::sinf(move_) * 1.5f, 0.0f);
-
-    color_ = DirectX::XMFLOAT4(0.1f, 1.0f, 1.0f, 1.0f);
+[[nodiscard]] Entity Object::create(EntityStore& entities) noexcept {
+    const auto entity = entities.add();
+    entities.colors()[entities.indexOf(entity)] = DirectX::XMFLOAT4(0.1f, 1.0f, 1.0f, 1.0f);
+    return entity;
 }
 
 //---------------------------------------------------------------------------------
 /**
- * @brief	[hs̎擾
- * @return  [hs
+ * @brief	SẴIuWFNg̍XV
+ * [hs͕`f[^l߂Ƃ TransformBatch ł܂Ƃ߂ČvZ
+ * @param	entities	XVGeBeBXgA
  */
-[[nodiscard]] DirectX::XMMATRIX Object::world() const noexcept {
-    return world_;
+void Object::update(EntityStore& entities) noexcept {
+    update(entities, 0, entities.size());
 }
 
 //---------------------------------------------------------------------------------
 /**
- * @brief	J[̎擾
- * @return  J[
+ * @brief	z [begin, end) ̃IuWFNg̍XV
+ * ͈͂dȂȂΕʁX̃Xbh瓯ɌĂׂ
+ * @param	entities	XVGeBeBXgA
+ * @param	begin		XVŏ̈ʒu
+ * @param	end			XVŌ̈ʒu̎
  */
-[[nodiscard]] DirectX::XMFLOAT4 Object::color() const noexcept {
-    return color_;
+void Object::update(EntityStore& entities, size_t begin, size_t end) noexcept {
+    // gR|[lg̔z񂾂擪珇ɏ
+    auto phases = entities.values(EntityStore::Component::phase);
+    auto positionY = entities.values(EntityStore::Component::positionY);
+    for (auto i = begin; i < end; ++i) {
+        phases[i] += moveSpeed;
+        positionY[i] = std::sinf(phases[i]) * moveAmplitude;
+    }
 }
@@ -2,11 +2,14 @@
 
 #pragma once
 
+#include "entity_store.h"
 #include <DirectXMath.h>
 
 //---------------------------------------------------------------------------------
 /**
  * @brief	IuWFNgNX
+ * IuWFNg̃f[^ EntityStore Ɏޖ̔zŎÃNX͑SIuWFNg܂Ƃ߂ď֐
+ * CX^X͍Ȃ
  */
 class Object final {
 public:
@@ -20,41 +23,32 @@ public:
     };
 
 public:
-    //---------------------------------------------------------------------------------
-    /**
-     * @brief    RXgN^
-     */
-    Object() = default;
+    Object() = delete;
+    ~Object() = delete;
 
     //---------------------------------------------------------------------------------
     /**
-     * @brief    fXgN^
+     * @brief	IuWFNg쐬
+     * @param	entities	ǉ̃GeBeBXgA
+     * @return	쐬IuWFNg̃nh
      */
-    ~Object() = default;
+    [[nodiscard]] static Entity create(EntityStore& entities) noexcept;
 
     //---------------------------------------------------------------------------------
     /**
-     * @brief	IuWFNg̍XV
+     * @brief	SẴIuWFNg̍XV
+     * [hs͕`f[^l߂Ƃ TransformBatch ł܂Ƃ߂ČvZ
+     * @param	entities	XVGeBeBXgA
      */
-    void update() noexcept;
+    static void update(EntityStore& entities) noexcept;
 
     //---------------------------------------------------------------------------------
     /**
-     * @brief	[hs̎擾
-     * @return  [hs
+     * @brief	z [begin, end) ̃IuWFNg̍XV
+     * ͈͂dȂȂΕʁX̃Xbh瓯ɌĂׂ
+     * @param	entities	XVGeBeBXgA
+     * @param	begin		XVŏ̈ʒu
+     * @param	end			XVŌ̈ʒu̎
      */
-    [[nodiscard]] DirectX::XMMATRIX world() const noexcept;
-
-    //---------------------------------------------------------------------------------
-    /**
-     * @brief	J[̎擾
-     * @return  J[
-     */
-    [[nodiscard]] DirectX::XMFLOAT4 color() const noexcept;
-
-private:
-    DirectX::XMMATRIX world_ = DirectX::XMMatrixIdentity();                /// [hs
-    DirectX::XMFLOAT4 color_ = DirectX::XMFLOAT4(1.0f, 1.0f, 1.0f, 1.0f);  /// J[(RGBA)
-
-    float move_{};  /// ړpϐ
-};
\ No newline at end of file
+    static void update(EntityStore& entities, size_t begin, size_t end) noexcept;
+};
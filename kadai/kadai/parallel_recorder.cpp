@@ -0,0 +1,152 @@
+﻿// 並列コマンド記録クラス
+
+#include "parallel_recorder.h"
+#include "profiler.h"
+#include <algorithm>
+#include <cassert>
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief    デストラクタ
+ */
+ParallelRecorder::~ParallelRecorder() {
+    // 記録スレッドを終了させる
+    {
+        std::lock_guard lock(mutex_);
+        quit_ = true;
+    }
+    startCondition_.notify_all();
+    for (auto& thread : threads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    threads_.clear();
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	記録スレッドとコマンドリストプールを作成する
+ * @param	device		デバイスクラスのインスタンス
+ * @param	threadCount	記録スレッドの数（呼び出し元のスレッドを含む）
+ * @param	frameCount	同時に処理するフレームの数
+ * @return	生成の成否
+ */
+[[nodiscard]] bool ParallelRecorder::create(const Device& device, UINT threadCount, UINT frameCount) noexcept {
+    threadCount = std::max(threadCount, 1u);
+    if (!commandListPool_.create(device, threadCount, frameCount)) {
+        return false;
+    }
+
+    // 0 番は呼び出し元のスレッドが担当するので、1 番以降のスレッドを作る
+    threads_.reserve(threadCount - 1);
+    for (UINT i = 1; i < threadCount; ++i) {
+        threads_.emplace_back(&ParallelRecorder::workerMain, this, i);
+    }
+
+    return true;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	描画リストを分割して並列に記録する
+ * 最初の塊は呼び出し元のスレッドで記録し、全ての記録が終わるまで戻らない
+ * @param	frameIndex			フレームの番号
+ * @param	itemCount			描画リストの要素数
+ * @param	minItemsPerChunk	一つの塊に含める最小の要素数
+ * @param	function			記録する関数
+ * @param	commandLists		記録したコマンドリストを塊の順に追加する配列
+ */
+void ParallelRecorder::record(UINT frameIndex, size_t itemCount, size_t minItemsPerChunk, const RecordFunction& function, std::vector<ID3D12CommandList*>& commandLists) noexcept {
+    if (itemCount == 0) {
+        return;
+    }
+
+    // 要素が少ない場合は塊を減らして、スレッドの起床やコマンドリストの提出を節約する
+    const auto maxChunks = static_cast<size_t>(commandListPool_.threadCount());
+    const auto chunks = std::clamp((itemCount + minItemsPerChunk - 1) / std::max<size_t>(minItemsPerChunk, 1), size_t{ 1 }, maxChunks);
+
+    {
+        std::lock_guard lock(mutex_);
+        function_ = &function;
+        frameIndex_ = frameIndex;
+        itemCount_ = itemCount;
+        chunkSize_ = (itemCount + chunks - 1) / chunks;
+        chunkCount_ = static_cast<UINT>((itemCount + chunkSize_ - 1) / chunkSize_);
+        pending_ = chunkCount_ - 1;
+        ++generation_;
+    }
+    if (chunkCount_ > 1) {
+        startCondition_.notify_all();
+    }
+
+    // 最初の塊は自分で記録する
+    recordChunk(0);
+
+    // 他の塊の記録完了を待つ
+    {
+        std::unique_lock lock(mutex_);
+        doneCondition_.wait(lock, [this] { return pending_ == 0; });
+        function_ = nullptr;
+    }
+
+    // 塊の順に提出するコマンドリストを並べる
+    for (UINT i = 0; i < chunkCount_; ++i) {
+        commandLists.push_back(commandListPool_.get(i, frameIndex).get());
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	記録スレッドの処理
+ * @param	threadIndex	記録スレッドの番号
+ */
+void ParallelRecorder::workerMain(UINT threadIndex) noexcept {
+    Profiler::instance().setThreadName("ParallelRecorder");
+
+    UINT64 seenGeneration = 0;
+    while (true) {
+        {
+            std::unique_lock lock(mutex_);
+            startCondition_.wait(lock, [&] { return quit_ || generation_ != seenGeneration; });
+            if (quit_) {
+                return;
+            }
+            seenGeneration = generation_;
+
+            // 今回の依頼で担当する塊が無ければ次の依頼を待つ
+            if (threadIndex >= chunkCount_) {
+                continue;
+            }
+        }
+
+        recordChunk(threadIndex);
+
+        bool finished = false;
+        {
+            std::lock_guard lock(mutex_);
+            finished = (--pending_ == 0);
+        }
+        if (finished) {
+            doneCondition_.notify_one();
+        }
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	一つの塊を記録する
+ * @param	chunkIndex	塊の番号（記録スレッドの番号と同じ）
+ */
+void ParallelRecorder::recordChunk(UINT chunkIndex) noexcept {
+    assert(function_ && "記録する関数が未設定です");
+    const ProfileScope scope("recordChunk");
+
+    const auto begin = chunkIndex * chunkSize_;
+    const auto end = std::min(begin + chunkSize_, itemCount_);
+
+    commandListPool_.reset(chunkIndex, frameIndex_);
+    const auto& commandList = commandListPool_.get(chunkIndex, frameIndex_);
+    (*function_)(commandList, begin, end);
+    commandList.get()->Close();
+}
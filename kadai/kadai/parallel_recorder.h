@@ -0,0 +1,93 @@
+﻿// 並列コマンド記録クラス
+
+#pragma once
+
+#include "command_list_pool.h"
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	並列コマンド記録クラス
+ * 描画リストをいくつかの塊に分け、塊毎に別のコマンドリストへ並列に記録する
+ * 記録したコマンドリストは塊の順に返すので、一度の ExecuteCommandLists でそのまま提出できる
+ */
+class ParallelRecorder final {
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	描画リストの [begin, end) をコマンドリストに記録する関数
+     */
+    using RecordFunction = std::function<void(const CommandList& commandList, size_t begin, size_t end)>;
+
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    コンストラクタ
+     */
+    ParallelRecorder() = default;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    デストラクタ
+     */
+    ~ParallelRecorder();
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	記録スレッドとコマンドリストプールを作成する
+     * @param	device		デバイスクラスのインスタンス
+     * @param	threadCount	記録スレッドの数（呼び出し元のスレッドを含む）
+     * @param	frameCount	同時に処理するフレームの数
+     * @return	生成の成否
+     */
+    [[nodiscard]] bool create(const Device& device, UINT threadCount, UINT frameCount) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	描画リストを分割して並列に記録する
+     * 最初の塊は呼び出し元のスレッドで記録し、全ての記録が終わるまで戻らない
+     * @param	frameIndex			フレームの番号
+     * @param	itemCount			描画リストの要素数
+     * @param	minItemsPerChunk	一つの塊に含める最小の要素数
+     * @param	function			記録する関数
+     * @param	commandLists		記録したコマンドリストを塊の順に追加する配列
+     */
+    void record(UINT frameIndex, size_t itemCount, size_t minItemsPerChunk, const RecordFunction& function, std::vector<ID3D12CommandList*>& commandLists) noexcept;
+
+private:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	記録スレッドの処理
+     * @param	threadIndex	記録スレッドの番号
+     */
+    void workerMain(UINT threadIndex) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	一つの塊を記録する
+     * @param	chunkIndex	塊の番号（記録スレッドの番号と同じ）
+     */
+    void recordChunk(UINT chunkIndex) noexcept;
+
+private:
+    CommandListPool          commandListPool_{};  /// 記録スレッド毎のコマンドリスト
+    std::vector<std::thread> threads_{};          /// 記録スレッド
+
+    std::mutex              mutex_{};           /// 以下の状態を守るミューテックス
+    std::condition_variable startCondition_{};  /// 記録開始の通知
+    std::condition_variable doneCondition_{};   /// 記録完了の通知
+    UINT64                  generation_{};      /// 記録を依頼した回数
+    UINT                    pending_{};         /// 記録中の塊の数
+    bool                    quit_{};            /// 終了要求
+
+    // 記録中のみ有効な依頼内容
+    const RecordFunction* function_{};    /// 記録する関数
+    UINT                  frameIndex_{};  /// フレームの番号
+    size_t                itemCount_{};   /// 描画リストの要素数
+    size_t                chunkSize_{};   /// 一つの塊の要素数
+    UINT                  chunkCount_{};  /// 塊の数
+};
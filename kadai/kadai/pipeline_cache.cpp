@@ -0,0 +1,214 @@
+﻿// パイプラインキャッシュクラス
+
+#include "pipeline_cache.h"
+#include "pipeline_hasher.h"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <thread>
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	パイプラインキャッシュを作成する
+ * 保存済みのファイルがあれば読み込む。別のアダプタやドライバで作られたファイルは使わない
+ * @param	device		デバイスクラスのインスタンス
+ * @param	dxgi		DXGI クラスのインスタンス
+ * @param	fileName	実行ファイルと同じディレクトリに置くキャッシュファイルの名前
+ * @return	生成の成否
+ */
+[[nodiscard]] bool PipelineCache::create(const Device& device, const DXGI& dxgi, const wchar_t* fileName) noexcept {
+    device_ = device.get();
+    if (!device_) {
+        assert(false && "デバイスが未作成です");
+        return false;
+    }
+
+    // シェーダファイルと同じく、実行ファイルがあるディレクトリに置く
+    wchar_t exePath[MAX_PATH];
+    GetModuleFileNameW(nullptr, exePath, MAX_PATH);
+    path_ = std::filesystem::path(exePath).parent_path() / fileName;
+
+    // 読み込めなかった場合は空のキャッシュから始める
+    (void)file_.load(path_, adapterIdentity(dxgi));
+
+    requests_.clear();
+    hitCount_ = 0;
+    missCount_ = 0;
+    return true;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	パイプラインステートの作成を要求する
+ * 実際の作成は build で行うので、それまで設定が指すシェーダや入力レイアウトを破棄しないこと
+ * @param	desc				パイプラインステートの設定
+ * @param	rootSignatureHash	ルートシグネチャのハッシュ値
+ * @param	pipelineState		作成したパイプラインステートの書き込み先
+ * @return	要求を受け付けた場合は true
+ */
+[[nodiscard]] bool PipelineCache::request(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, uint64_t rootSignatureHash, ID3D12PipelineState** pipelineState) noexcept {
+    if (!device_) {
+        assert(false && "パイプラインキャッシュが未作成です");
+        return false;
+    }
+    if (!pipelineState) {
+        assert(false && "パイプラインステートの書き込み先がありません");
+        return false;
+    }
+
+    Request request{};
+    request.desc_ = desc;
+    request.desc_.CachedPSO = {};
+    request.key_ = PipelineHasher::hashPipeline(desc, rootSignatureHash);
+    request.output_ = pipelineState;
+    requests_.push_back(std::move(request));
+    return true;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	要求されたパイプラインステートを並列に作成する
+ * キャッシュにあるものはブロブから作成し、無いものはコンパイルして結果をキャッシュに追加する
+ * @param	threadCount	作成に使うスレッドの数
+ * @return	全て作成できた場合は true
+ */
+[[nodiscard]] bool PipelineCache::build(UINT threadCount) noexcept {
+    if (requests_.empty()) {
+        return true;
+    }
+
+    // 作成はドライバのコンパイルが大半を占めるので、要求毎にスレッドへ分配する
+    // デバイスの作成関数はスレッドセーフなので、同期はどの要求を取るかだけでよい
+    std::atomic<size_t> next{ 0 };
+    auto                worker = [&]() {
+        for (auto i = next++; i < requests_.size(); i = next++) {
+            createPipelineState(requests_[i]);
+        }
+    };
+
+    const auto workerCount = std::clamp<size_t>(threadCount, 1, requests_.size());
+    std::vector<std::thread> threads{};
+    threads.reserve(workerCount - 1);
+    for (size_t i = 1; i < workerCount; ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();  // 呼び出し元のスレッドも作成に参加する
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // 結果の受け渡しとキャッシュへの追加は、全スレッドの終了後にまとめて行う
+    bool success = true;
+    for (auto& request : requests_) {
+        if (!request.pipelineState_) {
+            assert(false && "パイプラインステートの作成に失敗");
+            success = false;
+            continue;
+        }
+
+        *request.output_ = request.pipelineState_;
+        if (request.hit_) {
+            ++hitCount_;
+        } else {
+            ++missCount_;
+            if (!request.blob_.empty()) {
+                file_.store(request.key_, request.blob_.data(), request.blob_.size());
+            }
+        }
+    }
+    requests_.clear();
+
+    return success;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	キャッシュに追加があればファイルに保存する
+ * @return	保存の成否
+ */
+[[nodiscard]] bool PipelineCache::save() noexcept {
+    if (!file_.dirty()) {
+        return true;
+    }
+    return file_.save(path_);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	キャッシュから作成できた数を取得する
+ * @return	キャッシュから作成できた数
+ */
+[[nodiscard]] UINT PipelineCache::hitCount() const noexcept {
+    return hitCount_;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	コンパイルが必要だった数を取得する
+ * @return	コンパイルが必要だった数
+ */
+[[nodiscard]] UINT PipelineCache::missCount() const noexcept {
+    return missCount_;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	パイプラインステートを一つ作成する
+ * ワーカースレッドから呼ばれるので、キャッシュは読み込みのみ行う
+ * @param	request	作成要求
+ */
+void PipelineCache::createPipelineState(Request& request) const noexcept {
+    auto desc = request.desc_;
+
+    // キャッシュがあればブロブを渡してコンパイルを省く
+    // ドライバの更新などでブロブが使えない場合は作成に失敗するので、その時はコンパイルし直す
+    if (const auto* blob = file_.find(request.key_)) {
+        desc.CachedPSO.pCachedBlob = blob->data();
+        desc.CachedPSO.CachedBlobSizeInBytes = blob->size();
+        if (SUCCEEDED(device_->CreateGraphicsPipelineState(&desc, IID_PPV_ARGS(&request.pipelineState_)))) {
+            request.hit_ = true;
+            return;
+        }
+        request.pipelineState_ = nullptr;
+        desc.CachedPSO = {};
+    }
+
+    if (FAILED(device_->CreateGraphicsPipelineState(&desc, IID_PPV_ARGS(&request.pipelineState_)))) {
+        request.pipelineState_ = nullptr;
+        return;
+    }
+
+    // 次回の起動で使えるよう、コンパイル結果を取り出しておく
+    ID3DBlob* cachedBlob{};
+    if (SUCCEEDED(request.pipelineState_->GetCachedBlob(&cachedBlob)) && cachedBlob) {
+        const auto* data = static_cast<const uint8_t*>(cachedBlob->GetBufferPointer());
+        request.blob_.assign(data, data + cachedBlob->GetBufferSize());
+        cachedBlob->Release();
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	アダプタとドライバの識別値を計算する
+ * @param	dxgi	DXGI クラスのインスタンス
+ * @return	識別値
+ */
+[[nodiscard]] uint64_t PipelineCache::adapterIdentity(const DXGI& dxgi) noexcept {
+    PipelineHasher hasher{};
+
+    DXGI_ADAPTER_DESC1 desc{};
+    if (SUCCEEDED(dxgi.displayAdapter()->GetDesc1(&desc))) {
+        hasher.add(desc.VendorId);
+        hasher.add(desc.DeviceId);
+        hasher.add(desc.SubSysId);
+        hasher.add(desc.Revision);
+    }
+
+    // ユーザーモードドライバのバージョン
+    LARGE_INTEGER driverVersion{};
+    if (SUCCEEDED(dxgi.displayAdapter()->CheckInterfaceSupport(__uuidof(IDXGIDevice), &driverVersion))) {
+        hasher.add(driverVersion.QuadPart);
+    }
+
+    return hasher.value();
+}
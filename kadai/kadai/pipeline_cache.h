@@ -0,0 +1,122 @@
+﻿// パイプラインキャッシュクラス
+
+#pragma once
+
+#include "device.h"
+#include "DXGI.h"
+#include "pipeline_cache_file.h"
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	パイプラインキャッシュクラス
+ * パイプラインステートの作成要求を貯めておき、まとめてワーカースレッドで並列に作成する
+ * ドライバがコンパイルした結果はファイルに保存し、次回の起動ではそれを使ってコンパイルを省く
+ */
+class PipelineCache final {
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    コンストラクタ
+     */
+    PipelineCache() = default;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    デストラクタ
+     */
+    ~PipelineCache() = default;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	パイプラインキャッシュを作成する
+     * 保存済みのファイルがあれば読み込む。別のアダプタやドライバで作られたファイルは使わない
+     * @param	device		デバイスクラスのインスタンス
+     * @param	dxgi		DXGI クラスのインスタンス
+     * @param	fileName	実行ファイルと同じディレクトリに置くキャッシュファイルの名前
+     * @return	生成の成否
+     */
+    [[nodiscard]] bool create(const Device& device, const DXGI& dxgi, const wchar_t* fileName) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	パイプラインステートの作成を要求する
+     * 実際の作成は build で行うので、それまで設定が指すシェーダや入力レイアウトを破棄しないこと
+     * @param	desc				パイプラインステートの設定
+     * @param	rootSignatureHash	ルートシグネチャのハッシュ値
+     * @param	pipelineState		作成したパイプラインステートの書き込み先
+     * @return	要求を受け付けた場合は true
+     */
+    [[nodiscard]] bool request(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, uint64_t rootSignatureHash, ID3D12PipelineState** pipelineState) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	要求されたパイプラインステートを並列に作成する
+     * キャッシュにあるものはブロブから作成し、無いものはコンパイルして結果をキャッシュに追加する
+     * @param	threadCount	作成に使うスレッドの数
+     * @return	全て作成できた場合は true
+     */
+    [[nodiscard]] bool build(UINT threadCount) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	キャッシュに追加があればファイルに保存する
+     * @return	保存の成否
+     */
+    [[nodiscard]] bool save() noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	キャッシュから作成できた数を取得する
+     * @return	キャッシュから作成できた数
+     */
+    [[nodiscard]] UINT hitCount() const noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	コンパイルが必要だった数を取得する
+     * @return	コンパイルが必要だった数
+     */
+    [[nodiscard]] UINT missCount() const noexcept;
+
+private:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	作成要求
+     */
+    struct Request {
+        D3D12_GRAPHICS_PIPELINE_STATE_DESC desc_{};           /// パイプラインステートの設定
+        uint64_t                           key_{};            /// パイプラインのキー
+        ID3D12PipelineState**              output_{};         /// 作成したパイプラインステートの書き込み先
+        ID3D12PipelineState*               pipelineState_{};  /// 作成したパイプラインステート
+        std::vector<uint8_t>               blob_{};           /// 新しくコンパイルした結果
+        bool                               hit_{};            /// キャッシュから作成できたか
+    };
+
+private:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	パイプラインステートを一つ作成する
+     * ワーカースレッドから呼ばれるので、キャッシュは読み込みのみ行う
+     * @param	request	作成要求
+     */
+    void createPipelineState(Request& request) const noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	アダプタとドライバの識別値を計算する
+     * @param	dxgi	DXGI クラスのインスタンス
+     * @return	識別値
+     */
+    [[nodiscard]] static uint64_t adapterIdentity(const DXGI& dxgi) noexcept;
+
+private:
+    ID3D12Device*         device_{};      /// パイプラインステートを作成するデバイス
+    std::filesystem::path path_{};        /// キャッシュファイルのパス
+    PipelineCacheFile     file_{};        /// キャッシュの内容
+    std::vector<Request>  requests_{};    /// 作成待ちの要求
+    UINT                  hitCount_{};    /// キャッシュから作成できた数
+    UINT                  missCount_{};   /// コンパイルが必要だった数
+};
@@ -0,0 +1,260 @@
+﻿// パイプラインキャッシュファイルクラス
+
+#include "pipeline_cache_file.h"
+#include "pipeline_hasher.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <fstream>
+
+namespace {
+    constexpr size_t headerSize = 4 + 4 + 8 + 4 + 4;  /// ヘッダのサイズ
+    constexpr size_t entryHeaderSize = 8 + 8;         /// エントリ毎のキーとサイズのサイズ
+    constexpr size_t footerSize = 8;                  /// フッタのサイズ
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	値をバイト列の末尾に書き込む
+     * @param	output	書き込み先
+     * @param	value	書き込む値
+     */
+    template <class T>
+    void write(std::vector<uint8_t>& output, const T& value) noexcept {
+        const auto* bytes = reinterpret_cast<const uint8_t*>(&value);
+        output.insert(output.end(), bytes, bytes + sizeof(T));
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	値をバイト列から読み込む
+     * アライメントを気にせず読めるように memcpy で取り出す
+     * @param	data	バイト列の先頭
+     * @param	size	バイト列のサイズ
+     * @param	offset	読み込む位置、読み込んだ分だけ進める
+     * @param	value	読み込んだ値
+     * @return	範囲内で読み込めた場合は true
+     */
+    template <class T>
+    [[nodiscard]] bool read(const uint8_t* data, size_t size, size_t& offset, T& value) noexcept {
+        if (size - offset < sizeof(T)) {
+            return false;
+        }
+        std::memcpy(&value, data + offset, sizeof(T));
+        offset += sizeof(T);
+        return true;
+    }
+}  // namespace
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	全てのエントリを破棄する
+ * @param	identity	ブロブを作ったアダプタとドライバの識別値
+ */
+void PipelineCacheFile::reset(uint64_t identity) noexcept {
+    entries_.clear();
+    identity_ = identity;
+    dirty_ = false;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	キーに対応するブロブを探す
+ * @param	key	パイプラインのキー
+ * @return	ブロブ、見つからない場合は nullptr
+ */
+[[nodiscard]] const std::vector<uint8_t>* PipelineCacheFile::find(uint64_t key) const noexcept {
+    const auto it = entries_.find(key);
+    return it != entries_.end() ? &it->second : nullptr;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	ブロブを登録する
+ * 同じキーが既にある場合は上書きする
+ * @param	key		パイプラインのキー
+ * @param	data	ブロブの先頭
+ * @param	size	ブロブのサイズ
+ */
+void PipelineCacheFile::store(uint64_t key, const void* data, size_t size) noexcept {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    entries_[key].assign(bytes, bytes + size);
+    dirty_ = true;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	ファイル形式のバイト列に変換する
+ * キーの昇順に並べるので、同じ内容からは常に同じバイト列になる
+ * @param	output	書き込み先
+ */
+void PipelineCacheFile::serialize(std::vector<uint8_t>& output) const noexcept {
+    std::vector<uint64_t> keys{};
+    keys.reserve(entries_.size());
+    size_t totalSize = headerSize + footerSize;
+    for (const auto& [key, blob] : entries_) {
+        keys.push_back(key);
+        totalSize += entryHeaderSize + blob.size();
+    }
+    std::sort(keys.begin(), keys.end());
+
+    output.clear();
+    output.reserve(totalSize);
+
+    // ヘッダ
+    write(output, magic);
+    write(output, version);
+    write(output, identity_);
+    write(output, static_cast<uint32_t>(keys.size()));
+    write(output, uint32_t{ 0 });
+
+    // エントリ
+    for (const auto key : keys) {
+        const auto& blob = entries_.at(key);
+        write(output, key);
+        write(output, static_cast<uint64_t>(blob.size()));
+        output.insert(output.end(), blob.begin(), blob.end());
+    }
+
+    // フッタ
+    write(output, PipelineHasher::hashBytes(output.data(), output.size()));
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	ファイル形式のバイト列から読み込む
+ * 壊れている場合や識別値が一致しない場合は、全てのエントリを破棄して false を返す
+ * @param	data		バイト列の先頭
+ * @param	size		バイト列のサイズ
+ * @param	identity	現在のアダプタとドライバの識別値
+ * @return	読み込めた場合は true
+ */
+[[nodiscard]] bool PipelineCacheFile::deserialize(const uint8_t* data, size_t size, uint64_t identity) noexcept {
+    reset(identity);
+
+    if (!data || size < headerSize + footerSize) {
+        return false;
+    }
+
+    // 先にフッタのチェックサムで全体が壊れていないかを確かめる
+    const auto bodySize = size - footerSize;
+    size_t     footerOffset = bodySize;
+    uint64_t   checksum{};
+    if (!read(data, size, footerOffset, checksum) || checksum != PipelineHasher::hashBytes(data, bodySize)) {
+        return false;
+    }
+
+    // ヘッダ
+    size_t   offset = 0;
+    uint32_t fileMagic{};
+    uint32_t fileVersion{};
+    uint64_t fileIdentity{};
+    uint32_t entryCount{};
+    uint32_t reserved{};
+    if (!read(data, bodySize, offset, fileMagic) || !read(data, bodySize, offset, fileVersion) ||
+        !read(data, bodySize, offset, fileIdentity) || !read(data, bodySize, offset, entryCount) ||
+        !read(data, bodySize, offset, reserved)) {
+        return false;
+    }
+
+    // ドライバが変わるとブロブは使えないので、別の環境で作られたファイルは捨てる
+    if (fileMagic != magic || fileVersion != version || fileIdentity != identity) {
+        return false;
+    }
+
+    // エントリ
+    for (uint32_t i = 0; i < entryCount; ++i) {
+        uint64_t key{};
+        uint64_t blobSize{};
+        if (!read(data, bodySize, offset, key) || !read(data, bodySize, offset, blobSize) || blobSize > bodySize - offset) {
+            reset(identity);
+            return false;
+        }
+        entries_[key].assign(data + offset, data + offset + blobSize);
+        offset += static_cast<size_t>(blobSize);
+    }
+
+    // 余分なデータが残っている場合も壊れているとみなす
+    if (offset != bodySize) {
+        reset(identity);
+        return false;
+    }
+
+    return true;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	ファイルから読み込む
+ * @param	path		ファイルのパス
+ * @param	identity	現在のアダプタとドライバの識別値
+ * @return	読み込めた場合は true、ファイルが無い・壊れている・識別値が違う場合は false
+ */
+[[nodiscard]] bool PipelineCacheFile::load(const std::filesystem::path& path, uint64_t identity) noexcept {
+    reset(identity);
+
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        // 初回起動時はファイルが無いので、エラーにはしない
+        return false;
+    }
+
+    const auto size = static_cast<size_t>(file.tellg());
+    std::vector<uint8_t> data(size);
+    file.seekg(0);
+    if (!file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(size))) {
+        return false;
+    }
+
+    return deserialize(data.data(), data.size(), identity);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	ファイルに書き込む
+ * 書き込み途中で終了してもファイルが壊れないよう、一時ファイルに書いてから置き換える
+ * @param	path	ファイルのパス
+ * @return	書き込みの成否
+ */
+[[nodiscard]] bool PipelineCacheFile::save(const std::filesystem::path& path) noexcept {
+    std::vector<uint8_t> data{};
+    serialize(data);
+
+    auto temporaryPath = path;
+    temporaryPath += ".tmp";
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        if (!file || !file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()))) {
+            assert(false && "パイプラインキャッシュの書き込みに失敗しました");
+            return false;
+        }
+    }
+
+    std::error_code error{};
+    std::filesystem::rename(temporaryPath, path, error);
+    if (error) {
+        assert(false && "パイプラインキャッシュの置き換えに失敗しました");
+        std::filesystem::remove(temporaryPath, error);
+        return false;
+    }
+
+    dirty_ = false;
+    return true;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	エントリの数を取得する
+ * @return	エントリの数
+ */
+[[nodiscard]] size_t PipelineCacheFile::entryCount() const noexcept {
+    return entries_.size();
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	最後に読み書きしてから変更されたかを取得する
+ * @return	変更されていれば true
+ */
+[[nodiscard]] bool PipelineCacheFile::dirty() const noexcept {
+    return dirty_;
+}
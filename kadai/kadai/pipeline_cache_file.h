@@ -0,0 +1,120 @@
+﻿// パイプラインキャッシュファイルクラス
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <unordered_map>
+#include <vector>
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	パイプラインキャッシュファイルクラス
+ * パイプラインのキーとドライバがコンパイルした PSO ブロブの組を保持し、ファイルに読み書きする
+ * GPU リソースには依存しないので、ファイル形式だけを単体で確認できる
+ *
+ * ファイル形式（リトルエンディアン）
+ *   ヘッダ		magic(4) version(4) identity(8) entryCount(4) reserved(4)
+ *   エントリ	key(8) size(8) data(size) を entryCount 個
+ *   フッタ		checksum(8)  ヘッダからエントリ末尾までのハッシュ値
+ */
+class PipelineCacheFile final {
+public:
+    static constexpr uint32_t magic = 0x4353504b;  /// ファイルの識別子（"KPSC"）
+    static constexpr uint32_t version = 1;         /// ファイル形式のバージョン
+
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    コンストラクタ
+     */
+    PipelineCacheFile() = default;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    デストラクタ
+     */
+    ~PipelineCacheFile() = default;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	全てのエントリを破棄する
+     * @param	identity	ブロブを作ったアダプタとドライバの識別値
+     */
+    void reset(uint64_t identity) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	キーに対応するブロブを探す
+     * @param	key	パイプラインのキー
+     * @return	ブロブ、見つからない場合は nullptr
+     */
+    [[nodiscard]] const std::vector<uint8_t>* find(uint64_t key) const noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	ブロブを登録する
+     * 同じキーが既にある場合は上書きする
+     * @param	key		パイプラインのキー
+     * @param	data	ブロブの先頭
+     * @param	size	ブロブのサイズ
+     */
+    void store(uint64_t key, const void* data, size_t size) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	ファイル形式のバイト列に変換する
+     * キーの昇順に並べるので、同じ内容からは常に同じバイト列になる
+     * @param	output	書き込み先
+     */
+    void serialize(std::vector<uint8_t>& output) const noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	ファイル形式のバイト列から読み込む
+     * 壊れている場合や識別値が一致しない場合は、全てのエントリを破棄して false を返す
+     * @param	data		バイト列の先頭
+     * @param	size		バイト列のサイズ
+     * @param	identity	現在のアダプタとドライバの識別値
+     * @return	読み込めた場合は true
+     */
+    [[nodiscard]] bool deserialize(const uint8_t* data, size_t size, uint64_t identity) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	ファイルから読み込む
+     * @param	path		ファイルのパス
+     * @param	identity	現在のアダプタとドライバの識別値
+     * @return	読み込めた場合は true、ファイルが無い・壊れている・識別値が違う場合は false
+     */
+    [[nodiscard]] bool load(const std::filesystem::path& path, uint64_t identity) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	ファイルに書き込む
+     * 書き込み途中で終了してもファイルが壊れないよう、一時ファイルに書いてから置き換える
+     * @param	path	ファイルのパス
+     * @return	書き込みの成否
+     */
+    [[nodiscard]] bool save(const std::filesystem::path& path) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	エントリの数を取得する
+     * @return	エントリの数
+     */
+    [[nodiscard]] size_t entryCount() const noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	最後に読み書きしてから変更されたかを取得する
+     * @return	変更されていれば true
+     */
+    [[nodiscard]] bool dirty() const noexcept;
+
+private:
+    std::unordered_map<uint64_t, std::vector<uint8_t>> entries_{};  /// キー毎のブロブ
+    uint64_t identity_{};                                           /// ブロブを作ったアダプタとドライバの識別値
+    bool     dirty_{};                                              /// 変更されたか
+};
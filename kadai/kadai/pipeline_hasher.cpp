@@ -0,0 +1,203 @@
+﻿// パイプラインハッシュクラス
+
+#include "pipeline_hasher.h"
+
+#if defined(_WIN32)
+namespace {
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	シェーダのバイトコードをハッシュに加える
+     * @param	hasher		加える先
+     * @param	bytecode	シェーダのバイトコード
+     */
+    void addShader(PipelineHasher& hasher, const D3D12_SHADER_BYTECODE& bytecode) noexcept {
+        // 長さを先に加えて、未設定のシェーダと空のシェーダ以外が同じ値にならないようにする
+        hasher.add(static_cast<uint64_t>(bytecode.BytecodeLength));
+        if (bytecode.pShaderBytecode) {
+            hasher.addBytes(bytecode.pShaderBytecode, bytecode.BytecodeLength);
+        }
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	ステンシル操作をハッシュに加える
+     * @param	hasher	加える先
+     * @param	desc	ステンシル操作の設定
+     */
+    void addStencilOp(PipelineHasher& hasher, const D3D12_DEPTH_STENCILOP_DESC& desc) noexcept {
+        hasher.add(desc.StencilFailOp);
+        hasher.add(desc.StencilDepthFailOp);
+        hasher.add(desc.StencilPassOp);
+        hasher.add(desc.StencilFunc);
+    }
+}  // namespace
+#endif
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	バイト列をハッシュに加える
+ * @param	data	データの先頭
+ * @param	size	データのサイズ
+ */
+void PipelineHasher::addBytes(const void* data, size_t size) noexcept {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        value_ ^= bytes[i];
+        value_ *= prime;
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	文字列をハッシュに加える
+ * 終端まで含めて加えるので、連続する文字列の区切りが曖昧にならない
+ * @param	text	文字列（nullptr も可）
+ */
+void PipelineHasher::addString(const char* text) noexcept {
+    if (!text) {
+        add(uint8_t{ 0xff });  // 文字列には現れない値で nullptr と空文字列を区別する
+        return;
+    }
+    do {
+        add(static_cast<uint8_t>(*text));
+    } while (*text++ != '\0');
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	現在のハッシュ値を取得する
+ * @return	ハッシュ値
+ */
+[[nodiscard]] uint64_t PipelineHasher::value() const noexcept {
+    return value_;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	バイト列のハッシュ値を計算する
+ * @param	data	データの先頭
+ * @param	size	データのサイズ
+ * @return	ハッシュ値
+ */
+[[nodiscard]] uint64_t PipelineHasher::hashBytes(const void* data, size_t size) noexcept {
+    PipelineHasher hasher{};
+    hasher.addBytes(data, size);
+    return hasher.value();
+}
+
+#if defined(_WIN32)
+//---------------------------------------------------------------------------------
+/**
+ * @brief	パイプラインステートの設定のハッシュ値を計算する
+ * シェーダ、入力レイアウト、ブレンド・ラスタライザ・デプスステート、フォーマットを全て含める
+ * ルートシグネチャはポインタではなく、シリアライズ結果のハッシュ値で区別する
+ * キャッシュ済みの PSO ブロブはキーに含めない
+ * @param	desc				パイプラインステートの設定
+ * @param	rootSignatureHash	ルートシグネチャのハッシュ値
+ * @return	ハッシュ値
+ */
+[[nodiscard]] uint64_t PipelineHasher::hashPipeline(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, uint64_t rootSignatureHash) noexcept {
+    // 構造体をそのままハッシュするとポインタの値やパディングが混ざるので、メンバを一つずつ加える
+    PipelineHasher hasher{};
+    hasher.add(rootSignatureHash);
+
+    // シェーダ
+    addShader(hasher, desc.VS);
+    addShader(hasher, desc.PS);
+    addShader(hasher, desc.DS);
+    addShader(hasher, desc.HS);
+    addShader(hasher, desc.GS);
+
+    // ストリームアウトプット
+    const auto& streamOutput = desc.StreamOutput;
+    hasher.add(streamOutput.NumEntries);
+    for (UINT i = 0; i < streamOutput.NumEntries; ++i) {
+        const auto& entry = streamOutput.pSODeclaration[i];
+        hasher.add(entry.Stream);
+        hasher.addString(entry.SemanticName);
+        hasher.add(entry.SemanticIndex);
+        hasher.add(entry.StartComponent);
+        hasher.add(entry.ComponentCount);
+        hasher.add(entry.OutputSlot);
+    }
+    hasher.add(streamOutput.NumStrides);
+    for (UINT i = 0; i < streamOutput.NumStrides; ++i) {
+        hasher.add(streamOutput.pBufferStrides[i]);
+    }
+    hasher.add(streamOutput.RasterizedStream);
+
+    // ブレンドステート
+    const auto& blend = desc.BlendState;
+    hasher.add(blend.AlphaToCoverageEnable);
+    hasher.add(blend.IndependentBlendEnable);
+    for (const auto& target : blend.RenderTarget) {
+        hasher.add(target.BlendEnable);
+        hasher.add(target.LogicOpEnable);
+        hasher.add(target.SrcBlend);
+        hasher.add(target.DestBlend);
+        hasher.add(target.BlendOp);
+        hasher.add(target.SrcBlendAlpha);
+        hasher.add(target.DestBlendAlpha);
+        hasher.add(target.BlendOpAlpha);
+        hasher.add(target.LogicOp);
+        hasher.add(target.RenderTargetWriteMask);
+    }
+    hasher.add(desc.SampleMask);
+
+    // ラスタライザステート
+    const auto& rasterizer = desc.RasterizerState;
+    hasher.add(rasterizer.FillMode);
+    hasher.add(rasterizer.CullMode);
+    hasher.add(rasterizer.FrontCounterClockwise);
+    hasher.add(rasterizer.DepthBias);
+    hasher.add(rasterizer.DepthBiasClamp);
+    hasher.add(rasterizer.SlopeScaledDepthBias);
+    hasher.add(rasterizer.DepthClipEnable);
+    hasher.add(rasterizer.MultisampleEnable);
+    hasher.add(rasterizer.AntialiasedLineEnable);
+    hasher.add(rasterizer.ForcedSampleCount);
+    hasher.add(rasterizer.ConservativeRaster);
+
+    // デプスステンシルステート
+    const auto& depthStencil = desc.DepthStencilState;
+    hasher.add(depthStencil.DepthEnable);
+    hasher.add(depthStencil.DepthWriteMask);
+    hasher.add(depthStencil.DepthFunc);
+    hasher.add(depthStencil.StencilEnable);
+    hasher.add(depthStencil.StencilReadMask);
+    hasher.add(depthStencil.StencilWriteMask);
+    addStencilOp(hasher, depthStencil.FrontFace);
+    addStencilOp(hasher, depthStencil.BackFace);
+
+    // 入力レイアウト
+    const auto& inputLayout = desc.InputLayout;
+    hasher.add(inputLayout.NumElements);
+    for (UINT i = 0; i < inputLayout.NumElements; ++i) {
+        const auto& element = inputLayout.pInputElementDescs[i];
+        hasher.addString(element.SemanticName);
+        hasher.add(element.SemanticIndex);
+        hasher.add(element.Format);
+        hasher.add(element.InputSlot);
+        hasher.add(element.AlignedByteOffset);
+        hasher.add(element.InputSlotClass);
+        hasher.add(element.InstanceDataStepRate);
+    }
+    hasher.add(desc.IBStripCutValue);
+    hasher.add(desc.PrimitiveTopologyType);
+
+    // 出力先のフォーマット
+    // 使わないレンダーターゲットの値は結果に影響しないので含めない
+    hasher.add(desc.NumRenderTargets);
+    for (UINT i = 0; i < desc.NumRenderTargets && i < D3D12_SIMULTANEOUS_RENDER_TARGET_COUNT; ++i) {
+        hasher.add(desc.RTVFormats[i]);
+    }
+    hasher.add(desc.DSVFormat);
+    hasher.add(desc.SampleDesc.Count);
+    hasher.add(desc.SampleDesc.Quality);
+
+    hasher.add(desc.NodeMask);
+    hasher.add(desc.Flags);
+
+    return hasher.value();
+}
+#endif
@@ -0,0 +1,96 @@
+﻿// パイプラインハッシュクラス
+
+#pragma once
+
+// ヘッドレスビルドではキャッシュファイルのためにバイト列のハッシュだけを使う
+#if defined(_WIN32)
+#include <d3d12.h>
+#endif
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	パイプラインハッシュクラス
+ * パイプラインステートの設定から、実行を跨いでも変わらないキーを計算する（FNV-1a 64bit）
+ * ポインタの値はハッシュに含めず、指している中身を辿ってハッシュする
+ */
+class PipelineHasher final {
+public:
+    static constexpr uint64_t offsetBasis = 14695981039346656037ull;  /// FNV-1a の初期値
+    static constexpr uint64_t prime = 1099511628211ull;               /// FNV-1a の乗数
+
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    コンストラクタ
+     */
+    PipelineHasher() = default;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    デストラクタ
+     */
+    ~PipelineHasher() = default;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	バイト列をハッシュに加える
+     * @param	data	データの先頭
+     * @param	size	データのサイズ
+     */
+    void addBytes(const void* data, size_t size) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	文字列をハッシュに加える
+     * 終端まで含めて加えるので、連続する文字列の区切りが曖昧にならない
+     * @param	text	文字列（nullptr も可）
+     */
+    void addString(const char* text) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	数値や列挙値をハッシュに加える
+     * @param	value	加える値
+     */
+    template <class T>
+    void add(const T& value) noexcept {
+        static_assert(std::is_arithmetic_v<T> || std::is_enum_v<T>, "数値か列挙値のみハッシュに加えられます");
+        addBytes(&value, sizeof(T));
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	現在のハッシュ値を取得する
+     * @return	ハッシュ値
+     */
+    [[nodiscard]] uint64_t value() const noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	バイト列のハッシュ値を計算する
+     * @param	data	データの先頭
+     * @param	size	データのサイズ
+     * @return	ハッシュ値
+     */
+    [[nodiscard]] static uint64_t hashBytes(const void* data, size_t size) noexcept;
+
+#if defined(_WIN32)
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	パイプラインステートの設定のハッシュ値を計算する
+     * シェーダ、入力レイアウト、ブレンド・ラスタライザ・デプスステート、フォーマットを全て含める
+     * ルートシグネチャはポインタではなく、シリアライズ結果のハッシュ値で区別する
+     * キャッシュ済みの PSO ブロブはキーに含めない
+     * @param	desc				パイプラインステートの設定
+     * @param	rootSignatureHash	ルートシグネチャのハッシュ値
+     * @return	ハッシュ値
+     */
+    [[nodiscard]] static uint64_t hashPipeline(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc, uint64_t rootSignatureHash) noexcept;
+#endif
+
+private:
+    uint64_t value_ = offsetBasis;  /// 現在のハッシュ値
+};
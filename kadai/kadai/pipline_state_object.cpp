@@ -2,6 +2,16 @@
 #include "pipline_state_object.h"
 #include <cassert>
 
+namespace {
+    // _CAEg
+    // _obt@̃tH[}bgɍ킹Đݒ肷
+    // pCvCXe[g̍쐬͌ł܂Ƃ߂čŝŁA쐬v蒷c悤ɂĂ
+    constexpr D3D12_INPUT_ELEMENT_DESC inputElementDescs[] = {
+        {"POSITION", 0,    DXGI_FORMAT_R32G32B32_FLOAT, 0,  0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+        {   "COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
+    };
+}  // namespace
+
 //---------------------------------------------------------------------------------
 /**
  * @brief    fXgN^
@@ -16,20 +26,14 @@
 
 //---------------------------------------------------------------------------------
 /**
- * @brief	pCvCXe[gIuWFNg쐬
- * @param	device			foCXNX̃CX^X
+ * @brief	pCvCXe[gIuWFNg̍쐬v
+ * ۂ̍쐬 PipelineCache::build ł܂Ƃ߂čŝŁA܂ get ͎gȂ
  * @param	shader			VF[_NX̃CX^X
  * @param	rootSignature	[gVOl`NX̃CX^X
+ * @param	pipelineCache	pCvCLbVNX̃CX^X
  * @return	 true
  */
-[[nodiscard]] bool PiplineStateObject::create(const Device& device, const Shader& shader, const RootSignature& rootSignature) noexcept {
-    // _CAEg
-    // _obt@̃tH[}bgɍ킹Đݒ肷
-    D3D12_INPUT_ELEMENT_DESC inputElementDescs[] = {
-        {"POSITION", 0,    DXGI_FORMAT_R32G32B32_FLOAT, 0,  0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
-        {   "COLOR", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0},
-    };
-
+[[nodiscard]] bool PiplineStateObject::create(const Shader& shader, const RootSignature& rootSignature, PipelineCache& pipelineCache) noexcept {
     // fvXXe[g̐ݒ
     D3D12_DEPTH_STENCIL_DESC depthStateDesc{};
     depthStateDesc.DepthEnable = true;
@@ -88,9 +92,12 @@
     psoDesc.NumRenderTargets = 1;
     psoDesc.RTVFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
     psoDesc.SampleDesc.Count = 1;
-    auto res = device.get()->CreateGraphicsPipelineState(&psoDesc, IID_PPV_ARGS(&pipelineState_));
-    if (FAILED(res)) {
-        assert(false && "pCvCXe[g̍쐬Ɏs");
+
+    // 쐬̓pCvCLbVɔC
+    // [gVOl`̓|C^ł͂ȂnbVlŃLbṼL[Ɋ܂߂
+    if (!pipelineCache.request(psoDesc, rootSignature.hash(), &pipelineState_)) {
+        assert(false && "pCvCXe[g̍쐬vɎs");
+        return false;
     }
 
     return true;
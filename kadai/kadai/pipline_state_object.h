@@ -5,6 +5,7 @@
 #include "device.h"
 #include "shader.h"
 #include "root_signature.h"
+#include "pipeline_cache.h"
 
 //---------------------------------------------------------------------------------
 /**
@@ -26,13 +27,14 @@ public:
 
     //---------------------------------------------------------------------------------
     /**
-     * @brief	pCvCXe[gIuWFNg쐬
-     * @param	device			foCXNX̃CX^X
+     * @brief	pCvCXe[gIuWFNg̍쐬v
+     * ۂ̍쐬 PipelineCache::build ł܂Ƃ߂čŝŁA܂ get ͎gȂ
      * @param	shader			VF[_NX̃CX^X
      * @param	rootSignature	[gVOl`NX̃CX^X
+     * @param	pipelineCache	pCvCLbVNX̃CX^X
      * @return	 true
      */
-    [[nodiscard]] bool create(const Device& device, const Shader& shader, const RootSignature& rootSignature) noexcept;
+    [[nodiscard]] bool create(const Shader& shader, const RootSignature& rootSignature, PipelineCache& pipelineCache) noexcept;
 
     //---------------------------------------------------------------------------------
     /**
@@ -0,0 +1,199 @@
+﻿// プロファイラクラス
+
+#include "profiler.h"
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+
+thread_local Profiler::Track* Profiler::threadTrack_ = nullptr;
+
+namespace {
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	JSON の文字列として書き出す
+     * @param	file	書き込み先
+     * @param	text	文字列
+     */
+    void writeJsonString(std::ofstream& file, const char* text) noexcept {
+        file << '"';
+        for (const auto* c = text; *c; ++c) {
+            if (*c == '"' || *c == '\\') {
+                file << '\\' << *c;
+            } else if (*c == '\n') {
+                file << "\\n";
+            } else if (*c == '\t') {
+                file << "\\t";
+            } else if (static_cast<unsigned char>(*c) < 0x20) {
+                // 他の制御文字は JSON の文字列にそのまま入れられないので、16 進の u エスケープにする
+                char escaped[8];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned int>(static_cast<unsigned char>(*c)));
+                file << escaped;
+            } else {
+                file << *c;
+            }
+        }
+        file << '"';
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	ナノ秒をトレース形式の時刻（マイクロ秒）として書き出す
+     * @param	file			書き込み先
+     * @param	nanoseconds		時刻（ナノ秒）
+     */
+    void writeMicroseconds(std::ofstream& file, uint64_t nanoseconds) noexcept {
+        char text[32];
+        std::snprintf(text, sizeof(text), "%llu.%03llu", static_cast<unsigned long long>(nanoseconds / 1000), static_cast<unsigned long long>(nanoseconds % 1000));
+        file << text;
+    }
+}  // namespace
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief    コンストラクタ
+ */
+Profiler::Profiler() noexcept
+    : startTime_(now()) {
+    gpuTrack_ = &addTrack("GPU");
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	現在時刻を取得する
+ * std::chrono::steady_clock の値をそのまま使う（MSVC では QueryPerformanceCounter を元にしている）
+ * @return	現在時刻（ナノ秒）
+ */
+[[nodiscard]] uint64_t Profiler::now() noexcept {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	呼び出したスレッドのトラックに名前を付ける
+ * @param	name	トラックの名前
+ */
+void Profiler::setThreadName(const char* name) noexcept {
+    auto& track = threadTrack();
+    std::lock_guard lock(mutex_);
+    track.name_ = name;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	呼び出したスレッドのトラックに区間を記録する
+ * @param	name	区間の名前（記録中は参照し続けるので文字列リテラルを渡す）
+ * @param	begin	開始時刻（ナノ秒）
+ * @param	end		終了時刻（ナノ秒）
+ */
+void Profiler::record(const char* name, uint64_t begin, uint64_t end) noexcept {
+    write(threadTrack(), name, begin, end);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	GPU のトラックに区間を記録する
+ * GPU の結果を回収する一つのスレッドからだけ呼ぶこと
+ * @param	name	区間の名前（記録中は参照し続けるので文字列リテラルを渡す）
+ * @param	begin	CPU の時間軸に直した開始時刻（ナノ秒）
+ * @param	end		CPU の時間軸に直した終了時刻（ナノ秒）
+ */
+void Profiler::recordGpu(const char* name, uint64_t begin, uint64_t end) noexcept {
+    write(*gpuTrack_, name, begin, end);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	記録した区間を Chrome のトレース形式（JSON）で書き出す
+ * 記録中の区間と重なると内容が崩れることがあるので、ワーカースレッドが止まっているフレームの区切りで呼ぶ
+ * @param	path	ファイルのパス
+ * @return	書き込みの成否
+ */
+[[nodiscard]] bool Profiler::exportChromeTrace(const std::filesystem::path& path) const noexcept {
+    std::ofstream file(path, std::ios::trunc);
+    if (!file) {
+        assert(false && "トレースファイルを開けませんでした");
+        return false;
+    }
+
+    std::lock_guard lock(mutex_);
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    for (const auto& track : tracks_) {
+        // トラックの名前
+        file << (first ? "\n" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << track->id_ << ",\"args\":{\"name\":";
+        writeJsonString(file, track->name_.c_str());
+        file << "}}";
+        first = false;
+
+        // リングバッファに残っている区間を古い順に書き出す
+        const auto count = track->count_.load(std::memory_order_acquire);
+        const auto oldest = count > eventCapacity ? count - eventCapacity : 0;
+        for (auto i = oldest; i < count; ++i) {
+            const auto& event = track->events_[i % eventCapacity];
+            if (event.begin_ < startTime_ || event.end_ < event.begin_) {
+                continue;
+            }
+            file << ",\n{\"name\":";
+            writeJsonString(file, event.name_);
+            file << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << track->id_ << ",\"ts\":";
+            writeMicroseconds(file, event.begin_ - startTime_);
+            file << ",\"dur\":";
+            writeMicroseconds(file, event.end_ - event.begin_);
+            file << '}';
+        }
+    }
+    file << "\n]}\n";
+
+    if (!file) {
+        assert(false && "トレースファイルの書き込みに失敗しました");
+        return false;
+    }
+    return true;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	トラックを作成して登録する
+ * @param	name	トラックの名前
+ * @return	作成したトラック
+ */
+[[nodiscard]] Profiler::Track& Profiler::addTrack(std::string name) noexcept {
+    auto track = std::make_unique<Track>();
+    track->name_ = std::move(name);
+    track->events_.resize(eventCapacity);
+
+    std::lock_guard lock(mutex_);
+    track->id_ = static_cast<uint32_t>(tracks_.size());
+    tracks_.push_back(std::move(track));
+    return *tracks_.back();
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	呼び出したスレッドのトラックを取得する
+ * 初めて呼んだスレッドではトラックを作成する
+ * @return	トラック
+ */
+[[nodiscard]] Profiler::Track& Profiler::threadTrack() noexcept {
+    if (!threadTrack_) {
+        threadTrack_ = &addTrack("Thread");
+    }
+    return *threadTrack_;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	トラックに区間を書き込む
+ * @param	track	書き込むトラック
+ * @param	name	区間の名前
+ * @param	begin	開始時刻
+ * @param	end		終了時刻
+ */
+void Profiler::write(Track& track, const char* name, uint64_t begin, uint64_t end) noexcept {
+    // 書き込むのは持ち主のスレッドだけなので、書き終えてから数を進めれば読む側は書き終えた区間だけを見る
+    const auto index = track.count_.load(std::memory_order_relaxed);
+    track.events_[index % eventCapacity] = { name, begin, end };
+    track.count_.store(index + 1, std::memory_order_release);
+}
@@ -0,0 +1,183 @@
+﻿// プロファイラクラス
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	プロファイラクラス
+ * 処理の区間（名前と開始・終了時刻）をスレッド毎のリングバッファに記録し、Chrome のトレース形式で書き出す
+ * 書き出したファイルは chrome://tracing や Perfetto で開ける
+ * 記録はスレッド毎に分かれているのでロックを取らず、リングバッファが一周すると古い区間から上書きする
+ * GPU の区間は GpuProfiler が CPU と同じ時間軸に直してから GPU 用のトラックに記録する
+ * シングルトンパターンで作成する
+ */
+class Profiler final {
+public:
+    static constexpr uint32_t eventCapacity = 16 * 1024;  /// トラック毎に保持する区間の数
+
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	インスタンスの取得
+     * @return	インスタンスの参照
+     */
+    static Profiler& instance() noexcept {
+        static Profiler instance;
+        return instance;
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	現在時刻を取得する
+     * std::chrono::steady_clock の値をそのまま使う（MSVC では QueryPerformanceCounter を元にしている）
+     * @return	現在時刻（ナノ秒）
+     */
+    [[nodiscard]] static uint64_t now() noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	呼び出したスレッドのトラックに名前を付ける
+     * @param	name	トラックの名前
+     */
+    void setThreadName(const char* name) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	呼び出したスレッドのトラックに区間を記録する
+     * @param	name	区間の名前（記録中は参照し続けるので文字列リテラルを渡す）
+     * @param	begin	開始時刻（ナノ秒）
+     * @param	end		終了時刻（ナノ秒）
+     */
+    void record(const char* name, uint64_t begin, uint64_t end) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	GPU のトラックに区間を記録する
+     * GPU の結果を回収する一つのスレッドからだけ呼ぶこと
+     * @param	name	区間の名前（記録中は参照し続けるので文字列リテラルを渡す）
+     * @param	begin	CPU の時間軸に直した開始時刻（ナノ秒）
+     * @param	end		CPU の時間軸に直した終了時刻（ナノ秒）
+     */
+    void recordGpu(const char* name, uint64_t begin, uint64_t end) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	記録した区間を Chrome のトレース形式（JSON）で書き出す
+     * 記録中の区間と重なると内容が崩れることがあるので、ワーカースレッドが止まっているフレームの区切りで呼ぶ
+     * @param	path	ファイルのパス
+     * @return	書き込みの成否
+     */
+    [[nodiscard]] bool exportChromeTrace(const std::filesystem::path& path) const noexcept;
+
+private:
+    // シングルトンパターンにするため、コンストラクタとデストラクタを private にする
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    コンストラクタ
+     */
+    Profiler() noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    デストラクタ
+     */
+    ~Profiler() = default;
+
+private:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	記録した区間
+     */
+    struct Event {
+        const char* name_{};   /// 区間の名前
+        uint64_t    begin_{};  /// 開始時刻（ナノ秒）
+        uint64_t    end_{};    /// 終了時刻（ナノ秒）
+    };
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	一つのスレッド（または GPU）の区間のリングバッファ
+     * 書き込むのは持ち主のスレッドだけ
+     */
+    struct Track {
+        uint32_t              id_{};      /// トレースのスレッド番号
+        std::string           name_{};    /// トラックの名前
+        std::vector<Event>    events_{};  /// 区間のリングバッファ
+        std::atomic<uint64_t> count_{};   /// これまでに記録した区間の数
+    };
+
+private:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	トラックを作成して登録する
+     * @param	name	トラックの名前
+     * @return	作成したトラック
+     */
+    [[nodiscard]] Track& addTrack(std::string name) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	呼び出したスレッドのトラックを取得する
+     * 初めて呼んだスレッドではトラックを作成する
+     * @return	トラック
+     */
+    [[nodiscard]] Track& threadTrack() noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	トラックに区間を書き込む
+     * @param	track	書き込むトラック
+     * @param	name	区間の名前
+     * @param	begin	開始時刻
+     * @param	end		終了時刻
+     */
+    static void write(Track& track, const char* name, uint64_t begin, uint64_t end) noexcept;
+
+private:
+    static thread_local Track* threadTrack_;  /// スレッド毎のトラック
+
+    mutable std::mutex                  mutex_{};      /// トラックの一覧を守るミューテックス
+    std::vector<std::unique_ptr<Track>> tracks_{};     /// 全てのトラック（プログラムの終了まで破棄しない）
+    Track*                              gpuTrack_{};   /// GPU のトラック
+    uint64_t                            startTime_{};  /// 書き出す時刻の基準（ナノ秒）
+};
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	区間を計測するクラス
+ * 作成から破棄までを一つの区間として、作成したスレッドのトラックに記録する
+ */
+class ProfileScope final {
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    コンストラクタ
+     * @param	name	区間の名前（文字列リテラル）
+     */
+    explicit ProfileScope(const char* name) noexcept
+        : name_(name), begin_(Profiler::now()) {
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    デストラクタ
+     */
+    ~ProfileScope() {
+        Profiler::instance().record(name_, begin_, Profiler::now());
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    const char* name_{};   /// 区間の名前
+    uint64_t    begin_{};  /// 開始時刻（ナノ秒）
+};
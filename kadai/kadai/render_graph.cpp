@@ -0,0 +1,341 @@
+﻿// レンダーグラフクラス
+
+#include "render_graph.h"
+#include <algorithm>
+#include <cassert>
+
+namespace {
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	読み込み専用のステートか調べる
+     * @param	state	リソースステート
+     * @return	読み込み専用なら true
+     */
+    constexpr bool isReadOnly(RenderGraph::ResourceState state) noexcept {
+        return state != 0 && (state & RenderGraph::writeStateMask) == 0;
+    }
+}  // namespace
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	グラフを空にする
+ */
+void RenderGraph::reset() noexcept {
+    resources_.clear();
+    passes_.clear();
+    compiledPasses_.clear();
+    finalBarriers_.clear();
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	グラフの外で管理しているリソースを登録する
+ * 外部リソースはグラフの実行後に finalState へ戻され、書き込むパスは削除されない
+ * @param	initialState	グラフ実行前のステート
+ * @param	finalState		グラフ実行後に戻すステート
+ * @return	リソースの識別子
+ */
+[[nodiscard]] RenderGraph::ResourceHandle RenderGraph::importResource(ResourceState initialState, ResourceState finalState) {
+    resources_.push_back({ initialState, finalState, true });
+    return static_cast<ResourceHandle>(resources_.size() - 1);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	グラフの中だけで使うリソースを登録する
+ * @param	initialState	最初に使われる前のステート
+ * @return	リソースの識別子
+ */
+[[nodiscard]] RenderGraph::ResourceHandle RenderGraph::createResource(ResourceState initialState) {
+    resources_.push_back({ initialState, initialState, false });
+    return static_cast<ResourceHandle>(resources_.size() - 1);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	パスを追加する
+ * @param	execute			パスの処理
+ * @param	hasSideEffect	出力が使われなくても削除しない場合は true
+ * @return	パスの識別子
+ */
+[[nodiscard]] RenderGraph::PassHandle RenderGraph::addPass(std::function<void()> execute, bool hasSideEffect) {
+    passes_.push_back({ std::move(execute), {}, hasSideEffect });
+    return static_cast<PassHandle>(passes_.size() - 1);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	パスが読み込むリソースを宣言する
+ * @param	pass		パスの識別子
+ * @param	resource	リソースの識別子
+ * @param	state		読み込み時に必要なステート
+ */
+void RenderGraph::read(PassHandle pass, ResourceHandle resource, ResourceState state) {
+    assert(pass < passes_.size() && resource < resources_.size() && "不正な識別子です");
+    passes_[pass].accesses_.push_back({ resource, state, false });
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	パスが書き込むリソースを宣言する
+ * @param	pass		パスの識別子
+ * @param	resource	リソースの識別子
+ * @param	state		書き込み時に必要なステート
+ */
+void RenderGraph::write(PassHandle pass, ResourceHandle resource, ResourceState state) {
+    assert(pass < passes_.size() && resource < resources_.size() && "不正な識別子です");
+    passes_[pass].accesses_.push_back({ resource, state, true });
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	グラフをコンパイルする
+ * 不要なパスの削除、実行順の決定、バリアの計算を行う
+ */
+void RenderGraph::compile() {
+    const auto alive = cullPasses();
+    const auto order = schedulePasses(alive);
+    computeBarriers(order);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	コンパイル済みのパスを実行順に取得する
+ * @return	コンパイル済みのパスの配列
+ */
+[[nodiscard]] const std::vector<RenderGraph::CompiledPass>& RenderGraph::compiledPasses() const noexcept {
+    return compiledPasses_;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	全パスの実行後に外部リソースを元のステートに戻すバリアを取得する
+ * @return	バリアの配列
+ */
+[[nodiscard]] const std::vector<RenderGraph::Barrier>& RenderGraph::finalBarriers() const noexcept {
+    return finalBarriers_;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	パスの処理を実行する
+ * @param	pass	パスの識別子
+ */
+void RenderGraph::execute(PassHandle pass) const {
+    assert(pass < passes_.size() && "不正な識別子です");
+    if (passes_[pass].execute_) {
+        passes_[pass].execute_();
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	出力が使われないパスを調べる
+ * @return	パス毎の生存フラグ
+ */
+[[nodiscard]] std::vector<bool> RenderGraph::cullPasses() const {
+    // 後ろのパスから順に、その時点で内容が必要とされているリソースを追跡する
+    // 外部リソースはグラフの外で使われるので最初から必要とする
+    std::vector<bool> needed(resources_.size());
+    for (size_t i = 0; i < resources_.size(); ++i) {
+        needed[i] = resources_[i].imported_;
+    }
+
+    std::vector<bool> alive(passes_.size());
+    for (auto i = passes_.size(); i-- > 0;) {
+        const auto& pass = passes_[i];
+
+        // 必要とされているリソースに書き込むパスだけを残す
+        auto isAlive = pass.hasSideEffect_;
+        for (const auto& access : pass.accesses_) {
+            if (access.write_ && needed[access.resource_]) {
+                isAlive = true;
+            }
+        }
+        alive[i] = isAlive;
+        if (!isAlive) {
+            continue;
+        }
+
+        // このパスが書き込む前の内容は、読み込みがない限り不要になる
+        for (const auto& access : pass.accesses_) {
+            if (access.write_) {
+                needed[access.resource_] = false;
+            }
+        }
+        for (const auto& access : pass.accesses_) {
+            if (!access.write_) {
+                needed[access.resource_] = true;
+            }
+        }
+    }
+
+    return alive;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	依存関係を守りつつ、依存するパス同士がなるべく離れるように実行順を決める
+ * @param	alive	パス毎の生存フラグ
+ * @return	実行順に並べたパスの配列
+ */
+[[nodiscard]] std::vector<RenderGraph::PassHandle> RenderGraph::schedulePasses(const std::vector<bool>& alive) const {
+    const auto passCount = passes_.size();
+
+    // 宣言順にリソースの読み書きを辿って依存関係を作る
+    std::vector<std::vector<PassHandle>> dependents(passCount);
+    std::vector<uint32_t>                dependencyCount(passCount);
+    {
+        constexpr auto                       none = UINT32_MAX;
+        std::vector<PassHandle>              lastWriter(resources_.size(), none);
+        std::vector<std::vector<PassHandle>> readers(resources_.size());
+
+        auto addDependency = [&](PassHandle from, PassHandle to) {
+            if (from == none || from == to) {
+                return;
+            }
+            auto& list = dependents[from];
+            if (std::find(list.begin(), list.end(), to) == list.end()) {
+                list.push_back(to);
+                ++dependencyCount[to];
+            }
+        };
+
+        for (PassHandle i = 0; i < passCount; ++i) {
+            if (!alive[i]) {
+                continue;
+            }
+            for (const auto& access : passes_[i].accesses_) {
+                // 読み込みも書き込みも直前の書き込みを待つ
+                addDependency(lastWriter[access.resource_], i);
+                if (access.write_) {
+                    // 書き込みはそれまでの読み込みを待つ
+                    for (const auto reader : readers[access.resource_]) {
+                        addDependency(reader, i);
+                    }
+                }
+            }
+            for (const auto& access : passes_[i].accesses_) {
+                if (access.write_) {
+                    lastWriter[access.resource_] = i;
+                    readers[access.resource_].clear();
+                }
+            }
+            for (const auto& access : passes_[i].accesses_) {
+                if (!access.write_) {
+                    readers[access.resource_].push_back(i);
+                }
+            }
+        }
+    }
+
+    // 実行可能なパスの中から、依存先が最も早く終わっているものを選ぶ
+    // 依存するパス同士の間に別のパスが入るので、GPU 上で処理が重なりやすくなる
+    std::vector<size_t>     readyAt(passCount, 0);
+    std::vector<PassHandle> ready;
+    for (PassHandle i = 0; i < passCount; ++i) {
+        if (alive[i] && dependencyCount[i] == 0) {
+            ready.push_back(i);
+        }
+    }
+
+    std::vector<PassHandle> order;
+    while (!ready.empty()) {
+        auto best = ready.begin();
+        for (auto it = ready.begin(); it != ready.end(); ++it) {
+            if (readyAt[*it] < readyAt[*best] || (readyAt[*it] == readyAt[*best] && *it < *best)) {
+                best = it;
+            }
+        }
+        const auto pass = *best;
+        ready.erase(best);
+        order.push_back(pass);
+
+        for (const auto next : dependents[pass]) {
+            readyAt[next] = std::max(readyAt[next], order.size());
+            if (--dependencyCount[next] == 0) {
+                ready.push_back(next);
+            }
+        }
+    }
+
+    return order;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	実行順にステートを追跡してバリアを計算する
+ * @param	order	実行順に並べたパスの配列
+ */
+void RenderGraph::computeBarriers(const std::vector<PassHandle>& order) {
+    compiledPasses_.clear();
+    finalBarriers_.clear();
+
+    // パス毎に、リソース単位で必要なステートをまとめる
+    // 同じパス内の複数の読み込みはステートを合成し、書き込みがあれば書き込みのステートを優先する
+    struct Requirement {
+        ResourceHandle resource_{};
+        ResourceState  state_{};
+        bool           write_{};
+    };
+    std::vector<std::vector<Requirement>> requirements(order.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        auto& list = requirements[i];
+        for (const auto& access : passes_[order[i]].accesses_) {
+            auto it = std::find_if(list.begin(), list.end(), [&](const Requirement& r) { return r.resource_ == access.resource_; });
+            if (it == list.end()) {
+                list.push_back({ access.resource_, access.state_, access.write_ });
+            } else if (access.write_) {
+                assert((!it->write_ || it->state_ == access.state_) && "同じパスで異なるステートへの書き込みがあります");
+                it->state_ = access.state_;
+                it->write_ = true;
+            } else if (!it->write_) {
+                it->state_ |= access.state_;
+            }
+        }
+    }
+
+    // 連続する読み込みは、最初の読み込みの時点で後続の読み込みステートも合成しておく
+    // 読み込み同士の間のバリアが不要になる
+    {
+        std::vector<ResourceState> readUnion(resources_.size(), 0);
+        for (auto i = order.size(); i-- > 0;) {
+            for (auto& requirement : requirements[i]) {
+                if (requirement.write_) {
+                    readUnion[requirement.resource_] = 0;
+                } else {
+                    readUnion[requirement.resource_] |= requirement.state_;
+                    requirement.state_ = readUnion[requirement.resource_];
+                }
+            }
+        }
+    }
+
+    // 実行順にステートを追跡し、変化するところだけバリアを発行する
+    std::vector<ResourceState> current(resources_.size());
+    for (size_t i = 0; i < resources_.size(); ++i) {
+        current[i] = resources_[i].initialState_;
+    }
+
+    compiledPasses_.reserve(order.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        CompiledPass compiled{ order[i], {} };
+        for (const auto& requirement : requirements[i]) {
+            auto& state = current[requirement.resource_];
+            const auto covered = !requirement.write_ && isReadOnly(state) && (state & requirement.state_) == requirement.state_;
+            if (state == requirement.state_ || covered) {
+                continue;
+            }
+            compiled.barriers_.push_back({ requirement.resource_, state, requirement.state_ });
+            state = requirement.state_;
+        }
+        compiledPasses_.push_back(std::move(compiled));
+    }
+
+    // 外部リソースを元のステートに戻す
+    for (ResourceHandle i = 0; i < resources_.size(); ++i) {
+        if (resources_[i].imported_ && current[i] != resources_[i].finalState_) {
+            finalBarriers_.push_back({ i, current[i], resources_[i].finalState_ });
+        }
+    }
+}
@@ -0,0 +1,197 @@
+﻿// レンダーグラフクラス
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	レンダーグラフクラス
+ * パスが読み書きするリソースを宣言しておき、不要なパスの削除・パスの並び替え・
+ * リソースステートの遷移（バリア）の計算をまとめて行う
+ * グラフの構築とコンパイルは GPU に依存しないので、バリアの発行は呼び出し側で行う
+ */
+class RenderGraph final {
+public:
+    using ResourceHandle = uint32_t;  /// リソースの識別子
+    using PassHandle = uint32_t;      /// パスの識別子
+
+    // リソースステートは D3D12_RESOURCE_STATES と同じ値をそのまま使う
+    using ResourceState = uint32_t;
+
+    // 書き込みを伴うステート（RENDER_TARGET, UNORDERED_ACCESS, DEPTH_WRITE, STREAM_OUT, COPY_DEST, RESOLVE_DEST）
+    static constexpr ResourceState writeStateMask = 0x4 | 0x8 | 0x10 | 0x100 | 0x400 | 0x1000;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	リソースステートの遷移
+     */
+    struct Barrier {
+        ResourceHandle resource_{};  /// 対象のリソース
+        ResourceState  before_{};    /// 遷移前のステート
+        ResourceState  after_{};     /// 遷移後のステート
+    };
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	コンパイル済みのパス
+     */
+    struct CompiledPass {
+        PassHandle           pass_{};      /// 実行するパス
+        std::vector<Barrier> barriers_{};  /// パスの実行前にまとめて発行するバリア
+    };
+
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    コンストラクタ
+     */
+    RenderGraph() = default;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    デストラクタ
+     */
+    ~RenderGraph() = default;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	グラフを空にする
+     */
+    void reset() noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	グラフの外で管理しているリソースを登録する
+     * 外部リソースはグラフの実行後に finalState へ戻され、書き込むパスは削除されない
+     * @param	initialState	グラフ実行前のステート
+     * @param	finalState		グラフ実行後に戻すステート
+     * @return	リソースの識別子
+     */
+    [[nodiscard]] ResourceHandle importResource(ResourceState initialState, ResourceState finalState);
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	グラフの中だけで使うリソースを登録する
+     * @param	initialState	最初に使われる前のステート
+     * @return	リソースの識別子
+     */
+    [[nodiscard]] ResourceHandle createResource(ResourceState initialState);
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	パスを追加する
+     * @param	execute			パスの処理
+     * @param	hasSideEffect	出力が使われなくても削除しない場合は true
+     * @return	パスの識別子
+     */
+    [[nodiscard]] PassHandle addPass(std::function<void()> execute, bool hasSideEffect = false);
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	パスが読み込むリソースを宣言する
+     * @param	pass		パスの識別子
+     * @param	resource	リソースの識別子
+     * @param	state		読み込み時に必要なステート
+     */
+    void read(PassHandle pass, ResourceHandle resource, ResourceState state);
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	パスが書き込むリソースを宣言する
+     * @param	pass		パスの識別子
+     * @param	resource	リソースの識別子
+     * @param	state		書き込み時に必要なステート
+     */
+    void write(PassHandle pass, ResourceHandle resource, ResourceState state);
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	グラフをコンパイルする
+     * 不要なパスの削除、実行順の決定、バリアの計算を行う
+     */
+    void compile();
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	コンパイル済みのパスを実行順に取得する
+     * @return	コンパイル済みのパスの配列
+     */
+    [[nodiscard]] const std::vector<CompiledPass>& compiledPasses() const noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	全パスの実行後に外部リソースを元のステートに戻すバリアを取得する
+     * @return	バリアの配列
+     */
+    [[nodiscard]] const std::vector<Barrier>& finalBarriers() const noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	パスの処理を実行する
+     * @param	pass	パスの識別子
+     */
+    void execute(PassHandle pass) const;
+
+private:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	パスからリソースへのアクセス
+     */
+    struct Access {
+        ResourceHandle resource_{};  /// リソースの識別子
+        ResourceState  state_{};     /// 必要なステート
+        bool           write_{};     /// 書き込みなら true
+    };
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	リソースの情報
+     */
+    struct Resource {
+        ResourceState initialState_{};  /// 初期ステート
+        ResourceState finalState_{};    /// グラフ実行後に戻すステート
+        bool          imported_{};      /// 外部リソースなら true
+    };
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	パスの情報
+     */
+    struct Pass {
+        std::function<void()> execute_{};        /// パスの処理
+        std::vector<Access>   accesses_{};       /// リソースへのアクセス
+        bool                  hasSideEffect_{};  /// 削除しないパスなら true
+    };
+
+private:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	出力が使われないパスを調べる
+     * @return	パス毎の生存フラグ
+     */
+    [[nodiscard]] std::vector<bool> cullPasses() const;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	依存関係を守りつつ、依存するパス同士がなるべく離れるように実行順を決める
+     * @param	alive	パス毎の生存フラグ
+     * @return	実行順に並べたパスの配列
+     */
+    [[nodiscard]] std::vector<PassHandle> schedulePasses(const std::vector<bool>& alive) const;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	実行順にステートを追跡してバリアを計算する
+     * @param	order	実行順に並べたパスの配列
+     */
+    void computeBarriers(const std::vector<PassHandle>& order);
+
+private:
+    std::vector<Resource>     resources_{};      /// 登録されたリソース
+    std::vector<Pass>         passes_{};         /// 登録されたパス
+    std::vector<CompiledPass> compiledPasses_{};  /// コンパイル済みのパス
+    std::vector<Barrier>      finalBarriers_{};   /// 外部リソースを元に戻すバリア
+};
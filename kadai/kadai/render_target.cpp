@@ -26,20 +26,24 @@ RenderTarget::~RenderTarget() {
  * @param	heap		fBXNv^[q[ṽCX^X
  * @return	̐
  */
-[[nodiscard]] bool RenderTarget::createBackBuffer(const Device& device, const SwapChain& swapChain, const DescriptorHeap& heap) noexcept {
+[[nodiscard]] bool RenderTarget::createBackBuffer(const Device& device, const SwapChain& swapChain, DescriptorHeap& heap) noexcept {
     // Xbv`FC̐ݒ擾
     const auto& desc = swapChain.getDesc();
 
     // _[^[Qbg\[X̃TCYݒ
     renderTargets_.resize(desc.BufferCount);
 
-    // fBXNv^[q[ṽnh擾
-    auto handle = heap.get()->GetCPUDescriptorHandleForHeapStart();
-
     // fBXNv^[q[ṽ^Cv擾
     auto heapType = heap.getType();
     assert(heapType == D3D12_DESCRIPTOR_HEAP_TYPE_RTV && "fBXNv^q[ṽ^Cv RTV ł͂܂");
 
+    // obNobt@̃fBXNv^m
+    if (!heap.allocate(desc.BufferCount, rtvHandle_)) {
+        return false;
+    }
+    incrementSize_ = heap.incrementSize();
+    auto handle = rtvHandle_.cpu_;
+
     // obNobt@̐
     for (uint8_t i = 0; i < desc.BufferCount; ++i) {
         const auto hr = swapChain.get()->GetBuffer(i, IID_PPV_ARGS(&renderTargets_[i]));
@@ -52,34 +56,45 @@ RenderTarget::~RenderTarget() {
         device.get()->CreateRenderTargetView(renderTargets_[i], nullptr, handle);
 
         // ̃nhֈړ
-        handle.ptr += device.get()->GetDescriptorHandleIncrementSize(heapType);
+        handle.ptr += incrementSize_;
     }
 
     return true;
 }
 
+//---------------------------------------------------------------------------------
+/**
+ * @brief	obNobt@
+ * Xbv`FC̃TCYύXOɌĂ
+ * r[̃fBXNv^̓t[̊ɍėp̂ŁA蒼̋󂫂q[vɗpӂĂ
+ * @param	heap	r[mۂfBXNv^[q[ṽCX^X
+ */
+void RenderTarget::releaseBackBuffer(DescriptorHeap& heap) noexcept {
+    for (auto& rt : renderTargets_) {
+        if (rt) {
+            rt->Release();
+            rt = nullptr;
+        }
+    }
+    renderTargets_.clear();
+    heap.free(rtvHandle_);
+}
+
 //---------------------------------------------------------------------------------
 /**
  * @brief	r[ifBXNv^nhj擾
- * @param	heap	fBXNv^q[ṽCX^X
  * @param	index	CfbNX
  * @return	fBXNv^nh
  */
-[[nodiscard]] D3D12_CPU_DESCRIPTOR_HANDLE RenderTarget::getCpuDescriptorHandle(const Device& device, const DescriptorHeap& heap, UINT index) const noexcept {
+[[nodiscard]] D3D12_CPU_DESCRIPTOR_HANDLE RenderTarget::getCpuDescriptorHandle(UINT index) const noexcept {
 
     if (index >= renderTargets_.size() || !renderTargets_[index]) {
         assert(false && "sȃ_[^[Qbgł");
     }
 
-    // fBXNv^q[ṽnh擾
-    auto handle = heap.get()->GetCPUDescriptorHandleForHeapStart();
-
-    // fBXNv^q[ṽ^Cv擾
-    auto heapType = heap.getType();
-    assert(heapType == D3D12_DESCRIPTOR_HEAP_TYPE_RTV && "fBXNv^q[ṽ^Cv RTV ł͂܂");
-
-    // CfbNXɉănhړ
-    handle.ptr += index * device.get()->GetDescriptorHandleIncrementSize(heapType);
+    // 쐬ɊmۂfBXNv^̈ʒu߂
+    auto handle = rtvHandle_.cpu_;
+    handle.ptr += static_cast<SIZE_T>(index) * incrementSize_;
     return handle;
 }
 
@@ -34,17 +34,24 @@ public:
      * @param	heap		fBXNv^[q[ṽCX^X
      * @return	̐
      */
-    [[nodiscard]] bool createBackBuffer(const Device& device, const SwapChain& swapChain, const DescriptorHeap& heap) noexcept;
+    [[nodiscard]] bool createBackBuffer(const Device& device, const SwapChain& swapChain, DescriptorHeap& heap) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	obNobt@
+     * Xbv`FC̃TCYύXOɌĂ
+     * r[̃fBXNv^̓t[̊ɍėp̂ŁA蒼̋󂫂q[vɗpӂĂ
+     * @param	heap	r[mۂfBXNv^[q[ṽCX^X
+     */
+    void releaseBackBuffer(DescriptorHeap& heap) noexcept;
 
     //---------------------------------------------------------------------------------
     /**
      * @brief	r[ifBXNv^nhj擾
-     * @param	device	foCXNX̃CX^X
-     * @param	heap	fBXNv^q[ṽCX^X
      * @param	index	CfbNX
      * @return	fBXNv^nh
      */
-    [[nodiscard]] D3D12_CPU_DESCRIPTOR_HANDLE getCpuDescriptorHandle(const Device& device, const DescriptorHeap& heap, UINT index) const noexcept;
+    [[nodiscard]] D3D12_CPU_DESCRIPTOR_HANDLE getCpuDescriptorHandle(UINT index) const noexcept;
 
     //---------------------------------------------------------------------------------
     /**
@@ -56,4 +63,6 @@ public:
 
 private:
     std::vector<ID3D12Resource*> renderTargets_;  /// _[^[Qbg\[X̔z
+    DescriptorHeap::Handle       rtvHandle_{};      /// obNobt@AĊmۂ_[^[Qbgr[
+    UINT                         incrementSize_{};  /// fBXNv^̃TCY
 };
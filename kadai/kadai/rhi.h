@@ -0,0 +1,464 @@
+﻿// レンダリングハードウェアインターフェース
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <span>
+
+/// GPU 仮想アドレス
+using RhiGpuAddress = uint64_t;
+
+/// リソースステート（レンダーグラフと同じく D3D12_RESOURCE_STATES と同じ値をそのまま使う）
+using RhiResourceState = uint32_t;
+
+namespace RhiState {
+    constexpr RhiResourceState common = 0x0;                   /// 共通
+    constexpr RhiResourceState present = 0x0;                  /// 表示
+    constexpr RhiResourceState vertexAndConstantBuffer = 0x1;  /// 頂点バッファと定数バッファ
+    constexpr RhiResourceState indexBuffer = 0x2;              /// インデックスバッファ
+    constexpr RhiResourceState renderTarget = 0x4;             /// レンダーターゲット
+    constexpr RhiResourceState copyDest = 0x400;               /// コピー先
+    constexpr RhiResourceState copySource = 0x800;             /// コピー元
+    constexpr RhiResourceState genericRead = 0xac3;            /// 読み込み全般（アップロードヒープの初期ステート）
+}  // namespace RhiState
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	バッファを置くメモリの種類
+ */
+enum class RhiHeapType : uint8_t {
+    gpu,       /// GPU ローカル（CPU からは書き込めない）
+    upload,    /// CPU から書き込んで GPU が読む
+    readback,  /// GPU が書き込んで CPU が読む
+};
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	コマンドキューの種類
+ */
+enum class RhiQueueType : uint8_t {
+    graphics,  /// 描画
+    copy,      /// 転送
+};
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	ビューポート
+ */
+struct RhiViewport {
+    float x_{};              /// 左上の x 座標
+    float y_{};              /// 左上の y 座標
+    float width_{};          /// 幅
+    float height_{};         /// 高さ
+    float minDepth_{};       /// 深度の最小値
+    float maxDepth_ = 1.0f;  /// 深度の最大値
+};
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	シザー矩形
+ */
+struct RhiRect {
+    int32_t left_{};    /// 左端
+    int32_t top_{};     /// 上端
+    int32_t right_{};   /// 右端（含まない）
+    int32_t bottom_{};  /// 下端（含まない）
+};
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	頂点バッファビュー
+ */
+struct RhiVertexBufferView {
+    RhiGpuAddress address_{};  /// 先頭の GPU アドレス
+    uint32_t      size_{};     /// バッファのサイズ
+    uint32_t      stride_{};   /// 一頂点のサイズ
+};
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	インデックスバッファビュー
+ */
+struct RhiIndexBufferView {
+    RhiGpuAddress address_{};      /// 先頭の GPU アドレス
+    uint32_t      size_{};         /// バッファのサイズ
+    uint32_t      indexSize_ = 2;  /// 一インデックスのサイズ（2 か 4）
+};
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	リソースの基底クラス
+ * バリアの対象として扱えるものはここから派生する
+ */
+class RhiResource {
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    デストラクタ
+     */
+    virtual ~RhiResource() = default;
+
+    RhiResource(const RhiResource&) = delete;
+    RhiResource& operator=(const RhiResource&) = delete;
+
+protected:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    コンストラクタ
+     */
+    RhiResource() = default;
+};
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	バッファ
+ */
+class RhiBuffer : public RhiResource {
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	バッファのサイズを取得する
+     * @return	バッファのサイズ
+     */
+    [[nodiscard]] virtual uint64_t size() const noexcept = 0;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	先頭の GPU アドレスを取得する
+     * @return	GPU アドレス
+     */
+    [[nodiscard]] virtual RhiGpuAddress gpuAddress() const noexcept = 0;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	CPU から読み書きできるようにする
+     * GPU ローカルのバッファは読み書きできないので nullptr を返す
+     * @return	先頭の CPU アドレス
+     */
+    [[nodiscard]] virtual void* map() noexcept = 0;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	CPU からの読み書きを終える
+     */
+    virtual void unmap() noexcept = 0;
+};
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	テクスチャ
+ * 今はスワップチェインのバックバッファのみ
+ */
+class RhiTexture : public RhiResource {
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	幅を取得する
+     * @return	幅
+     */
+    [[nodiscard]] virtual uint32_t width() const noexcept = 0;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	高さを取得する
+     * @return	高さ
+     */
+    [[nodiscard]] virtual uint32_t height() const noexcept = 0;
+};
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	パイプライン
+ * パイプラインステートとルートシグネチャの組。中身はバックエンド毎に異なる
+ */
+class RhiPipeline {
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    デストラクタ
+     */
+    virtual ~RhiPipeline() = default;
+};
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	フェンス
+ */
+class RhiFence {
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    デストラクタ
+     */
+    virtual ~RhiFence() = default;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	GPU が到達済みのフェンス値を取得する
+     * @return	到達済みのフェンス値
+     */
+    [[nodiscard]] virtual uint64_t completedValue() const noexcept = 0;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	GPU がフェンス値に到達するまで CPU で待つ
+     * @param	value	待つフェンス値
+     */
+    virtual void wait(uint64_t value) noexcept = 0;
+};
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	コマンドリスト
+ * 一つのコマンドリストは一つのスレッドからのみ記録すること
+ */
+class RhiCommandList {
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    デストラクタ
+     */
+    virtual ~RhiCommandList() = default;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	記録を開始する
+     * 前回の記録を提出した場合は、GPU がその実行を終えてから呼ぶこと
+     */
+    virtual void reset() noexcept = 0;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	記録を終了する
+     */
+    virtual void close() noexcept = 0;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	リソースステートを遷移させる
+     * @param	resource	対象のリソース
+     * @param	before		遷移前のステート
+     * @param	after		遷移後のステート
+     */
+    virtual void barrier(RhiResource& resource, RhiResourceState before, RhiResourceState after) noexcept = 0;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	レンダーターゲットを設定する
+     * @param	target	レンダーターゲット
+     */
+    virtual void setRenderTarget(RhiTexture& target) noexcept = 0;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	レンダーターゲットを塗りつぶす
+     * @param	target	レンダーターゲット
+     * @param	color	塗りつぶす色（r, g, b, a）
+     */
+    virtual void clearRenderTarget(RhiTexture& target, const float (&color)[4]) noexcept = 0;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	ビューポートを設定する
+     * @param	viewport	ビューポート
+     */
+    virtual void setViewport(const RhiViewport& viewport) noexcept = 0;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	シザー矩形を設定する
+     * @param	rect	シザー矩形
+     */
+    virtual void setScissor(const RhiRect& rect) noexcept = 0;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	パイプラインを設定する
+     * @param	pipeline	パイプライン
+     */
+    virtual void setPipeline(const RhiPipeline& pipeline) noexcept = 0;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	ルート CBV を設定する
+     * @param	parameterIndex	ルートパラメータの番号
+     * @param	address			定数バッファの GPU アドレス
+     */
+    virtual void setConstantBuffer(uint32_t parameterIndex, RhiGpuAddress address) noexcept = 0;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	ルート SRV を設定する
+     * @param	parameterIndex	ルートパラメータの番号
+     * @param	address			バッファの GPU アドレス
+     */
+    virtual void setShaderResource(uint32_t parameterIndex, RhiGpuAddress address) noexcept = 0;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	ルート定数を設定する
+     * @param	parameterIndex	ルートパラメータの番号
+     * @param	value			32bit の値
+     * @param	offset			ルート定数内の位置（32bit 単位）
+     */
+    virtual void setConstant(uint32_t parameterIndex, uint32_t value, uint32_t offset) noexcept = 0;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	頂点バッファを設定する
+     * @param	view	頂点バッファビュー
+     */
+    virtual void setVertexBuffer(const RhiVertexBufferView& view) noexcept = 0;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	インデックスバッファを設定する
+     * @param	view	インデックスバッファビュー
+     */
+    virtual void setIndexBuffer(const RhiIndexBufferView& view) noexcept = 0;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	インデックスを使ってインスタンス描画する
+     * @param	indexCount		インスタンス毎のインデックス数
+     * @param	instanceCount	インスタンスの数
+     * @param	startIndex		先頭インデックスの位置
+     * @param	baseVertex		インデックスに加える頂点の位置
+     * @param	startInstance	先頭インスタンスの番号
+     */
+    virtual void drawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex, int32_t baseVertex, uint32_t startInstance) noexcept = 0;
+};
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	コマンドキュー
+ */
+class RhiQueue {
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    デストラクタ
+     */
+    virtual ~RhiQueue() = default;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	記録を終えたコマンドリストを並び順に実行する
+     * @param	commandLists	実行するコマンドリスト
+     */
+    virtual void execute(std::span<RhiCommandList* const> commandLists) noexcept = 0;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	ここまでの実行が終わったらフェンスに値を書き込む
+     * @param	fence	書き込むフェンス
+     * @param	value	書き込む値
+     */
+    virtual void signal(RhiFence& fence, uint64_t value) noexcept = 0;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	フェンスが値に到達するまで以降の実行を GPU 側で待たせる
+     * @param	fence	待つフェンス
+     * @param	value	待つ値
+     */
+    virtual void wait(RhiFence& fence, uint64_t value) noexcept = 0;
+};
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	スワップチェイン
+ */
+class RhiSwapChain {
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    デストラクタ
+     */
+    virtual ~RhiSwapChain() = default;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	バックバッファの数を取得する
+     * @return	バックバッファの数
+     */
+    [[nodiscard]] virtual uint32_t bufferCount() const noexcept = 0;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	今回描画するバックバッファの番号を取得する
+     * @return	バックバッファの番号
+     */
+    [[nodiscard]] virtual uint32_t currentIndex() const noexcept = 0;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	バックバッファを取得する
+     * @param	index	バックバッファの番号
+     * @return	バックバッファ
+     */
+    [[nodiscard]] virtual RhiTexture& backBuffer(uint32_t index) noexcept = 0;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	今回のバックバッファを表示する
+     * @param	syncInterval	垂直同期の間隔（0 なら待たない）
+     */
+    virtual void present(uint32_t syncInterval) noexcept = 0;
+};
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	デバイス
+ * リソースとコマンドリストの作成、キューとスワップチェインの取得を行う
+ */
+class RhiDevice {
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    デストラクタ
+     */
+    virtual ~RhiDevice() = default;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	バッファを作成する
+     * 初期ステートはメモリの種類で決まる（gpu は common、upload は genericRead、readback は copyDest）
+     * @param	heapType	バッファを置くメモリの種類
+     * @param	size		バッファのサイズ
+     * @return	作成したバッファ、失敗した場合は nullptr
+     */
+    [[nodiscard]] virtual std::unique_ptr<RhiBuffer> createBuffer(RhiHeapType heapType, uint64_t size) noexcept = 0;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	フェンスを作成する
+     * @return	作成したフェンス、失敗した場合は nullptr
+     */
+    [[nodiscard]] virtual std::unique_ptr<RhiFence> createFence() noexcept = 0;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	コマンドリストを作成する
+     * 作成直後は記録を終えた状態なので、記録前に reset を呼ぶこと
+     * @param	queueType	提出するキューの種類
+     * @return	作成したコマンドリスト、失敗した場合は nullptr
+     */
+    [[nodiscard]] virtual std::unique_ptr<RhiCommandList> createCommandList(RhiQueueType queueType) noexcept = 0;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	コマンドキューを取得する
+     * @param	queueType	キューの種類
+     * @return	コマンドキュー
+     */
+    [[nodiscard]] virtual RhiQueue& queue(RhiQueueType queueType) noexcept = 0;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	スワップチェインを取得する
+     * @return	スワップチェイン
+     */
+    [[nodiscard]] virtual RhiSwapChain& swapChain() noexcept = 0;
+};
@@ -0,0 +1,660 @@
+﻿// D3D12 デバイスクラス
+
+#include "rhi_d3d12.h"
+#include <cassert>
+
+namespace {
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	メモリの種類を D3D12 のヒープの種類に変換する
+     * @param	heapType	メモリの種類
+     * @return	ヒープの種類
+     */
+    [[nodiscard]] D3D12_HEAP_TYPE toD3D12(RhiHeapType heapType) noexcept {
+        switch (heapType) {
+            case RhiHeapType::upload:
+                return D3D12_HEAP_TYPE_UPLOAD;
+            case RhiHeapType::readback:
+                return D3D12_HEAP_TYPE_READBACK;
+            default:
+                return D3D12_HEAP_TYPE_DEFAULT;
+        }
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	メモリの種類に対応する初期ステートを取得する
+     * @param	heapType	メモリの種類
+     * @return	初期ステート
+     */
+    [[nodiscard]] D3D12_RESOURCE_STATES initialState(RhiHeapType heapType) noexcept {
+        switch (heapType) {
+            case RhiHeapType::upload:
+                return D3D12_RESOURCE_STATE_GENERIC_READ;
+            case RhiHeapType::readback:
+                return D3D12_RESOURCE_STATE_COPY_DEST;
+            default:
+                return D3D12_RESOURCE_STATE_COMMON;
+        }
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	リソースから ID3D12Resource を取り出す
+     * @param	resource	リソース（D3D12 のバッファかテクスチャ）
+     * @return	ID3D12Resource
+     */
+    [[nodiscard]] ID3D12Resource* nativeResource(RhiResource& resource) noexcept {
+        if (auto* texture = dynamic_cast<RhiD3D12Texture*>(&resource)) {
+            return texture->get();
+        }
+        if (auto* buffer = dynamic_cast<RhiD3D12Buffer*>(&resource)) {
+            return buffer->get();
+        }
+        assert(false && "D3D12 のリソースではありません");
+        return nullptr;
+    }
+}  // namespace
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief    コンストラクタ
+ * @param	memoryAllocator	確保した GPU メモリアロケータ
+ * @param	allocation		確保したリソース
+ * @param	size			バッファのサイズ
+ */
+RhiD3D12Buffer::RhiD3D12Buffer(GpuMemoryAllocator& memoryAllocator, const GpuMemoryAllocator::Allocation& allocation, uint64_t size) noexcept
+    : memoryAllocator_(&memoryAllocator), allocation_(allocation), size_(size) {
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief    デストラクタ
+ */
+RhiD3D12Buffer::~RhiD3D12Buffer() {
+    // GPU が参照中の可能性があるので、解放はフレームの完了まで遅らせる
+    memoryAllocator_->free(allocation_);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	バッファのサイズを取得する
+ * @return	バッファのサイズ
+ */
+[[nodiscard]] uint64_t RhiD3D12Buffer::size() const noexcept {
+    return size_;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	先頭の GPU アドレスを取得する
+ * @return	GPU アドレス
+ */
+[[nodiscard]] RhiGpuAddress RhiD3D12Buffer::gpuAddress() const noexcept {
+    return allocation_.resource_->GetGPUVirtualAddress();
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	CPU から読み書きできるようにする
+ * @return	先頭の CPU アドレス、GPU ローカルのバッファは nullptr
+ */
+[[nodiscard]] void* RhiD3D12Buffer::map() noexcept {
+    if (allocation_.heapType_ == D3D12_HEAP_TYPE_DEFAULT) {
+        assert(false && "GPU ローカルのバッファはマップできません");
+        return nullptr;
+    }
+
+    void* data{};
+    if (FAILED(allocation_.resource_->Map(0, nullptr, &data))) {
+        assert(false && "バッファのマップに失敗しました");
+        return nullptr;
+    }
+    return data;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	CPU からの読み書きを終える
+ */
+void RhiD3D12Buffer::unmap() noexcept {
+    allocation_.resource_->Unmap(0, nullptr);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	リソースを取得する
+ * @return	リソース
+ */
+[[nodiscard]] ID3D12Resource* RhiD3D12Buffer::get() const noexcept {
+    return allocation_.resource_;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief    コンストラクタ
+ * @param	resource	リソース
+ * @param	rtvHandle	レンダーターゲットビューのハンドル
+ */
+RhiD3D12Texture::RhiD3D12Texture(ID3D12Resource* resource, D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle) noexcept
+    : resource_(resource), rtvHandle_(rtvHandle) {
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	幅を取得する
+ * @return	幅
+ */
+[[nodiscard]] uint32_t RhiD3D12Texture::width() const noexcept {
+    return static_cast<uint32_t>(resource_->GetDesc().Width);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	高さを取得する
+ * @return	高さ
+ */
+[[nodiscard]] uint32_t RhiD3D12Texture::height() const noexcept {
+    return resource_->GetDesc().Height;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	リソースを取得する
+ * @return	リソース
+ */
+[[nodiscard]] ID3D12Resource* RhiD3D12Texture::get() const noexcept {
+    return resource_;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	レンダーターゲットビューのハンドルを取得する
+ * @return	ハンドル
+ */
+[[nodiscard]] D3D12_CPU_DESCRIPTOR_HANDLE RhiD3D12Texture::rtvHandle() const noexcept {
+    return rtvHandle_;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief    コンストラクタ
+ * @param	pipelineState	パイプラインステート
+ * @param	rootSignature	ルートシグネチャ
+ */
+RhiD3D12Pipeline::RhiD3D12Pipeline(ID3D12PipelineState* pipelineState, ID3D12RootSignature* rootSignature) noexcept
+    : pipelineState_(pipelineState), rootSignature_(rootSignature) {
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	パイプラインステートを取得する
+ * @return	パイプラインステート
+ */
+[[nodiscard]] ID3D12PipelineState* RhiD3D12Pipeline::pipelineState() const noexcept {
+    return pipelineState_;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	ルートシグネチャを取得する
+ * @return	ルートシグネチャ
+ */
+[[nodiscard]] ID3D12RootSignature* RhiD3D12Pipeline::rootSignature() const noexcept {
+    return rootSignature_;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	フェンスを作成する
+ * @param	device	デバイスクラスのインスタンス
+ * @return	生成の成否
+ */
+[[nodiscard]] bool RhiD3D12Fence::create(const Device& device) noexcept {
+    return fence_.create(device);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	GPU が到達済みのフェンス値を取得する
+ * @return	到達済みのフェンス値
+ */
+[[nodiscard]] uint64_t RhiD3D12Fence::completedValue() const noexcept {
+    return fence_.get()->GetCompletedValue();
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	GPU がフェンス値に到達するまで CPU で待つ
+ * @param	value	待つフェンス値
+ */
+void RhiD3D12Fence::wait(uint64_t value) noexcept {
+    fence_.wait(value);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	フェンスを取得する
+ * @return	フェンス
+ */
+[[nodiscard]] ID3D12Fence* RhiD3D12Fence::get() const noexcept {
+    return fence_.get();
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	コマンドアロケータとコマンドリストを作成する
+ * @param	device	デバイスクラスのインスタンス
+ * @param	type	コマンドリストの種類
+ * @return	生成の成否
+ */
+[[nodiscard]] bool RhiD3D12CommandList::create(const Device& device, D3D12_COMMAND_LIST_TYPE type) noexcept {
+    if (!commandAllocator_.create(device, type)) {
+        return false;
+    }
+    if (!commandList_.create(device, commandAllocator_)) {
+        return false;
+    }
+    target_ = commandList_.get();
+    return true;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	既存の記録中のコマンドリストに記録するようにする
+ * @param	commandList	記録先のコマンドリスト
+ */
+void RhiD3D12CommandList::attach(const CommandList& commandList) noexcept {
+    target_ = commandList.get();
+    rootSignature_ = nullptr;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	記録を開始する
+ */
+void RhiD3D12CommandList::reset() noexcept {
+    if (target_ != commandList_.get()) {
+        assert(false && "既存のコマンドリストに記録している場合はリセットできません");
+        return;
+    }
+    commandAllocator_.reset();
+    commandList_.reset(commandAllocator_);
+    rootSignature_ = nullptr;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	記録を終了する
+ */
+void RhiD3D12CommandList::close() noexcept {
+    target_->Close();
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	リソースステートを遷移させる
+ * @param	resource	対象のリソース
+ * @param	before		遷移前のステート
+ * @param	after		遷移後のステート
+ */
+void RhiD3D12CommandList::barrier(RhiResource& resource, RhiResourceState before, RhiResourceState after) noexcept {
+    D3D12_RESOURCE_BARRIER barrier{};
+    barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+    barrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+    barrier.Transition.pResource = nativeResource(resource);
+    barrier.Transition.StateBefore = static_cast<D3D12_RESOURCE_STATES>(before);
+    barrier.Transition.StateAfter = static_cast<D3D12_RESOURCE_STATES>(after);
+    barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+    target_->ResourceBarrier(1, &barrier);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	レンダーターゲットを設定する
+ * @param	target	レンダーターゲット
+ */
+void RhiD3D12CommandList::setRenderTarget(RhiTexture& target) noexcept {
+    const auto rtvHandle = static_cast<RhiD3D12Texture&>(target).rtvHandle();
+    target_->OMSetRenderTargets(1, &rtvHandle, false, nullptr);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	レンダーターゲットを塗りつぶす
+ * @param	target	レンダーターゲット
+ * @param	color	塗りつぶす色
+ */
+void RhiD3D12CommandList::clearRenderTarget(RhiTexture& target, const float (&color)[4]) noexcept {
+    target_->ClearRenderTargetView(static_cast<RhiD3D12Texture&>(target).rtvHandle(), color, 0, nullptr);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	ビューポートを設定する
+ * @param	viewport	ビューポート
+ */
+void RhiD3D12CommandList::setViewport(const RhiViewport& viewport) noexcept {
+    D3D12_VIEWPORT d3d12Viewport{};
+    d3d12Viewport.TopLeftX = viewport.x_;
+    d3d12Viewport.TopLeftY = viewport.y_;
+    d3d12Viewport.Width = viewport.width_;
+    d3d12Viewport.Height = viewport.height_;
+    d3d12Viewport.MinDepth = viewport.minDepth_;
+    d3d12Viewport.MaxDepth = viewport.maxDepth_;
+    target_->RSSetViewports(1, &d3d12Viewport);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	シザー矩形を設定する
+ * @param	rect	シザー矩形
+ */
+void RhiD3D12CommandList::setScissor(const RhiRect& rect) noexcept {
+    D3D12_RECT d3d12Rect{};
+    d3d12Rect.left = rect.left_;
+    d3d12Rect.top = rect.top_;
+    d3d12Rect.right = rect.right_;
+    d3d12Rect.bottom = rect.bottom_;
+    target_->RSSetScissorRects(1, &d3d12Rect);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	パイプラインを設定する
+ * ルートシグネチャは変わった時だけ設定し直す（設定し直すとルートパラメータが全て無効になるため）
+ * @param	pipeline	パイプライン
+ */
+void RhiD3D12CommandList::setPipeline(const RhiPipeline& pipeline) noexcept {
+    const auto& d3d12Pipeline = static_cast<const RhiD3D12Pipeline&>(pipeline);
+    if (rootSignature_ != d3d12Pipeline.rootSignature()) {
+        rootSignature_ = d3d12Pipeline.rootSignature();
+        target_->SetGraphicsRootSignature(rootSignature_);
+    }
+    target_->SetPipelineState(d3d12Pipeline.pipelineState());
+    target_->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	ルート CBV を設定する
+ * @param	parameterIndex	ルートパラメータの番号
+ * @param	address			定数バッファの GPU アドレス
+ */
+void RhiD3D12CommandList::setConstantBuffer(uint32_t parameterIndex, RhiGpuAddress address) noexcept {
+    target_->SetGraphicsRootConstantBufferView(parameterIndex, address);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	ルート SRV を設定する
+ * @param	parameterIndex	ルートパラメータの番号
+ * @param	address			バッファの GPU アドレス
+ */
+void RhiD3D12CommandList::setShaderResource(uint32_t parameterIndex, RhiGpuAddress address) noexcept {
+    target_->SetGraphicsRootShaderResourceView(parameterIndex, address);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	ルート定数を設定する
+ * @param	parameterIndex	ルートパラメータの番号
+ * @param	value			32bit の値
+ * @param	offset			ルート定数内の位置
+ */
+void RhiD3D12CommandList::setConstant(uint32_t parameterIndex, uint32_t value, uint32_t offset) noexcept {
+    target_->SetGraphicsRoot32BitConstant(parameterIndex, value, offset);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	頂点バッファを設定する
+ * @param	view	頂点バッファビュー
+ */
+void RhiD3D12CommandList::setVertexBuffer(const RhiVertexBufferView& view) noexcept {
+    D3D12_VERTEX_BUFFER_VIEW vertexBufferView{};
+    vertexBufferView.BufferLocation = view.address_;
+    vertexBufferView.SizeInBytes = view.size_;
+    vertexBufferView.StrideInBytes = view.stride_;
+    target_->IASetVertexBuffers(0, 1, &vertexBufferView);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	インデックスバッファを設定する
+ * @param	view	インデックスバッファビュー
+ */
+void RhiD3D12CommandList::setIndexBuffer(const RhiIndexBufferView& view) noexcept {
+    D3D12_INDEX_BUFFER_VIEW indexBufferView{};
+    indexBufferView.BufferLocation = view.address_;
+    indexBufferView.SizeInBytes = view.size_;
+    indexBufferView.Format = view.indexSize_ == 4 ? DXGI_FORMAT_R32_UINT : DXGI_FORMAT_R16_UINT;
+    target_->IASetIndexBuffer(&indexBufferView);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	インデックスを使ってインスタンス描画する
+ * @param	indexCount		インスタンス毎のインデックス数
+ * @param	instanceCount	インスタンスの数
+ * @param	startIndex		先頭インデックスの位置
+ * @param	baseVertex		インデックスに加える頂点の位置
+ * @param	startInstance	先頭インスタンスの番号
+ */
+void RhiD3D12CommandList::drawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex, int32_t baseVertex, uint32_t startInstance) noexcept {
+    target_->DrawIndexedInstanced(indexCount, instanceCount, startIndex, baseVertex, startInstance);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	記録先のコマンドリストを取得する
+ * @return	コマンドリスト
+ */
+[[nodiscard]] ID3D12GraphicsCommandList* RhiD3D12CommandList::get() const noexcept {
+    return target_;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	コマンドキューを作成する
+ * @param	device	デバイスクラスのインスタンス
+ * @param	type	コマンドリストの種類
+ * @return	生成の成否
+ */
+[[nodiscard]] bool RhiD3D12Queue::create(const Device& device, D3D12_COMMAND_LIST_TYPE type) noexcept {
+    if (!commandQueue_.create(device, type)) {
+        return false;
+    }
+    queue_ = commandQueue_.get();
+    return true;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	既存のコマンドキューを使うようにする
+ * @param	commandQueue	コマンドキュー
+ */
+void RhiD3D12Queue::attach(const CommandQueue& commandQueue) noexcept {
+    queue_ = commandQueue.get();
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	記録を終えたコマンドリストを並び順に実行する
+ * @param	commandLists	実行するコマンドリスト
+ */
+void RhiD3D12Queue::execute(std::span<RhiCommandList* const> commandLists) noexcept {
+    lists_.clear();
+    for (auto* commandList : commandLists) {
+        lists_.push_back(static_cast<RhiD3D12CommandList*>(commandList)->get());
+    }
+    queue_->ExecuteCommandLists(static_cast<UINT>(lists_.size()), lists_.data());
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	ここまでの実行が終わったらフェンスに値を書き込む
+ * @param	fence	書き込むフェンス
+ * @param	value	書き込む値
+ */
+void RhiD3D12Queue::signal(RhiFence& fence, uint64_t value) noexcept {
+    queue_->Signal(static_cast<RhiD3D12Fence&>(fence).get(), value);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	フェンスが値に到達するまで以降の実行を GPU 側で待たせる
+ * @param	fence	待つフェンス
+ * @param	value	待つ値
+ */
+void RhiD3D12Queue::wait(RhiFence& fence, uint64_t value) noexcept {
+    queue_->Wait(static_cast<RhiD3D12Fence&>(fence).get(), value);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	スワップチェインとバックバッファを使うようにする
+ * @param	swapChain		スワップチェイン
+ * @param	renderTarget	バックバッファのレンダーターゲット
+ */
+void RhiD3D12SwapChain::attach(const SwapChain& swapChain, const RenderTarget& renderTarget) noexcept {
+    swapChain_ = &swapChain;
+
+    backBuffers_.clear();
+    for (UINT i = 0; i < swapChain.getDesc().BufferCount; ++i) {
+        backBuffers_.push_back(std::make_unique<RhiD3D12Texture>(renderTarget.get(i), renderTarget.getCpuDescriptorHandle(i)));
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	バックバッファの数を取得する
+ * @return	バックバッファの数
+ */
+[[nodiscard]] uint32_t RhiD3D12SwapChain::bufferCount() const noexcept {
+    return static_cast<uint32_t>(backBuffers_.size());
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	今回描画するバックバッファの番号を取得する
+ * @return	バックバッファの番号
+ */
+[[nodiscard]] uint32_t RhiD3D12SwapChain::currentIndex() const noexcept {
+    return swapChain_->get()->GetCurrentBackBufferIndex();
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	バックバッファを取得する
+ * @param	index	バックバッファの番号
+ * @return	バックバッファ
+ */
+[[nodiscard]] RhiTexture& RhiD3D12SwapChain::backBuffer(uint32_t index) noexcept {
+    assert(index < backBuffers_.size() && "バックバッファの番号が範囲外です");
+    return *backBuffers_[index];
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	今回のバックバッファを表示する
+ * @param	syncInterval	垂直同期の間隔
+ */
+void RhiD3D12SwapChain::present(uint32_t syncInterval) noexcept {
+    swapChain_->get()->Present(syncInterval, 0);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	D3D12 デバイスを作成する
+ * @param	device			デバイスクラスのインスタンス
+ * @param	graphicsQueue	描画キュー
+ * @param	swapChain		スワップチェイン
+ * @param	renderTarget	バックバッファのレンダーターゲット
+ * @param	memoryAllocator	バッファの確保に使う GPU メモリアロケータ
+ * @return	生成の成否
+ */
+[[nodiscard]] bool RhiD3D12Device::create(const Device& device, const CommandQueue& graphicsQueue, const SwapChain& swapChain, const RenderTarget& renderTarget, GpuMemoryAllocator& memoryAllocator) noexcept {
+    device_ = &device;
+    memoryAllocator_ = &memoryAllocator;
+
+    graphicsQueue_.attach(graphicsQueue);
+    if (!copyQueue_.create(device, D3D12_COMMAND_LIST_TYPE_COPY)) {
+        return false;
+    }
+    swapChain_.attach(swapChain, renderTarget);
+    return true;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	作り直したバックバッファを使うようにする
+ * スワップチェインのサイズを変更した後に呼ぶ（以前のバックバッファのテクスチャは破棄される）
+ * @param	swapChain		スワップチェイン
+ * @param	renderTarget	バックバッファのレンダーターゲット
+ */
+void RhiD3D12Device::attachSwapChain(const SwapChain& swapChain, const RenderTarget& renderTarget) noexcept {
+    swapChain_.attach(swapChain, renderTarget);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	バッファを作成する
+ * @param	heapType	バッファを置くメモリの種類
+ * @param	size		バッファのサイズ
+ * @return	作成したバッファ、失敗した場合は nullptr
+ */
+[[nodiscard]] std::unique_ptr<RhiBuffer> RhiD3D12Device::createBuffer(RhiHeapType heapType, uint64_t size) noexcept {
+    GpuMemoryAllocator::Allocation allocation{};
+    if (!memoryAllocator_->createBuffer(toD3D12(heapType), size, initialState(heapType), allocation)) {
+        return nullptr;
+    }
+    return std::make_unique<RhiD3D12Buffer>(*memoryAllocator_, allocation, size);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	フェンスを作成する
+ * @return	作成したフェンス、失敗した場合は nullptr
+ */
+[[nodiscard]] std::unique_ptr<RhiFence> RhiD3D12Device::createFence() noexcept {
+    auto fence = std::make_unique<RhiD3D12Fence>();
+    if (!fence->create(*device_)) {
+        return nullptr;
+    }
+    return fence;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	コマンドリストを作成する
+ * @param	queueType	提出するキューの種類
+ * @return	作成したコマンドリスト、失敗した場合は nullptr
+ */
+[[nodiscard]] std::unique_ptr<RhiCommandList> RhiD3D12Device::createCommandList(RhiQueueType queueType) noexcept {
+    auto commandList = std::make_unique<RhiD3D12CommandList>();
+    const auto type = queueType == RhiQueueType::copy ? D3D12_COMMAND_LIST_TYPE_COPY : D3D12_COMMAND_LIST_TYPE_DIRECT;
+    if (!commandList->create(*device_, type)) {
+        return nullptr;
+    }
+    return commandList;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	コマンドキューを取得する
+ * @param	queueType	キューの種類
+ * @return	コマンドキュー
+ */
+[[nodiscard]] RhiQueue& RhiD3D12Device::queue(RhiQueueType queueType) noexcept {
+    return queueType == RhiQueueType::copy ? copyQueue_ : graphicsQueue_;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	スワップチェインを取得する
+ * @return	スワップチェイン
+ */
+[[nodiscard]] RhiSwapChain& RhiD3D12Device::swapChain() noexcept {
+    return swapChain_;
+}
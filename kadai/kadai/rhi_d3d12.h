@@ -0,0 +1,338 @@
+﻿// D3D12 デバイスクラス
+
+#pragma once
+
+#include "rhi.h"
+#include "device.h"
+#include "command_allocator.h"
+#include "command_list.h"
+#include "command_queue.h"
+#include "fence.h"
+#include "swap_chain.h"
+#include "render_target.h"
+#include "gpu_memory_allocator.h"
+#include <memory>
+#include <vector>
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	D3D12 のバッファ
+ * GPU メモリアロケータから確保し、破棄は GPU の完了まで遅らせる
+ */
+class RhiD3D12Buffer final : public RhiBuffer {
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    コンストラクタ
+     * @param	memoryAllocator	確保した GPU メモリアロケータ
+     * @param	allocation		確保したリソース
+     * @param	size			バッファのサイズ
+     */
+    RhiD3D12Buffer(GpuMemoryAllocator& memoryAllocator, const GpuMemoryAllocator::Allocation& allocation, uint64_t size) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    デストラクタ
+     */
+    ~RhiD3D12Buffer() override;
+
+    [[nodiscard]] uint64_t      size() const noexcept override;
+    [[nodiscard]] RhiGpuAddress gpuAddress() const noexcept override;
+    [[nodiscard]] void*         map() noexcept override;
+    void                        unmap() noexcept override;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	リソースを取得する
+     * @return	リソース
+     */
+    [[nodiscard]] ID3D12Resource* get() const noexcept;
+
+private:
+    GpuMemoryAllocator*            memoryAllocator_{};  /// 確保した GPU メモリアロケータ
+    GpuMemoryAllocator::Allocation allocation_{};       /// 確保したリソース
+    uint64_t                       size_{};             /// バッファのサイズ
+};
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	D3D12 のテクスチャ
+ * リソースとレンダーターゲットビューは所有しない
+ */
+class RhiD3D12Texture final : public RhiTexture {
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    コンストラクタ
+     * @param	resource	リソース
+     * @param	rtvHandle	レンダーターゲットビューのハンドル
+     */
+    RhiD3D12Texture(ID3D12Resource* resource, D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle) noexcept;
+
+    [[nodiscard]] uint32_t width() const noexcept override;
+    [[nodiscard]] uint32_t height() const noexcept override;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	リソースを取得する
+     * @return	リソース
+     */
+    [[nodiscard]] ID3D12Resource* get() const noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	レンダーターゲットビューのハンドルを取得する
+     * @return	ハンドル
+     */
+    [[nodiscard]] D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle() const noexcept;
+
+private:
+    ID3D12Resource*             resource_{};   /// リソース
+    D3D12_CPU_DESCRIPTOR_HANDLE rtvHandle_{};  /// レンダーターゲットビューのハンドル
+};
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	D3D12 のパイプライン
+ * パイプラインステートとルートシグネチャは所有しない
+ */
+class RhiD3D12Pipeline final : public RhiPipeline {
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    コンストラクタ
+     */
+    RhiD3D12Pipeline() = default;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    コンストラクタ
+     * @param	pipelineState	パイプラインステート
+     * @param	rootSignature	ルートシグネチャ
+     */
+    RhiD3D12Pipeline(ID3D12PipelineState* pipelineState, ID3D12RootSignature* rootSignature) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	パイプラインステートを取得する
+     * @return	パイプラインステート
+     */
+    [[nodiscard]] ID3D12PipelineState* pipelineState() const noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	ルートシグネチャを取得する
+     * @return	ルートシグネチャ
+     */
+    [[nodiscard]] ID3D12RootSignature* rootSignature() const noexcept;
+
+private:
+    ID3D12PipelineState* pipelineState_{};  /// パイプラインステート
+    ID3D12RootSignature* rootSignature_{};  /// ルートシグネチャ
+};
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	D3D12 のフェンス
+ */
+class RhiD3D12Fence final : public RhiFence {
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	フェンスを作成する
+     * @param	device	デバイスクラスのインスタンス
+     * @return	生成の成否
+     */
+    [[nodiscard]] bool create(const Device& device) noexcept;
+
+    [[nodiscard]] uint64_t completedValue() const noexcept override;
+    void                   wait(uint64_t value) noexcept override;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	フェンスを取得する
+     * @return	フェンス
+     */
+    [[nodiscard]] ID3D12Fence* get() const noexcept;
+
+private:
+    Fence fence_{};  /// フェンス
+};
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	D3D12 のコマンドリスト
+ * 自身でコマンドアロケータとコマンドリストを持つ場合と、既存のコマンドリストに記録する場合がある
+ */
+class RhiD3D12CommandList final : public RhiCommandList {
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    コンストラクタ
+     */
+    RhiD3D12CommandList() = default;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    デストラクタ
+     */
+    ~RhiD3D12CommandList() override = default;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	コマンドアロケータとコマンドリストを作成する
+     * @param	device	デバイスクラスのインスタンス
+     * @param	type	コマンドリストの種類
+     * @return	生成の成否
+     */
+    [[nodiscard]] bool create(const Device& device, D3D12_COMMAND_LIST_TYPE type) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	既存の記録中のコマンドリストに記録するようにする
+     * リセットと提出は呼び出し側で行うので、reset は呼ばないこと
+     * @param	commandList	記録先のコマンドリスト
+     */
+    void attach(const CommandList& commandList) noexcept;
+
+    void reset() noexcept override;
+    void close() noexcept override;
+    void barrier(RhiResource& resource, RhiResourceState before, RhiResourceState after) noexcept override;
+    void setRenderTarget(RhiTexture& target) noexcept override;
+    void clearRenderTarget(RhiTexture& target, const float (&color)[4]) noexcept override;
+    void setViewport(const RhiViewport& viewport) noexcept override;
+    void setScissor(const RhiRect& rect) noexcept override;
+    void setPipeline(const RhiPipeline& pipeline) noexcept override;
+    void setConstantBuffer(uint32_t parameterIndex, RhiGpuAddress address) noexcept override;
+    void setShaderResource(uint32_t parameterIndex, RhiGpuAddress address) noexcept override;
+    void setConstant(uint32_t parameterIndex, uint32_t value, uint32_t offset) noexcept override;
+    void setVertexBuffer(const RhiVertexBufferView& view) noexcept override;
+    void setIndexBuffer(const RhiIndexBufferView& view) noexcept override;
+    void drawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex, int32_t baseVertex, uint32_t startInstance) noexcept override;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	記録先のコマンドリストを取得する
+     * @return	コマンドリスト
+     */
+    [[nodiscard]] ID3D12GraphicsCommandList* get() const noexcept;
+
+private:
+    CommandAllocator           commandAllocator_{};  /// 自身で作成したコマンドアロケータ
+    CommandList                commandList_{};       /// 自身で作成したコマンドリスト
+    ID3D12GraphicsCommandList* target_{};            /// 記録先のコマンドリスト
+    ID3D12RootSignature*       rootSignature_{};     /// 設定中のルートシグネチャ
+};
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	D3D12 のコマンドキュー
+ * 既存のコマンドキューを使う場合と、自身で作成する場合がある
+ */
+class RhiD3D12Queue final : public RhiQueue {
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	コマンドキューを作成する
+     * @param	device	デバイスクラスのインスタンス
+     * @param	type	コマンドリストの種類
+     * @return	生成の成否
+     */
+    [[nodiscard]] bool create(const Device& device, D3D12_COMMAND_LIST_TYPE type) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	既存のコマンドキューを使うようにする
+     * @param	commandQueue	コマンドキュー
+     */
+    void attach(const CommandQueue& commandQueue) noexcept;
+
+    void execute(std::span<RhiCommandList* const> commandLists) noexcept override;
+    void signal(RhiFence& fence, uint64_t value) noexcept override;
+    void wait(RhiFence& fence, uint64_t value) noexcept override;
+
+private:
+    CommandQueue                    commandQueue_{};  /// 自身で作成したコマンドキュー
+    ID3D12CommandQueue*             queue_{};         /// 使うコマンドキュー
+    std::vector<ID3D12CommandList*> lists_{};         /// 提出するコマンドリストの作業領域
+};
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	D3D12 のスワップチェイン
+ * スワップチェインとレンダーターゲットは所有しない
+ */
+class RhiD3D12SwapChain final : public RhiSwapChain {
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	スワップチェインとバックバッファを使うようにする
+     * @param	swapChain		スワップチェイン
+     * @param	renderTarget	バックバッファのレンダーターゲット
+     */
+    void attach(const SwapChain& swapChain, const RenderTarget& renderTarget) noexcept;
+
+    [[nodiscard]] uint32_t    bufferCount() const noexcept override;
+    [[nodiscard]] uint32_t    currentIndex() const noexcept override;
+    [[nodiscard]] RhiTexture& backBuffer(uint32_t index) noexcept override;
+    void                      present(uint32_t syncInterval) noexcept override;
+
+private:
+    const SwapChain*                              swapChain_{};    /// スワップチェイン
+    std::vector<std::unique_ptr<RhiD3D12Texture>> backBuffers_{};  /// バックバッファ
+};
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	D3D12 デバイスクラス
+ * 既存のデバイス・描画キュー・スワップチェインをレンダリングハードウェアインターフェースとして使えるようにする
+ */
+class RhiD3D12Device final : public RhiDevice {
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    コンストラクタ
+     */
+    RhiD3D12Device() = default;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    デストラクタ
+     */
+    ~RhiD3D12Device() override = default;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	D3D12 デバイスを作成する
+     * 転送キューは自身で作成し、それ以外は渡したものを使う
+     * @param	device			デバイスクラスのインスタンス
+     * @param	graphicsQueue	描画キュー
+     * @param	swapChain		スワップチェイン
+     * @param	renderTarget	バックバッファのレンダーターゲット
+     * @param	memoryAllocator	バッファの確保に使う GPU メモリアロケータ
+     * @return	生成の成否
+     */
+    [[nodiscard]] bool create(const Device& device, const CommandQueue& graphicsQueue, const SwapChain& swapChain, const RenderTarget& renderTarget, GpuMemoryAllocator& memoryAllocator) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	作り直したバックバッファを使うようにする
+     * スワップチェインのサイズを変更した後に呼ぶ（以前のバックバッファのテクスチャは破棄される）
+     * @param	swapChain		スワップチェイン
+     * @param	renderTarget	バックバッファのレンダーターゲット
+     */
+    void attachSwapChain(const SwapChain& swapChain, const RenderTarget& renderTarget) noexcept;
+
+    [[nodiscard]] std::unique_ptr<RhiBuffer>      createBuffer(RhiHeapType heapType, uint64_t size) noexcept override;
+    [[nodiscard]] std::unique_ptr<RhiFence>       createFence() noexcept override;
+    [[nodiscard]] std::unique_ptr<RhiCommandList> createCommandList(RhiQueueType queueType) noexcept override;
+    [[nodiscard]] RhiQueue&                       queue(RhiQueueType queueType) noexcept override;
+    [[nodiscard]] RhiSwapChain&                   swapChain() noexcept override;
+
+private:
+    const Device*       device_{};           /// デバイス
+    GpuMemoryAllocator* memoryAllocator_{};  /// バッファの確保に使う GPU メモリアロケータ
+    RhiD3D12Queue       graphicsQueue_{};    /// 描画キュー
+    RhiD3D12Queue       copyQueue_{};        /// 転送キュー
+    RhiD3D12SwapChain   swapChain_{};        /// スワップチェイン
+};
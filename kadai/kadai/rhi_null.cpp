@@ -0,0 +1,944 @@
+﻿// ヌルデバイスクラス
+
+#include "rhi_null.h"
+#include <algorithm>
+#include <cassert>
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	別の統計情報を加える
+ * @param	other	加える統計情報
+ * @return	自身
+ */
+RhiNullStatistics& RhiNullStatistics::operator+=(const RhiNullStatistics& other) noexcept {
+    drawCount_ += other.drawCount_;
+    instanceCount_ += other.instanceCount_;
+    indexCount_ += other.indexCount_;
+    pipelineChangeCount_ += other.pipelineChangeCount_;
+    bindingCount_ += other.bindingCount_;
+    barrierCount_ += other.barrierCount_;
+    commandListCount_ += other.commandListCount_;
+    submitCount_ += other.submitCount_;
+    presentCount_ += other.presentCount_;
+    fenceWaitCount_ += other.fenceWaitCount_;
+    errorCount_ += other.errorCount_;
+    lifetimeErrorCount_ += other.lifetimeErrorCount_;
+    return *this;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief    コンストラクタ
+ * @param	device		作成したデバイス
+ * @param	heapType	バッファを置くメモリの種類
+ * @param	size		バッファのサイズ
+ * @param	address		割り当てた GPU アドレス
+ */
+RhiNullBuffer::RhiNullBuffer(RhiNullDevice& device, RhiHeapType heapType, uint64_t size, RhiGpuAddress address) noexcept
+    : device_(&device), heapType_(heapType), address_(address), data_(static_cast<size_t>(size)) {
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief    デストラクタ
+ */
+RhiNullBuffer::~RhiNullBuffer() {
+    device_->unregisterResource(*this, address_);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	バッファのサイズを取得する
+ * @return	バッファのサイズ
+ */
+[[nodiscard]] uint64_t RhiNullBuffer::size() const noexcept {
+    return data_.size();
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	先頭の GPU アドレスを取得する
+ * @return	GPU アドレス
+ */
+[[nodiscard]] RhiGpuAddress RhiNullBuffer::gpuAddress() const noexcept {
+    return address_;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	CPU から読み書きできるようにする
+ * @return	先頭の CPU アドレス、GPU ローカルのバッファは nullptr
+ */
+[[nodiscard]] void* RhiNullBuffer::map() noexcept {
+    if (heapType_ == RhiHeapType::gpu) {
+        assert(false && "GPU ローカルのバッファはマップできません");
+        return nullptr;
+    }
+    ++mapCount_;
+    return data_.data();
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	CPU からの読み書きを終える
+ */
+void RhiNullBuffer::unmap() noexcept {
+    assert(mapCount_ > 0 && "マップしていないバッファをアンマップしています");
+    if (mapCount_ > 0) {
+        --mapCount_;
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	中身を取得する
+ * @return	先頭のアドレス
+ */
+[[nodiscard]] const uint8_t* RhiNullBuffer::data() const noexcept {
+    return data_.data();
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief    コンストラクタ
+ * @param	device	作成したデバイス
+ * @param	width	幅
+ * @param	height	高さ
+ */
+RhiNullTexture::RhiNullTexture(RhiNullDevice& device, uint32_t width, uint32_t height) noexcept
+    : device_(&device), width_(width), height_(height) {
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief    デストラクタ
+ */
+RhiNullTexture::~RhiNullTexture() {
+    device_->unregisterResource(*this);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	幅を取得する
+ * @return	幅
+ */
+[[nodiscard]] uint32_t RhiNullTexture::width() const noexcept {
+    return width_;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	高さを取得する
+ * @return	高さ
+ */
+[[nodiscard]] uint32_t RhiNullTexture::height() const noexcept {
+    return height_;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief    コンストラクタ
+ * @param	key	パイプラインの識別値
+ */
+RhiNullPipeline::RhiNullPipeline(uint64_t key) noexcept
+    : key_(key) {
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	識別値を取得する
+ * @return	識別値
+ */
+[[nodiscard]] uint64_t RhiNullPipeline::key() const noexcept {
+    return key_;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief    コンストラクタ
+ * @param	device	作成したデバイス
+ */
+RhiNullFence::RhiNullFence(RhiNullDevice& device) noexcept
+    : device_(&device) {
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief    デストラクタ
+ */
+RhiNullFence::~RhiNullFence() {
+    device_->removeFence(*this);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	GPU が到達済みのフェンス値を取得する
+ * @return	到達済みのフェンス値
+ */
+[[nodiscard]] uint64_t RhiNullFence::completedValue() const noexcept {
+    std::lock_guard lock(device_->mutex_);
+    return completed_;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	GPU がフェンス値に到達するまで CPU で待つ
+ * 実際には待たず、値に届くまでの書き込みを全て完了させる
+ * @param	value	待つフェンス値
+ */
+void RhiNullFence::wait(uint64_t value) noexcept {
+    device_->wait(*this, value);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	記録を開始する
+ * 前回の記録の後に検出した誤った使い方は、今回の記録と一緒に提出時に報告する
+ */
+void RhiNullCommandList::reset() noexcept {
+    auto errorCount = idleErrorCount_;
+    if (recording_) {
+        ++errorCount;
+        lastError_ = "記録中のコマンドリストをリセットしています";
+    }
+
+    recording_ = true;
+    pipeline_ = nullptr;
+    vertexBuffer_ = false;
+    indexBuffer_ = false;
+    statistics_ = {};
+    statistics_.errorCount_ = errorCount;
+    idleErrorCount_ = 0;
+    barriers_.clear();
+    resources_.clear();
+    addresses_.clear();
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	記録を終了する
+ */
+void RhiNullCommandList::close() noexcept {
+    if (checkRecording()) {
+        recording_ = false;
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	リソースステートを遷移させる
+ * ステートの検証は提出時に提出の順で行う
+ * @param	resource	対象のリソース
+ * @param	before		遷移前のステート
+ * @param	after		遷移後のステート
+ */
+void RhiNullCommandList::barrier(RhiResource& resource, RhiResourceState before, RhiResourceState after) noexcept {
+    if (!checkRecording()) {
+        return;
+    }
+    barriers_.push_back({ &resource, before, after });
+    resources_.push_back(&resource);
+    ++statistics_.barrierCount_;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	レンダーターゲットを設定する
+ * @param	target	レンダーターゲット
+ */
+void RhiNullCommandList::setRenderTarget(RhiTexture& target) noexcept {
+    if (!checkRecording()) {
+        return;
+    }
+    resources_.push_back(&target);
+    ++statistics_.bindingCount_;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	レンダーターゲットを塗りつぶす
+ * @param	target	レンダーターゲット
+ * @param	color	塗りつぶす色
+ */
+void RhiNullCommandList::clearRenderTarget(RhiTexture& target, const float (&color)[4]) noexcept {
+    (void)color;
+    if (!checkRecording()) {
+        return;
+    }
+    resources_.push_back(&target);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	ビューポートを設定する
+ * @param	viewport	ビューポート
+ */
+void RhiNullCommandList::setViewport(const RhiViewport& viewport) noexcept {
+    (void)viewport;
+    (void)checkRecording();
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	シザー矩形を設定する
+ * @param	rect	シザー矩形
+ */
+void RhiNullCommandList::setScissor(const RhiRect& rect) noexcept {
+    (void)rect;
+    (void)checkRecording();
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	パイプラインを設定する
+ * 同じパイプラインを続けて設定した場合は切り替えとして数えない
+ * @param	pipeline	パイプライン
+ */
+void RhiNullCommandList::setPipeline(const RhiPipeline& pipeline) noexcept {
+    if (!checkRecording()) {
+        return;
+    }
+    if (pipeline_ != &pipeline) {
+        pipeline_ = &pipeline;
+        ++statistics_.pipelineChangeCount_;
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	ルート CBV を設定する
+ * @param	parameterIndex	ルートパラメータの番号
+ * @param	address			定数バッファの GPU アドレス
+ */
+void RhiNullCommandList::setConstantBuffer(uint32_t parameterIndex, RhiGpuAddress address) noexcept {
+    (void)parameterIndex;
+    if (!checkRecording()) {
+        return;
+    }
+    addresses_.push_back(address);
+    ++statistics_.bindingCount_;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	ルート SRV を設定する
+ * @param	parameterIndex	ルートパラメータの番号
+ * @param	address			バッファの GPU アドレス
+ */
+void RhiNullCommandList::setShaderResource(uint32_t parameterIndex, RhiGpuAddress address) noexcept {
+    (void)parameterIndex;
+    if (!checkRecording()) {
+        return;
+    }
+    addresses_.push_back(address);
+    ++statistics_.bindingCount_;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	ルート定数を設定する
+ * @param	parameterIndex	ルートパラメータの番号
+ * @param	value			32bit の値
+ * @param	offset			ルート定数内の位置
+ */
+void RhiNullCommandList::setConstant(uint32_t parameterIndex, uint32_t value, uint32_t offset) noexcept {
+    (void)parameterIndex;
+    (void)value;
+    (void)offset;
+    if (!checkRecording()) {
+        return;
+    }
+    ++statistics_.bindingCount_;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	頂点バッファを設定する
+ * @param	view	頂点バッファビュー
+ */
+void RhiNullCommandList::setVertexBuffer(const RhiVertexBufferView& view) noexcept {
+    if (!checkRecording()) {
+        return;
+    }
+    addresses_.push_back(view.address_);
+    vertexBuffer_ = true;
+    ++statistics_.bindingCount_;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	インデックスバッファを設定する
+ * @param	view	インデックスバッファビュー
+ */
+void RhiNullCommandList::setIndexBuffer(const RhiIndexBufferView& view) noexcept {
+    if (!checkRecording()) {
+        return;
+    }
+    addresses_.push_back(view.address_);
+    indexBuffer_ = true;
+    ++statistics_.bindingCount_;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	インデックスを使ってインスタンス描画する
+ * @param	indexCount		インスタンス毎のインデックス数
+ * @param	instanceCount	インスタンスの数
+ * @param	startIndex		先頭インデックスの位置
+ * @param	baseVertex		インデックスに加える頂点の位置
+ * @param	startInstance	先頭インスタンスの番号
+ */
+void RhiNullCommandList::drawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex, int32_t baseVertex, uint32_t startInstance) noexcept {
+    (void)startIndex;
+    (void)baseVertex;
+    (void)startInstance;
+    if (!checkRecording()) {
+        return;
+    }
+    if (!pipeline_ || !vertexBuffer_ || !indexBuffer_) {
+        ++statistics_.errorCount_;
+        lastError_ = "パイプラインか頂点・インデックスバッファを設定せずに描画しています";
+        return;
+    }
+    ++statistics_.drawCount_;
+    statistics_.instanceCount_ += instanceCount;
+    statistics_.indexCount_ += static_cast<uint64_t>(indexCount) * instanceCount;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	記録中かを確かめる
+ * @return	記録中なら true、そうでなければ誤った使い方として数えて false
+ */
+[[nodiscard]] bool RhiNullCommandList::checkRecording() noexcept {
+    if (!recording_) {
+        // 記録済みの統計情報は提出済みかもしれないので、次の記録に持ち越す
+        ++idleErrorCount_;
+        lastError_ = "記録中でないコマンドリストにコマンドを記録しています";
+        return false;
+    }
+    return true;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief    コンストラクタ
+ * @param	device	所属するデバイス
+ */
+RhiNullQueue::RhiNullQueue(RhiNullDevice& device) noexcept
+    : device_(&device) {
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	記録を終えたコマンドリストを並び順に実行する
+ * @param	commandLists	実行するコマンドリスト
+ */
+void RhiNullQueue::execute(std::span<RhiCommandList* const> commandLists) noexcept {
+    device_->execute(commandLists);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	ここまでの実行が終わったらフェンスに値を書き込む
+ * @param	fence	書き込むフェンス
+ * @param	value	書き込む値
+ */
+void RhiNullQueue::signal(RhiFence& fence, uint64_t value) noexcept {
+    device_->signal(static_cast<RhiNullFence&>(fence), value);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	フェンスが値に到達するまで以降の実行を GPU 側で待たせる
+ * @param	fence	待つフェンス
+ * @param	value	待つ値
+ */
+void RhiNullQueue::wait(RhiFence& fence, uint64_t value) noexcept {
+    device_->waitOnQueue(static_cast<const RhiNullFence&>(fence), value);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief    コンストラクタ
+ * @param	device	所属するデバイス
+ */
+RhiNullSwapChain::RhiNullSwapChain(RhiNullDevice& device) noexcept
+    : device_(&device) {
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	バックバッファを作成する
+ * @param	width		幅
+ * @param	height		高さ
+ * @param	bufferCount	バックバッファの数
+ */
+void RhiNullSwapChain::create(uint32_t width, uint32_t height, uint32_t bufferCount) noexcept {
+    backBuffers_.clear();
+    for (uint32_t i = 0; i < bufferCount; ++i) {
+        auto backBuffer = std::make_unique<RhiNullTexture>(*device_, width, height);
+        device_->registerResource(*backBuffer, RhiState::present);
+        backBuffers_.push_back(std::move(backBuffer));
+    }
+    currentIndex_ = 0;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	バックバッファの数を取得する
+ * @return	バックバッファの数
+ */
+[[nodiscard]] uint32_t RhiNullSwapChain::bufferCount() const noexcept {
+    return static_cast<uint32_t>(backBuffers_.size());
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	今回描画するバックバッファの番号を取得する
+ * @return	バックバッファの番号
+ */
+[[nodiscard]] uint32_t RhiNullSwapChain::currentIndex() const noexcept {
+    return currentIndex_;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	バックバッファを取得する
+ * @param	index	バックバッファの番号
+ * @return	バックバッファ
+ */
+[[nodiscard]] RhiTexture& RhiNullSwapChain::backBuffer(uint32_t index) noexcept {
+    assert(index < backBuffers_.size() && "バックバッファの番号が範囲外です");
+    return *backBuffers_[index];
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	今回のバックバッファを表示する
+ * @param	syncInterval	垂直同期の間隔（使わない）
+ */
+void RhiNullSwapChain::present(uint32_t syncInterval) noexcept {
+    (void)syncInterval;
+    if (backBuffers_.empty()) {
+        assert(false && "スワップチェインが未作成です");
+        return;
+    }
+    device_->present(*backBuffers_[currentIndex_]);
+    currentIndex_ = (currentIndex_ + 1) % static_cast<uint32_t>(backBuffers_.size());
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief    コンストラクタ
+ */
+RhiNullDevice::RhiNullDevice() noexcept
+    : nextAddress_(baseAddress), graphicsQueue_(*this), copyQueue_(*this), swapChain_(*this) {
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief    デストラクタ
+ */
+RhiNullDevice::~RhiNullDevice() {
+    // バックバッファの登録解除でロックを使うので、メンバの破棄より先に破棄する
+    swapChain_.create(0, 0, 0);
+    assert(resources_.empty() && "ヌルデバイスから作成したリソースが破棄されていません");
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	ヌルデバイスを作成する
+ * @param	width		バックバッファの幅
+ * @param	height		バックバッファの高さ
+ * @param	bufferCount	バックバッファの数
+ * @param	latency		シグナルが到達するまでに必要な後続のシグナルの数
+ * @return	生成の成否
+ */
+[[nodiscard]] bool RhiNullDevice::create(uint32_t width, uint32_t height, uint32_t bufferCount, uint32_t latency) noexcept {
+    if (bufferCount == 0) {
+        assert(false && "バックバッファの数が 0 です");
+        return false;
+    }
+
+    latency_ = latency;
+    swapChain_.create(width, height, bufferCount);
+    return true;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	バッファを作成する
+ * @param	heapType	バッファを置くメモリの種類
+ * @param	size		バッファのサイズ
+ * @return	作成したバッファ
+ */
+[[nodiscard]] std::unique_ptr<RhiBuffer> RhiNullDevice::createBuffer(RhiHeapType heapType, uint64_t size) noexcept {
+    if (size == 0) {
+        assert(false && "サイズが 0 のバッファは作成できません");
+        return nullptr;
+    }
+
+    RhiGpuAddress address{};
+    {
+        std::lock_guard lock(mutex_);
+        address = nextAddress_;
+        nextAddress_ += (size + addressAlignment - 1) / addressAlignment * addressAlignment;
+    }
+
+    auto buffer = std::make_unique<RhiNullBuffer>(*this, heapType, size, address);
+    const auto state = heapType == RhiHeapType::upload   ? RhiState::genericRead
+                       : heapType == RhiHeapType::readback ? RhiState::copyDest
+                                                           : RhiState::common;
+    registerBuffer(*buffer, state);
+    return buffer;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	フェンスを作成する
+ * @return	作成したフェンス
+ */
+[[nodiscard]] std::unique_ptr<RhiFence> RhiNullDevice::createFence() noexcept {
+    return std::make_unique<RhiNullFence>(*this);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	コマンドリストを作成する
+ * @param	queueType	提出するキューの種類
+ * @return	作成したコマンドリスト
+ */
+[[nodiscard]] std::unique_ptr<RhiCommandList> RhiNullDevice::createCommandList(RhiQueueType queueType) noexcept {
+    (void)queueType;
+    return std::make_unique<RhiNullCommandList>();
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	コマンドキューを取得する
+ * 全てのキューは一つの提出順を共有する
+ * @param	queueType	キューの種類
+ * @return	コマンドキュー
+ */
+[[nodiscard]] RhiQueue& RhiNullDevice::queue(RhiQueueType queueType) noexcept {
+    return queueType == RhiQueueType::copy ? copyQueue_ : graphicsQueue_;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	スワップチェインを取得する
+ * @return	スワップチェイン
+ */
+[[nodiscard]] RhiSwapChain& RhiNullDevice::swapChain() noexcept {
+    return swapChain_;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	GPU アドレスが指すバッファの中身を取得する
+ * @param	address	GPU アドレス
+ * @param	size	読むサイズ
+ * @return	中身の先頭、範囲がバッファに収まらない場合は nullptr
+ */
+[[nodiscard]] const uint8_t* RhiNullDevice::resolve(RhiGpuAddress address, uint64_t size) const noexcept {
+    std::lock_guard lock(mutex_);
+
+    // アドレス以下で最も大きい先頭アドレスを持つバッファが候補になる
+    auto it = addressMap_.upper_bound(address);
+    if (it == addressMap_.begin()) {
+        return nullptr;
+    }
+    --it;
+
+    const auto* buffer = it->second;
+    const auto  offset = address - it->first;
+    if (offset > buffer->size() || size > buffer->size() - offset) {
+        return nullptr;
+    }
+    return buffer->data() + offset;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	全てのシグナルを到達させる
+ */
+void RhiNullDevice::flush() noexcept {
+    std::lock_guard lock(mutex_);
+    while (!pending_.empty()) {
+        retireFront();
+    }
+    current_.resources_.clear();
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	統計情報を取得する
+ * @return	統計情報
+ */
+[[nodiscard]] RhiNullStatistics RhiNullDevice::statistics() const noexcept {
+    std::lock_guard lock(mutex_);
+    return statistics_;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	統計情報をリセットする
+ */
+void RhiNullDevice::resetStatistics() noexcept {
+    std::lock_guard lock(mutex_);
+    statistics_ = {};
+    lastError_ = nullptr;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	作成中のリソースの数を取得する
+ * @return	リソースの数
+ */
+[[nodiscard]] size_t RhiNullDevice::liveResourceCount() const noexcept {
+    std::lock_guard lock(mutex_);
+    return resources_.size();
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	最後に検出した誤った使い方の内容を取得する
+ * @return	内容、無い場合は nullptr
+ */
+[[nodiscard]] const char* RhiNullDevice::lastError() const noexcept {
+    std::lock_guard lock(mutex_);
+    return lastError_;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	リソースを登録する
+ * @param	resource	リソース
+ * @param	state		初期ステート
+ */
+void RhiNullDevice::registerResource(const RhiResource& resource, RhiResourceState state) noexcept {
+    std::lock_guard lock(mutex_);
+    resources_[&resource] = { state };
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	バッファを登録する
+ * @param	buffer	バッファ
+ * @param	state	初期ステート
+ */
+void RhiNullDevice::registerBuffer(RhiNullBuffer& buffer, RhiResourceState state) noexcept {
+    std::lock_guard lock(mutex_);
+    resources_[&buffer] = { state };
+    addressMap_[buffer.gpuAddress()] = &buffer;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	リソースの登録を解除する
+ * GPU が使用中の場合は誤った使い方として数える
+ * @param	resource	リソース
+ * @param	address		バッファの場合は GPU アドレス、それ以外は 0
+ */
+void RhiNullDevice::unregisterResource(const RhiResource& resource, RhiGpuAddress address) noexcept {
+    std::lock_guard lock(mutex_);
+
+    if (inUse(resource)) {
+        ++statistics_.lifetimeErrorCount_;
+        reportError("GPU が使用中のリソースを破棄しています");
+
+        // 破棄したリソースを後から参照しないよう、提出からも取り除く
+        const auto erase = [&resource](Submission& submission) {
+            std::erase(submission.resources_, &resource);
+        };
+        erase(current_);
+        std::for_each(pending_.begin(), pending_.end(), erase);
+    }
+
+    resources_.erase(&resource);
+    if (address != 0) {
+        addressMap_.erase(address);
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	コマンドリストの提出を受け付ける
+ * 提出の順にバリアを適用してステートを検証し、参照したリソースをシグナルまで保持する
+ * @param	commandLists	実行するコマンドリスト
+ */
+void RhiNullDevice::execute(std::span<RhiCommandList* const> commandLists) noexcept {
+    std::lock_guard lock(mutex_);
+    ++statistics_.submitCount_;
+
+    for (auto* commandList : commandLists) {
+        auto& list = *static_cast<RhiNullCommandList*>(commandList);
+        if (list.recording_) {
+            reportError("記録中のコマンドリストを提出しています");
+            continue;
+        }
+
+        statistics_ += list.statistics_;
+        ++statistics_.commandListCount_;
+        if (list.lastError_) {
+            lastError_ = list.lastError_;
+        }
+
+        for (const auto& barrier : list.barriers_) {
+            auto it = resources_.find(barrier.resource_);
+            if (it == resources_.end()) {
+                reportError("破棄されたリソースにバリアを発行しています");
+                continue;
+            }
+            if (it->second.state_ != barrier.before_) {
+                reportError("バリアの遷移前のステートが現在のステートと一致しません");
+            }
+            it->second.state_ = barrier.after_;
+        }
+
+        for (const auto* resource : list.resources_) {
+            if (!resources_.contains(resource)) {
+                reportError("破棄されたリソースを参照しています");
+                continue;
+            }
+            current_.resources_.push_back(resource);
+        }
+
+        // GPU アドレスは再利用しないので、見つからなければ破棄されたバッファを指している
+        for (const auto address : list.addresses_) {
+            auto it = addressMap_.upper_bound(address);
+            if (it == addressMap_.begin() || address - std::prev(it)->first >= std::prev(it)->second->size()) {
+                reportError("破棄されたバッファの GPU アドレスを参照しています");
+                continue;
+            }
+            current_.resources_.push_back(std::prev(it)->second);
+        }
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	シグナルを受け付け、遅延の分を超えたシグナルを到達させる
+ * @param	fence	書き込むフェンス
+ * @param	value	書き込む値
+ */
+void RhiNullDevice::signal(RhiNullFence& fence, uint64_t value) noexcept {
+    std::lock_guard lock(mutex_);
+
+    current_.fence_ = &fence;
+    current_.value_ = value;
+    pending_.push_back(std::move(current_));
+    current_ = {};
+
+    // GPU が latency 回分のシグナルだけ遅れて処理を進めているとみなす
+    while (pending_.size() > latency_) {
+        retireFront();
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	フェンスが値に届くまでシグナルを到達させる
+ * @param	fence	待つフェンス
+ * @param	value	待つ値
+ */
+void RhiNullDevice::wait(RhiNullFence& fence, uint64_t value) noexcept {
+    std::lock_guard lock(mutex_);
+    if (fence.completed_ >= value) {
+        return;
+    }
+
+    // 実際の GPU なら待たされる場面なので、CPU が止まった回数として数える
+    ++statistics_.fenceWaitCount_;
+    while (fence.completed_ < value && !pending_.empty()) {
+        retireFront();
+    }
+    if (fence.completed_ < value) {
+        reportError("シグナルされていないフェンス値を待っています");
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	キューの GPU 側の待ちを受け付ける
+ * @param	fence	待つフェンス
+ * @param	value	待つ値
+ */
+void RhiNullDevice::waitOnQueue(const RhiNullFence& fence, uint64_t value) noexcept {
+    std::lock_guard lock(mutex_);
+    if (fence.completed_ >= value) {
+        return;
+    }
+    const auto signaled = std::any_of(pending_.begin(), pending_.end(), [&](const Submission& submission) {
+        return submission.fence_ == &fence && submission.value_ >= value;
+    });
+    if (!signaled) {
+        reportError("GPU がシグナルされていないフェンス値を待っています");
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	フェンスの破棄に合わせて、そのフェンスへのシグナルを取り除く
+ * 提出が参照しているリソースは、フェンスが無くなっても到達するまで保持する
+ * @param	fence	破棄するフェンス
+ */
+void RhiNullDevice::removeFence(const RhiNullFence& fence) noexcept {
+    std::lock_guard lock(mutex_);
+    for (auto& submission : pending_) {
+        if (submission.fence_ == &fence) {
+            submission.fence_ = nullptr;
+        }
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	表示を受け付ける
+ * @param	backBuffer	表示するバックバッファ
+ */
+void RhiNullDevice::present(const RhiNullTexture& backBuffer) noexcept {
+    std::lock_guard lock(mutex_);
+    ++statistics_.presentCount_;
+
+    const auto it = resources_.find(&backBuffer);
+    if (it == resources_.end() || it->second.state_ != RhiState::present) {
+        reportError("表示のステートでないバックバッファを表示しています");
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	シグナル済みの先頭の提出を完了させる
+ */
+void RhiNullDevice::retireFront() noexcept {
+    auto& submission = pending_.front();
+    if (submission.fence_) {
+        submission.fence_->completed_ = std::max(submission.fence_->completed_, submission.value_);
+    }
+    pending_.pop_front();
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	GPU が使用中のリソースかを調べる
+ * @param	resource	リソース
+ * @return	使用中なら true
+ */
+[[nodiscard]] bool RhiNullDevice::inUse(const RhiResource& resource) const noexcept {
+    const auto contains = [&resource](const Submission& submission) {
+        return std::find(submission.resources_.begin(), submission.resources_.end(), &resource) != submission.resources_.end();
+    };
+    return contains(current_) || std::any_of(pending_.begin(), pending_.end(), contains);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	誤った使い方を記録する
+ * @param	message	内容
+ */
+void RhiNullDevice::reportError(const char* message) noexcept {
+    ++statistics_.errorCount_;
+    lastError_ = message;
+}
@@ -0,0 +1,536 @@
+﻿// ヌルデバイスクラス
+
+#pragma once
+
+#include "rhi.h"
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+class RhiNullDevice;
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	ヌルデバイスの統計情報
+ * 記録・提出されたコマンドの数と、検出した誤った使い方の数
+ */
+struct RhiNullStatistics {
+    uint64_t drawCount_{};            /// 描画の数
+    uint64_t instanceCount_{};        /// 描画したインスタンスの数
+    uint64_t indexCount_{};           /// 描画したインデックスの数
+    uint64_t pipelineChangeCount_{};  /// パイプラインの切り替えの数
+    uint64_t bindingCount_{};         /// バッファとルート定数の設定の数
+    uint64_t barrierCount_{};         /// バリアの数
+    uint64_t commandListCount_{};     /// 実行したコマンドリストの数
+    uint64_t submitCount_{};          /// キューへの提出の数
+    uint64_t presentCount_{};         /// 表示の数
+    uint64_t fenceWaitCount_{};       /// CPU が GPU を待った回数
+    uint64_t errorCount_{};           /// 誤った使い方の数
+    uint64_t lifetimeErrorCount_{};   /// GPU が使用中のリソースを破棄した数
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	別の統計情報を加える
+     * @param	other	加える統計情報
+     * @return	自身
+     */
+    RhiNullStatistics& operator+=(const RhiNullStatistics& other) noexcept;
+};
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	ヌルデバイスのバッファ
+ * 中身は CPU のメモリに置き、GPU アドレスはデバイスが重ならないように割り当てる
+ */
+class RhiNullBuffer final : public RhiBuffer {
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    コンストラクタ
+     * @param	device		作成したデバイス
+     * @param	heapType	バッファを置くメモリの種類
+     * @param	size		バッファのサイズ
+     * @param	address		割り当てた GPU アドレス
+     */
+    RhiNullBuffer(RhiNullDevice& device, RhiHeapType heapType, uint64_t size, RhiGpuAddress address) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    デストラクタ
+     */
+    ~RhiNullBuffer() override;
+
+    [[nodiscard]] uint64_t      size() const noexcept override;
+    [[nodiscard]] RhiGpuAddress gpuAddress() const noexcept override;
+    [[nodiscard]] void*         map() noexcept override;
+    void                        unmap() noexcept override;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	中身を取得する
+     * GPU ローカルのバッファも含め、GPU から見える内容をそのまま読める
+     * @return	先頭のアドレス
+     */
+    [[nodiscard]] const uint8_t* data() const noexcept;
+
+private:
+    RhiNullDevice*       device_{};    /// 作成したデバイス
+    RhiHeapType          heapType_{};  /// バッファを置くメモリの種類
+    RhiGpuAddress        address_{};   /// GPU アドレス
+    std::vector<uint8_t> data_{};      /// 中身
+    uint32_t             mapCount_{};  /// map の入れ子の数
+};
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	ヌルデバイスのテクスチャ
+ * 大きさだけを持ち、画素は持たない
+ */
+class RhiNullTexture final : public RhiTexture {
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    コンストラクタ
+     * @param	device	作成したデバイス
+     * @param	width	幅
+     * @param	height	高さ
+     */
+    RhiNullTexture(RhiNullDevice& device, uint32_t width, uint32_t height) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    デストラクタ
+     */
+    ~RhiNullTexture() override;
+
+    [[nodiscard]] uint32_t width() const noexcept override;
+    [[nodiscard]] uint32_t height() const noexcept override;
+
+private:
+    RhiNullDevice* device_{};  /// 作成したデバイス
+    uint32_t       width_{};   /// 幅
+    uint32_t       height_{};  /// 高さ
+};
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	ヌルデバイスのパイプライン
+ * 区別できるように識別値だけを持つ
+ */
+class RhiNullPipeline final : public RhiPipeline {
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    コンストラクタ
+     * @param	key	パイプラインの識別値（シェーダのバリエーションなど）
+     */
+    explicit RhiNullPipeline(uint64_t key = 0) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	識別値を取得する
+     * @return	識別値
+     */
+    [[nodiscard]] uint64_t key() const noexcept;
+
+private:
+    uint64_t key_{};  /// 識別値
+};
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	ヌルデバイスのフェンス
+ * キューが書き込んだ値は、デバイスに設定した遅延の分だけ後の提出で到達したことになる
+ */
+class RhiNullFence final : public RhiFence {
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    コンストラクタ
+     * @param	device	作成したデバイス
+     */
+    explicit RhiNullFence(RhiNullDevice& device) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    デストラクタ
+     */
+    ~RhiNullFence() override;
+
+    [[nodiscard]] uint64_t completedValue() const noexcept override;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	GPU がフェンス値に到達するまで CPU で待つ
+     * 実際には待たず、値に届くまでの書き込みを全て完了させる
+     * 書き込まれる予定の無い値を待った場合は誤った使い方として数える
+     * @param	value	待つフェンス値
+     */
+    void wait(uint64_t value) noexcept override;
+
+private:
+    friend class RhiNullDevice;
+
+    RhiNullDevice* device_{};     /// 作成したデバイス
+    uint64_t       completed_{};  /// 到達済みのフェンス値
+};
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	ヌルデバイスのコマンドリスト
+ * コマンドは実行せず、数と参照したリソースだけを記録する
+ * 記録中でない時のコマンドや、パイプラインや頂点バッファを設定していない描画は誤った使い方として数える
+ */
+class RhiNullCommandList final : public RhiCommandList {
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    コンストラクタ
+     */
+    RhiNullCommandList() = default;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    デストラクタ
+     */
+    ~RhiNullCommandList() override = default;
+
+    void reset() noexcept override;
+    void close() noexcept override;
+    void barrier(RhiResource& resource, RhiResourceState before, RhiResourceState after) noexcept override;
+    void setRenderTarget(RhiTexture& target) noexcept override;
+    void clearRenderTarget(RhiTexture& target, const float (&color)[4]) noexcept override;
+    void setViewport(const RhiViewport& viewport) noexcept override;
+    void setScissor(const RhiRect& rect) noexcept override;
+    void setPipeline(const RhiPipeline& pipeline) noexcept override;
+    void setConstantBuffer(uint32_t parameterIndex, RhiGpuAddress address) noexcept override;
+    void setShaderResource(uint32_t parameterIndex, RhiGpuAddress address) noexcept override;
+    void setConstant(uint32_t parameterIndex, uint32_t value, uint32_t offset) noexcept override;
+    void setVertexBuffer(const RhiVertexBufferView& view) noexcept override;
+    void setIndexBuffer(const RhiIndexBufferView& view) noexcept override;
+    void drawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex, int32_t baseVertex, uint32_t startInstance) noexcept override;
+
+private:
+    friend class RhiNullDevice;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	記録したバリア
+     */
+    struct Barrier {
+        const RhiResource* resource_{};  /// 対象のリソース
+        RhiResourceState   before_{};    /// 遷移前のステート
+        RhiResourceState   after_{};     /// 遷移後のステート
+    };
+
+private:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	記録中かを確かめる
+     * @return	記録中なら true、そうでなければ誤った使い方として数えて false
+     */
+    [[nodiscard]] bool checkRecording() noexcept;
+
+private:
+    bool                            recording_{};       /// 記録中か
+    const RhiPipeline*              pipeline_{};        /// 設定中のパイプライン
+    bool                            vertexBuffer_{};    /// 頂点バッファを設定したか
+    bool                            indexBuffer_{};     /// インデックスバッファを設定したか
+    RhiNullStatistics               statistics_{};      /// 記録したコマンドの数
+    uint64_t                        idleErrorCount_{};  /// 記録中でない時に検出した誤った使い方の数（次の記録で報告する）
+    const char*                     lastError_{};       /// 最後に検出した誤った使い方の内容
+    std::vector<Barrier>            barriers_{};        /// 記録したバリア
+    std::vector<const RhiResource*> resources_{};       /// 参照したリソース
+    std::vector<RhiGpuAddress>      addresses_{};       /// 参照したバッファの GPU アドレス
+};
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	ヌルデバイスのキュー
+ */
+class RhiNullQueue final : public RhiQueue {
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    コンストラクタ
+     * @param	device	所属するデバイス
+     */
+    explicit RhiNullQueue(RhiNullDevice& device) noexcept;
+
+    void execute(std::span<RhiCommandList* const> commandLists) noexcept override;
+    void signal(RhiFence& fence, uint64_t value) noexcept override;
+    void wait(RhiFence& fence, uint64_t value) noexcept override;
+
+private:
+    RhiNullDevice* device_{};  /// 所属するデバイス
+};
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	ヌルデバイスのスワップチェイン
+ * 表示する度にバックバッファの番号を進める
+ */
+class RhiNullSwapChain final : public RhiSwapChain {
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    コンストラクタ
+     * @param	device	所属するデバイス
+     */
+    explicit RhiNullSwapChain(RhiNullDevice& device) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	バックバッファを作成する
+     * @param	width		幅
+     * @param	height		高さ
+     * @param	bufferCount	バックバッファの数
+     */
+    void create(uint32_t width, uint32_t height, uint32_t bufferCount) noexcept;
+
+    [[nodiscard]] uint32_t    bufferCount() const noexcept override;
+    [[nodiscard]] uint32_t    currentIndex() const noexcept override;
+    [[nodiscard]] RhiTexture& backBuffer(uint32_t index) noexcept override;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	今回のバックバッファを表示する
+     * バックバッファが表示のステートになっていなければ誤った使い方として数える
+     * @param	syncInterval	垂直同期の間隔（ヌルデバイスでは使わない）
+     */
+    void present(uint32_t syncInterval) noexcept override;
+
+private:
+    RhiNullDevice*                               device_{};        /// 所属するデバイス
+    std::vector<std::unique_ptr<RhiNullTexture>> backBuffers_{};   /// バックバッファ
+    uint32_t                                     currentIndex_{};  /// 今回描画するバックバッファの番号
+};
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	ヌルデバイスクラス
+ * GPU を使わずに、D3D12 のデバイスと同じ呼び出しを受け付ける
+ * ウィンドウやグラフィックスドライバの無い環境で、フレームの CPU 側の処理を動かして計測・確認するために使う
+ *
+ * ・リソースの生存管理	作成中のリソースを数え、GPU が使用中（フェンス未到達の提出が参照中）のリソースの破棄を検出する
+ * ・フェンスの模擬		シグナルは latency 回後のシグナルで到達したことにする。CPU の wait は即座に到達させる
+ * ・ステートの検証		提出の順にバリアを適用し、遷移前のステートの食い違いを検出する
+ */
+class RhiNullDevice final : public RhiDevice {
+public:
+    static constexpr RhiGpuAddress baseAddress = 0x10000;       /// 最初に割り当てる GPU アドレス
+    static constexpr RhiGpuAddress addressAlignment = 0x10000;  /// GPU アドレスのアライメント（D3D12 のバッファと同じ 64KB）
+
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    コンストラクタ
+     */
+    RhiNullDevice() noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    デストラクタ
+     * デバイスから作成したリソースは先に破棄しておくこと
+     */
+    ~RhiNullDevice() override;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	ヌルデバイスを作成する
+     * @param	width		バックバッファの幅
+     * @param	height		バックバッファの高さ
+     * @param	bufferCount	バックバッファの数
+     * @param	latency		シグナルが到達するまでに必要な後続のシグナルの数（0 なら即座に到達）
+     * @return	生成の成否
+     */
+    [[nodiscard]] bool create(uint32_t width, uint32_t height, uint32_t bufferCount, uint32_t latency) noexcept;
+
+    [[nodiscard]] std::unique_ptr<RhiBuffer>      createBuffer(RhiHeapType heapType, uint64_t size) noexcept override;
+    [[nodiscard]] std::unique_ptr<RhiFence>       createFence() noexcept override;
+    [[nodiscard]] std::unique_ptr<RhiCommandList> createCommandList(RhiQueueType queueType) noexcept override;
+    [[nodiscard]] RhiQueue&                       queue(RhiQueueType queueType) noexcept override;
+    [[nodiscard]] RhiSwapChain&                   swapChain() noexcept override;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	GPU アドレスが指すバッファの中身を取得する
+     * @param	address	GPU アドレス
+     * @param	size	読むサイズ
+     * @return	中身の先頭、範囲がバッファに収まらない場合は nullptr
+     */
+    [[nodiscard]] const uint8_t* resolve(RhiGpuAddress address, uint64_t size) const noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	全てのシグナルを到達させる（GPU がアイドルになった状態にする）
+     */
+    void flush() noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	統計情報を取得する
+     * @return	統計情報
+     */
+    [[nodiscard]] RhiNullStatistics statistics() const noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	統計情報をリセットする
+     */
+    void resetStatistics() noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	作成中のリソースの数を取得する
+     * @return	リソースの数
+     */
+    [[nodiscard]] size_t liveResourceCount() const noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	最後に検出した誤った使い方の内容を取得する
+     * @return	内容、無い場合は nullptr
+     */
+    [[nodiscard]] const char* lastError() const noexcept;
+
+private:
+    friend class RhiNullBuffer;
+    friend class RhiNullTexture;
+    friend class RhiNullFence;
+    friend class RhiNullCommandList;
+    friend class RhiNullQueue;
+    friend class RhiNullSwapChain;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	作成中のリソースの情報
+     */
+    struct ResourceRecord {
+        RhiResourceState state_{};  /// 提出済みのコマンドを全て実行した後のステート
+    };
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	一つのシグナルまでの提出
+     */
+    struct Submission {
+        std::vector<const RhiResource*> resources_{};  /// 参照したリソース
+        RhiNullFence*                   fence_{};      /// 完了を知らせるフェンス（シグナル前やフェンスの破棄後は nullptr）
+        uint64_t                        value_{};      /// 完了を知らせるフェンス値
+    };
+
+private:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	リソースを登録する
+     * @param	resource	リソース
+     * @param	state		初期ステート
+     */
+    void registerResource(const RhiResource& resource, RhiResourceState state) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	バッファを登録する
+     * @param	buffer	バッファ
+     * @param	state	初期ステート
+     */
+    void registerBuffer(RhiNullBuffer& buffer, RhiResourceState state) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	リソースの登録を解除する
+     * GPU が使用中の場合は誤った使い方として数える
+     * GPU アドレスは再利用しないので、破棄したバッファのアドレスを参照すると提出時に検出できる
+     * @param	resource	リソース
+     * @param	address		バッファの場合は GPU アドレス、それ以外は 0
+     */
+    void unregisterResource(const RhiResource& resource, RhiGpuAddress address = 0) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	コマンドリストの提出を受け付ける
+     * @param	commandLists	実行するコマンドリスト
+     */
+    void execute(std::span<RhiCommandList* const> commandLists) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	シグナルを受け付け、遅延の分を超えたシグナルを到達させる
+     * @param	fence	書き込むフェンス
+     * @param	value	書き込む値
+     */
+    void signal(RhiNullFence& fence, uint64_t value) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	フェンスが値に届くまでシグナルを到達させる
+     * @param	fence	待つフェンス
+     * @param	value	待つ値
+     */
+    void wait(RhiNullFence& fence, uint64_t value) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	キューの GPU 側の待ちを受け付ける
+     * 到達済みでもシグナル済みでもない値を待つと GPU が止まるので、誤った使い方として数える
+     * @param	fence	待つフェンス
+     * @param	value	待つ値
+     */
+    void waitOnQueue(const RhiNullFence& fence, uint64_t value) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	フェンスの破棄に合わせて、そのフェンスへのシグナルを取り除く
+     * @param	fence	破棄するフェンス
+     */
+    void removeFence(const RhiNullFence& fence) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	表示を受け付ける
+     * @param	backBuffer	表示するバックバッファ
+     */
+    void present(const RhiNullTexture& backBuffer) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	シグナル済みの先頭の提出を完了させる
+     * ロックを取った状態で呼ぶこと
+     */
+    void retireFront() noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	GPU が使用中のリソースかを調べる
+     * ロックを取った状態で呼ぶこと
+     * @param	resource	リソース
+     * @return	使用中なら true
+     */
+    [[nodiscard]] bool inUse(const RhiResource& resource) const noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	誤った使い方を記録する
+     * ロックを取った状態で呼ぶこと
+     * @param	message	内容
+     */
+    void reportError(const char* message) noexcept;
+
+private:
+    mutable std::mutex                                     mutex_{};        /// 以下のメンバを守るロック
+    std::unordered_map<const RhiResource*, ResourceRecord> resources_{};    /// 作成中のリソース
+    std::map<RhiGpuAddress, RhiNullBuffer*>                addressMap_{};   /// GPU アドレスからバッファへの対応
+    RhiGpuAddress                                          nextAddress_{};  /// 次に割り当てる GPU アドレス
+    Submission                                             current_{};      /// まだシグナルしていない提出
+    std::deque<Submission>                                 pending_{};      /// シグナル済みでフェンスが未到達の提出
+    uint32_t                                               latency_{};      /// シグナルが到達するまでに必要な後続のシグナルの数
+    RhiNullStatistics                                      statistics_{};   /// 統計情報
+    const char*                                            lastError_{};    /// 最後に検出した誤った使い方の内容
+    RhiNullQueue                                           graphicsQueue_;  /// 描画キュー
+    RhiNullQueue                                           copyQueue_;      /// 転送キュー
+    RhiNullSwapChain                                       swapChain_;      /// スワップチェイン
+};
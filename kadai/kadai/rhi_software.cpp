@@ -0,0 +1,227 @@
+﻿// ソフトウェアラスタライザのコマンドリストクラス
+
+#include "rhi_software.h"
+#include "root_parameter.h"
+#include <cassert>
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief    コンストラクタ
+ * @param	device		バッファを作成したヌルデバイス
+ * @param	rasterizer	描画先のソフトウェアラスタライザ
+ */
+RhiSoftwareCommandList::RhiSoftwareCommandList(const RhiNullDevice& device, SoftwareRasterizer& rasterizer) noexcept
+    : device_(&device), rasterizer_(&rasterizer) {
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	記録を開始する
+ * 設定中の状態は全て解除する
+ */
+void RhiSoftwareCommandList::reset() noexcept {
+    assert(!recording_ && "記録中のコマンドリストをリセットしています");
+    recording_ = true;
+    target_ = nullptr;
+    viewport_ = {};
+    scissor_ = {};
+    pipeline_ = nullptr;
+    cameraAddress_ = 0;
+    instancesAddress_ = 0;
+    instanceOffset_ = 0;
+    vertexBuffer_ = {};
+    indexBuffer_ = {};
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	記録を終了し、振り分け済みの三角形をラスタライズする
+ */
+void RhiSoftwareCommandList::close() noexcept {
+    assert(recording_ && "記録していないコマンドリストを閉じています");
+    recording_ = false;
+    rasterizer_->flush();
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	リソースのステート遷移を記録する
+ * ソフトウェアラスタライザにはステートが無いので何もしない
+ * @param	resource	対象のリソース
+ * @param	before		遷移前のステート
+ * @param	after		遷移後のステート
+ */
+void RhiSoftwareCommandList::barrier(RhiResource& /*resource*/, RhiResourceState /*before*/, RhiResourceState /*after*/) noexcept {
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	描画先を設定する
+ * @param	target	描画先
+ */
+void RhiSoftwareCommandList::setRenderTarget(RhiTexture& target) noexcept {
+    if (checkTarget(target)) {
+        target_ = &target;
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	描画先をクリアする
+ * @param	target	描画先
+ * @param	color	クリア色
+ */
+void RhiSoftwareCommandList::clearRenderTarget(RhiTexture& target, const float (&color)[4]) noexcept {
+    if (checkTarget(target)) {
+        rasterizer_->clear(color);
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	ビューポートを設定する
+ * @param	viewport	ビューポート
+ */
+void RhiSoftwareCommandList::setViewport(const RhiViewport& viewport) noexcept {
+    viewport_ = viewport;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	シザー矩形を設定する
+ * @param	rect	シザー矩形
+ */
+void RhiSoftwareCommandList::setScissor(const RhiRect& rect) noexcept {
+    scissor_ = rect;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	パイプラインを設定する
+ * @param	pipeline	ヌルデバイスのパイプライン
+ */
+void RhiSoftwareCommandList::setPipeline(const RhiPipeline& pipeline) noexcept {
+    pipeline_ = static_cast<const RhiNullPipeline*>(&pipeline);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	定数バッファを設定する
+ * @param	parameterIndex	ルートパラメータの番号
+ * @param	address			定数バッファの GPU アドレス
+ */
+void RhiSoftwareCommandList::setConstantBuffer(uint32_t parameterIndex, RhiGpuAddress address) noexcept {
+    if (parameterIndex != RootParameter::camera) {
+        assert(false && "カメラ以外の定数バッファには対応していません");
+        return;
+    }
+    cameraAddress_ = address;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	シェーダリソースを設定する
+ * @param	parameterIndex	ルートパラメータの番号
+ * @param	address			バッファの GPU アドレス
+ */
+void RhiSoftwareCommandList::setShaderResource(uint32_t parameterIndex, RhiGpuAddress address) noexcept {
+    if (parameterIndex != RootParameter::instances) {
+        assert(false && "インスタンスデータ以外のシェーダリソースには対応していません");
+        return;
+    }
+    instancesAddress_ = address;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	ルート定数を設定する
+ * @param	parameterIndex	ルートパラメータの番号
+ * @param	value			値
+ * @param	offset			32bit 単位の位置
+ */
+void RhiSoftwareCommandList::setConstant(uint32_t parameterIndex, uint32_t value, uint32_t offset) noexcept {
+    if (parameterIndex != RootParameter::drawConstants || offset >= RootParameter::drawConstantsCount) {
+        assert(false && "描画毎の定数の範囲外です");
+        return;
+    }
+    instanceOffset_ = value;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	頂点バッファを設定する
+ * @param	view	頂点バッファビュー
+ */
+void RhiSoftwareCommandList::setVertexBuffer(const RhiVertexBufferView& view) noexcept {
+    vertexBuffer_ = view;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	インデックスバッファを設定する
+ * @param	view	インデックスバッファビュー
+ */
+void RhiSoftwareCommandList::setIndexBuffer(const RhiIndexBufferView& view) noexcept {
+    indexBuffer_ = view;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	インデックス付きのインスタンス描画を行う
+ * 設定中のバッファの中身をヌルデバイスから引いてソフトウェアラスタライザに渡す
+ * @param	indexCount		インスタンス毎のインデックス数
+ * @param	instanceCount	インスタンスの数
+ * @param	startIndex		先頭インデックスの位置
+ * @param	baseVertex		インデックスに加える頂点の位置
+ * @param	startInstance	インスタンス番号の開始値（シェーダの SV_InstanceID には影響しない）
+ */
+void RhiSoftwareCommandList::drawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex, int32_t baseVertex, uint32_t /*startInstance*/) noexcept {
+    if (!recording_ || !target_ || !pipeline_) {
+        assert(false && "描画の前に記録の開始と描画先とパイプラインの設定が必要です");
+        return;
+    }
+
+    const auto key = static_cast<ShaderKey>(pipeline_->key());
+    const auto usedInstances = uint64_t{ instanceOffset_ } + (hasShaderFeature(key, ShaderFeature::instancing) ? instanceCount : 1);
+
+    SoftwareRasterizer::DrawCall drawCall{};
+    drawCall.vertices_ = device_->resolve(vertexBuffer_.address_, vertexBuffer_.size_);
+    drawCall.vertexStride_ = vertexBuffer_.stride_;
+    drawCall.vertexCount_ = vertexBuffer_.stride_ ? vertexBuffer_.size_ / vertexBuffer_.stride_ : 0;
+    drawCall.indices_ = device_->resolve(indexBuffer_.address_, indexBuffer_.size_);
+    drawCall.indexSize_ = indexBuffer_.indexSize_;
+    drawCall.indexCount_ = indexCount;
+    drawCall.startIndex_ = startIndex;
+    drawCall.baseVertex_ = baseVertex;
+    drawCall.camera_ = reinterpret_cast<const SoftwareRasterizer::CameraData*>(device_->resolve(cameraAddress_, sizeof(SoftwareRasterizer::CameraData)));
+    drawCall.instances_ = reinterpret_cast<const SoftwareRasterizer::InstanceData*>(device_->resolve(instancesAddress_, usedInstances * sizeof(SoftwareRasterizer::InstanceData)));
+    drawCall.instanceOffset_ = instanceOffset_;
+    drawCall.instanceCount_ = instanceCount;
+    drawCall.key_ = key;
+    drawCall.viewport_ = viewport_;
+    drawCall.scissor_ = scissor_;
+    if (!drawCall.vertices_ || !drawCall.indices_ || !drawCall.camera_ || !drawCall.instances_) {
+        assert(false && "描画に使うバッファが未設定か、範囲がバッファに収まっていません");
+        return;
+    }
+    if ((uint64_t{ startIndex } + indexCount) * indexBuffer_.indexSize_ > indexBuffer_.size_) {
+        assert(false && "インデックスがインデックスバッファの範囲外です");
+        return;
+    }
+
+    rasterizer_->draw(drawCall);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	描画先がラスタライザと同じ大きさかを確かめる
+ * @param	target	描画先
+ * @return	同じなら true
+ */
+[[nodiscard]] bool RhiSoftwareCommandList::checkTarget(const RhiTexture& target) const noexcept {
+    if (target.width() != rasterizer_->width() || target.height() != rasterizer_->height()) {
+        assert(false && "描画先の大きさがソフトウェアラスタライザと一致しません");
+        return false;
+    }
+    return true;
+}
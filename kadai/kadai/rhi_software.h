@@ -0,0 +1,71 @@
+﻿// ソフトウェアラスタライザのコマンドリストクラス
+
+#pragma once
+
+#include "rhi.h"
+#include "rhi_null.h"
+#include "software_rasterizer.h"
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	ソフトウェアラスタライザで描画するコマンドリスト
+ * ヌルデバイスのバッファの中身を GPU アドレスから引き、記録と同時にソフトウェアラスタライザへ渡す
+ * パイプラインはヌルデバイスのものを使い、その識別値をシェーダのバリエーションのキーとして扱う
+ * ルートパラメータは RootParameter の並び（カメラ、インスタンスデータ、描画毎の定数）に従う
+ * ピクセルは close で確定するので、一フレーム分を一つのコマンドリストに記録する
+ * キューには提出しない。バリアはステートの検証をヌルデバイスに任せ、ここでは何もしない
+ */
+class RhiSoftwareCommandList final : public RhiCommandList {
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    コンストラクタ
+     * @param	device		バッファを作成したヌルデバイス
+     * @param	rasterizer	描画先のソフトウェアラスタライザ
+     */
+    RhiSoftwareCommandList(const RhiNullDevice& device, SoftwareRasterizer& rasterizer) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    デストラクタ
+     */
+    ~RhiSoftwareCommandList() override = default;
+
+    void reset() noexcept override;
+    void close() noexcept override;
+    void barrier(RhiResource& resource, RhiResourceState before, RhiResourceState after) noexcept override;
+    void setRenderTarget(RhiTexture& target) noexcept override;
+    void clearRenderTarget(RhiTexture& target, const float (&color)[4]) noexcept override;
+    void setViewport(const RhiViewport& viewport) noexcept override;
+    void setScissor(const RhiRect& rect) noexcept override;
+    void setPipeline(const RhiPipeline& pipeline) noexcept override;
+    void setConstantBuffer(uint32_t parameterIndex, RhiGpuAddress address) noexcept override;
+    void setShaderResource(uint32_t parameterIndex, RhiGpuAddress address) noexcept override;
+    void setConstant(uint32_t parameterIndex, uint32_t value, uint32_t offset) noexcept override;
+    void setVertexBuffer(const RhiVertexBufferView& view) noexcept override;
+    void setIndexBuffer(const RhiIndexBufferView& view) noexcept override;
+    void drawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex, int32_t baseVertex, uint32_t startInstance) noexcept override;
+
+private:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	描画先がラスタライザと同じ大きさかを確かめる
+     * @param	target	描画先
+     * @return	同じなら true
+     */
+    [[nodiscard]] bool checkTarget(const RhiTexture& target) const noexcept;
+
+private:
+    const RhiNullDevice*   device_{};            /// バッファを作成したヌルデバイス
+    SoftwareRasterizer*    rasterizer_{};        /// 描画先のソフトウェアラスタライザ
+    bool                   recording_{};         /// 記録中か
+    const RhiTexture*      target_{};            /// 設定中の描画先
+    RhiViewport            viewport_{};          /// 設定中のビューポート
+    RhiRect                scissor_{};           /// 設定中のシザー矩形
+    const RhiNullPipeline* pipeline_{};          /// 設定中のパイプライン
+    RhiGpuAddress          cameraAddress_{};     /// カメラの定数バッファの GPU アドレス
+    RhiGpuAddress          instancesAddress_{};  /// インスタンスデータの GPU アドレス
+    uint32_t               instanceOffset_{};    /// 描画毎の定数（インスタンスデータの開始位置）
+    RhiVertexBufferView    vertexBuffer_{};      /// 設定中の頂点バッファ
+    RhiIndexBufferView     indexBuffer_{};       /// 設定中のインデックスバッファ
+};
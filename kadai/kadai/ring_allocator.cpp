@@ -0,0 +1,143 @@
+﻿// リングアロケータクラス
+
+#include "ring_allocator.h"
+#include <cassert>
+
+namespace {
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	値をアライメントに切り上げる
+     * @param	value		値
+     * @param	alignment	アライメント（2 の累乗）
+     * @return	切り上げた値
+     */
+    constexpr uint64_t alignUp(uint64_t value, uint64_t alignment) noexcept {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+}  // namespace
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	アロケータを初期化する
+ * @param	capacity	管理するバッファのサイズ
+ */
+void RingAllocator::initialize(uint64_t capacity) noexcept {
+    frames_.clear();
+    capacity_ = capacity;
+    head_ = 0;
+    tail_ = 0;
+    usedSize_ = 0;
+    frameSize_ = 0;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	領域を確保する
+ * @param	size		確保するサイズ
+ * @param	alignment	アライメント（2 の累乗）
+ * @return	確保した領域のオフセット、空きが無い場合は invalidOffset
+ */
+[[nodiscard]] uint64_t RingAllocator::allocate(uint64_t size, uint64_t alignment) noexcept {
+    assert(alignment != 0 && (alignment & (alignment - 1)) == 0 && "アライメントが 2 の累乗ではありません");
+
+    if (size == 0 || size > capacity_) {
+        return invalidOffset;
+    }
+
+    // 全て空いていて GPU の処理待ちのフレームも無いなら先頭から使い直す
+    // 処理待ちのフレームが残っていると、解放した時に末尾がそのフレームの終端へ戻ってしまう
+    if (usedSize_ == 0 && frames_.empty()) {
+        head_ = 0;
+        tail_ = 0;
+    } else if (head_ == tail_) {
+        // 使用中なのに先頭と末尾が一致している場合は満杯
+        return invalidOffset;
+    }
+
+    const auto offset = alignUp(head_, alignment);
+    uint64_t   consumed = 0;  // 今回の確保で消費するサイズ（パディングを含む）
+    uint64_t   result = invalidOffset;
+
+    if (head_ >= tail_) {
+        // [tail_, head_) が使用中なので末尾と先頭の空きを順に調べる
+        if (offset + size <= capacity_) {
+            result = offset;
+            consumed = offset + size - head_;
+        } else if (size <= tail_) {
+            // 末尾に収まらないので先頭へ折り返す（末尾の残りは捨てる）
+            result = 0;
+            consumed = capacity_ - head_ + size;
+        }
+    } else {
+        // [head_, tail_) が空き領域
+        if (offset + size <= tail_) {
+            result = offset;
+            consumed = offset + size - head_;
+        }
+    }
+
+    if (result == invalidOffset) {
+        return invalidOffset;
+    }
+
+    head_ = result + size;
+    usedSize_ += consumed;
+    frameSize_ += consumed;
+    return result;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	現在のフレームで確保した領域をフェンス値で区切る
+ * 何も確保していないフレームは記録しない
+ * @param	fenceValue	このフレームの完了時にシグナルされるフェンス値
+ */
+void RingAllocator::finishFrame(uint64_t fenceValue) noexcept {
+    // 何も確保しなかったフレームは解放する領域が無いので積まない
+    if (frameSize_ == 0) {
+        return;
+    }
+    frames_.push_back({ fenceValue, head_, frameSize_ });
+    frameSize_ = 0;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	GPU の処理が完了したフレームの領域を解放する
+ * @param	completedFenceValue	GPU が到達済みのフェンス値
+ */
+void RingAllocator::release(uint64_t completedFenceValue) noexcept {
+    while (!frames_.empty() && frames_.front().fenceValue_ <= completedFenceValue) {
+        const auto& frame = frames_.front();
+        tail_ = frame.endOffset_;
+        usedSize_ -= frame.size_;
+        frames_.pop_front();
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	使用中の最も古いフレームのフェンス値を取得する
+ * @return	フェンス値、使用中のフレームが無い場合は 0
+ */
+[[nodiscard]] uint64_t RingAllocator::oldestFenceValue() const noexcept {
+    return frames_.empty() ? 0 : frames_.front().fenceValue_;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	使用中のサイズを取得する
+ * @return	使用中のサイズ（アライメントや折り返しによる無駄を含む）
+ */
+[[nodiscard]] uint64_t RingAllocator::usedSize() const noexcept {
+    return usedSize_;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	管理しているバッファのサイズを取得する
+ * @return	バッファのサイズ
+ */
+[[nodiscard]] uint64_t RingAllocator::capacity() const noexcept {
+    return capacity_;
+}
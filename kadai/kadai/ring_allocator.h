@@ -0,0 +1,102 @@
+﻿// リングアロケータクラス
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	リングアロケータクラス
+ * バッファ上のオフセットのみを管理し、GPU リソースには依存しない
+ * フレーム毎にフェンス値で区切り、GPU の処理が終わった領域から再利用する
+ */
+class RingAllocator final {
+public:
+    static constexpr uint64_t invalidOffset = UINT64_MAX;  /// 確保失敗を表すオフセット
+
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    コンストラクタ
+     */
+    RingAllocator() = default;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    デストラクタ
+     */
+    ~RingAllocator() = default;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	アロケータを初期化する
+     * @param	capacity	管理するバッファのサイズ
+     */
+    void initialize(uint64_t capacity) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	領域を確保する
+     * @param	size		確保するサイズ
+     * @param	alignment	アライメント（2 の累乗）
+     * @return	確保した領域のオフセット、空きが無い場合は invalidOffset
+     */
+    [[nodiscard]] uint64_t allocate(uint64_t size, uint64_t alignment) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	現在のフレームで確保した領域をフェンス値で区切る
+     * 何も確保していないフレームは記録しない
+     * @param	fenceValue	このフレームの完了時にシグナルされるフェンス値
+     */
+    void finishFrame(uint64_t fenceValue) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	GPU の処理が完了したフレームの領域を解放する
+     * @param	completedFenceValue	GPU が到達済みのフェンス値
+     */
+    void release(uint64_t completedFenceValue) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	使用中の最も古いフレームのフェンス値を取得する
+     * @return	フェンス値、使用中のフレームが無い場合は 0
+     */
+    [[nodiscard]] uint64_t oldestFenceValue() const noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	使用中のサイズを取得する
+     * @return	使用中のサイズ（アライメントや折り返しによる無駄を含む）
+     */
+    [[nodiscard]] uint64_t usedSize() const noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	管理しているバッファのサイズを取得する
+     * @return	バッファのサイズ
+     */
+    [[nodiscard]] uint64_t capacity() const noexcept;
+
+private:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	フレーム毎の使用領域
+     */
+    struct FrameEntry {
+        uint64_t fenceValue_{};  /// フレーム完了時のフェンス値
+        uint64_t endOffset_{};   /// フレームの終端オフセット
+        uint64_t size_{};        /// フレームで使用したサイズ
+    };
+
+private:
+    std::deque<FrameEntry> frames_{};  /// GPU の処理待ちのフレーム
+
+    uint64_t capacity_{};   /// バッファのサイズ
+    uint64_t head_{};       /// 次に確保する位置
+    uint64_t tail_{};       /// 使用中の最も古い位置
+    uint64_t usedSize_{};   /// 使用中のサイズ
+    uint64_t frameSize_{};  /// 現在のフレームで使用したサイズ
+};
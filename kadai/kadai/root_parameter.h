@@ -0,0 +1,17 @@
+﻿// ルートパラメータの番号
+
+#pragma once
+
+#include <cstdint>
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	ルートシグネチャのパラメータの番号
+ * ルートシグネチャの作成と、バックエンドに依存しない描画の記録の両方で使う
+ */
+namespace RootParameter {
+    constexpr uint32_t camera = 0;              /// カメラ（コマンドリスト毎に一度だけ設定するルート CBV）
+    constexpr uint32_t instances = 1;           /// インスタンスデータ（コマンドリスト毎に一度だけ設定するルート SRV）
+    constexpr uint32_t drawConstants = 2;       /// 描画毎の定数（ルート定数）
+    constexpr uint32_t drawConstantsCount = 1;  /// 描画毎の定数の 32bit 値の数
+}  // namespace RootParameter
@@ -1,6 +1,7 @@
 /// [gVOl`NX
 
 #include "root_signature.h"
+#include "pipeline_hasher.h"
 #include <cassert>
 
 //---------------------------------------------------------------------------------
@@ -24,35 +25,33 @@ RootSignature::~RootSignature() {
 [[nodiscard]] bool RootSignature::create(const Device& device) noexcept {
     // `ɕKvȃ\[XVF[_ɓ`
 
+    // [gp[^̐ݒ
+    // JƃCX^Xf[^̓Abv[hOobt@ GPU AhX𒼐ڐݒ肷̂ŁAfBXNv^e[uł͂Ȃ[gfBXNv^ɂ
+    // `斈ɕςl̓[g萔ɂāAR}hXgɒڏ
+    constexpr auto       paramNum = 3;
+    D3D12_ROOT_PARAMETER rootParameters[paramNum]{};
+
     // RX^gobt@( Xbg b0 )
     // ̏ꍇ̓J̃r[sˉes񂪓z
-    D3D12_DESCRIPTOR_RANGE r0{};
-    r0.RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_CBV;
-    r0.NumDescriptors = 1;
-    r0.BaseShaderRegister = 0;
-    r0.RegisterSpace = 0;
-    r0.OffsetInDescriptorsFromTableStart = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND;
-
-    // RX^gobt@( Xbg b1 )
-    // ̏ꍇ̓|S̃[hsFz
-    D3D12_DESCRIPTOR_RANGE r1{};
-    r1.RangeType = D3D12_DESCRIPTOR_RANGE_TYPE_CBV;
-    r1.NumDescriptors = 1;
-    r1.BaseShaderRegister = 1;  // Xbgԍ 1 ɕύX
-    r1.RegisterSpace = 0;
-    r1.OffsetInDescriptorsFromTableStart = D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND;
+    rootParameters[cameraParameter].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV;
+    rootParameters[cameraParameter].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;  // _VF[_[݂̂ŗp
+    rootParameters[cameraParameter].Descriptor.ShaderRegister = 0;
+    rootParameters[cameraParameter].Descriptor.RegisterSpace = 0;
 
-    // [gp[^̐ݒ
-    constexpr auto       paramNum = 2;
-    D3D12_ROOT_PARAMETER rootParameters[paramNum]{};
-    rootParameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
-    rootParameters[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;  // _VF[_[݂̂ŗp
-    rootParameters[0].DescriptorTable.NumDescriptorRanges = 1;
-    rootParameters[0].DescriptorTable.pDescriptorRanges = &r0;
-    rootParameters[1].ParameterType = D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE;
-    rootParameters[1].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL;  // SẴVF[_[ŗp
-    rootParameters[1].DescriptorTable.NumDescriptorRanges = 1;
-    rootParameters[1].DescriptorTable.pDescriptorRanges = &r1;
+    // XgN`[hobt@( Xbg t0 )
+    // t[̑SCX^X̃[hsF̔z񂪓z
+    rootParameters[instanceParameter].ParameterType = D3D12_ROOT_PARAMETER_TYPE_SRV;
+    rootParameters[instanceParameter].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;  // _VF[_[݂̂ŗp
+    rootParameters[instanceParameter].Descriptor.ShaderRegister = 0;
+    rootParameters[instanceParameter].Descriptor.RegisterSpace = 0;
+
+    // [g萔( Xbg b1 )
+    // `斈̃CX^Xf[^̊Jnʒuz
+    rootParameters[drawConstantsParameter].ParameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS;
+    rootParameters[drawConstantsParameter].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX;  // _VF[_[݂̂ŗp
+    rootParameters[drawConstantsParameter].Constants.ShaderRegister = 1;
+    rootParameters[drawConstantsParameter].Constants.RegisterSpace = 0;
+    rootParameters[drawConstantsParameter].Constants.Num32BitValues = drawConstantsCount;
 
     // [gVOl`̐ݒ
     D3D12_ROOT_SIGNATURE_DESC rootSignatureDesc{};
@@ -75,6 +74,9 @@ RootSignature::~RootSignature() {
         assert(false && "[gVOl`̃VACYɎs");
     }
     else {
+        // pCvCLbṼL[Ɏg߁AVACYʂ̃nbVlcĂ
+        hash_ = PipelineHasher::hashBytes(signature->GetBufferPointer(), signature->GetBufferSize());
+
         // [gVOl`̐
         res = device.get()->CreateRootSignature(
             0,
@@ -111,3 +113,17 @@ RootSignature::~RootSignature() {
 
     return rootSignature_;
 }
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	[gVOl`̃nbVl擾
+ * VACYʂvẐŁAsׂłlɂȂ
+ * @return	nbVl
+ */
+[[nodiscard]] uint64_t RootSignature::hash() const noexcept {
+    if (!rootSignature_) {
+        assert(false && "[gVOl`Ă܂");
+    }
+
+    return hash_;
+}
@@ -3,12 +3,19 @@
 #pragma once
 
 #include "device.h"
+#include "root_parameter.h"
 
 //---------------------------------------------------------------------------------
 /**
  * @brief	[gVOl`NX
  */
 class RootSignature final {
+public:
+    static constexpr UINT cameraParameter = RootParameter::camera;                 /// JiR}hXgɈxݒ肷郋[g CBVj
+    static constexpr UINT instanceParameter = RootParameter::instances;            /// CX^Xf[^iR}hXgɈxݒ肷郋[g SRVj
+    static constexpr UINT drawConstantsParameter = RootParameter::drawConstants;   /// `斈̒萔i[g萔j
+    static constexpr UINT drawConstantsCount = RootParameter::drawConstantsCount;  /// `斈̒萔 32bit l̐
+
 public:
     //---------------------------------------------------------------------------------
     /**
@@ -37,6 +44,15 @@ public:
      */
     [[nodiscard]] ID3D12RootSignature* get() const noexcept;
 
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	[gVOl`̃nbVl擾
+     * VACYʂvẐŁAsׂłlɂȂ
+     * @return	nbVl
+     */
+    [[nodiscard]] uint64_t hash() const noexcept;
+
 private:
     ID3D12RootSignature* rootSignature_{};  /// [gVOl`
+    uint64_t             hash_{};           /// VACYʂ̃nbVl
 };
@@ -0,0 +1,48 @@
+﻿// シーン描画パスクラス
+
+#include "scene_pass.h"
+#include "root_parameter.h"
+#include <cassert>
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	描画を記録する
+ * コマンドリスト毎にステートは引き継がれないので、共通の設定も毎回記録する
+ * 全てのパイプラインは同じルートシグネチャを使うこと
+ * @param	commandList	記録先のコマンドリスト
+ * @param	frame		全ての描画で共通の設定
+ * @param	draws		記録する描画
+ */
+void ScenePass::record(RhiCommandList& commandList, const Frame& frame, std::span<const Draw> draws) noexcept {
+    if (draws.empty()) {
+        return;
+    }
+    assert(frame.renderTarget_ && "描画先が未設定です");
+
+    commandList.setRenderTarget(*frame.renderTarget_);
+    commandList.setViewport(frame.viewport_);
+    commandList.setScissor(frame.scissor_);
+
+    // ルートパラメータはルートシグネチャの設定後でないと有効にならないので、先に最初のパイプラインを設定する
+    const auto* currentPipeline = draws.front().pipeline_;
+    commandList.setPipeline(*currentPipeline);
+
+    // カメラとインスタンスデータはコマンドリスト毎に一度だけ設定する
+    commandList.setConstantBuffer(RootParameter::camera, frame.camera_);
+    commandList.setShaderResource(RootParameter::instances, frame.instances_);
+
+    // 全メッシュが共有バッファに入っているので、バッファの設定は一度だけでよい
+    commandList.setVertexBuffer(frame.vertexBuffer_);
+    commandList.setIndexBuffer(frame.indexBuffer_);
+
+    // 描画毎にはルート定数でインスタンスデータの開始位置だけを変える
+    // パイプラインはバリエーションが変わった時だけ切り替える
+    for (const auto& draw : draws) {
+        if (draw.pipeline_ != currentPipeline) {
+            commandList.setPipeline(*draw.pipeline_);
+            currentPipeline = draw.pipeline_;
+        }
+        commandList.setConstant(RootParameter::drawConstants, draw.instanceOffset_, 0);
+        commandList.drawIndexedInstanced(draw.indexCount_, draw.instanceCount_, draw.startIndex_, draw.baseVertex_, 0);
+    }
+}
@@ -0,0 +1,57 @@
+﻿// シーン描画パスクラス
+
+#pragma once
+
+#include "rhi.h"
+#include <cstdint>
+#include <span>
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	シーン描画パスクラス
+ * フレームのインスタンスバッファとメッシュプールを使う描画を、バックエンドに依存せずに記録する
+ * D3D12 でもヌルデバイスでも同じコマンド列になるので、記録の CPU コストを GPU 無しで計測できる
+ */
+class ScenePass final {
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	描画単位
+     */
+    struct Draw {
+        const RhiPipeline* pipeline_{};        /// 描画に使うパイプライン
+        uint32_t           indexCount_{};      /// インデックス数
+        uint32_t           startIndex_{};      /// 先頭インデックスの位置
+        int32_t            baseVertex_{};      /// 先頭頂点の位置
+        uint32_t           instanceOffset_{};  /// フレームのインスタンスバッファ内の開始位置
+        uint32_t           instanceCount_{};   /// インスタンスの数
+    };
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	全ての描画で共通の設定
+     */
+    struct Frame {
+        RhiTexture*         renderTarget_{};  /// 描画先
+        RhiViewport         viewport_{};      /// ビューポート
+        RhiRect             scissor_{};       /// シザー矩形
+        RhiGpuAddress       camera_{};        /// カメラの定数データの GPU アドレス
+        RhiGpuAddress       instances_{};     /// フレームのインスタンスデータの GPU アドレス
+        RhiVertexBufferView vertexBuffer_{};  /// メッシュプールの共有頂点バッファ
+        RhiIndexBufferView  indexBuffer_{};   /// メッシュプールの共有インデックスバッファ
+    };
+
+public:
+    ScenePass() = delete;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	描画を記録する
+     * コマンドリスト毎にステートは引き継がれないので、共通の設定も毎回記録する
+     * 全てのパイプラインは同じルートシグネチャを使うこと
+     * @param	commandList	記録先のコマンドリスト
+     * @param	frame		全ての描画で共通の設定
+     * @param	draws		記録する描画
+     */
+    static void record(RhiCommandList& commandList, const Frame& frame, std::span<const Draw> draws) noexcept;
+};
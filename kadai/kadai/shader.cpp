@@ -1,14 +1,136 @@
 ﻿#include "shader.h"
 #include "device.h" // Deviceクラスが必要
 #include <cassert>
+#include <cstring>
 #include <string>
 #include <algorithm>
 #include <filesystem>
+#include <iterator>
 #include <D3Dcompiler.h>
 #include <stdio.h> // OutputDebugStringA のために必要
 
 #pragma comment(lib, "d3dcompiler.lib")
 
+// ビルド時にコンパイルしたシェーダのバイトコード
+// shader_permutations.targets が機能ビットの全ての組み合わせについて shader.hlsl をコンパイルし、
+// $(IntDir)shaders にバリエーション毎のヘッダと一覧の shader_variants.h を出力する
+#if __has_include("shader_variants.h")
+#include "shader_variants.h"
+#define SHADER_EMBEDDED_BYTECODE 1
+#endif
+
+// 開発中（デバッグビルド）のみ、バイトコードが無い場合に shader.hlsl を実行時にコンパイルする
+#if defined(_DEBUG)
+#define SHADER_RUNTIME_COMPILE 1
+#endif
+
+#if !defined(SHADER_EMBEDDED_BYTECODE) && !defined(SHADER_RUNTIME_COMPILE)
+#error "Shader bytecode headers are missing (build with shader_permutations.targets)"
+#endif
+
+namespace {
+#if defined(SHADER_EMBEDDED_BYTECODE)
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	実行ファイルに埋め込んだバリエーション
+     */
+    struct EmbeddedVariant {
+        const BYTE* vertexShader_{};      /// 頂点シェーダのバイトコード
+        size_t      vertexShaderSize_{};  /// 頂点シェーダのサイズ
+        const BYTE* pixelShader_{};       /// ピクセルシェーダのバイトコード
+        size_t      pixelShaderSize_{};   /// ピクセルシェーダのサイズ
+    };
+
+    /// 埋め込んだバリエーションの一覧（キーの順に並ぶ）
+#define SHADER_EMBEDDED_VARIANT(key) { g_shader_vs_##key, sizeof(g_shader_vs_##key), g_shader_ps_##key, sizeof(g_shader_ps_##key) },
+    constexpr EmbeddedVariant embeddedVariants[] = { SHADER_VARIANTS(SHADER_EMBEDDED_VARIANT) };
+#undef SHADER_EMBEDDED_VARIANT
+
+    static_assert(SHADER_VARIANT_COUNT == ShaderVariantRegistry::keyCount, "全てのキーのバリエーションがビルドされていません");
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	埋め込んだバリエーションを探す
+     * @param	key	バリエーションのキー
+     * @return	バリエーション、埋め込まれていない場合は nullptr
+     */
+    [[nodiscard]] const EmbeddedVariant* findEmbeddedVariant(ShaderKey key) noexcept {
+        return key < std::size(embeddedVariants) ? &embeddedVariants[key] : nullptr;
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	埋め込まれたバイトコードからシェーダのデータを作る
+     * @param	bytecode	バイトコードの先頭
+     * @param	size		バイトコードのサイズ
+     * @param	blob		作成したシェーダのデータ
+     * @return	成功すれば true
+     */
+    [[nodiscard]] bool createFromBytecode(const void* bytecode, size_t size, ID3DBlob** blob) noexcept {
+        if (FAILED(D3DCreateBlob(size, blob))) {
+            assert(false && "Shader Blob Create Failed");
+            return false;
+        }
+        std::memcpy((*blob)->GetBufferPointer(), bytecode, size);
+        return true;
+    }
+#endif
+
+#if defined(SHADER_RUNTIME_COMPILE)
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	シェーダファイルを実行時にコンパイルする
+     * 開発中のみ使うので、デバッグ情報付き・最適化なしでコンパイルする
+     * @param	path		シェーダファイルのパス
+     * @param	key			バリエーションのキー
+     * @param	entryPoint	エントリポイント名
+     * @param	target		シェーダモデル
+     * @param	blob		コンパイルしたシェーダのデータ
+     * @return	成功すれば true
+     */
+    [[nodiscard]] bool compileFromFile(const std::wstring& path, ShaderKey key, const char* entryPoint, const char* target, ID3DBlob** blob) noexcept {
+        // ビルド時のエントリファイルと同じく、キーをマクロで渡して機能を切り替える
+        const auto             keyText = std::to_string(key);
+        const D3D_SHADER_MACRO macros[] = {
+            { "SHADER_KEY", keyText.c_str() },
+            { nullptr, nullptr },
+        };
+
+        ID3DBlob* error = nullptr;
+        const auto res = D3DCompileFromFile(
+            path.data(),
+            macros,
+            D3D_COMPILE_STANDARD_FILE_INCLUDE,  // shader_features.h をインクルードするため
+            entryPoint,
+            target,
+            D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION,
+            0,
+            blob,
+            &error
+        );
+
+        if (FAILED(res)) {
+            if (error) {
+                char* p = static_cast<char*>(error->GetBufferPointer());
+                OutputDebugStringA("Shader Compile Error: ");
+                OutputDebugStringA(p);
+                // 日本語エラーを英語に変更 (改行エラー回避)
+                assert(false && "Shader Compile Failed (Check Output Window)");
+            }
+            else {
+                assert(false && "Shader Compile Failed (File Not Found or Path Error)");
+            }
+        }
+        if (error) { // 警告などでBLOBが生成された場合も解放する
+            error->Release();
+            error = nullptr;
+        }
+
+        return SUCCEEDED(res) && *blob;
+    }
+#endif
+}  // namespace
+
 //---------------------------------------------------------------------------------
 /**
  * @brief	デストラクタ
@@ -28,96 +150,42 @@ Shader::~Shader() {
 //---------------------------------------------------------------------------------
 /**
  * @brief	シェーダを作成する
+ * ビルド時にコンパイルしたバイトコードを使い、無い場合は開発中のみ実行時にコンパイルする
  * @param	device	デバイスクラスのインスタンス
+ * @param	key		作成するバリエーションのキー
  * @return	成功すれば true
  */
-[[nodiscard]] bool Shader::create(const Device& device) noexcept {
-
-    // 実行ファイルがあるディレクトリの絶対パスを取得し、シェーダファイルのパスを構築する
-    wchar_t exePath[MAX_PATH];
-    GetModuleFileNameW(nullptr, exePath, MAX_PATH);
-
-    std::filesystem::path fullPath(exePath);
-    std::wstring dir = fullPath.parent_path().wstring();
-
-    // shader.hlsl への絶対パスを構築 (実行ファイルと同じディレクトリを想定)
-    std::wstring shaderFullPath = dir + L"\\shader.hlsl";
-
-    ID3DBlob* error = nullptr;
-    HRESULT res;
-    bool success = true;
-
-    //---------------------------------------------------------------------
-    // 1. 頂点シェーダのコンパイル (エントリポイント名は "main" を使用)
-    res = D3DCompileFromFile(
-        shaderFullPath.data(),
-        nullptr,
-        nullptr,
-        "main",
-        "vs_5_0",
-        D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION,
-        0,
-        &vertexShader_,
-        &error
-    );
-
-    if (FAILED(res)) {
-        success = false;
-        if (error) {
-            char* p = static_cast<char*>(error->GetBufferPointer());
-            OutputDebugStringA("VS Compile Error: ");
-            OutputDebugStringA(p);
-            // 日本語エラーを英語に変更 (改行エラー回避)
-            assert(false && "Vertex Shader Compile Failed (Check Output Window)");
-            error->Release();
-            error = nullptr;
-        }
-        else {
-            assert(false && "Vertex Shader Compile Failed (File Not Found or Path Error)");
-        }
-    }
-    if (error) { // 失敗しなかったが、警告などでBLOBが生成された場合の解放処理
-        error->Release();
-        error = nullptr;
-    }
-    if (!vertexShader_) { return false; } // コンパイル失敗時に false を返す
-
-    //---------------------------------------------------------------------
-    // 2. ピクセルシェーダのコンパイル
-    res = D3DCompileFromFile(
-        shaderFullPath.data(),
-        nullptr,
-        nullptr,
-        "ps",
-        "ps_5_0",
-        D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION,
-        0,
-        &pixelShader_,
-        &error
-    );
-
-    if (FAILED(res)) {
-        success = false;
-        if (error) {
-            char* p = static_cast<char*>(error->GetBufferPointer());
-            OutputDebugStringA("PS Compile Error: ");
-            OutputDebugStringA(p);
-            // 日本語エラーを英語に変更
-            assert(false && "Pixel Shader Compile Failed (Check Output Window)");
-            error->Release();
-            error = nullptr;
-        }
-        else {
-            assert(false && "Pixel Shader Compile Failed (File Not Found or Path Error)");
-        }
+[[nodiscard]] bool Shader::create(const Device& device, ShaderKey key) noexcept {
+    key_ = key;
+
+#if defined(SHADER_EMBEDDED_BYTECODE)
+    // 最適化済みのバイトコードが実行ファイルに入っているので、起動時のコンパイルもシェーダファイルも不要
+    if (const auto* variant = findEmbeddedVariant(key)) {
+        if (!createFromBytecode(variant->vertexShader_, variant->vertexShaderSize_, &vertexShader_)) { return false; }
+        if (!createFromBytecode(variant->pixelShader_, variant->pixelShaderSize_, &pixelShader_)) { return false; }
+        return true;
     }
-    if (error) {
-        error->Release();
-        error = nullptr;
+#endif
+
+#if defined(SHADER_RUNTIME_COMPILE)
+    // shader.hlsl は shader_features.h を相対パスでインクルードするので、ソースのディレクトリにある両方をそのまま使う
+    // ソースが無い環境では、shader_permutations.targets が実行ファイルの隣にコピーした両方を使う
+    auto shaderPath = std::filesystem::path(__FILE__).parent_path() / L"shader.hlsl";
+    if (!std::filesystem::exists(shaderPath)) {
+        wchar_t exePath[MAX_PATH];
+        GetModuleFileNameW(nullptr, exePath, MAX_PATH);
+        shaderPath = std::filesystem::path(exePath).parent_path() / L"shader.hlsl";
     }
-    if (!pixelShader_) { return false; }
+    const auto shaderFullPath = shaderPath.wstring();
 
-    return success;
+    // エントリポイント名は shader.hlsl の関数名に合わせる
+    if (!compileFromFile(shaderFullPath, key, "vs", "vs_5_0", &vertexShader_)) { return false; }
+    if (!compileFromFile(shaderFullPath, key, "ps", "ps_5_0", &pixelShader_)) { return false; }
+    return true;
+#else
+    assert(false && "Shader Variant Not Embedded (Check SHADER_FEATURE_COUNT)");
+    return false;
+#endif
 }
 
 //---------------------------------------------------------------------------------
@@ -142,4 +210,13 @@ Shader::~Shader() {
         assert(false && "Pixel Shader is nullptr");
     }
     return pixelShader_;
-}
\ No newline at end of file
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	バリエーションのキーを取得する
+ * @return	バリエーションのキー
+ */
+[[nodiscard]] ShaderKey Shader::key() const noexcept {
+    return key_;
+}
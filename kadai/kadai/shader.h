@@ -3,6 +3,7 @@
 #pragma once
 
 #include "device.h"
+#include "shader_permutation.h"
 
 //---------------------------------------------------------------------------------
 /**
@@ -25,10 +26,12 @@ public:
     //---------------------------------------------------------------------------------
     /**
      * @brief	VF[_쐬
+     * rhɃRpCoCgR[hgAꍇ͊ĴݎsɃRpC
      * @param	device	foCXNX̃CX^X
+     * @param	key		쐬oG[ṼL[
      * @return	 true
      */
-    [[nodiscard]] bool create(const Device& device) noexcept;
+    [[nodiscard]] bool create(const Device& device, ShaderKey key) noexcept;
 
     //---------------------------------------------------------------------------------
     /**
@@ -44,8 +47,16 @@ public:
      */
     [[nodiscard]] ID3DBlob* pixelShader() const noexcept;
 
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	oG[ṼL[擾
+     * @return	oG[ṼL[
+     */
+    [[nodiscard]] ShaderKey key() const noexcept;
+
 
 private:
     ID3DBlob* vertexShader_{};  /// _VF[_
     ID3DBlob* pixelShader_{};   /// sNZVF[_
+    ShaderKey key_{};           /// oG[ṼL[
 };
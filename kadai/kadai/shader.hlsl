@@ -1,10 +1,32 @@
 // _obt@̓ê܂܏o͂VF[_
+// @\̑gݍ킹ɕʂ̃VF[_ƂăRpCA͑SăvvZbTŉ
+
+#include "shader_features.h"
+
+// oG[ṼL[ishader_permutations.targets Ǝs̃RpCŃ}NƂēnj
+#ifndef SHADER_KEY
+#define SHADER_KEY (SHADER_FEATURE_INSTANCING | SHADER_FEATURE_VERTEX_COLOR)
+#endif
+
+#define USE_INSTANCING   ((SHADER_KEY & SHADER_FEATURE_INSTANCING) != 0)
+#define USE_VERTEX_COLOR ((SHADER_KEY & SHADER_FEATURE_VERTEX_COLOR) != 0)
+#define USE_FOG          ((SHADER_KEY & SHADER_FEATURE_FOG) != 0)
+#define USE_ALPHA_TEST   ((SHADER_KEY & SHADER_FEATURE_ALPHA_TEST) != 0)
+
+// ̐ݒir[Ԃ̉sj
+static const float3 fogColor = float3(0.2f, 0.2f, 0.2f); // wĩNAFɍ킹
+static const float fogStart = 5.0f; // n߂鋗
+static const float fogEnd = 50.0f; // ̐FɂȂ鋗
+
+// At@eXg臒l
+static const float alphaTestThreshold = 0.5f;
 
 // _VF[_͍̓\
 struct VSInput
 {
     float3 position : POSITION; // ́F_W
     float4 color : COLOR; // ́F_F
+    uint instanceId : SV_InstanceID; // ́FCX^Xԍ
 };
 
 // JRX^gobt@
@@ -14,11 +36,20 @@ cbuffer ConstantBuffer : register(b0)
     matrix projection;
 };
 
-// |SRX^gobt@
-cbuffer ConstantBuffer : register(b1)
+// CX^X̃f[^
+struct InstanceData
 {
-    matrix world;
-    float4 color;
+    matrix world; // |S̃[hs
+    float4 color; // |S̐F
+};
+
+// CX^Xf[^̔zit[̑SCX^Xj
+StructuredBuffer<InstanceData> instances : register(t0);
+
+// `斈̒萔i[g萔j
+cbuffer DrawConstants : register(b1)
+{
+    uint instanceOffset; // ̕`ŎgCX^Xf[^̊Jnʒu
 };
 
 
@@ -27,6 +58,9 @@ struct VSOutput
 {
     float4 position : SV_POSITION; // óFϊW
     float4 color : COLOR; // óF_F
+#if USE_FOG
+    float fog : FOG; // óF̔Z
+#endif
 };
 
 
@@ -37,17 +71,32 @@ VSOutput vs(VSInput input)
 {
     VSOutput output;
     
+#if USE_INSTANCING
+    // `̊JnʒuƃCX^Xԍ玩̃f[^o
+    InstanceData instance = instances[instanceOffset + input.instanceId];
+#else
+    // `斈Ɉ̃f[^g
+    InstanceData instance = instances[instanceOffset];
+#endif
+    
     // 3DW4DWɕϊ
     float4 pos = float4(input.position, 1.0f);
 	
-    pos = mul(pos, world); // |S̃[hsŃ[hϊ	
+    pos = mul(pos, instance.world); // |S̃[hsŃ[hϊ	
     pos = mul(pos, view); // J̃r[sŃr[ϊ
+#if USE_FOG
+    output.fog = saturate((pos.z - fogStart) / (fogEnd - fogStart)); // r[Ԃ̉s疶̔Z߂
+#endif
     pos = mul(pos, projection); // J̃vWFNVsŃvWFNVϊ
 	
     output.position = pos;
     
-    // F̂܂܎̒iKɓn
-    output.color = input.color;
+#if USE_VERTEX_COLOR
+    // |S̐Fƒ_FZĎ̒iKɓn
+    output.color = input.color * instance.color;
+#else
+    output.color = instance.color;
+#endif
     
     return output;
 }
@@ -57,6 +106,13 @@ VSOutput vs(VSInput input)
 // -------------------------------
 float4 ps(VSOutput input) : SV_TARGET
 {
-	// |S̐Fƒ_FZďo
-    return input.color * color;
+	// _VF[_ŏZς݂̐F̂܂܏o
+    float4 color = input.color;
+#if USE_ALPHA_TEST
+    clip(color.a - alphaTestThreshold);
+#endif
+#if USE_FOG
+    color.rgb = lerp(color.rgb, fogColor, input.fog);
+#endif
+    return color;
 }
\ No newline at end of file
@@ -0,0 +1,15 @@
+﻿// シェーダの機能ビット
+// HLSL と C++ の両方からインクルードするので、マクロ定義とコメントのみを書く
+
+#ifndef SHADER_FEATURES_H
+#define SHADER_FEATURES_H
+
+// 各ビットの組み合わせがシェーダのバリエーションのキーになる
+#define SHADER_FEATURE_INSTANCING   0x1  // インスタンス番号でインスタンスデータを引く
+#define SHADER_FEATURE_VERTEX_COLOR 0x2  // 頂点色をインスタンスの色に乗算する
+#define SHADER_FEATURE_FOG          0x4  // ビュー空間の奥行きに応じて霧の色を混ぜる
+#define SHADER_FEATURE_ALPHA_TEST   0x8  // アルファ値が閾値未満のピクセルを捨てる
+
+#define SHADER_FEATURE_COUNT 4  // 機能ビットの数
+
+#endif  // SHADER_FEATURES_H
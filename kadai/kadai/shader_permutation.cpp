@@ -0,0 +1,62 @@
+﻿// シェーダバリエーションクラス
+
+#include "shader_permutation.h"
+#include <cassert>
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief    コンストラクタ
+ */
+ShaderVariantRegistry::ShaderVariantRegistry() noexcept {
+    indices_.fill(invalidIndex);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	使うキーを登録する
+ * 同じキーを何度登録しても番号は変わらない
+ * @param	key	シェーダのキー
+ * @return	登録したキーの番号、キーが範囲外の場合は invalidIndex
+ */
+uint32_t ShaderVariantRegistry::add(ShaderKey key) noexcept {
+    if (key >= keyCount) {
+        assert(false && "シェーダのキーが範囲外です");
+        return invalidIndex;
+    }
+
+    if (indices_[key] == invalidIndex) {
+        indices_[key] = static_cast<uint32_t>(keys_.size());
+        keys_.push_back(key);
+    }
+    return indices_[key];
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	キーの番号を取得する
+ * @param	key	シェーダのキー
+ * @return	キーの番号、未登録の場合は invalidIndex
+ */
+[[nodiscard]] uint32_t ShaderVariantRegistry::find(ShaderKey key) const noexcept {
+    return key < keyCount ? indices_[key] : invalidIndex;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	番号のキーを取得する
+ * @param	index	キーの番号
+ * @return	シェーダのキー
+ */
+[[nodiscard]] ShaderKey ShaderVariantRegistry::key(uint32_t index) const noexcept {
+    assert(index < keys_.size() && "シェーダのバリエーションの番号が範囲外です");
+    return keys_[index];
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	登録したキーの数を取得する
+ * @return	登録したキーの数
+ */
+[[nodiscard]] uint32_t ShaderVariantRegistry::size() const noexcept {
+    return static_cast<uint32_t>(keys_.size());
+}
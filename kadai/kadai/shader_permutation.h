@@ -0,0 +1,102 @@
+﻿// シェーダバリエーションクラス
+
+#pragma once
+
+#include "shader_features.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/// シェーダのバリエーションのキー（機能ビットの組み合わせ）
+using ShaderKey = uint32_t;
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	シェーダの機能ビット
+ * 値は HLSL と共有する shader_features.h の定義をそのまま使う
+ */
+namespace ShaderFeature {
+    constexpr ShaderKey none = 0;                                   /// 機能なし
+    constexpr ShaderKey instancing = SHADER_FEATURE_INSTANCING;     /// インスタンス番号でインスタンスデータを引く
+    constexpr ShaderKey vertexColor = SHADER_FEATURE_VERTEX_COLOR;  /// 頂点色をインスタンスの色に乗算する
+    constexpr ShaderKey fog = SHADER_FEATURE_FOG;                   /// ビュー空間の奥行きに応じて霧の色を混ぜる
+    constexpr ShaderKey alphaTest = SHADER_FEATURE_ALPHA_TEST;      /// アルファ値が閾値未満のピクセルを捨てる
+
+    constexpr uint32_t  count = SHADER_FEATURE_COUNT;  /// 機能ビットの数
+    constexpr ShaderKey all = (1u << count) - 1;       /// 全ての機能ビット
+
+    static_assert((instancing | vertexColor | fog | alphaTest) == all, "機能ビットの定義と数が一致していません");
+}  // namespace ShaderFeature
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	キーが機能を含むかを調べる
+ * @param	key		シェーダのキー
+ * @param	feature	調べる機能ビット
+ * @return	全て含む場合は true
+ */
+[[nodiscard]] constexpr bool hasShaderFeature(ShaderKey key, ShaderKey feature) noexcept {
+    return (key & feature) == feature;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	シェーダバリエーションクラス
+ * 使うキーを登録順に番号付けし、キーから番号を配列の添え字だけで引けるようにする
+ * 番号はシェーダやパイプラインステートの配列の添え字として使う
+ */
+class ShaderVariantRegistry final {
+public:
+    static constexpr uint32_t invalidIndex = UINT32_MAX;                          /// 未登録を表す番号
+    static constexpr size_t   keyCount = size_t{ 1 } << ShaderFeature::count;  /// キーの取り得る値の数
+
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    コンストラクタ
+     */
+    ShaderVariantRegistry() noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    デストラクタ
+     */
+    ~ShaderVariantRegistry() = default;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	使うキーを登録する
+     * 同じキーを何度登録しても番号は変わらない
+     * @param	key	シェーダのキー
+     * @return	登録したキーの番号、キーが範囲外の場合は invalidIndex
+     */
+    uint32_t add(ShaderKey key) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	キーの番号を取得する
+     * @param	key	シェーダのキー
+     * @return	キーの番号、未登録の場合は invalidIndex
+     */
+    [[nodiscard]] uint32_t find(ShaderKey key) const noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	番号のキーを取得する
+     * @param	index	キーの番号
+     * @return	シェーダのキー
+     */
+    [[nodiscard]] ShaderKey key(uint32_t index) const noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	登録したキーの数を取得する
+     * @return	登録したキーの数
+     */
+    [[nodiscard]] uint32_t size() const noexcept;
+
+private:
+    std::array<uint32_t, keyCount> indices_{};  /// キー毎の番号
+    std::vector<ShaderKey>         keys_{};     /// 番号毎のキー
+};
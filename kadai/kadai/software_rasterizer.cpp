@@ -0,0 +1,770 @@
+﻿// ソフトウェアラスタライザクラス
+
+#include "software_rasterizer.h"
+#include "profiler.h"
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <emmintrin.h>
+
+namespace {
+    // shader.hlsl と同じ霧とアルファテストの設定
+    constexpr float fogColor[3] = { 0.2f, 0.2f, 0.2f };  /// 霧の色
+    constexpr float fogStart = 5.0f;                      /// 霧がかかり始める距離
+    constexpr float fogEnd = 50.0f;                       /// 霧の色だけになる距離
+    constexpr float alphaTestThreshold = 0.5f;            /// アルファテストの閾値
+
+    constexpr int32_t subPixelScale = 1 << SoftwareRasterizer::subPixelBits;  /// 1 ピクセルの固定小数点の値
+    constexpr int32_t subPixelHalf = subPixelScale / 2;                        /// ピクセルの中心までの固定小数点の値
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	4 ピクセル分の書き込みマスク（カバレッジのビットから引く）
+     */
+    alignas(16) constexpr int32_t laneMasks[16][4] = {
+        { 0, 0, 0, 0 }, { -1, 0, 0, 0 }, { 0, -1, 0, 0 }, { -1, -1, 0, 0 },
+        { 0, 0, -1, 0 }, { -1, 0, -1, 0 }, { 0, -1, -1, 0 }, { -1, -1, -1, 0 },
+        { 0, 0, 0, -1 }, { -1, 0, 0, -1 }, { 0, -1, 0, -1 }, { -1, -1, 0, -1 },
+        { 0, 0, -1, -1 }, { -1, 0, -1, -1 }, { 0, -1, -1, -1 }, { -1, -1, -1, -1 },
+    };
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	転置済みの行列同士を掛ける
+     * 転置済みの行列は列ベクトルに左から掛ける形になるので、a * b は b の変換の後に a の変換を行う
+     * @param	a		後に行う変換
+     * @param	b		先に行う変換
+     * @param	output	書き込み先
+     */
+    void multiplyMatrix(const float* a, const float* b, float* output) noexcept {
+        for (int row = 0; row < 4; ++row) {
+            for (int column = 0; column < 4; ++column) {
+                output[row * 4 + column] = a[row * 4 + 0] * b[0 * 4 + column] + a[row * 4 + 1] * b[1 * 4 + column] +
+                                           a[row * 4 + 2] * b[2 * 4 + column] + a[row * 4 + 3] * b[3 * 4 + column];
+            }
+        }
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	色を R8G8B8A8_UNORM のピクセルにする
+     * @param	color	色（r, g, b, a）
+     * @return	ピクセル
+     */
+    [[nodiscard]] uint32_t packColor(const float (&color)[4]) noexcept {
+        uint32_t pixel = 0;
+        for (int i = 0; i < 4; ++i) {
+            const auto value = static_cast<uint32_t>(std::lround(std::clamp(color[i], 0.0f, 1.0f) * 255.0f));
+            pixel |= value << (i * 8);
+        }
+        return pixel;
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	視錐台の平面までの距離を求める
+     * @param	position	クリップ空間の座標
+     * @param	plane		平面の番号（-x, +x, -y, +y, 手前, 奥）
+     * @return	内側なら 0 以上
+     */
+    [[nodiscard]] float planeDistance(const float (&position)[4], int plane) noexcept {
+        switch (plane) {
+            case 0: return position[3] + position[0];
+            case 1: return position[3] - position[0];
+            case 2: return position[3] + position[1];
+            case 3: return position[3] - position[1];
+            case 4: return position[2];
+            default: return position[3] - position[2];
+        }
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	インデックスを読む
+     * @param	indices		インデックスバッファの先頭
+     * @param	indexSize	一インデックスのサイズ
+     * @param	position	読む位置
+     * @return	インデックス
+     */
+    [[nodiscard]] uint32_t readIndex(const void* indices, uint32_t indexSize, uint32_t position) noexcept {
+        if (indexSize == 2) {
+            return static_cast<const uint16_t*>(indices)[position];
+        }
+        return static_cast<const uint32_t*>(indices)[position];
+    }
+}  // namespace
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief    デストラクタ
+ */
+SoftwareRasterizer::~SoftwareRasterizer() {
+    // ワーカースレッドを終了させる
+    {
+        std::lock_guard lock(mutex_);
+        quit_ = true;
+    }
+    startCondition_.notify_all();
+    for (auto& thread : threads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    threads_.clear();
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	描画先とワーカースレッドを作成する
+ * @param	width		描画先の幅
+ * @param	height		描画先の高さ
+ * @param	threadCount	ラスタライズに使うスレッドの数（呼び出し元のスレッドを含む）
+ * @return	生成の成否
+ */
+[[nodiscard]] bool SoftwareRasterizer::create(uint32_t width, uint32_t height, uint32_t threadCount) noexcept {
+    if (width == 0 || height == 0 || width > maxSize || height > maxSize) {
+        assert(false && "描画先の大きさが範囲外です");
+        return false;
+    }
+
+    width_ = width;
+    height_ = height;
+    tilesX_ = (width + tileSize - 1) / tileSize;
+    tilesY_ = (height + tileSize - 1) / tileSize;
+    pitch_ = tilesX_ * tileSize;
+
+    // タイル単位で書き込めるよう、端のタイルも丸ごと確保しておく
+    pixels_.assign(static_cast<size_t>(pitch_) * tilesY_ * tileSize, 0);
+    bins_.resize(static_cast<size_t>(tilesX_) * tilesY_);
+
+    threadCount = std::max(threadCount, 1u);
+    queues_.reserve(threadCount);
+    for (uint32_t i = 0; i < threadCount; ++i) {
+        queues_.push_back(std::make_unique<TileQueue>());
+    }
+
+    // 0 番は呼び出し元のスレッドが担当するので、1 番以降のスレッドを作る
+    threads_.reserve(threadCount - 1);
+    for (uint32_t i = 1; i < threadCount; ++i) {
+        threads_.emplace_back(&SoftwareRasterizer::workerMain, this, i);
+    }
+
+    return true;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	描画先を塗りつぶす
+ * 振り分け済みの三角形は先にラスタライズする
+ * @param	color	塗りつぶす色（r, g, b, a）
+ */
+void SoftwareRasterizer::clear(const float (&color)[4]) noexcept {
+    flush();
+    std::fill(pixels_.begin(), pixels_.end(), packColor(color));
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	描画する
+ * 頂点処理とクリッピングを行い、三角形をタイルに振り分ける。ピクセルは flush まで書き込まない
+ * 入力のデータは呼び出し中にしか参照しない
+ * @param	drawCall	描画の入力
+ */
+void SoftwareRasterizer::draw(const DrawCall& drawCall) noexcept {
+    if (!drawCall.vertices_ || !drawCall.indices_ || !drawCall.camera_ || !drawCall.instances_) {
+        assert(false && "描画の入力が不足しています");
+        return;
+    }
+    if (drawCall.indexSize_ != 2 && drawCall.indexSize_ != 4) {
+        assert(false && "インデックスのサイズが不正です");
+        return;
+    }
+    if (drawCall.indexCount_ < 3 || drawCall.instanceCount_ == 0) {
+        return;
+    }
+    ++statistics_.drawCount_;
+
+    // 参照される頂点の範囲を調べ、その範囲だけを頂点処理する
+    int64_t minVertex = INT64_MAX;
+    int64_t maxVertex = INT64_MIN;
+    for (uint32_t i = 0; i < drawCall.indexCount_; ++i) {
+        const auto vertex = static_cast<int64_t>(readIndex(drawCall.indices_, drawCall.indexSize_, drawCall.startIndex_ + i)) + drawCall.baseVertex_;
+        minVertex = std::min(minVertex, vertex);
+        maxVertex = std::max(maxVertex, vertex);
+    }
+    if (minVertex < 0 || maxVertex >= drawCall.vertexCount_) {
+        assert(false && "インデックスが頂点バッファの範囲外です");
+        return;
+    }
+    vertices_.resize(static_cast<size_t>(maxVertex - minVertex + 1));
+
+    const auto useInstancing = hasShaderFeature(drawCall.key_, ShaderFeature::instancing);
+    const auto useVertexColor = hasShaderFeature(drawCall.key_, ShaderFeature::vertexColor);
+    const auto useFog = hasShaderFeature(drawCall.key_, ShaderFeature::fog);
+
+    for (uint32_t instanceId = 0; instanceId < drawCall.instanceCount_; ++instanceId) {
+        const auto& instance = drawCall.instances_[drawCall.instanceOffset_ + (useInstancing ? instanceId : 0)];
+
+        // ワールド・ビュー変換と、それに射影変換まで合わせた行列を作る
+        float worldView[16];
+        float worldViewProjection[16];
+        multiplyMatrix(drawCall.camera_->view_, instance.world_, worldView);
+        multiplyMatrix(drawCall.camera_->projection_, worldView, worldViewProjection);
+
+        for (size_t i = 0; i < vertices_.size(); ++i) {
+            const auto* source = drawCall.vertices_ + (minVertex + i) * drawCall.vertexStride_;
+            float position[3];
+            float color[4];
+            std::memcpy(position, source, sizeof(position));
+            std::memcpy(color, source + sizeof(position), sizeof(color));
+
+            auto& vertex = vertices_[i];
+            for (int row = 0; row < 4; ++row) {
+                const auto* m = &worldViewProjection[row * 4];
+                vertex.position_[row] = m[0] * position[0] + m[1] * position[1] + m[2] * position[2] + m[3];
+            }
+            for (int c = 0; c < 4; ++c) {
+                vertex.color_[c] = useVertexColor ? color[c] * instance.color_[c] : instance.color_[c];
+            }
+            vertex.fog_ = 0.0f;
+            if (useFog) {
+                const auto viewZ = worldView[8] * position[0] + worldView[9] * position[1] + worldView[10] * position[2] + worldView[11];
+                vertex.fog_ = std::clamp((viewZ - fogStart) / (fogEnd - fogStart), 0.0f, 1.0f);
+            }
+        }
+
+        for (uint32_t i = 0; i + 2 < drawCall.indexCount_; i += 3) {
+            ClipVertex triangle[3];
+            for (uint32_t k = 0; k < 3; ++k) {
+                const auto vertex = static_cast<int64_t>(readIndex(drawCall.indices_, drawCall.indexSize_, drawCall.startIndex_ + i + k)) + drawCall.baseVertex_;
+                triangle[k] = vertices_[static_cast<size_t>(vertex - minVertex)];
+            }
+            clipTriangle(triangle, drawCall);
+        }
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	振り分け済みの三角形をタイル毎に並列にラスタライズする
+ * 全てのタイルが終わるまで戻らない
+ */
+void SoftwareRasterizer::flush() noexcept {
+    if (triangles_.empty()) {
+        return;
+    }
+
+    // 三角形の多いタイルから順に各スレッドへ配る
+    std::vector<uint32_t> tiles;
+    for (uint32_t i = 0; i < bins_.size(); ++i) {
+        if (!bins_[i].empty()) {
+            tiles.push_back(i);
+        }
+    }
+    std::stable_sort(tiles.begin(), tiles.end(), [this](uint32_t a, uint32_t b) { return bins_[a].size() > bins_[b].size(); });
+    for (size_t i = 0; i < tiles.size(); ++i) {
+        queues_[i % queues_.size()]->tiles_.push_back(tiles[i]);
+    }
+
+    {
+        std::lock_guard lock(mutex_);
+        pending_ = static_cast<uint32_t>(threads_.size());
+        ++generation_;
+    }
+    if (!threads_.empty()) {
+        startCondition_.notify_all();
+    }
+
+    // 0 番のキューは自分で処理する
+    processTiles(0);
+
+    // 他のスレッドの完了を待つ
+    {
+        std::unique_lock lock(mutex_);
+        doneCondition_.wait(lock, [this] { return pending_ == 0; });
+    }
+
+    for (const auto tile : tiles) {
+        bins_[tile].clear();
+    }
+    triangles_.clear();
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	描画先の幅を取得する
+ * @return	幅
+ */
+[[nodiscard]] uint32_t SoftwareRasterizer::width() const noexcept {
+    return width_;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	描画先の高さを取得する
+ * @return	高さ
+ */
+[[nodiscard]] uint32_t SoftwareRasterizer::height() const noexcept {
+    return height_;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	ピクセルを取得する
+ * @param	x	x 座標
+ * @param	y	y 座標
+ * @return	R8G8B8A8_UNORM のピクセル（下位のバイトから r, g, b, a）
+ */
+[[nodiscard]] uint32_t SoftwareRasterizer::pixel(uint32_t x, uint32_t y) const noexcept {
+    assert(x < width_ && y < height_ && "座標が範囲外です");
+    return pixels_[static_cast<size_t>(y) * pitch_ + x];
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	全てのピクセルを行の順に詰めて取り出す
+ * @param	output	書き込み先（幅 × 高さの要素数になる）
+ */
+void SoftwareRasterizer::copyPixels(std::vector<uint32_t>& output) const noexcept {
+    output.resize(static_cast<size_t>(width_) * height_);
+    for (uint32_t y = 0; y < height_; ++y) {
+        const auto* row = &pixels_[static_cast<size_t>(y) * pitch_];
+        std::copy(row, row + width_, output.begin() + static_cast<ptrdiff_t>(y) * width_);
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	統計情報を取得する
+ * @return	統計情報
+ */
+[[nodiscard]] SoftwareRasterizer::Statistics SoftwareRasterizer::statistics() const noexcept {
+    auto statistics = statistics_;
+    statistics.pixelCount_ = pixelCount_.load(std::memory_order_relaxed);
+    statistics.stealCount_ = stealCount_.load(std::memory_order_relaxed);
+    return statistics;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	統計情報をリセットする
+ */
+void SoftwareRasterizer::resetStatistics() noexcept {
+    statistics_ = {};
+    pixelCount_.store(0, std::memory_order_relaxed);
+    stealCount_.store(0, std::memory_order_relaxed);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	三角形を視錐台でクリッピングしてラスタライズの準備をする
+ * @param	vertices	三角形の頂点
+ * @param	drawCall	描画の入力
+ */
+void SoftwareRasterizer::clipTriangle(const ClipVertex (&vertices)[3], const DrawCall& drawCall) noexcept {
+    // 各頂点がどの平面の外側にあるかを調べる
+    uint32_t outside[3]{};
+    for (int i = 0; i < 3; ++i) {
+        for (int plane = 0; plane < 6; ++plane) {
+            if (planeDistance(vertices[i].position_, plane) < 0.0f) {
+                outside[i] |= 1u << plane;
+            }
+        }
+    }
+
+    // 全ての頂点が同じ平面の外側なら見えない
+    if (outside[0] & outside[1] & outside[2]) {
+        return;
+    }
+    // 全ての頂点が内側ならそのまま使う
+    const auto crossed = outside[0] | outside[1] | outside[2];
+    if (crossed == 0) {
+        setupTriangle(vertices[0], vertices[1], vertices[2], drawCall);
+        return;
+    }
+
+    // 跨いでいる平面で順に切り取る（三角形を 6 平面で切ると最大 9 頂点になる）
+    ClipVertex polygons[2][9];
+    int count = 3;
+    std::copy(std::begin(vertices), std::end(vertices), polygons[0]);
+    int current = 0;
+    for (int plane = 0; plane < 6; ++plane) {
+        if ((crossed & (1u << plane)) == 0) {
+            continue;
+        }
+        const auto* input = polygons[current];
+        auto* output = polygons[current ^ 1];
+        int outputCount = 0;
+        for (int i = 0; i < count; ++i) {
+            const auto& a = input[i];
+            const auto& b = input[(i + 1) % count];
+            const auto distanceA = planeDistance(a.position_, plane);
+            const auto distanceB = planeDistance(b.position_, plane);
+            if (distanceA >= 0.0f) {
+                output[outputCount++] = a;
+            }
+            if ((distanceA >= 0.0f) != (distanceB >= 0.0f)) {
+                // 平面との交点の属性はクリップ空間で線形に補間する
+                const auto t = distanceA / (distanceA - distanceB);
+                auto& vertex = output[outputCount++];
+                for (int k = 0; k < 4; ++k) {
+                    vertex.position_[k] = a.position_[k] + (b.position_[k] - a.position_[k]) * t;
+                    vertex.color_[k] = a.color_[k] + (b.color_[k] - a.color_[k]) * t;
+                }
+                vertex.fog_ = a.fog_ + (b.fog_ - a.fog_) * t;
+            }
+        }
+        count = outputCount;
+        current ^= 1;
+        if (count < 3) {
+            return;
+        }
+    }
+
+    // 切り取った凸多角形を扇状の三角形に分ける
+    const auto* polygon = polygons[current];
+    for (int i = 1; i + 1 < count; ++i) {
+        setupTriangle(polygon[0], polygon[i], polygon[i + 1], drawCall);
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	ラスタライズの準備をしてタイルに振り分ける
+ * @param	v0			頂点 0
+ * @param	v1			頂点 1
+ * @param	v2			頂点 2
+ * @param	drawCall	描画の入力
+ */
+void SoftwareRasterizer::setupTriangle(const ClipVertex& v0, const ClipVertex& v1, const ClipVertex& v2, const DrawCall& drawCall) noexcept {
+    const ClipVertex* vertices[3] = { &v0, &v1, &v2 };
+
+    // ビューポート変換して固定小数点に丸める
+    const auto& viewport = drawCall.viewport_;
+    constexpr auto limit = static_cast<float>(maxSize * subPixelScale);
+    int32_t x[3];
+    int32_t y[3];
+    float   invW[3];
+    for (int i = 0; i < 3; ++i) {
+        const auto& position = vertices[i]->position_;
+        invW[i] = 1.0f / position[3];
+        const auto screenX = viewport.x_ + (position[0] * invW[i] + 1.0f) * 0.5f * viewport.width_;
+        const auto screenY = viewport.y_ + (1.0f - position[1] * invW[i]) * 0.5f * viewport.height_;
+        x[i] = static_cast<int32_t>(std::lround(std::clamp(screenX * subPixelScale, 0.0f, limit)));
+        y[i] = static_cast<int32_t>(std::lround(std::clamp(screenY * subPixelScale, 0.0f, limit)));
+    }
+
+    // カリングはしないので、裏向きの三角形は頂点を入れ替えて表向きにそろえる
+    auto area = static_cast<int64_t>(x[1] - x[0]) * (y[2] - y[0]) - static_cast<int64_t>(y[1] - y[0]) * (x[2] - x[0]);
+    if (area == 0) {
+        return;
+    }
+    if (area < 0) {
+        std::swap(vertices[1], vertices[2]);
+        std::swap(x[1], x[2]);
+        std::swap(y[1], y[2]);
+        std::swap(invW[1], invW[2]);
+        area = -area;
+    }
+
+    Triangle triangle{};
+    triangle.key_ = drawCall.key_;
+
+    // 範囲をシザー矩形と描画先で切り詰める
+    triangle.minX_ = std::max({ *std::min_element(x, x + 3) >> subPixelBits, drawCall.scissor_.left_, 0 });
+    triangle.minY_ = std::max({ *std::min_element(y, y + 3) >> subPixelBits, drawCall.scissor_.top_, 0 });
+    triangle.maxX_ = std::min({ (*std::max_element(x, x + 3) >> subPixelBits) + 1, drawCall.scissor_.right_, static_cast<int32_t>(width_) });
+    triangle.maxY_ = std::min({ (*std::max_element(y, y + 3) >> subPixelBits) + 1, drawCall.scissor_.bottom_, static_cast<int32_t>(height_) });
+    if (triangle.minX_ >= triangle.maxX_ || triangle.minY_ >= triangle.maxY_) {
+        return;
+    }
+
+    // 頂点 i の向かいの辺のエッジ関数（三角形の内側で正になる）
+    for (int i = 0; i < 3; ++i) {
+        const auto from = (i + 1) % 3;
+        const auto to = (i + 2) % 3;
+        const auto a = y[from] - y[to];
+        const auto b = x[to] - x[from];
+        triangle.edgeA_[i] = a;
+        triangle.edgeB_[i] = b;
+        triangle.edgeC_[i] = -(static_cast<int64_t>(a) * x[from] + static_cast<int64_t>(b) * y[from]);
+        // 左上ルール：左の辺と上の辺の上に中心があるピクセルだけを含める
+        const auto topLeft = a > 0 || (a == 0 && b > 0);
+        triangle.edgeBias_[i] = topLeft ? 0 : -1;
+    }
+
+    // 重心座標の傾きから、1/w を掛けた属性の平面を作る（パースペクティブ補正）
+    const auto scale = static_cast<float>(subPixelScale) / static_cast<float>(area);
+    const float gradientX[2] = { triangle.edgeA_[1] * scale, triangle.edgeA_[2] * scale };
+    const float gradientY[2] = { triangle.edgeB_[1] * scale, triangle.edgeB_[2] * scale };
+    float attributes[3][6];
+    for (int i = 0; i < 3; ++i) {
+        attributes[i][0] = invW[i];
+        for (int c = 0; c < 4; ++c) {
+            attributes[i][1 + c] = vertices[i]->color_[c] * invW[i];
+        }
+        attributes[i][5] = vertices[i]->fog_ * invW[i];
+    }
+    for (int k = 0; k < 6; ++k) {
+        const auto delta1 = attributes[1][k] - attributes[0][k];
+        const auto delta2 = attributes[2][k] - attributes[0][k];
+        triangle.planes_[k][0] = attributes[0][k];
+        triangle.planes_[k][1] = delta1 * gradientX[0] + delta2 * gradientX[1];
+        triangle.planes_[k][2] = delta1 * gradientY[0] + delta2 * gradientY[1];
+    }
+    triangle.originX_ = static_cast<float>(x[0]) / subPixelScale;
+    triangle.originY_ = static_cast<float>(y[0]) / subPixelScale;
+
+    // 重なるタイルに振り分ける
+    const auto index = static_cast<uint32_t>(triangles_.size());
+    triangles_.push_back(triangle);
+    ++statistics_.triangleCount_;
+    constexpr auto tile = static_cast<int32_t>(tileSize);
+    for (auto tileY = triangle.minY_ / tile; tileY <= (triangle.maxY_ - 1) / tile; ++tileY) {
+        for (auto tileX = triangle.minX_ / tile; tileX <= (triangle.maxX_ - 1) / tile; ++tileX) {
+            bins_[static_cast<size_t>(tileY) * tilesX_ + tileX].push_back(index);
+            ++statistics_.binnedCount_;
+        }
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	ワーカースレッドの処理
+ * @param	threadIndex	ワーカースレッドの番号
+ */
+void SoftwareRasterizer::workerMain(uint32_t threadIndex) noexcept {
+    Profiler::instance().setThreadName("SoftwareRasterizer");
+
+    uint64_t seenGeneration = 0;
+    while (true) {
+        {
+            std::unique_lock lock(mutex_);
+            startCondition_.wait(lock, [&] { return quit_ || generation_ != seenGeneration; });
+            if (quit_) {
+                return;
+            }
+            seenGeneration = generation_;
+        }
+
+        processTiles(threadIndex);
+
+        bool finished = false;
+        {
+            std::lock_guard lock(mutex_);
+            finished = (--pending_ == 0);
+        }
+        if (finished) {
+            doneCondition_.notify_one();
+        }
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	タイルが無くなるまでラスタライズする
+ * @param	threadIndex	スレッドの番号
+ */
+void SoftwareRasterizer::processTiles(uint32_t threadIndex) noexcept {
+    const ProfileScope scope("rasterizeTiles");
+    uint64_t pixelCount = 0;
+    uint64_t stealCount = 0;
+    uint32_t tileIndex = 0;
+    bool     stolen = false;
+    while (popTile(threadIndex, tileIndex, stolen)) {
+        pixelCount += rasterizeTile(tileIndex);
+        stealCount += stolen ? 1 : 0;
+    }
+    pixelCount_.fetch_add(pixelCount, std::memory_order_relaxed);
+    stealCount_.fetch_add(stealCount, std::memory_order_relaxed);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	次に処理するタイルを取り出す
+ * 自分のキューの先頭（重いタイル）から取り、空なら他のスレッドのキューの末尾（軽いタイル）から盗む
+ * @param	threadIndex	スレッドの番号
+ * @param	tileIndex	取り出したタイルの番号
+ * @param	stolen		盗んだ場合は true
+ * @return	取り出せた場合は true
+ */
+[[nodiscard]] bool SoftwareRasterizer::popTile(uint32_t threadIndex, uint32_t& tileIndex, bool& stolen) noexcept {
+    {
+        auto& queue = *queues_[threadIndex];
+        std::lock_guard lock(queue.mutex_);
+        if (!queue.tiles_.empty()) {
+            tileIndex = queue.tiles_.front();
+            queue.tiles_.pop_front();
+            stolen = false;
+            return true;
+        }
+    }
+
+    // flush の途中でタイルは増えないので、一周して全て空なら終わり
+    const auto queueCount = static_cast<uint32_t>(queues_.size());
+    for (uint32_t i = 1; i < queueCount; ++i) {
+        auto& queue = *queues_[(threadIndex + i) % queueCount];
+        std::lock_guard lock(queue.mutex_);
+        if (!queue.tiles_.empty()) {
+            tileIndex = queue.tiles_.back();
+            queue.tiles_.pop_back();
+            stolen = true;
+            return true;
+        }
+    }
+    return false;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	一つのタイルに振り分けた三角形をラスタライズする
+ * @param	tileIndex	タイルの番号
+ * @return	書き込んだピクセルの数
+ */
+[[nodiscard]] uint64_t SoftwareRasterizer::rasterizeTile(uint32_t tileIndex) noexcept {
+    const auto tileLeft = static_cast<int32_t>((tileIndex % tilesX_) * tileSize);
+    const auto tileTop = static_cast<int32_t>((tileIndex / tilesX_) * tileSize);
+
+    const auto zero = _mm_setzero_ps();
+    const auto one = _mm_set1_ps(1.0f);
+    const auto byteMask = _mm_set1_epi32(0xff);
+    const auto toUnit = _mm_set1_ps(1.0f / 255.0f);
+    const auto toByte = _mm_set1_ps(255.0f);
+    const auto laneOffsets = _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f);
+
+    uint64_t pixelCount = 0;
+    for (const auto index : bins_[tileIndex]) {
+        const auto& triangle = triangles_[index];
+        const auto left = std::max(triangle.minX_, tileLeft);
+        const auto top = std::max(triangle.minY_, tileTop);
+        const auto right = std::min(triangle.maxX_, tileLeft + static_cast<int32_t>(tileSize));
+        const auto bottom = std::min(triangle.maxY_, tileTop + static_cast<int32_t>(tileSize));
+
+        // タイル内の範囲の四隅で各辺を調べ、完全に外側なら捨て、完全に内側の辺は評価を省く
+        const int64_t sampleLeft = left * subPixelScale + subPixelHalf;
+        const int64_t sampleTop = top * subPixelScale + subPixelHalf;
+        const int64_t sampleRight = (right - 1) * subPixelScale + subPixelHalf;
+        const int64_t sampleBottom = (bottom - 1) * subPixelScale + subPixelHalf;
+        int  partialEdges[3];
+        int  partialCount = 0;
+        bool rejected = false;
+        for (int i = 0; i < 3; ++i) {
+            const int64_t a = triangle.edgeA_[i];
+            const int64_t b = triangle.edgeB_[i];
+            const auto c = triangle.edgeC_[i] + triangle.edgeBias_[i];
+            const auto minimum = c + a * (a > 0 ? sampleLeft : sampleRight) + b * (b > 0 ? sampleTop : sampleBottom);
+            const auto maximum = c + a * (a > 0 ? sampleRight : sampleLeft) + b * (b > 0 ? sampleBottom : sampleTop);
+            if (maximum < 0) {
+                rejected = true;
+                break;
+            }
+            if (minimum < 0) {
+                partialEdges[partialCount++] = i;
+            }
+        }
+        if (rejected) {
+            continue;
+        }
+
+        const auto useAlphaTest = hasShaderFeature(triangle.key_, ShaderFeature::alphaTest);
+        const auto useFog = hasShaderFeature(triangle.key_, ShaderFeature::fog);
+
+        // 4 ピクセル単位で処理するので、左端を 4 の倍数に揃える（タイルの左端も 4 の倍数）
+        const auto alignedLeft = left & ~3;
+        __m128i edgeSteps[3];
+        __m128i edgeLanes[3];
+        for (int p = 0; p < partialCount; ++p) {
+            const auto a = triangle.edgeA_[partialEdges[p]] * subPixelScale;
+            edgeSteps[p] = _mm_set1_epi32(a * 4);
+            edgeLanes[p] = _mm_set_epi32(a * 3, a * 2, a, 0);
+        }
+        __m128 planeX[6];
+        for (int k = 0; k < 6; ++k) {
+            planeX[k] = _mm_set1_ps(triangle.planes_[k][1]);
+        }
+
+        for (auto y = top; y < bottom; ++y) {
+            auto* row = &pixels_[static_cast<size_t>(y) * pitch_];
+            const int64_t sampleY = y * subPixelScale + subPixelHalf;
+
+            // 部分的に掛かる辺は、この行の左端の値から 4 ピクセルずつ 32bit のまま進める（タイル内なら桁あふれしない）
+            __m128i edges[3];
+            for (int p = 0; p < partialCount; ++p) {
+                const auto i = partialEdges[p];
+                const auto value = triangle.edgeC_[i] + triangle.edgeBias_[i] +
+                                   static_cast<int64_t>(triangle.edgeA_[i]) * (alignedLeft * subPixelScale + subPixelHalf) +
+                                   static_cast<int64_t>(triangle.edgeB_[i]) * sampleY;
+                edges[p] = _mm_add_epi32(_mm_set1_epi32(static_cast<int32_t>(value)), edgeLanes[p]);
+            }
+
+            const auto offsetY = static_cast<float>(y) + 0.5f - triangle.originY_;
+            __m128 planeRow[6];
+            for (int k = 0; k < 6; ++k) {
+                planeRow[k] = _mm_set1_ps(triangle.planes_[k][0] + triangle.planes_[k][2] * offsetY);
+            }
+
+            for (auto x = alignedLeft; x < right; x += 4) {
+                // 符号ビットが立っているレーンは辺の外側
+                auto outside = _mm_setzero_si128();
+                for (int p = 0; p < partialCount; ++p) {
+                    outside = _mm_or_si128(outside, edges[p]);
+                    edges[p] = _mm_add_epi32(edges[p], edgeSteps[p]);
+                }
+                auto coverage = ~_mm_movemask_ps(_mm_castsi128_ps(outside)) & 0xf;
+                if (x < left) {
+                    coverage &= ~((1 << (left - x)) - 1);
+                }
+                if (x + 4 > right) {
+                    coverage &= (1 << (right - x)) - 1;
+                }
+                if (coverage == 0) {
+                    continue;
+                }
+
+                // 1/w で割ってパースペクティブ補正した属性を求める
+                const auto offsetX = _mm_add_ps(_mm_set1_ps(static_cast<float>(x) + 0.5f - triangle.originX_), laneOffsets);
+                const auto w = _mm_div_ps(one, _mm_add_ps(planeRow[0], _mm_mul_ps(planeX[0], offsetX)));
+                __m128 color[4];
+                for (int c = 0; c < 4; ++c) {
+                    color[c] = _mm_mul_ps(_mm_add_ps(planeRow[1 + c], _mm_mul_ps(planeX[1 + c], offsetX)), w);
+                }
+
+                if (useAlphaTest) {
+                    coverage &= _mm_movemask_ps(_mm_cmpge_ps(color[3], _mm_set1_ps(alphaTestThreshold)));
+                    if (coverage == 0) {
+                        continue;
+                    }
+                }
+                if (useFog) {
+                    const auto fog = _mm_mul_ps(_mm_add_ps(planeRow[5], _mm_mul_ps(planeX[5], offsetX)), w);
+                    for (int c = 0; c < 3; ++c) {
+                        color[c] = _mm_add_ps(color[c], _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(fogColor[c]), color[c]), fog));
+                    }
+                }
+                for (auto& channel : color) {
+                    channel = _mm_min_ps(_mm_max_ps(channel, zero), one);
+                }
+
+                // SRC_ALPHA / INV_SRC_ALPHA で合成し、アルファはそのまま書き込む
+                const auto destination = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + x));
+                const auto inverseAlpha = _mm_sub_ps(one, color[3]);
+                auto packed = _mm_cvtps_epi32(_mm_mul_ps(color[3], toByte));
+                packed = _mm_slli_epi32(packed, 24);
+                for (int c = 0; c < 3; ++c) {
+                    const auto shift = _mm_cvtsi32_si128(c * 8);
+                    const auto target = _mm_mul_ps(_mm_cvtepi32_ps(_mm_and_si128(_mm_srl_epi32(destination, shift), byteMask)), toUnit);
+                    const auto blended = _mm_add_ps(_mm_mul_ps(color[c], color[3]), _mm_mul_ps(target, inverseAlpha));
+                    packed = _mm_or_si128(packed, _mm_sll_epi32(_mm_cvtps_epi32(_mm_mul_ps(blended, toByte)), shift));
+                }
+
+                const auto mask = _mm_load_si128(reinterpret_cast<const __m128i*>(laneMasks[coverage]));
+                const auto result = _mm_or_si128(_mm_and_si128(mask, packed), _mm_andnot_si128(mask, destination));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(row + x), result);
+                pixelCount += std::popcount(static_cast<uint32_t>(coverage));
+            }
+        }
+    }
+    return pixelCount;
+}
@@ -0,0 +1,295 @@
+﻿// ソフトウェアラスタライザクラス
+
+#pragma once
+
+#include "rhi.h"
+#include "shader_permutation.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	ソフトウェアラスタライザクラス
+ * shader.hlsl と PiplineStateObject の設定と同じ処理を CPU で行い、R8G8B8A8_UNORM の画素を作る
+ * GPU の無い環境で、比較用の正解画像の作成や描画結果の回帰テストに使う
+ *
+ * ・頂点処理		ワールド・ビュー・プロジェクション変換、頂点色とインスタンスの色の乗算、霧の濃さ
+ * ・クリッピング	同次座標で視錐台の 6 平面に対して行う（DepthClipEnable と同じ）
+ * ・ラスタライズ	頂点座標を固定小数点に丸め、エッジ関数を SSE2 で 4 ピクセルずつ評価する（左上ルール）
+ * ・ピクセル処理	パースペクティブ補正した色、アルファテスト、霧、SRC_ALPHA / INV_SRC_ALPHA のブレンド
+ *
+ * 三角形は画面のタイル毎に振り分けておき、flush でタイルをワーカースレッドに分配する
+ * 各スレッドは自分のキューが空になると他のスレッドのキューからタイルを盗むので、偏った画面でも負荷が揃う
+ * タイル内では三角形を描画の順に処理するので、結果はスレッド数によらず同じになる
+ * 深度バッファは使わない（描画時にデプスステンシルビューを設定していないため）
+ */
+class SoftwareRasterizer final {
+public:
+    static constexpr uint32_t tileSize = 64;      /// タイルの一辺のピクセル数
+    static constexpr uint32_t maxSize = 4096;     /// 描画先の幅と高さの上限（固定小数点のエッジ関数が 32bit に収まる範囲）
+    static constexpr int32_t  subPixelBits = 4;   /// 頂点座標の小数部のビット数
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	カメラの定数データ（シェーダの b0 と同じ並び）
+     */
+    struct CameraData {
+        float view_[16]{};        /// ビュー行列（転置済み）
+        float projection_[16]{};  /// 射影行列（転置済み）
+    };
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	インスタンスデータ（シェーダの t0 と同じ並び）
+     */
+    struct InstanceData {
+        float world_[16]{};  /// ワールド行列（転置済み）
+        float color_[4]{};   /// ポリゴンの色
+    };
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	描画の入力
+     * 頂点は MeshPool::Vertex と同じく、位置（float3）の後に色（float4）が続く並び
+     */
+    struct DrawCall {
+        const uint8_t*      vertices_{};        /// 頂点バッファの先頭
+        uint32_t            vertexStride_{};    /// 一頂点のサイズ
+        uint32_t            vertexCount_{};     /// 頂点バッファに入っている頂点数
+        const void*         indices_{};         /// インデックスバッファの先頭
+        uint32_t            indexSize_{};       /// 一インデックスのサイズ（2 か 4）
+        uint32_t            indexCount_{};      /// インスタンス毎のインデックス数
+        uint32_t            startIndex_{};      /// 先頭インデックスの位置
+        int32_t             baseVertex_{};      /// インデックスに加える頂点の位置
+        const CameraData*   camera_{};          /// カメラの定数データ
+        const InstanceData* instances_{};       /// インスタンスデータの配列
+        uint32_t            instanceOffset_{};  /// 使うインスタンスデータの開始位置
+        uint32_t            instanceCount_{};   /// インスタンスの数
+        ShaderKey           key_{};             /// シェーダのバリエーション
+        RhiViewport         viewport_{};        /// ビューポート
+        RhiRect             scissor_{};         /// シザー矩形
+    };
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	統計情報
+     */
+    struct Statistics {
+        uint64_t drawCount_{};      /// 描画の数
+        uint64_t triangleCount_{};  /// クリッピング後にラスタライズした三角形の数
+        uint64_t binnedCount_{};    /// タイルに振り分けた三角形の延べ数
+        uint64_t pixelCount_{};     /// 書き込んだピクセルの数
+        uint64_t stealCount_{};     /// 他のスレッドから盗んだタイルの数
+    };
+
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    コンストラクタ
+     */
+    SoftwareRasterizer() = default;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    デストラクタ
+     */
+    ~SoftwareRasterizer();
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	描画先とワーカースレッドを作成する
+     * @param	width		描画先の幅
+     * @param	height		描画先の高さ
+     * @param	threadCount	ラスタライズに使うスレッドの数（呼び出し元のスレッドを含む）
+     * @return	生成の成否
+     */
+    [[nodiscard]] bool create(uint32_t width, uint32_t height, uint32_t threadCount) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	描画先を塗りつぶす
+     * 振り分け済みの三角形は先にラスタライズする
+     * @param	color	塗りつぶす色（r, g, b, a）
+     */
+    void clear(const float (&color)[4]) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	描画する
+     * 頂点処理とクリッピングを行い、三角形をタイルに振り分ける。ピクセルは flush まで書き込まない
+     * 入力のデータは呼び出し中にしか参照しない
+     * @param	drawCall	描画の入力
+     */
+    void draw(const DrawCall& drawCall) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	振り分け済みの三角形をタイル毎に並列にラスタライズする
+     * 全てのタイルが終わるまで戻らない
+     */
+    void flush() noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	描画先の幅を取得する
+     * @return	幅
+     */
+    [[nodiscard]] uint32_t width() const noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	描画先の高さを取得する
+     * @return	高さ
+     */
+    [[nodiscard]] uint32_t height() const noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	ピクセルを取得する
+     * @param	x	x 座標
+     * @param	y	y 座標
+     * @return	R8G8B8A8_UNORM のピクセル（下位のバイトから r, g, b, a）
+     */
+    [[nodiscard]] uint32_t pixel(uint32_t x, uint32_t y) const noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	全てのピクセルを行の順に詰めて取り出す
+     * @param	output	書き込み先（幅 × 高さの要素数になる）
+     */
+    void copyPixels(std::vector<uint32_t>& output) const noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	統計情報を取得する
+     * @return	統計情報
+     */
+    [[nodiscard]] Statistics statistics() const noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	統計情報をリセットする
+     */
+    void resetStatistics() noexcept;
+
+private:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	クリップ空間の頂点
+     */
+    struct ClipVertex {
+        float position_[4]{};  /// クリップ空間の座標
+        float color_[4]{};     /// 色
+        float fog_{};          /// 霧の濃さ
+    };
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	ラスタライズの準備を済ませた三角形
+     * エッジ関数は 1/16 ピクセル単位の固定小数点、補間用の平面は先頭頂点を原点としたピクセル単位
+     */
+    struct Triangle {
+        int32_t   edgeA_[3]{};      /// エッジ関数の x の係数
+        int32_t   edgeB_[3]{};      /// エッジ関数の y の係数
+        int64_t   edgeC_[3]{};      /// エッジ関数の定数項
+        int32_t   edgeBias_[3]{};   /// 左上ルールのための補正（左上の辺は 0、それ以外は -1）
+        int32_t   minX_{};          /// 範囲の左端（ピクセル）
+        int32_t   minY_{};          /// 範囲の上端（ピクセル）
+        int32_t   maxX_{};          /// 範囲の右端（含まない）
+        int32_t   maxY_{};          /// 範囲の下端（含まない）
+        float     originX_{};       /// 補間の原点の x 座標
+        float     originY_{};       /// 補間の原点の y 座標
+        float     planes_[6][3]{};  /// 1/w と、1/w を掛けた r, g, b, a, 霧の濃さの平面（原点の値、x の傾き、y の傾き）
+        ShaderKey key_{};           /// シェーダのバリエーション
+    };
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	ワーカースレッド毎のタイルのキュー
+     */
+    struct TileQueue {
+        std::mutex           mutex_{};  /// キューを守るミューテックス
+        std::deque<uint32_t> tiles_{};  /// 処理するタイルの番号
+    };
+
+private:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	三角形を視錐台でクリッピングしてラスタライズの準備をする
+     * @param	vertices	三角形の頂点
+     * @param	drawCall	描画の入力
+     */
+    void clipTriangle(const ClipVertex (&vertices)[3], const DrawCall& drawCall) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	ラスタライズの準備をしてタイルに振り分ける
+     * @param	v0			頂点 0
+     * @param	v1			頂点 1
+     * @param	v2			頂点 2
+     * @param	drawCall	描画の入力
+     */
+    void setupTriangle(const ClipVertex& v0, const ClipVertex& v1, const ClipVertex& v2, const DrawCall& drawCall) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	ワーカースレッドの処理
+     * @param	threadIndex	ワーカースレッドの番号
+     */
+    void workerMain(uint32_t threadIndex) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	タイルが無くなるまでラスタライズする
+     * @param	threadIndex	スレッドの番号
+     */
+    void processTiles(uint32_t threadIndex) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	次に処理するタイルを取り出す
+     * 自分のキューの先頭（重いタイル）から取り、空なら他のスレッドのキューの末尾（軽いタイル）から盗む
+     * @param	threadIndex	スレッドの番号
+     * @param	tileIndex	取り出したタイルの番号
+     * @param	stolen		盗んだ場合は true
+     * @return	取り出せた場合は true
+     */
+    [[nodiscard]] bool popTile(uint32_t threadIndex, uint32_t& tileIndex, bool& stolen) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	一つのタイルに振り分けた三角形をラスタライズする
+     * @param	tileIndex	タイルの番号
+     * @return	書き込んだピクセルの数
+     */
+    [[nodiscard]] uint64_t rasterizeTile(uint32_t tileIndex) noexcept;
+
+private:
+    uint32_t                                width_{};       /// 描画先の幅
+    uint32_t                                height_{};      /// 描画先の高さ
+    uint32_t                                pitch_{};       /// 一行のピクセル数（タイルの大きさに切り上げ）
+    uint32_t                                tilesX_{};      /// 横方向のタイル数
+    uint32_t                                tilesY_{};      /// 縦方向のタイル数
+    std::vector<uint32_t>                   pixels_{};      /// 描画先（タイルの大きさに切り上げた大きさ）
+    std::vector<Triangle>                   triangles_{};   /// 振り分け済みの三角形
+    std::vector<std::vector<uint32_t>>      bins_{};        /// タイル毎の三角形の番号（描画の順）
+    std::vector<ClipVertex>                 vertices_{};    /// 頂点処理の結果の作業領域
+    std::vector<std::unique_ptr<TileQueue>> queues_{};      /// スレッド毎のタイルのキュー
+    Statistics                              statistics_{};  /// 統計情報（ピクセル数と盗んだ数以外）
+    std::atomic<uint64_t>                   pixelCount_{};  /// 書き込んだピクセルの数
+    std::atomic<uint64_t>                   stealCount_{};  /// 他のスレッドから盗んだタイルの数
+
+    std::vector<std::thread> threads_{};         /// ワーカースレッド
+    std::mutex               mutex_{};           /// 以下の状態を守るミューテックス
+    std::condition_variable  startCondition_{};  /// ラスタライズ開始の通知
+    std::condition_variable  doneCondition_{};   /// ラスタライズ完了の通知
+    uint64_t                 generation_{};      /// ラスタライズを依頼した回数
+    uint32_t                 pending_{};         /// 処理中のワーカースレッドの数
+    bool                     quit_{};            /// 終了要求
+};
@@ -1,7 +1,5 @@
 ﻿#pragma once
-#include "device.h"
-#include "command_list.h"
-#include <DirectXMath.h>
+#include "mesh_pool.h"
 
 class SquarePolygon
 {
@@ -13,17 +11,10 @@ public:
     };
 
     SquarePolygon() = default;
-    ~SquarePolygon();
-    [[nodiscard]] bool create(const Device& device) noexcept;
-    void draw(ID3D12GraphicsCommandList* list) const;
+    ~SquarePolygon() = default;
+    [[nodiscard]] bool create(MeshPool& meshPool, UploadManager& uploadManager) noexcept;
+    [[nodiscard]] const Mesh& mesh() const noexcept { return mesh_; }
 
 private:
-    [[nodiscard]] bool createVertexBuffer(const Device& device) noexcept;
-    [[nodiscard]] bool createIndexBuffer(const Device& device) noexcept;
-
-    ID3D12Resource* vertexBuffer_{};
-    ID3D12Resource* IndexBuffer_{};
-    D3D12_VERTEX_BUFFER_VIEW vertexBufferView_ = {};
-    D3D12_INDEX_BUFFER_VIEW  indexBufferView_ = {};
+    Mesh mesh_{};  // メッシュプール内の位置情報
 };
-
@@ -10,6 +10,10 @@
  * @brief    fXgN^
  */
 SwapChain::~SwapChain() {
+    if (frameLatencyWaitable_) {
+        CloseHandle(frameLatencyWaitable_);
+        frameLatencyWaitable_ = nullptr;
+    }
     if (swapChain_) {
         swapChain_->Release();
         swapChain_ = nullptr;
@@ -22,9 +26,10 @@ SwapChain::~SwapChain() {
  * @param	dxgi			dxgi NX̃CX^X
  * @param	window			EBhENX̃CX^X
  * @param	commandQueue	R}hL[NX̃CX^X
+ * @param	maxFrameLatency	Present słt[i0 Ȃҋ@\ɂȂj
  * @return	̐
  */
-[[nodiscard]] bool SwapChain::create(const DXGI& dxgi, const Window& window, const CommandQueue& commandQueue) noexcept {
+[[nodiscard]] bool SwapChain::create(const DXGI& dxgi, const Window& window, const CommandQueue& commandQueue, UINT maxFrameLatency) noexcept {
     // EBhETCY擾
     const auto [w, h] = window.size();
 
@@ -36,6 +41,9 @@ SwapChain::~SwapChain() {
     swapChainDesc_.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;  // _[^[QbgƂĎgp
     swapChainDesc_.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;    // t[ʍXV̂ŕ`悪Iobt@j
     swapChainDesc_.SampleDesc.Count = 1;                                // }`TvOȂ
+    if (maxFrameLatency > 0) {
+        swapChainDesc_.Flags = DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT;  // t[̊Jnnhő҂Ă悤ɂ
+    }
 
     // ꎞIȃXbv`FC̍쐬
     // Xbv`FC̃AbvO[hKvɂȂ
@@ -62,9 +70,105 @@ SwapChain::~SwapChain() {
         }
     }
 
+    sourceWidth_ = swapChainDesc_.Width;
+    sourceHeight_ = swapChainDesc_.Height;
+
+    // ҋ@\ȃXbv`FĆAsłt[ݒ肵Ăҋ@p̃nh擾
+    if (maxFrameLatency > 0) {
+        const auto hr = swapChain_->SetMaximumFrameLatency(maxFrameLatency);
+        if (FAILED(hr)) {
+            assert(false && "őt[x̐ݒɎs");
+            return false;
+        }
+        frameLatencyWaitable_ = swapChain_->GetFrameLatencyWaitableObject();
+        if (!frameLatencyWaitable_) {
+            assert(false && "t[x̑ҋ@pnh̎擾Ɏs");
+            return false;
+        }
+    }
+
     return true;
 }
 
+//---------------------------------------------------------------------------------
+/**
+ * @brief	obNobt@̃TCYύX
+ * obNobt@QƂĂ郊\[XƃR}hSĎĂĂ
+ * @param	width	
+ * @param	height	c
+ * @return	ύX̐
+ */
+[[nodiscard]] bool SwapChain::resize(UINT width, UINT height) noexcept {
+    if (!swapChain_) {
+        assert(false && "Xbv`FC쐬ł");
+        return false;
+    }
+
+    // obt@ƃtH[}bg͂̂܂܂ɂāA쐬̃tOiҋ@\Ȃǁjp
+    const auto hr = swapChain_->ResizeBuffers(swapChainDesc_.BufferCount, width, height, swapChainDesc_.Format, swapChainDesc_.Flags);
+    if (FAILED(hr)) {
+        assert(false && "obNobt@̃TCYύXɎs");
+        return false;
+    }
+    swapChainDesc_.Width = width;
+    swapChainDesc_.Height = height;
+
+    // TCYςƕ\Ɏg͈͂̓obNobt@Ŝɖ߂
+    sourceWidth_ = width;
+    sourceHeight_ = height;
+    return true;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	\ɎgobNobt@͈̔͂ݒ肷
+ * ォw肵TCY͈̔͂AEBhEŜɊg債ĕ\ig͕\ōsj
+ * @param	width	iobNobt@̉ȉj
+ * @param	height	ciobNobt@̏cȉj
+ * @return	ݒ̐
+ */
+[[nodiscard]] bool SwapChain::setSourceSize(UINT width, UINT height) noexcept {
+    if (!swapChain_) {
+        assert(false && "Xbv`FC쐬ł");
+        return false;
+    }
+    if (width == sourceWidth_ && height == sourceHeight_) {
+        return true;
+    }
+
+    const auto hr = swapChain_->SetSourceSize(width, height);
+    if (FAILED(hr)) {
+        assert(false && "\Ɏg͈͂̐ݒɎs");
+        return false;
+    }
+    sourceWidth_ = width;
+    sourceHeight_ = height;
+    return true;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	̃t[n߂悤ɂȂ܂ő҂
+ * ҋ@\ȃXbv`FCłȂΉȂ
+ * @param	timeout	҂Ԃ̏i~bj
+ * @return	҂Ă true
+ */
+[[nodiscard]] bool SwapChain::waitForFrame(DWORD timeout) const noexcept {
+    if (!frameLatencyWaitable_) {
+        return true;
+    }
+    return WaitForSingleObjectEx(frameLatencyWaitable_, timeout, TRUE) == WAIT_OBJECT_0;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	ҋ@\ȃXbv`FC
+ * @return	ҋ@\Ȃ true
+ */
+[[nodiscard]] bool SwapChain::isWaitable() const noexcept {
+    return frameLatencyWaitable_ != nullptr;
+}
+
 //---------------------------------------------------------------------------------
 /**
  * @brief	Xbv`FC擾
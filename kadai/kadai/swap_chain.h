@@ -9,6 +9,8 @@
 //---------------------------------------------------------------------------------
 /**
  * @brief	Xbv`FCNX
+ * őt[xw肵́Aҋ@\ȃXbv`FCƂč쐬
+ * ̏ꍇ Present ĂԑO waitForFrame ŃobNobt@󂭂̂҂
  */
 class SwapChain final {
 public:
@@ -30,9 +32,46 @@ public:
      * @param	dxgi			dxgi NX̃CX^X
      * @param	window			EBhENX̃CX^X
      * @param	commandQueue	R}hL[NX̃CX^X
+     * @param	maxFrameLatency	Present słt[i0 Ȃҋ@\ɂȂj
      * @return	̐
      */
-    [[nodiscard]] bool create(const DXGI& dxgi, const Window& window, const CommandQueue& commandQueue) noexcept;
+    [[nodiscard]] bool create(const DXGI& dxgi, const Window& window, const CommandQueue& commandQueue, UINT maxFrameLatency = 0) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	obNobt@̃TCYύX
+     * obNobt@QƂĂ郊\[XƃR}hSĎĂĂ
+     * @param	width	
+     * @param	height	c
+     * @return	ύX̐
+     */
+    [[nodiscard]] bool resize(UINT width, UINT height) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	\ɎgobNobt@͈̔͂ݒ肷
+     * ォw肵TCY͈̔͂AEBhEŜɊg債ĕ\ig͕\ōsj
+     * @param	width	iobNobt@̉ȉj
+     * @param	height	ciobNobt@̏cȉj
+     * @return	ݒ̐
+     */
+    [[nodiscard]] bool setSourceSize(UINT width, UINT height) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	̃t[n߂悤ɂȂ܂ő҂
+     * ҋ@\ȃXbv`FCłȂΉȂ
+     * @param	timeout	҂Ԃ̏i~bj
+     * @return	҂Ă true
+     */
+    [[nodiscard]] bool waitForFrame(DWORD timeout = 1000) const noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	ҋ@\ȃXbv`FC
+     * @return	ҋ@\Ȃ true
+     */
+    [[nodiscard]] bool isWaitable() const noexcept;
 
     //---------------------------------------------------------------------------------
     /**
@@ -52,4 +91,7 @@ public:
 private:
     IDXGISwapChain3* swapChain_{};      /// Xbv`FC
     DXGI_SWAP_CHAIN_DESC1 swapChainDesc_{};  /// Xbv`FC̐ݒ
+    HANDLE           frameLatencyWaitable_{};  /// t[x̑ҋ@pnh
+    UINT             sourceWidth_{};           /// \Ɏg͈͂̉
+    UINT             sourceHeight_{};          /// \Ɏg͈͂̏c
 };
\ No newline at end of file
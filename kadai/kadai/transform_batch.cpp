@@ -0,0 +1,379 @@
+﻿// ワールド行列の一括計算クラス
+
+#include "transform_batch.h"
+#include <immintrin.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// MSVC は命令セットの指定が無くても AVX2 の組み込み関数を使えるが、GCC / Clang は関数毎に許可が要る
+#if defined(__GNUC__) || defined(__clang__)
+#define TRANSFORM_BATCH_AVX2 __attribute__((target("avx2")))
+#else
+#define TRANSFORM_BATCH_AVX2
+#endif
+
+namespace {
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	AVX2 を使えるか調べる
+     * CPU が対応していても、OS が YMM レジスタを保存しない場合は使えない
+     * @return	使えれば true
+     */
+    [[nodiscard]] bool supportsAvx2() noexcept {
+#if defined(_MSC_VER)
+        int info[4]{};
+        __cpuid(info, 0);
+        if (info[0] < 7) {
+            return false;
+        }
+        __cpuid(info, 1);
+        const auto osxsave = (info[2] & (1 << 27)) != 0;
+        const auto avx = (info[2] & (1 << 28)) != 0;
+        if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+            return false;
+        }
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#else
+        return __builtin_cpu_supports("avx2");
+#endif
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	入力の位置を取得する
+     * @param	indices	入力の位置の並び（nullptr なら書き込み先と同じ位置）
+     * @param	i		書き込み先の位置
+     * @return	入力の位置
+     */
+    template <bool Indexed>
+    [[nodiscard]] size_t sourceIndex(const uint32_t* indices, size_t i) noexcept {
+        if constexpr (Indexed) {
+            return indices[i];
+        } else {
+            return i;
+        }
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	4 個分の入力を読み込む
+     * 位置の並びを使う場合は飛び飛びの位置から集める
+     * @param	values	入力の配列
+     * @param	indices	入力の位置の並び
+     * @param	i		書き込み先の位置
+     * @return	4 個分の値
+     */
+    template <bool Indexed>
+    [[nodiscard]] __m128 load4(const float* values, const uint32_t* indices, size_t i) noexcept {
+        if constexpr (Indexed) {
+            return _mm_setr_ps(values[indices[i]], values[indices[i + 1]], values[indices[i + 2]], values[indices[i + 3]]);
+        } else {
+            return _mm_loadu_ps(values + i);
+        }
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	8 個分の入力を読み込む
+     * 位置の並びを使う場合は AVX2 の gather で集める
+     * @param	values	入力の配列
+     * @param	indices	入力の位置の並び
+     * @param	i		書き込み先の位置
+     * @return	8 個分の値
+     */
+    template <bool Indexed>
+    [[nodiscard]] TRANSFORM_BATCH_AVX2 __m256 load8(const float* values, const uint32_t* indices, size_t i) noexcept {
+        if constexpr (Indexed) {
+            const auto offsets = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(indices + i));
+            return _mm256_i32gather_ps(values, offsets, sizeof(float));
+        } else {
+            return _mm256_loadu_ps(values + i);
+        }
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	一つのオブジェクトの行列を計算する
+     * @param	source		入力の配列
+     * @param	i			入力の位置
+     * @param	destination	書き込み先（float 16 個）
+     */
+    void composeScalar(const TransformBatch::Source& source, size_t i, float* destination) noexcept {
+        const auto x = source.rotationX_[i];
+        const auto y = source.rotationY_[i];
+        const auto z = source.rotationZ_[i];
+        const auto w = source.rotationW_[i];
+        const auto sx = source.scaleX_[i];
+        const auto sy = source.scaleY_[i];
+        const auto sz = source.scaleZ_[i];
+
+        // 回転行列の各行に拡大率を掛け、最後の行に移動を置いた行列を転置した形で書く
+        destination[0] = sx * (1.0f - 2.0f * (y * y + z * z));
+        destination[1] = sy * (2.0f * (x * y - z * w));
+        destination[2] = sz * (2.0f * (x * z + y * w));
+        destination[3] = source.positionX_[i];
+        destination[4] = sx * (2.0f * (x * y + z * w));
+        destination[5] = sy * (1.0f - 2.0f * (x * x + z * z));
+        destination[6] = sz * (2.0f * (y * z - x * w));
+        destination[7] = source.positionY_[i];
+        destination[8] = sx * (2.0f * (x * z - y * w));
+        destination[9] = sy * (2.0f * (y * z + x * w));
+        destination[10] = sz * (1.0f - 2.0f * (x * x + y * y));
+        destination[11] = source.positionZ_[i];
+        destination[12] = 0.0f;
+        destination[13] = 0.0f;
+        destination[14] = 0.0f;
+        destination[15] = 1.0f;
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	4 個ずつ SSE で計算する
+     * 要素毎に 4 個分をまとめて計算し、最後に 4x4 の転置でオブジェクト毎の並びに直す
+     * @param	source		入力の配列
+     * @param	indices		入力の位置の並び
+     * @param	begin		計算を始める位置
+     * @param	count		計算する数
+     * @param	destination	書き込み先の先頭
+     * @param	stride		行列の間隔（バイト）
+     * @return	計算し終えた位置（端数は計算しない）
+     */
+    template <bool Indexed>
+    [[nodiscard]] size_t composeSse(const TransformBatch::Source& source, const uint32_t* indices, size_t begin, size_t count, uint8_t* destination, size_t stride) noexcept {
+        const auto one = _mm_set1_ps(1.0f);
+        const auto two = _mm_set1_ps(2.0f);
+        const auto lastRow = _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f);
+
+        auto i = begin;
+        for (; i + 4 <= count; i += 4) {
+            const auto x = load4<Indexed>(source.rotationX_, indices, i);
+            const auto y = load4<Indexed>(source.rotationY_, indices, i);
+            const auto z = load4<Indexed>(source.rotationZ_, indices, i);
+            const auto w = load4<Indexed>(source.rotationW_, indices, i);
+            const auto sx = load4<Indexed>(source.scaleX_, indices, i);
+            const auto sy = load4<Indexed>(source.scaleY_, indices, i);
+            const auto sz = load4<Indexed>(source.scaleZ_, indices, i);
+
+            const auto xx = _mm_mul_ps(x, x);
+            const auto yy = _mm_mul_ps(y, y);
+            const auto zz = _mm_mul_ps(z, z);
+            const auto xy = _mm_mul_ps(x, y);
+            const auto xz = _mm_mul_ps(x, z);
+            const auto yz = _mm_mul_ps(y, z);
+            const auto xw = _mm_mul_ps(x, w);
+            const auto yw = _mm_mul_ps(y, w);
+            const auto zw = _mm_mul_ps(z, w);
+
+            // 転置後の行 r の要素 c を 4 個分
+            auto m00 = _mm_mul_ps(sx, _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))));
+            auto m01 = _mm_mul_ps(sy, _mm_mul_ps(two, _mm_sub_ps(xy, zw)));
+            auto m02 = _mm_mul_ps(sz, _mm_mul_ps(two, _mm_add_ps(xz, yw)));
+            auto m03 = load4<Indexed>(source.positionX_, indices, i);
+            auto m10 = _mm_mul_ps(sx, _mm_mul_ps(two, _mm_add_ps(xy, zw)));
+            auto m11 = _mm_mul_ps(sy, _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))));
+            auto m12 = _mm_mul_ps(sz, _mm_mul_ps(two, _mm_sub_ps(yz, xw)));
+            auto m13 = load4<Indexed>(source.positionY_, indices, i);
+            auto m20 = _mm_mul_ps(sx, _mm_mul_ps(two, _mm_sub_ps(xz, yw)));
+            auto m21 = _mm_mul_ps(sy, _mm_mul_ps(two, _mm_add_ps(yz, xw)));
+            auto m22 = _mm_mul_ps(sz, _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))));
+            auto m23 = load4<Indexed>(source.positionZ_, indices, i);
+
+            // 要素毎の並びをオブジェクト毎の行に直す
+            _MM_TRANSPOSE4_PS(m00, m01, m02, m03);
+            _MM_TRANSPOSE4_PS(m10, m11, m12, m13);
+            _MM_TRANSPOSE4_PS(m20, m21, m22, m23);
+            const __m128 rows[3][4] = {
+                { m00, m01, m02, m03 },
+                { m10, m11, m12, m13 },
+                { m20, m21, m22, m23 },
+            };
+            for (size_t k = 0; k < 4; ++k) {
+                auto* matrix = reinterpret_cast<float*>(destination + (i + k) * stride);
+                _mm_storeu_ps(matrix + 0, rows[0][k]);
+                _mm_storeu_ps(matrix + 4, rows[1][k]);
+                _mm_storeu_ps(matrix + 8, rows[2][k]);
+                _mm_storeu_ps(matrix + 12, lastRow);
+            }
+        }
+        return i;
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	128 ビット毎に 4x4 の転置を行う
+     * 下位 128 ビットは前半 4 個、上位 128 ビットは後半 4 個のオブジェクトの行になる
+     */
+    TRANSFORM_BATCH_AVX2 void transpose4x4Lanes(__m256& a, __m256& b, __m256& c, __m256& d) noexcept {
+        const auto t0 = _mm256_unpacklo_ps(a, b);
+        const auto t1 = _mm256_unpacklo_ps(c, d);
+        const auto t2 = _mm256_unpackhi_ps(a, b);
+        const auto t3 = _mm256_unpackhi_ps(c, d);
+        a = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(1, 0, 1, 0));
+        b = _mm256_shuffle_ps(t0, t1, _MM_SHUFFLE(3, 2, 3, 2));
+        c = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(1, 0, 1, 0));
+        d = _mm256_shuffle_ps(t2, t3, _MM_SHUFFLE(3, 2, 3, 2));
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	8 個ずつ AVX2 で計算する
+     * @param	source		入力の配列
+     * @param	indices		入力の位置の並び
+     * @param	count		計算する数
+     * @param	destination	書き込み先の先頭
+     * @param	stride		行列の間隔（バイト）
+     * @return	計算し終えた位置（端数は計算しない）
+     */
+    template <bool Indexed>
+    [[nodiscard]] TRANSFORM_BATCH_AVX2 size_t composeAvx2(const TransformBatch::Source& source, const uint32_t* indices, size_t count, uint8_t* destination, size_t stride) noexcept {
+        const auto one = _mm256_set1_ps(1.0f);
+        const auto two = _mm256_set1_ps(2.0f);
+        const auto lastRow = _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f);
+
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            const auto x = load8<Indexed>(source.rotationX_, indices, i);
+            const auto y = load8<Indexed>(source.rotationY_, indices, i);
+            const auto z = load8<Indexed>(source.rotationZ_, indices, i);
+            const auto w = load8<Indexed>(source.rotationW_, indices, i);
+            const auto sx = load8<Indexed>(source.scaleX_, indices, i);
+            const auto sy = load8<Indexed>(source.scaleY_, indices, i);
+            const auto sz = load8<Indexed>(source.scaleZ_, indices, i);
+
+            const auto xx = _mm256_mul_ps(x, x);
+            const auto yy = _mm256_mul_ps(y, y);
+            const auto zz = _mm256_mul_ps(z, z);
+            const auto xy = _mm256_mul_ps(x, y);
+            const auto xz = _mm256_mul_ps(x, z);
+            const auto yz = _mm256_mul_ps(y, z);
+            const auto xw = _mm256_mul_ps(x, w);
+            const auto yw = _mm256_mul_ps(y, w);
+            const auto zw = _mm256_mul_ps(z, w);
+
+            // 転置後の行 r の要素 c を 8 個分
+            auto m00 = _mm256_mul_ps(sx, _mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(yy, zz))));
+            auto m01 = _mm256_mul_ps(sy, _mm256_mul_ps(two, _mm256_sub_ps(xy, zw)));
+            auto m02 = _mm256_mul_ps(sz, _mm256_mul_ps(two, _mm256_add_ps(xz, yw)));
+            auto m03 = load8<Indexed>(source.positionX_, indices, i);
+            auto m10 = _mm256_mul_ps(sx, _mm256_mul_ps(two, _mm256_add_ps(xy, zw)));
+            auto m11 = _mm256_mul_ps(sy, _mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(xx, zz))));
+            auto m12 = _mm256_mul_ps(sz, _mm256_mul_ps(two, _mm256_sub_ps(yz, xw)));
+            auto m13 = load8<Indexed>(source.positionY_, indices, i);
+            auto m20 = _mm256_mul_ps(sx, _mm256_mul_ps(two, _mm256_sub_ps(xz, yw)));
+            auto m21 = _mm256_mul_ps(sy, _mm256_mul_ps(two, _mm256_add_ps(yz, xw)));
+            auto m22 = _mm256_mul_ps(sz, _mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(xx, yy))));
+            auto m23 = load8<Indexed>(source.positionZ_, indices, i);
+
+            transpose4x4Lanes(m00, m01, m02, m03);
+            transpose4x4Lanes(m10, m11, m12, m13);
+            transpose4x4Lanes(m20, m21, m22, m23);
+            const __m256 rows[3][4] = {
+                { m00, m01, m02, m03 },
+                { m10, m11, m12, m13 },
+                { m20, m21, m22, m23 },
+            };
+            for (size_t k = 0; k < 4; ++k) {
+                auto* low = reinterpret_cast<float*>(destination + (i + k) * stride);
+                auto* high = reinterpret_cast<float*>(destination + (i + k + 4) * stride);
+                for (size_t r = 0; r < 3; ++r) {
+                    _mm_storeu_ps(low + r * 4, _mm256_castps256_ps128(rows[r][k]));
+                    _mm_storeu_ps(high + r * 4, _mm256_extractf128_ps(rows[r][k], 1));
+                }
+                _mm_storeu_ps(low + 12, lastRow);
+                _mm_storeu_ps(high + 12, lastRow);
+            }
+        }
+        return i;
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	命令セットを選んで計算する
+     * @param	source		入力の配列
+     * @param	indices		入力の位置の並び
+     * @param	count		計算する数
+     * @param	destination	書き込み先の先頭
+     * @param	stride		行列の間隔（バイト）
+     * @param	path		計算に使う命令セット
+     */
+    template <bool Indexed>
+    void compose(const TransformBatch::Source& source, const uint32_t* indices, size_t count, void* destination, size_t stride, TransformBatch::Path path) noexcept {
+        auto* bytes = static_cast<uint8_t*>(destination);
+
+        size_t done = 0;
+        if (path == TransformBatch::Path::avx2) {
+            done = composeAvx2<Indexed>(source, indices, count, bytes, stride);
+        }
+        if (path != TransformBatch::Path::scalar) {
+            // AVX2 の端数も 4 個以上残っていれば SSE で計算する
+            done = composeSse<Indexed>(source, indices, done, count, bytes, stride);
+        }
+        for (auto i = done; i < count; ++i) {
+            composeScalar(source, sourceIndex<Indexed>(indices, i), reinterpret_cast<float*>(bytes + i * stride));
+        }
+    }
+}  // namespace
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	エンティティストアの配列を入力にする
+ * @param	entities	エンティティストア
+ * @return	入力の配列
+ */
+[[nodiscard]] TransformBatch::Source TransformBatch::source(const EntityStore& entities) noexcept {
+    using Component = EntityStore::Component;
+    return {
+        entities.values(Component::positionX).data(),
+        entities.values(Component::positionY).data(),
+        entities.values(Component::positionZ).data(),
+        entities.values(Component::rotationX).data(),
+        entities.values(Component::rotationY).data(),
+        entities.values(Component::rotationZ).data(),
+        entities.values(Component::rotationW).data(),
+        entities.values(Component::scaleX).data(),
+        entities.values(Component::scaleY).data(),
+        entities.values(Component::scaleZ).data(),
+    };
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	この CPU で一番速い命令セットを取得する
+ * @return	命令セット
+ */
+[[nodiscard]] TransformBatch::Path TransformBatch::bestPath() noexcept {
+    // CPU は実行中に変わらないので、最初の一回だけ調べる
+    static const auto path = supportsAvx2() ? Path::avx2 : Path::sse;
+    return path;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	転置済みのワールド行列をまとめて計算する
+ * 行列は float 16 個（行優先）で、一つ書く度に stride バイト進める
+ * @param	source		入力の配列
+ * @param	count		計算する数
+ * @param	destination	書き込み先の先頭
+ * @param	stride		行列の間隔（バイト）
+ * @param	path		計算に使う命令セット
+ */
+void TransformBatch::compose(const Source& source, size_t count, void* destination, size_t stride, Path path) noexcept {
+    ::compose<false>(source, nullptr, count, destination, stride, path);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	指定した位置のオブジェクトだけ、転置済みのワールド行列を詰めて計算する
+ * indices[i] の位置の入力から計算した行列を、書き込み先の i 番目に書く
+ * @param	source		入力の配列
+ * @param	indices		入力の位置の並び
+ * @param	destination	書き込み先の先頭
+ * @param	stride		行列の間隔（バイト）
+ * @param	path		計算に使う命令セット
+ */
+void TransformBatch::compose(const Source& source, std::span<const uint32_t> indices, void* destination, size_t stride, Path path) noexcept {
+    ::compose<true>(source, indices.data(), indices.size(), destination, stride, path);
+}
@@ -0,0 +1,90 @@
+﻿// ワールド行列の一括計算クラス
+
+#pragma once
+
+#include "entity_store.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	ワールド行列の一括計算クラス
+ * 成分毎に分かれた座標・回転（クォータニオン）・拡大率の配列から、拡大 → 回転 → 移動の順に掛けたワールド行列をまとめて計算する
+ * 行列はシェーダーに渡す形（転置済み）で書き込み先に直接書くので、後から転置やコピーをし直す必要は無い
+ * AVX2 が使える CPU では 8 個ずつ、それ以外は SSE で 4 個ずつ計算し、端数だけを一つずつ計算する
+ * インスタンスは作らない
+ */
+class TransformBatch final {
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	計算に使う命令セット
+     */
+    enum class Path : uint8_t {
+        scalar,  /// SIMD を使わない（結果の確認用）
+        sse,     /// SSE で 4 個ずつ
+        avx2,    /// AVX2 で 8 個ずつ
+    };
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	入力の配列
+     * 全ての配列は同じ長さで、同じ位置が同じオブジェクトを表す
+     */
+    struct Source {
+        const float* positionX_{};  /// 座標の x
+        const float* positionY_{};  /// 座標の y
+        const float* positionZ_{};  /// 座標の z
+        const float* rotationX_{};  /// 回転の x
+        const float* rotationY_{};  /// 回転の y
+        const float* rotationZ_{};  /// 回転の z
+        const float* rotationW_{};  /// 回転の w
+        const float* scaleX_{};     /// 拡大率の x
+        const float* scaleY_{};     /// 拡大率の y
+        const float* scaleZ_{};     /// 拡大率の z
+    };
+
+public:
+    TransformBatch() = delete;
+    ~TransformBatch() = delete;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	エンティティストアの配列を入力にする
+     * @param	entities	エンティティストア
+     * @return	入力の配列
+     */
+    [[nodiscard]] static Source source(const EntityStore& entities) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	この CPU で一番速い命令セットを取得する
+     * @return	命令セット
+     */
+    [[nodiscard]] static Path bestPath() noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	転置済みのワールド行列をまとめて計算する
+     * 行列は float 16 個（行優先）で、一つ書く度に stride バイト進める
+     * @param	source		入力の配列
+     * @param	count		計算する数
+     * @param	destination	書き込み先の先頭
+     * @param	stride		行列の間隔（バイト）
+     * @param	path		計算に使う命令セット
+     */
+    static void compose(const Source& source, size_t count, void* destination, size_t stride, Path path = bestPath()) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	指定した位置のオブジェクトだけ、転置済みのワールド行列を詰めて計算する
+     * indices[i] の位置の入力から計算した行列を、書き込み先の i 番目に書く
+     * @param	source		入力の配列
+     * @param	indices		入力の位置の並び
+     * @param	destination	書き込み先の先頭
+     * @param	stride		行列の間隔（バイト）
+     * @param	path		計算に使う命令セット
+     */
+    static void compose(const Source& source, std::span<const uint32_t> indices, void* destination, size_t stride, Path path = bestPath()) noexcept;
+};
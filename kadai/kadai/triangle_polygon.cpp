@@ -2,219 +2,38 @@
 
 #include "triangle_polygon.h"
 #include <cassert>
-#include <d3d12.h>
-#include "command_list.h"
-
-namespace {
-
-    //---------------------------------------------------------------------------------
-    /**
-     * @brief    _obt@tH[}bg
-     */
-    struct Vertex {
-        DirectX::XMFLOAT3 position;  // _Wix, y, zj
-        DirectX::XMFLOAT4 color;     // _Fir, g, b, aj
-    };
-}  // namespace
-
-//---------------------------------------------------------------------------------
-/**
- * @brief    fXgN^
- */
-TrianglePolygon::~TrianglePolygon() {
-    // _obt@̉
-    if (vertexBuffer_) {
-        vertexBuffer_->Release();
-        vertexBuffer_ = nullptr;
-    }
-
-    // CfbNXobt@̉
-    if (indexBuffer_) {
-        indexBuffer_->Release();
-        indexBuffer_ = nullptr;
-    }
-}
 
 //---------------------------------------------------------------------------------
 /**
  * @brief	|S̐
- * @param	device	foCXNX̃CX^X
+ * _ƃCfbNX̓bVv[̋Lobt@Ɋi[
+ * @param	meshPool		i[̃bVv[
+ * @param	uploadManager	]ɎgAbv[hǗ
  * @return	 true
  */
-[[nodiscard]] bool TrianglePolygon::create(const Device& device) noexcept {
-    // _obt@̐
-    if (!createVertexBuffer(device)) {
-        return false;
-    }
-    // CfbNXobt@̐
-    if (!createIndexBuffer(device)) {
-        return false;
-    }
-
-    return true;
-}
-
-//---------------------------------------------------------------------------------
-/**
- * @brief	_obt@̐
- * @param	device	foCXNX̃CX^X
- * @return	 true
- */
-[[nodiscard]] bool TrianglePolygon::createVertexBuffer(const Device& device) noexcept {
+[[nodiscard]] bool TrianglePolygon::create(MeshPool& meshPool, UploadManager& uploadManager) noexcept {
     // 񗘗pOp`̒_f[^
-    Vertex triangleVertices[] = {
+    const MeshPool::Vertex triangleVertices[] = {
         {  {0.0f, 0.5f, 0.0f}, {1.0f, 0.0f, 0.0f, 1.0f}}, // 㒸_iԐFj
         { {0.5f, -0.5f, 0.0f}, {0.0f, 1.0f, 0.0f, 1.0f}}, // E_iΐFj
         {{-0.5f, -0.5f, 0.0f}, {0.0f, 0.0f, 1.0f, 1.0f}}  // _iFj
     };
 
-    // _f[^̃TCY
-    const auto vertexBufferSize = sizeof(triangleVertices);
-
-    // q[v̐ݒw
-    // CPU ANZX\ȃ𗘗pׂ̐ݒ
-    D3D12_HEAP_PROPERTIES heapProperty{};
-    heapProperty.Type = D3D12_HEAP_TYPE_UPLOAD;
-    heapProperty.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
-    heapProperty.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
-    heapProperty.CreationNodeMask = 1;
-    heapProperty.VisibleNodeMask = 1;
-
-    // ǂȃ\[X쐬邩̐ݒ
-    D3D12_RESOURCE_DESC resourceDesc{};
-    resourceDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
-    resourceDesc.Alignment = 0;
-    resourceDesc.Width = vertexBufferSize;
-    resourceDesc.Height = 1;
-    resourceDesc.DepthOrArraySize = 1;
-    resourceDesc.MipLevels = 1;
-    resourceDesc.Format = DXGI_FORMAT_UNKNOWN;
-    resourceDesc.SampleDesc.Count = 1;
-    resourceDesc.SampleDesc.Quality = 0;
-    resourceDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
-    resourceDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
-
-    // _obt@̐
-    auto res = device.get()->CreateCommittedResource(
-        &heapProperty,
-        D3D12_HEAP_FLAG_NONE,
-        &resourceDesc,
-        D3D12_RESOURCE_STATE_GENERIC_READ,
-        nullptr,
-        IID_PPV_ARGS(&vertexBuffer_));
-    if (FAILED(res)) {
-        assert(false && "_obt@̍쐬Ɏs");
-        return false;
-    }
-
-    // _obt@Ƀf[^]
-    // CPU ANZX\ȃAhX擾
-    Vertex* data{};
-
-    // obt@}bviCPUANZX\ɂj
-    // vertexBuffer_ 𒼐ڗp̂ł͂ȂAdata čXVC[W
-    res = vertexBuffer_->Map(0, nullptr, reinterpret_cast<void**>(&data));
-    if (FAILED(res)) {
-        assert(false && "_obt@̃}bvɎs");
-        return false;
-    }
-
-    // _f[^Rs[
-    memcpy_s(data, vertexBufferSize, triangleVertices, vertexBufferSize);
-
-    // Rs[ÎŃ}bviCPUANZXsɂj
-    // ܂ŗ GPU p郁̈iVRAMjɃRs[ς݂Ȃ̂ŁAtriangleVertices ͕svɂȂ
-    vertexBuffer_->Unmap(0, nullptr);
-
-    // _obt@r[̐ݒ
-    vertexBufferView_.BufferLocation = vertexBuffer_->GetGPUVirtualAddress();  // _obt@̃AhX
-    vertexBufferView_.SizeInBytes = vertexBufferSize;                       // _obt@̃TCY
-    vertexBufferView_.StrideInBytes = sizeof(Vertex);                         // 1_̃TCY
-
-    return true;
-}
-
-//---------------------------------------------------------------------------------
-/**
- * @brief	CfbNXobt@̐
- * @param	device	foCXNX̃CX^X
- * @return	 true
- */
-[[nodiscard]] bool TrianglePolygon::createIndexBuffer(const Device& device) noexcept {
-    uint16_t triangleIndices[] = {
+    const uint16_t triangleIndices[] = {
         0, 1, 2  // Op`\钸_̃CfbNX
     };
 
-    // CfbNXf[^̃TCY
-    const auto indexBufferSize = sizeof(triangleIndices);
-
-    // q[v̐ݒw
-    D3D12_HEAP_PROPERTIES heapProperty{};
-    heapProperty.Type = D3D12_HEAP_TYPE_UPLOAD;
-    heapProperty.CPUPageProperty = D3D12_CPU_PAGE_PROPERTY_UNKNOWN;
-    heapProperty.MemoryPoolPreference = D3D12_MEMORY_POOL_UNKNOWN;
-    heapProperty.CreationNodeMask = 1;
-    heapProperty.VisibleNodeMask = 1;
-
-    // \[X̐ݒs
-    D3D12_RESOURCE_DESC resourceDesc{};
-    resourceDesc.Dimension = D3D12_RESOURCE_DIMENSION_BUFFER;
-    resourceDesc.Alignment = 0;
-    resourceDesc.Width = indexBufferSize;
-    resourceDesc.Height = 1;
-    resourceDesc.DepthOrArraySize = 1;
-    resourceDesc.MipLevels = 1;
-    resourceDesc.Format = DXGI_FORMAT_UNKNOWN;
-    resourceDesc.SampleDesc.Count = 1;
-    resourceDesc.SampleDesc.Quality = 0;
-    resourceDesc.Layout = D3D12_TEXTURE_LAYOUT_ROW_MAJOR;
-    resourceDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
-
-    // CfbNXobt@̐
-    auto res = device.get()->CreateCommittedResource(
-        &heapProperty,
-        D3D12_HEAP_FLAG_NONE,
-        &resourceDesc,
-        D3D12_RESOURCE_STATE_GENERIC_READ,
-        nullptr,
-        IID_PPV_ARGS(&indexBuffer_));
-    if (FAILED(res)) {
-        assert(false && "CfbNXobt@̍쐬Ɏs");
-        return false;
-    }
-
-    // CfbNXobt@Ƀf[^]
-    uint16_t* data{};
-    res = indexBuffer_->Map(0, nullptr, reinterpret_cast<void**>(&data));
-    if (FAILED(res)) {
-        assert(false && "CfbNXobt@̃}bvɎs");
-        return false;
-    }
-
-    memcpy_s(data, indexBufferSize, triangleIndices, indexBufferSize);
-    // ܂ŗ GPU p郁̈iVRAMjɃRs[ς݂Ȃ̂ŁAtriangleIndices ͕svɂȂ
-    indexBuffer_->Unmap(0, nullptr);
-
-    // CfbNXobt@r[쐬
-    indexBufferView_.BufferLocation = indexBuffer_->GetGPUVirtualAddress();
-    indexBufferView_.SizeInBytes = indexBufferSize;
-    indexBufferView_.Format = DXGI_FORMAT_R16_UINT;  // triangleIndices ̌^ 16bit ȂȂ̂ R16_UINT
-
-    return true;
+    // Lobt@ɒǉ
+    // f[^͈ꎞobt@ɃRs[ς݂Ȃ̂ŁAtriangleVertices  triangleIndices ͕svɂȂ
+    return meshPool.add(uploadManager, triangleVertices, triangleIndices, mesh_);
 }
 
 //---------------------------------------------------------------------------------
 /**
- * @brief	|S̕`
- * @param	commandList	R}hXg
+ * @brief	bV擾
+ * @return	bVv[̈ʒu
  */
-void TrianglePolygon::draw(const CommandList& commandList) noexcept {
-    // _obt@̐ݒ
-    commandList.get()->IASetVertexBuffers(0, 1, &vertexBufferView_);
-    // CfbNXobt@̐ݒ
-    commandList.get()->IASetIndexBuffer(&indexBufferView_);
-    // v~eBu`̐ݒiOp`j
-    commandList.get()->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-    // `R}h
-    commandList.get()->DrawIndexedInstanced(3, 1, 0, 0, 0);
+[[nodiscard]] const Mesh& TrianglePolygon::mesh() const noexcept {
+    assert(mesh_.indexCount_ != 0 && "|S쐬ł");
+    return mesh_;
 }
@@ -2,9 +2,7 @@
 
 #pragma once
 
-#include "device.h"
-#include "command_list.h"
-#include <DirectXMath.h>
+#include "mesh_pool.h"
 
 //---------------------------------------------------------------------------------
 /**
@@ -32,45 +30,25 @@ public:
     /**
      * @brief    デストラクタ
      */
-    ~TrianglePolygon();
+    ~TrianglePolygon() = default;
 
     //---------------------------------------------------------------------------------
     /**
      * @brief	ポリゴンの生成
-     * @param	device	デバイスクラスのインスタンス
+     * 頂点とインデックスはメッシュプールの共有バッファに格納する
+     * @param	meshPool		格納先のメッシュプール
+     * @param	uploadManager	転送に使うアップロード管理
      * @return	成功すれば true
      */
-    [[nodiscard]] bool create(const Device& device) noexcept;
+    [[nodiscard]] bool create(MeshPool& meshPool, UploadManager& uploadManager) noexcept;
 
     //---------------------------------------------------------------------------------
     /**
-     * @brief	ポリゴンの描画
-     * @param	commandList	コマンドリスト
+     * @brief	メッシュを取得する
+     * @return	メッシュプール内の位置情報
      */
-    void draw(const CommandList& commandList) noexcept;
+    [[nodiscard]] const Mesh& mesh() const noexcept;
 
 private:
-    //---------------------------------------------------------------------------------
-    /**
-     * @brief	頂点バッファの生成
-     * @param	device	デバイスクラスのインスタンス
-     * @return	成功すれば true
-     */
-    [[nodiscard]] bool createVertexBuffer(const Device& device) noexcept;
-
-    //---------------------------------------------------------------------------------
-    /**
-     * @brief	インデックスバッファの生成
-     * @param	device	デバイスクラスのインスタンス
-     * @return	成功すれば true
-     */
-    [[nodiscard]] bool createIndexBuffer(const Device& device) noexcept;
-
-private:
-    ID3D12Resource* vertexBuffer_{};  /// 頂点バッファ
-    ID3D12Resource* indexBuffer_{};   /// インデックスバッファ
-
-    D3D12_VERTEX_BUFFER_VIEW vertexBufferView_ = {};  ///< 頂点バッファビュー
-    D3D12_INDEX_BUFFER_VIEW  indexBufferView_ = {};  ///< インデックスバッファビュー
+    Mesh mesh_{};  /// メッシュプール内の位置情報
 };
-
@@ -0,0 +1,198 @@
+﻿// アップロード管理クラス
+
+#include "upload_manager.h"
+#include <cassert>
+#include <cstring>
+
+namespace {
+    constexpr UINT64 stagingAlignment = 16;     // 一時バッファから切り出す領域のアライメント
+    constexpr UINT   commandAllocatorCount = 3;  // コピー用コマンドアロケータの数（完了を待たずに続けて提出できる転送の数）
+}  // namespace
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief    デストラクタ
+ */
+UploadManager::~UploadManager() {
+    // 一時バッファはコピーキューしか使わないので、転送の完了を待ってから解放する
+    if (submittedFenceValue_ != 0) {
+        fence_.wait(submittedFenceValue_);
+    }
+    if (stagingBuffer_.resource_) {
+        stagingBuffer_.resource_->Unmap(0, nullptr);
+        memoryAllocator_->free(stagingBuffer_);
+    }
+    stagingData_ = nullptr;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	アップロード管理を作成する
+ * @param	device			デバイスクラスのインスタンス
+ * @param	memoryAllocator	一時バッファの確保に使う GPU メモリアロケータ
+ * @param	stagingSize		一時バッファのサイズ
+ * @return	生成の成否
+ */
+[[nodiscard]] bool UploadManager::create(const Device& device, GpuMemoryAllocator& memoryAllocator, UINT64 stagingSize) noexcept {
+    // 描画とは別のコピーキューで転送する
+    if (!copyQueue_.create(device, D3D12_COMMAND_LIST_TYPE_COPY)) return false;
+    // 前の転送の完了を待たずに次の転送を記録できるように、アロケータは複数用意して順番に使う
+    commandAllocators_ = std::vector<CommandAllocator>(commandAllocatorCount);
+    allocatorFenceValues_.assign(commandAllocatorCount, 0);
+    for (auto& commandAllocator : commandAllocators_) {
+        if (!commandAllocator.create(device, D3D12_COMMAND_LIST_TYPE_COPY)) return false;
+    }
+    if (!commandList_.create(device, commandAllocators_[0])) return false;
+    if (!fence_.create(device)) return false;
+
+    // 一時バッファの作成
+    memoryAllocator_ = &memoryAllocator;
+    if (!memoryAllocator.createBuffer(D3D12_HEAP_TYPE_UPLOAD, stagingSize, D3D12_RESOURCE_STATE_GENERIC_READ, stagingBuffer_)) {
+        assert(false && "アップロード用一時バッファの作成に失敗しました");
+        return false;
+    }
+
+    D3D12_RANGE readRange{ 0, 0 };  // CPU からは読み込まない
+    const auto res = stagingBuffer_.resource_->Map(0, &readRange, reinterpret_cast<void**>(&stagingData_));
+    if (FAILED(res)) {
+        assert(false && "アップロード用一時バッファのマップに失敗しました");
+        return false;
+    }
+
+    stagingAllocator_.initialize(stagingSize);
+    return true;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	バッファへの転送を予約する
+ * 転送は submit を呼ぶまで実行されない
+ * @param	destination			転送先のバッファ（COMMON ステートであること）
+ * @param	destinationOffset	転送先のオフセット
+ * @param	data				転送するデータ
+ * @param	size				転送するサイズ
+ * @return	予約の成否
+ */
+[[nodiscard]] bool UploadManager::upload(ID3D12Resource* destination, UINT64 destinationOffset, const void* data, UINT64 size) noexcept {
+    if (!stagingBuffer_.resource_) {
+        assert(false && "アップロード管理が未作成です");
+        return false;
+    }
+    if (size == 0) {
+        return true;
+    }
+
+    auto offset = stagingAllocator_.allocate(size, stagingAlignment);
+    while (offset == RingAllocator::invalidOffset) {
+        // 一時バッファが足りないので、予約済みの転送を実行して古い領域が空くのを待つ
+        submit();
+        const auto oldestFenceValue = stagingAllocator_.oldestFenceValue();
+        if (oldestFenceValue == 0) {
+            assert(false && "アップロード用一時バッファの容量が不足しています");
+            return false;
+        }
+        fence_.wait(oldestFenceValue);
+        stagingAllocator_.release(fence_.get()->GetCompletedValue());
+
+        offset = stagingAllocator_.allocate(size, stagingAlignment);
+    }
+
+    if (!recording_) {
+        beginRecording();
+    }
+
+    std::memcpy(stagingData_ + offset, data, static_cast<size_t>(size));
+    commandList_.get()->CopyBufferRegion(destination, destinationOffset, stagingBuffer_.resource_, offset, size);
+    return true;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	予約した転送をコピーキューで実行する
+ * @return	転送の完了時にシグナルされるフェンス値
+ */
+UINT64 UploadManager::submit() noexcept {
+    if (!recording_) {
+        return submittedFenceValue_;
+    }
+
+    commandList_.get()->Close();
+    ID3D12CommandList* ppCommandLists[] = { commandList_.get() };
+    copyQueue_.get()->ExecuteCommandLists(_countof(ppCommandLists), ppCommandLists);
+    copyQueue_.get()->Signal(fence_.get(), nextFenceValue_);
+
+    stagingAllocator_.finishFrame(nextFenceValue_);
+    allocatorFenceValues_[allocatorIndex_] = nextFenceValue_;
+    submittedFenceValue_ = nextFenceValue_;
+    nextFenceValue_++;
+    recording_ = false;
+    return submittedFenceValue_;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	予約中の転送が完了した時にシグナルされるフェンス値を取得する
+ * @return	フェンス値
+ */
+[[nodiscard]] UINT64 UploadManager::pendingFenceValue() const noexcept {
+    return nextFenceValue_;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	転送の完了を描画キューに GPU 側で待たせる
+ * 既に完了している、または待機済みの場合は何もしない
+ * @param	commandQueue	待たせるコマンドキュー
+ * @param	fenceValue		待つ転送のフェンス値
+ */
+void UploadManager::waitOnQueue(const CommandQueue& commandQueue, UINT64 fenceValue) noexcept {
+    if (fenceValue <= waitedFenceValue_ || isComplete(fenceValue)) {
+        return;
+    }
+    assert(fenceValue <= submittedFenceValue_ && "提出前の転送を待とうとしています");
+
+    // CPU は止めずに、描画キューだけを転送の完了まで待たせる
+    commandQueue.get()->Wait(fence_.get(), fenceValue);
+    waitedFenceValue_ = fenceValue;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	転送が完了したか調べる
+ * @param	fenceValue	転送のフェンス値
+ * @return	完了していれば true
+ */
+[[nodiscard]] bool UploadManager::isComplete(UINT64 fenceValue) const noexcept {
+    return fence_.get()->GetCompletedValue() >= fenceValue;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	全ての転送の完了を CPU で待つ
+ */
+void UploadManager::waitIdle() noexcept {
+    const auto fenceValue = submit();
+    if (fenceValue != 0) {
+        fence_.wait(fenceValue);
+        stagingAllocator_.release(fence_.get()->GetCompletedValue());
+    }
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	コマンドの記録を開始する
+ * コマンドアロケータは順番に使い回し、同じアロケータを使った転送が終わっていなければ完了を待つ
+ */
+void UploadManager::beginRecording() noexcept {
+    // 次のアロケータを使った転送はアロケータの数だけ前の転送なので、直前の転送の完了は待たない
+    allocatorIndex_ = (allocatorIndex_ + 1) % static_cast<UINT>(commandAllocators_.size());
+    if (allocatorFenceValues_[allocatorIndex_] != 0) {
+        fence_.wait(allocatorFenceValues_[allocatorIndex_]);
+    }
+    stagingAllocator_.release(fence_.get()->GetCompletedValue());
+
+    auto& commandAllocator = commandAllocators_[allocatorIndex_];
+    commandAllocator.reset();
+    commandList_.reset(commandAllocator);
+    recording_ = true;
+}
@@ -0,0 +1,118 @@
+﻿// アップロード管理クラス
+
+#pragma once
+
+#include "device.h"
+#include "command_queue.h"
+#include "command_allocator.h"
+#include "command_list.h"
+#include "fence.h"
+#include "ring_allocator.h"
+#include "gpu_memory_allocator.h"
+#include <vector>
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	アップロード管理クラス
+ * データをアップロードヒープに一旦置き、コピーキューで DEFAULT ヒープのリソースへ転送する
+ * 転送の完了はフェンス値で表し、描画キューは初めて使う時にだけ GPU 側で待つ
+ */
+class UploadManager final {
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    コンストラクタ
+     */
+    UploadManager() = default;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    デストラクタ
+     */
+    ~UploadManager();
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	アップロード管理を作成する
+     * @param	device			デバイスクラスのインスタンス
+     * @param	memoryAllocator	一時バッファの確保に使う GPU メモリアロケータ
+     * @param	stagingSize		一時バッファのサイズ
+     * @return	生成の成否
+     */
+    [[nodiscard]] bool create(const Device& device, GpuMemoryAllocator& memoryAllocator, UINT64 stagingSize) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	バッファへの転送を予約する
+     * 転送は submit を呼ぶまで実行されない
+     * @param	destination			転送先のバッファ（COMMON ステートであること）
+     * @param	destinationOffset	転送先のオフセット
+     * @param	data				転送するデータ
+     * @param	size				転送するサイズ
+     * @return	予約の成否
+     */
+    [[nodiscard]] bool upload(ID3D12Resource* destination, UINT64 destinationOffset, const void* data, UINT64 size) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	予約した転送をコピーキューで実行する
+     * @return	転送の完了時にシグナルされるフェンス値
+     */
+    UINT64 submit() noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	予約中の転送が完了した時にシグナルされるフェンス値を取得する
+     * @return	フェンス値
+     */
+    [[nodiscard]] UINT64 pendingFenceValue() const noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	転送の完了を描画キューに GPU 側で待たせる
+     * 既に完了している、または待機済みの場合は何もしない
+     * @param	commandQueue	待たせるコマンドキュー
+     * @param	fenceValue		待つ転送のフェンス値
+     */
+    void waitOnQueue(const CommandQueue& commandQueue, UINT64 fenceValue) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	転送が完了したか調べる
+     * @param	fenceValue	転送のフェンス値
+     * @return	完了していれば true
+     */
+    [[nodiscard]] bool isComplete(UINT64 fenceValue) const noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	全ての転送の完了を CPU で待つ
+     */
+    void waitIdle() noexcept;
+
+private:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	コマンドの記録を開始する
+     * コマンドアロケータは順番に使い回し、同じアロケータを使った転送が終わっていなければ完了を待つ
+     */
+    void beginRecording() noexcept;
+
+private:
+    CommandQueue                  copyQueue_{};             /// コピーキュー
+    std::vector<CommandAllocator> commandAllocators_{};     /// コピー用コマンドアロケータ（転送毎に順番に使う）
+    std::vector<UINT64>           allocatorFenceValues_{};  /// アロケータ毎の最後に提出した転送のフェンス値
+    UINT                          allocatorIndex_{};        /// 記録中の転送で使うアロケータの番号
+    CommandList                   commandList_{};           /// コピー用コマンドリスト
+    Fence                         fence_{};                 /// 転送の完了を表すフェンス
+
+    GpuMemoryAllocator*            memoryAllocator_{};   /// 一時バッファを確保した GPU メモリアロケータ
+    GpuMemoryAllocator::Allocation stagingBuffer_{};     /// 一時バッファ（アップロードヒープ）
+    UINT8*                         stagingData_{};       /// マップ済みの一時バッファ
+    RingAllocator                  stagingAllocator_{};  /// 一時バッファの領域管理
+
+    UINT64 nextFenceValue_ = 1;      /// 次の転送でシグナルするフェンス値
+    UINT64 submittedFenceValue_{};   /// 最後に提出した転送のフェンス値
+    UINT64 waitedFenceValue_{};      /// 描画キューに待たせた最大のフェンス値
+    bool   recording_{};             /// コマンドを記録中か
+};
@@ -0,0 +1,128 @@
+﻿// アップロードリングバッファクラス
+
+#include "upload_ring.h"
+#include <cassert>
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief    デストラクタ
+ */
+UploadRing::~UploadRing() {
+    if (buffer_.resource_) {
+        // GPU が参照中の可能性があるので、フレームの完了を待ってから解放する
+        buffer_.resource_->Unmap(0, nullptr);
+        memoryAllocator_->free(buffer_);
+    }
+    cpuAddress_ = nullptr;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	リングバッファを作成する
+ * @param	memoryAllocator	バッファの確保に使う GPU メモリアロケータ
+ * @param	size			バッファのサイズ
+ * @return	生成の成否
+ */
+[[nodiscard]] bool UploadRing::create(GpuMemoryAllocator& memoryAllocator, UINT64 size) noexcept {
+    // アライメント済みサイズの計算
+    const auto alignedSize = (size + alignment - 1) & ~(alignment - 1);
+
+    // バッファリソースの作成
+    memoryAllocator_ = &memoryAllocator;
+    if (!memoryAllocator.createBuffer(D3D12_HEAP_TYPE_UPLOAD, alignedSize, D3D12_RESOURCE_STATE_GENERIC_READ, buffer_)) {
+        assert(false && "アップロードリングバッファの作成に失敗しました");
+        return false;
+    }
+
+    // アップロードヒープはマップしたままでも問題ないので、作成時に一度だけマップする
+    D3D12_RANGE readRange{ 0, 0 };  // CPU からは読み込まない
+    const auto res = buffer_.resource_->Map(0, &readRange, reinterpret_cast<void**>(&cpuAddress_));
+    if (FAILED(res)) {
+        assert(false && "アップロードリングバッファのマップに失敗しました");
+        return false;
+    }
+
+    gpuAddress_ = buffer_.resource_->GetGPUVirtualAddress();
+    allocator_.initialize(alignedSize);
+
+    return true;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	領域を確保する
+ * 空きが無い場合は最も古いフレームの GPU 処理完了を待ってから確保し直す
+ * @param	size		確保するサイズ
+ * @param	fence		フレーム完了待ちに使うフェンス
+ * @param	allocation	確保した領域
+ * @return	確保の成否
+ */
+[[nodiscard]] bool UploadRing::allocate(UINT64 size, const Fence& fence, Allocation& allocation) noexcept {
+    if (!buffer_.resource_) {
+        assert(false && "アップロードリングバッファが未作成です");
+        return false;
+    }
+
+    auto offset = allocator_.allocate(size, alignment);
+    while (offset == RingAllocator::invalidOffset) {
+        // 待つべきフレームが無い場合はバッファサイズが足りていない
+        const auto oldestFenceValue = allocator_.oldestFenceValue();
+        if (oldestFenceValue == 0) {
+            assert(false && "アップロードリングバッファの容量が不足しています");
+            return false;
+        }
+
+        // GPU が使い終わるまで待ってから領域を解放する
+        fence.wait(oldestFenceValue);
+        allocator_.release(fence.get()->GetCompletedValue());
+
+        offset = allocator_.allocate(size, alignment);
+    }
+
+    allocation.cpuAddress_ = cpuAddress_ + offset;
+    allocation.gpuAddress_ = gpuAddress_ + offset;
+    return true;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	現在のフレームで確保した領域をフェンス値で区切る
+ * @param	fenceValue	このフレームの完了時にシグナルされるフェンス値
+ */
+void UploadRing::finishFrame(UINT64 fenceValue) noexcept {
+    allocator_.finishFrame(fenceValue);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	GPU の処理が完了したフレームの領域を解放する
+ * @param	completedFenceValue	GPU が到達済みのフェンス値
+ */
+void UploadRing::release(UINT64 completedFenceValue) noexcept {
+    allocator_.release(completedFenceValue);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	GPU アドレスから書き込み用の CPU アドレスを求める
+ * 確保済みの領域に後から書き直す場合に使う（キャプチャしたコマンドの再生など）
+ * @param	address	GPU アドレス
+ * @param	size	書き込むサイズ
+ * @return	CPU アドレス、範囲がバッファに収まらない場合は nullptr
+ */
+[[nodiscard]] void* UploadRing::cpuAddress(D3D12_GPU_VIRTUAL_ADDRESS address, UINT64 size) const noexcept {
+    if (!cpuAddress_ || address < gpuAddress_ || size > allocator_.capacity() || address - gpuAddress_ > allocator_.capacity() - size) {
+        return nullptr;
+    }
+    return cpuAddress_ + (address - gpuAddress_);
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	バッファを取得する
+ * @return	バッファのポインタ
+ */
+[[nodiscard]] ID3D12Resource* UploadRing::get() const noexcept {
+    assert(buffer_.resource_ && "アップロードリングバッファが未作成です");
+    return buffer_.resource_;
+}
@@ -0,0 +1,98 @@
+﻿// アップロードリングバッファクラス
+
+#pragma once
+
+#include "device.h"
+#include "fence.h"
+#include "ring_allocator.h"
+#include "gpu_memory_allocator.h"
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	アップロードリングバッファクラス
+ * 大きなアップロードヒープを作成時に一度だけマップし、描画毎の定数データを切り出して使う
+ */
+class UploadRing final {
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	確保した領域
+     */
+    struct Allocation {
+        void*                     cpuAddress_{};  /// CPU から書き込むアドレス
+        D3D12_GPU_VIRTUAL_ADDRESS gpuAddress_{};  /// GPU から参照するアドレス
+    };
+
+    static constexpr UINT64 alignment = D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT;  /// 確保する領域のアライメント
+
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    コンストラクタ
+     */
+    UploadRing() = default;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief    デストラクタ
+     */
+    ~UploadRing();
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	リングバッファを作成する
+     * @param	memoryAllocator	バッファの確保に使う GPU メモリアロケータ
+     * @param	size			バッファのサイズ
+     * @return	生成の成否
+     */
+    [[nodiscard]] bool create(GpuMemoryAllocator& memoryAllocator, UINT64 size) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	領域を確保する
+     * 空きが無い場合は最も古いフレームの GPU 処理完了を待ってから確保し直す
+     * @param	size		確保するサイズ
+     * @param	fence		フレーム完了待ちに使うフェンス
+     * @param	allocation	確保した領域
+     * @return	確保の成否
+     */
+    [[nodiscard]] bool allocate(UINT64 size, const Fence& fence, Allocation& allocation) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	現在のフレームで確保した領域をフェンス値で区切る
+     * @param	fenceValue	このフレームの完了時にシグナルされるフェンス値
+     */
+    void finishFrame(UINT64 fenceValue) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	GPU の処理が完了したフレームの領域を解放する
+     * @param	completedFenceValue	GPU が到達済みのフェンス値
+     */
+    void release(UINT64 completedFenceValue) noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	GPU アドレスから書き込み用の CPU アドレスを求める
+     * 確保済みの領域に後から書き直す場合に使う（キャプチャしたコマンドの再生など）
+     * @param	address	GPU アドレス
+     * @param	size	書き込むサイズ
+     * @return	CPU アドレス、範囲がバッファに収まらない場合は nullptr
+     */
+    [[nodiscard]] void* cpuAddress(D3D12_GPU_VIRTUAL_ADDRESS address, UINT64 size) const noexcept;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	バッファを取得する
+     * @return	バッファのポインタ
+     */
+    [[nodiscard]] ID3D12Resource* get() const noexcept;
+
+private:
+    GpuMemoryAllocator*            memoryAllocator_{};  /// バッファを確保した GPU メモリアロケータ
+    GpuMemoryAllocator::Allocation buffer_{};           /// アップロードバッファ
+    UINT8*                    cpuAddress_{};  /// マップ済みの先頭アドレス
+    D3D12_GPU_VIRTUAL_ADDRESS gpuAddress_{};  /// GPU 仮想アドレスの先頭
+    RingAllocator             allocator_{};   /// 領域の管理
+};
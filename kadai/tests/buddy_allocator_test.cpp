@@ -0,0 +1,154 @@
+// バディアロケータクラスのテスト
+
+#include "buddy_allocator.h"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace {
+    constexpr uint64_t minBlockSize = 64 * 1024;      // D3D12 のバッファの配置単位と同じ
+    constexpr uint64_t capacity = 16 * minBlockSize;  // 1 MiB
+}  // namespace
+
+TEST(BuddyAllocatorTest, RoundsUpToPowerOfTwoBlocks) {
+    BuddyAllocator allocator;
+    allocator.initialize(capacity, minBlockSize);
+
+    EXPECT_EQ(allocator.allocate(1), 0u);
+    EXPECT_EQ(allocator.allocate(minBlockSize + 1), 2 * minBlockSize);
+
+    const auto statistics = allocator.statistics();
+    EXPECT_EQ(statistics.usedSize_, 3 * minBlockSize);
+    EXPECT_EQ(statistics.requestedSize_, minBlockSize + 2);
+    EXPECT_EQ(statistics.allocationCount_, 2u);
+    EXPECT_EQ(statistics.largestFreeBlock_, 8 * minBlockSize);
+}
+
+TEST(BuddyAllocatorTest, BlocksAreAlignedToTheirSize) {
+    BuddyAllocator allocator;
+    allocator.initialize(capacity, minBlockSize);
+
+    (void)allocator.allocate(minBlockSize);
+    for (const auto size : { 2 * minBlockSize, 4 * minBlockSize, minBlockSize }) {
+        const auto offset = allocator.allocate(size);
+        ASSERT_NE(offset, BuddyAllocator::invalidOffset);
+        EXPECT_EQ(offset % size, 0u);
+    }
+
+    // アライメントが大きい場合はアライメント分のブロックを使う
+    const auto aligned = allocator.allocate(1, 8 * minBlockSize);
+    ASSERT_NE(aligned, BuddyAllocator::invalidOffset);
+    EXPECT_EQ(aligned % (8 * minBlockSize), 0u);
+}
+
+TEST(BuddyAllocatorTest, FailsWhenFullOrTooLarge) {
+    BuddyAllocator allocator;
+    allocator.initialize(capacity, minBlockSize);
+
+    EXPECT_EQ(allocator.allocate(0), BuddyAllocator::invalidOffset);
+    EXPECT_EQ(allocator.allocate(capacity + 1), BuddyAllocator::invalidOffset);
+    EXPECT_EQ(allocator.allocate(capacity), 0u);
+    EXPECT_EQ(allocator.allocate(1), BuddyAllocator::invalidOffset);
+    EXPECT_EQ(allocator.statistics().failedAllocationCount_, 3u);
+    EXPECT_EQ(allocator.fragmentation(), 0.0f);
+
+    allocator.free(0);
+    EXPECT_TRUE(allocator.empty());
+}
+
+TEST(BuddyAllocatorTest, MergesBuddiesBackToWholeRange) {
+    BuddyAllocator allocator;
+    allocator.initialize(capacity, minBlockSize);
+
+    std::vector<uint64_t> offsets;
+    for (uint64_t i = 0; i < capacity / minBlockSize; ++i) {
+        offsets.push_back(allocator.allocate(minBlockSize));
+    }
+    EXPECT_EQ(allocator.statistics().largestFreeBlock_, 0u);
+
+    // 相方同士が揃うまでは結合されない（0 と 2 は相方ではない）
+    allocator.free(offsets[0]);
+    allocator.free(offsets[2]);
+    EXPECT_EQ(allocator.statistics().largestFreeBlock_, minBlockSize);
+    allocator.free(offsets[1]);
+    EXPECT_EQ(allocator.statistics().largestFreeBlock_, 2 * minBlockSize);
+    allocator.free(offsets[3]);
+    EXPECT_EQ(allocator.statistics().largestFreeBlock_, 4 * minBlockSize);
+
+    for (size_t i = 4; i < offsets.size(); ++i) {
+        allocator.free(offsets[i]);
+    }
+    EXPECT_TRUE(allocator.empty());
+    EXPECT_EQ(allocator.statistics().largestFreeBlock_, capacity);
+    EXPECT_EQ(allocator.allocate(capacity), 0u);
+}
+
+TEST(BuddyAllocatorTest, ReportsFragmentation) {
+    BuddyAllocator allocator;
+    allocator.initialize(capacity, minBlockSize);
+
+    std::vector<uint64_t> offsets;
+    for (uint64_t i = 0; i < capacity / minBlockSize; ++i) {
+        offsets.push_back(allocator.allocate(minBlockSize));
+    }
+
+    // 一つ置きに解放すると空きの半分は使えるが、最小ブロックより大きな確保はできない
+    for (size_t i = 0; i < offsets.size(); i += 2) {
+        allocator.free(offsets[i]);
+    }
+    EXPECT_EQ(allocator.allocate(2 * minBlockSize), BuddyAllocator::invalidOffset);
+    EXPECT_NEAR(allocator.fragmentation(), 1.0f - 1.0f / 8.0f, 1e-6f);
+
+    const auto statistics = allocator.statistics();
+    EXPECT_EQ(statistics.peakUsedSize_, capacity);
+    EXPECT_EQ(statistics.usedSize_, capacity / 2);
+}
+
+TEST(BuddyAllocatorTest, RandomAllocateFreeKeepsBlocksDisjoint) {
+    BuddyAllocator allocator;
+    allocator.initialize(capacity, minBlockSize);
+
+    struct Range {
+        uint64_t offset_{};
+        uint64_t size_{};
+    };
+    std::vector<Range> live;
+    std::vector<uint8_t> owner(capacity / minBlockSize, 0);
+
+    std::mt19937 random(7);
+    std::uniform_int_distribution<uint64_t> sizeDistribution(1, capacity / 4);
+
+    for (int step = 0; step < 20000; ++step) {
+        if (live.empty() || random() % 2 == 0) {
+            const auto size = sizeDistribution(random);
+            const auto offset = allocator.allocate(size);
+            if (offset == BuddyAllocator::invalidOffset) {
+                continue;
+            }
+            ASSERT_LE(offset + size, capacity);
+            for (auto i = offset / minBlockSize; i < (offset + size + minBlockSize - 1) / minBlockSize; ++i) {
+                ASSERT_EQ(owner[i], 0) << "overlap at block " << i;
+                owner[i] = 1;
+            }
+            live.push_back({ offset, size });
+        } else {
+            const auto index = random() % live.size();
+            const auto range = live[index];
+            live[index] = live.back();
+            live.pop_back();
+            allocator.free(range.offset_);
+            for (auto i = range.offset_ / minBlockSize; i < (range.offset_ + range.size_ + minBlockSize - 1) / minBlockSize; ++i) {
+                owner[i] = 0;
+            }
+        }
+        ASSERT_EQ(allocator.statistics().allocationCount_, live.size());
+    }
+
+    for (const auto& range : live) {
+        allocator.free(range.offset_);
+    }
+    EXPECT_TRUE(allocator.empty());
+    EXPECT_EQ(allocator.statistics().usedSize_, 0u);
+    EXPECT_EQ(allocator.statistics().largestFreeBlock_, capacity);
+}
@@ -0,0 +1,315 @@
+// コマンドのキャプチャと再生クラスのテスト
+// ヌルデバイスに転送しながらシーン描画パスをキャプチャし、再生した結果が同じ統計と定数データになることを確かめる
+
+#include "command_capture.h"
+#include "rhi_null.h"
+#include "scene_pass.h"
+#include <gtest/gtest.h>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <numeric>
+#include <span>
+#include <vector>
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	テストで途中で切れたり壊れたりしたストリームを作る
+ */
+class CommandStreamTestAccess final {
+public:
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	バイト列を先頭から指定したサイズまでに切り詰める（コマンドの数と表はそのまま）
+     * @param	stream	切り詰めるストリーム
+     * @param	size	残すサイズ
+     */
+    static void truncate(CommandStream& stream, size_t size) {
+        stream.data_.resize(size);
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	バイト列の一バイトを書き換える
+     * @param	stream	書き換えるストリーム
+     * @param	offset	書き換える位置
+     * @param	value	書き込む値
+     */
+    static void overwrite(CommandStream& stream, size_t offset, uint8_t value) {
+        stream.data_[offset] = value;
+    }
+};
+
+namespace {
+    constexpr uint32_t width = 64;         // バックバッファの幅
+    constexpr uint32_t height = 64;        // バックバッファの高さ
+    constexpr uint32_t bufferCount = 2;    // バックバッファの数
+    constexpr uint32_t latency = 2;        // GPU が遅れるシグナルの数
+    constexpr uint64_t bufferSize = 4096;  // テストで使うバッファのサイズ
+    constexpr uint32_t cameraSize = 256;   // カメラの定数データのサイズ
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	ヌルデバイスとシーン描画パスの記録に必要なもの一式
+     */
+    struct Scene {
+        RhiNullDevice                   device_{};        /// デバイス
+        std::unique_ptr<RhiBuffer>      camera_{};        /// カメラの定数バッファ
+        std::unique_ptr<RhiBuffer>      instances_{};     /// インスタンスデータ
+        std::unique_ptr<RhiBuffer>      vertices_{};      /// 頂点バッファ
+        std::unique_ptr<RhiBuffer>      indices_{};       /// インデックスバッファ
+        std::unique_ptr<RhiFence>       fence_{};         /// 提出の完了を待つフェンス
+        std::unique_ptr<RhiCommandList> commandList_{};   /// コマンドリスト
+        RhiNullPipeline                 opaque_{ 1 };     /// 不透明のパイプライン
+        RhiNullPipeline                 alphaTest_{ 2 };  /// アルファテストのパイプライン
+        uint64_t                        fenceValue_{};    /// 最後にシグナルした値
+
+        //---------------------------------------------------------------------------------
+        /**
+         * @brief	デバイスとリソースを作成する
+         * @return	生成の成否
+         */
+        [[nodiscard]] bool create() {
+            if (!device_.create(width, height, bufferCount, latency)) {
+                return false;
+            }
+            camera_ = device_.createBuffer(RhiHeapType::upload, cameraSize);
+            instances_ = device_.createBuffer(RhiHeapType::upload, bufferSize);
+            vertices_ = device_.createBuffer(RhiHeapType::gpu, bufferSize);
+            indices_ = device_.createBuffer(RhiHeapType::gpu, bufferSize);
+            fence_ = device_.createFence();
+            commandList_ = device_.createCommandList(RhiQueueType::graphics);
+            return camera_ && instances_ && vertices_ && indices_ && fence_ && commandList_;
+        }
+
+        //---------------------------------------------------------------------------------
+        /**
+         * @brief	全ての描画で共通の設定を作る
+         * @return	共通の設定
+         */
+        [[nodiscard]] ScenePass::Frame frame() {
+            ScenePass::Frame frame;
+            frame.renderTarget_ = &device_.swapChain().backBuffer(0);
+            frame.viewport_ = { 0.0f, 0.0f, static_cast<float>(width), static_cast<float>(height) };
+            frame.scissor_ = { 0, 0, static_cast<int32_t>(width), static_cast<int32_t>(height) };
+            frame.camera_ = camera_->gpuAddress();
+            frame.instances_ = instances_->gpuAddress();
+            frame.vertexBuffer_ = { vertices_->gpuAddress(), static_cast<uint32_t>(bufferSize), 28 };
+            frame.indexBuffer_ = { indices_->gpuAddress(), static_cast<uint32_t>(bufferSize), 2 };
+            return frame;
+        }
+
+        //---------------------------------------------------------------------------------
+        /**
+         * @brief	コマンドリストを提出して完了を待つ
+         */
+        void submit() {
+            RhiCommandList* const lists[] = { commandList_.get() };
+            auto& queue = device_.queue(RhiQueueType::graphics);
+            queue.execute(lists);
+            queue.signal(*fence_, ++fenceValue_);
+            device_.flush();
+        }
+
+        //---------------------------------------------------------------------------------
+        /**
+         * @brief	GPU アドレスが指すアップロードヒープのバッファに書き込む
+         * @param	address	書き込む GPU アドレス
+         * @param	data	書き込むデータ
+         * @return	バッファに収まれば true
+         */
+        [[nodiscard]] bool write(RhiGpuAddress address, std::span<const uint8_t> data) {
+            for (auto* buffer : { camera_.get(), instances_.get() }) {
+                if (address >= buffer->gpuAddress() && address + data.size() <= buffer->gpuAddress() + buffer->size()) {
+                    auto* destination = static_cast<uint8_t*>(buffer->map());
+                    std::memcpy(destination + (address - buffer->gpuAddress()), data.data(), data.size());
+                    buffer->unmap();
+                    return true;
+                }
+            }
+            return false;
+        }
+    };
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	描画毎に値の違う定数データを作る
+     * @param	size	サイズ
+     * @param	seed	先頭の値
+     * @return	定数データ
+     */
+    [[nodiscard]] std::vector<uint8_t> makePayload(size_t size, uint8_t seed) {
+        std::vector<uint8_t> payload(size);
+        std::iota(payload.begin(), payload.end(), seed);
+        return payload;
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	二つの統計情報の全ての数が一致することを確かめる
+     * @param	actual		再生した時の統計情報
+     * @param	expected	キャプチャした時の統計情報
+     */
+    void expectSameStatistics(const RhiNullStatistics& actual, const RhiNullStatistics& expected) {
+        EXPECT_EQ(actual.drawCount_, expected.drawCount_);
+        EXPECT_EQ(actual.instanceCount_, expected.instanceCount_);
+        EXPECT_EQ(actual.indexCount_, expected.indexCount_);
+        EXPECT_EQ(actual.pipelineChangeCount_, expected.pipelineChangeCount_);
+        EXPECT_EQ(actual.bindingCount_, expected.bindingCount_);
+        EXPECT_EQ(actual.barrierCount_, expected.barrierCount_);
+        EXPECT_EQ(actual.commandListCount_, expected.commandListCount_);
+        EXPECT_EQ(actual.submitCount_, expected.submitCount_);
+        EXPECT_EQ(actual.errorCount_, expected.errorCount_);
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	エントリーのキャプチャと同じく、定数データ・バリア・クリア・シーン描画パスを記録する
+     * @param	scene		記録するシーン
+     * @param	stream		記録先のストリーム
+     * @param	camera		カメラの定数データ
+     * @param	instances	インスタンスデータ
+     */
+    void capture(Scene& scene, CommandStream& stream, std::span<const uint8_t> camera, std::span<const uint8_t> instances) {
+        const std::array draws = {
+            ScenePass::Draw{ &scene.opaque_, 36, 0, 0, 0, 10 },
+            ScenePass::Draw{ &scene.opaque_, 6, 36, 24, 10, 5 },
+            ScenePass::Draw{ &scene.alphaTest_, 3, 42, 28, 15, 1 },
+        };
+        const float clearColor[4] = { 0.1f, 0.2f, 0.3f, 1.0f };
+        auto frame = scene.frame();
+
+        scene.commandList_->reset();
+        CaptureCommandList capture(stream, scene.commandList_.get());
+        ASSERT_TRUE(scene.write(frame.camera_, camera));
+        capture.upload(frame.camera_, camera);
+        ASSERT_TRUE(scene.write(frame.instances_, instances));
+        capture.upload(frame.instances_, instances);
+        capture.barrier(*frame.renderTarget_, RhiState::present, RhiState::renderTarget);
+        capture.clearRenderTarget(*frame.renderTarget_, clearColor);
+        ScenePass::record(capture, frame, draws);
+        capture.barrier(*frame.renderTarget_, RhiState::renderTarget, RhiState::present);
+        scene.commandList_->close();
+        scene.submit();
+    }
+}  // namespace
+
+TEST(CommandCaptureTest, ReplayMatchesCapturedFrame) {
+    Scene scene;
+    ASSERT_TRUE(scene.create());
+    const auto camera = makePayload(cameraSize, 3);
+    const auto instances = makePayload(16 * 64, 100);
+
+    CommandStream stream;
+    capture(scene, stream, camera, instances);
+    ASSERT_FALSE(stream.empty());
+    EXPECT_EQ(stream.uploadSize(), camera.size() + instances.size());
+    const auto captured = scene.device_.statistics();
+    ASSERT_EQ(captured.errorCount_, 0u) << scene.device_.lastError();
+    ASSERT_EQ(captured.drawCount_, 3u);
+
+    // 定数データを壊してから再生すると、キャプチャした時の中身に戻る
+    const std::vector<uint8_t> garbage(bufferSize, 0xcd);
+    ASSERT_TRUE(scene.write(scene.camera_->gpuAddress(), std::span(garbage).first(cameraSize)));
+    ASSERT_TRUE(scene.write(scene.instances_->gpuAddress(), garbage));
+    scene.device_.resetStatistics();
+
+    std::vector<std::vector<uint8_t>> uploads;
+    const auto upload = [&](RhiGpuAddress address, std::span<const uint8_t> data) {
+        uploads.emplace_back(data.begin(), data.end());
+        return scene.write(address, data);
+    };
+    scene.commandList_->reset();
+    ASSERT_TRUE(CommandReplayer::replay(stream, *scene.commandList_, upload));
+    scene.commandList_->close();
+    scene.submit();
+
+    expectSameStatistics(scene.device_.statistics(), captured);
+    ASSERT_EQ(uploads.size(), 2u);
+    EXPECT_EQ(uploads[0], camera);
+    EXPECT_EQ(uploads[1], instances);
+    const auto* cameraData = scene.device_.resolve(scene.camera_->gpuAddress(), camera.size());
+    const auto* instanceData = scene.device_.resolve(scene.instances_->gpuAddress(), instances.size());
+    ASSERT_NE(cameraData, nullptr);
+    ASSERT_NE(instanceData, nullptr);
+    EXPECT_EQ(std::memcmp(cameraData, camera.data(), camera.size()), 0);
+    EXPECT_EQ(std::memcmp(instanceData, instances.data(), instances.size()), 0);
+}
+
+TEST(CommandCaptureTest, ReplayWithoutUploadFunctionOnlyIssuesCommands) {
+    Scene scene;
+    ASSERT_TRUE(scene.create());
+    CommandStream stream;
+    capture(scene, stream, makePayload(cameraSize, 0), makePayload(64, 0));
+    const auto captured = scene.device_.statistics();
+    scene.device_.resetStatistics();
+
+    scene.commandList_->reset();
+    ASSERT_TRUE(CommandReplayer::replay(stream, *scene.commandList_, {}));
+    scene.commandList_->close();
+    scene.submit();
+    expectSameStatistics(scene.device_.statistics(), captured);
+
+    // 書き込めない定数データがあれば失敗を返す
+    scene.commandList_->reset();
+    EXPECT_FALSE(CommandReplayer::replay(stream, *scene.commandList_, [](RhiGpuAddress, std::span<const uint8_t>) { return false; }));
+    scene.commandList_->close();
+}
+
+TEST(CommandCaptureTest, BenchmarkReplaysEveryRepeat) {
+    Scene scene;
+    ASSERT_TRUE(scene.create());
+    CommandStream stream;
+    capture(scene, stream, makePayload(cameraSize, 0), makePayload(64, 0));
+    const auto captured = scene.device_.statistics();
+    scene.device_.resetStatistics();
+
+    std::vector<double> milliseconds;
+    ASSERT_TRUE(CommandReplayer::benchmark(stream, scene.device_, 5, {}, milliseconds));
+    EXPECT_EQ(milliseconds.size(), 5u);
+    const auto statistics = scene.device_.statistics();
+    EXPECT_EQ(statistics.drawCount_, captured.drawCount_ * 5);
+    EXPECT_EQ(statistics.submitCount_, 5u);
+    EXPECT_EQ(statistics.errorCount_, 0u) << scene.device_.lastError();
+}
+
+TEST(CommandCaptureTest, TruncatedStreamsAreRejected) {
+    Scene scene;
+    ASSERT_TRUE(scene.create());
+    CommandStream original;
+    capture(scene, original, makePayload(cameraSize, 0), makePayload(64, 0));
+    const auto size = original.bytes().size();
+    ASSERT_GT(size, 0u);
+
+    // コマンドの途中でもコマンドの境目でも、最後まで揃っていないストリームは再生しない
+    for (size_t length = 0; length < size; ++length) {
+        auto stream = original;
+        CommandStreamTestAccess::truncate(stream, length);
+        scene.commandList_->reset();
+        EXPECT_FALSE(CommandReplayer::replay(stream, *scene.commandList_, {})) << "length " << length;
+        scene.commandList_->close();
+    }
+}
+
+TEST(CommandCaptureTest, UnknownCommandIsRejected) {
+    Scene scene;
+    ASSERT_TRUE(scene.create());
+    CommandStream original;
+    capture(scene, original, makePayload(cameraSize, 0), makePayload(64, 0));
+
+    // 先頭のコマンドの種類を、定義に無い値に書き換える
+    const auto unknown = static_cast<uint8_t>(static_cast<uint8_t>(CommandStream::Command::upload) + 1);
+    for (const auto value : { unknown, uint8_t{ 0xff } }) {
+        auto stream = original;
+        CommandStreamTestAccess::overwrite(stream, 0, value);
+        scene.commandList_->reset();
+        std::vector<RhiGpuAddress> uploads;
+        EXPECT_FALSE(CommandReplayer::replay(stream, *scene.commandList_, [&uploads](RhiGpuAddress address, std::span<const uint8_t>) {
+            uploads.push_back(address);
+            return true;
+        })) << "command " << static_cast<int>(value);
+        scene.commandList_->close();
+        EXPECT_TRUE(uploads.empty());
+    }
+}
@@ -0,0 +1,142 @@
+// 動的解像度の制御クラスのテスト
+
+#include "dynamic_resolution.h"
+#include <gtest/gtest.h>
+
+namespace {
+    constexpr double targetTime = 14.0;   // 目標の GPU 時間（ミリ秒）
+    constexpr int    settleFrames = 300;  // 倍率が落ち着くまでのフレーム数
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	GPU 時間が描画するピクセル数に比例するとみなして、倍率から GPU 時間を求める
+     * @param	fullTime	倍率 1 での GPU 時間（ミリ秒）
+     * @param	scale		描画解像度の倍率
+     * @return	GPU 時間（ミリ秒）
+     */
+    [[nodiscard]] double gpuTime(double fullTime, float scale) {
+        return fullTime * scale * scale;
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	倍率で GPU 時間が変わる負荷を一定フレーム流す
+     * @param	controller	動かす制御
+     * @param	fullTime	倍率 1 での GPU 時間（ミリ秒）
+     * @param	frames		フレーム数
+     * @return	最後の倍率
+     */
+    float run(DynamicResolution& controller, double fullTime, int frames) {
+        for (int frame = 0; frame < frames; ++frame) {
+            (void)controller.update(gpuTime(fullTime, controller.scale()));
+        }
+        return controller.scale();
+    }
+}  // namespace
+
+TEST(DynamicResolutionTest, ConvergesIntoTargetBand) {
+    DynamicResolution controller;
+    ASSERT_EQ(controller.scale(), 1.0f);
+
+    // 目標より重い場面では、GPU 時間が目標の前後の幅に入るまで倍率を下げる
+    for (const auto fullTime : { 16.0, 20.0, 30.0 }) {
+        controller.reset();
+        const auto scale = run(controller, fullTime, settleFrames);
+        const auto ratio = gpuTime(fullTime, scale) / targetTime;
+        EXPECT_LT(scale, 1.0f) << fullTime;
+        EXPECT_GE(ratio, controller.settings().lowerThreshold_) << fullTime;
+        EXPECT_LE(ratio, controller.settings().upperThreshold_) << fullTime;
+    }
+}
+
+TEST(DynamicResolutionTest, RecoversWhenLoadDrops) {
+    DynamicResolution controller;
+    (void)run(controller, 25.0, settleFrames);
+    ASSERT_LT(controller.scale(), 0.8f);
+
+    // 負荷が下がると上限まで戻る
+    EXPECT_EQ(run(controller, 8.0, settleFrames), 1.0f);
+}
+
+TEST(DynamicResolutionTest, HoldsScaleInsideHysteresisBand) {
+    DynamicResolution controller;
+    (void)run(controller, 20.0, settleFrames);
+    const auto settled = controller.scale();
+
+    // 幅の中の時間では、上下に揺れても倍率を変えない
+    const auto lower = targetTime * controller.settings().lowerThreshold_;
+    const auto upper = targetTime * controller.settings().upperThreshold_;
+    for (int frame = 0; frame < 100; ++frame) {
+        EXPECT_EQ(controller.update(frame % 2 == 0 ? lower + 0.1 : upper - 0.1), settled) << "frame " << frame;
+    }
+
+    // 幅を超える時間が続けば下げ、下回る時間が続けば上げる
+    (void)run(controller, gpuTime(upper * 1.2, 1.0f) / (settled * settled), 10);
+    EXPECT_LT(controller.scale(), settled);
+    controller.reset();
+    (void)run(controller, 20.0, settleFrames);
+    (void)run(controller, gpuTime(lower * 0.8, 1.0f) / (settled * settled), 10);
+    EXPECT_GT(controller.scale(), settled);
+}
+
+TEST(DynamicResolutionTest, DecreasesFasterThanIncreases) {
+    // 倍率 1 から、幅の中央の倍の時間を計測する
+    DynamicResolution decreasing;
+    const auto aim = (decreasing.settings().lowerThreshold_ + decreasing.settings().upperThreshold_) * 0.5;
+    const auto down = 1.0f - decreasing.update(targetTime * aim * 2.0);
+
+    // 下限の倍率から、幅の中央の半分の時間を計測する（目標の倍率との差は同じ程度）
+    DynamicResolution increasing;
+    auto settings = increasing.settings();
+    settings.maxScale_ = settings.minScale_;
+    increasing.setSettings(settings);
+    settings.maxScale_ = 1.0f;
+    increasing.setSettings(settings);
+    ASSERT_EQ(increasing.scale(), settings.minScale_);
+    const auto up = increasing.update(targetTime * aim * 0.5) - settings.minScale_;
+
+    // 目標を超えた時は早めに下げ、余裕がある時はゆっくり上げる
+    EXPECT_GT(up, 0.0f);
+    EXPECT_GT(down, 4.0f * up);
+}
+
+TEST(DynamicResolutionTest, ClampsToScaleRange) {
+    DynamicResolution controller;
+    auto settings = controller.settings();
+    settings.minScale_ = 0.6f;
+    settings.maxScale_ = 0.9f;
+    controller.setSettings(settings);
+
+    // 設定を変えた時点で現在の倍率も範囲に収める
+    EXPECT_EQ(controller.scale(), 0.9f);
+
+    // 下限でも目標に届かない負荷では下限に留まり、軽い負荷では上限に留まる
+    EXPECT_EQ(run(controller, 100.0, settleFrames), 0.6f);
+    EXPECT_EQ(run(controller, 1.0, settleFrames), 0.9f);
+
+    settings.maxScale_ = 0.7f;
+    controller.setSettings(settings);
+    EXPECT_EQ(controller.scale(), 0.7f);
+}
+
+TEST(DynamicResolutionTest, IgnoresInvalidSamplesAndResets) {
+    DynamicResolution controller;
+    EXPECT_EQ(controller.update(0.0), 1.0f);
+    EXPECT_EQ(controller.update(-5.0), 1.0f);
+
+    auto settings = controller.settings();
+    settings.targetTime_ = 0.0;
+    controller.setSettings(settings);
+    EXPECT_EQ(controller.update(100.0), 1.0f);
+
+    settings.targetTime_ = targetTime;
+    controller.setSettings(settings);
+    (void)run(controller, 40.0, settleFrames);
+    ASSERT_LT(controller.scale(), 1.0f);
+
+    // 履歴を捨てるので、リセット直後の一回目は平滑化されずにそのまま判断に使われる
+    // （履歴が残っていれば、目標付近の時間と平滑化されて幅に収まり倍率は変わらない）
+    controller.reset();
+    EXPECT_EQ(controller.scale(), 1.0f);
+    EXPECT_LT(controller.update(targetTime * 1.2), 1.0f);
+}
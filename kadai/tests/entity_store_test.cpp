@@ -0,0 +1,193 @@
+// エンティティストアクラスのテスト
+
+#include "entity_store.h"
+#include "simd_paths.h"
+#include "transform_batch.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace {
+    using Component = EntityStore::Component;
+
+    constexpr size_t matrixSize = 16;  // 行列一つの float の数
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	エンティティの全てのコンポーネントに、値をコンポーネント毎に少しずつずらして書く
+     * @param	store	エンティティストア
+     * @param	entity	書き込むエンティティ
+     * @param	value	エンティティ毎の値
+     */
+    void setComponents(EntityStore& store, Entity entity, float value) {
+        const auto index = store.indexOf(entity);
+        for (uint32_t component = 0; component < static_cast<uint32_t>(Component::count); ++component) {
+            store.values(static_cast<Component>(component))[index] = value + static_cast<float>(component) * 0.01f;
+        }
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	回転（単位クォータニオン）・拡大率・座標に乱数を書く
+     * @param	store	エンティティストア
+     * @param	random	乱数
+     */
+    void randomizeTransforms(EntityStore& store, std::mt19937& random) {
+        std::uniform_real_distribution<float> distribution(-2.0f, 2.0f);
+        for (uint32_t i = 0; i < store.size(); ++i) {
+            for (const auto component : { Component::positionX, Component::positionY, Component::positionZ, Component::scaleX, Component::scaleY, Component::scaleZ }) {
+                store.values(component)[i] = distribution(random);
+            }
+            float q[4] = { distribution(random), distribution(random), distribution(random), distribution(random) };
+            const auto length = std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+            store.values(Component::rotationX)[i] = q[0] / length;
+            store.values(Component::rotationY)[i] = q[1] / length;
+            store.values(Component::rotationZ)[i] = q[2] / length;
+            store.values(Component::rotationW)[i] = q[3] / length;
+        }
+    }
+}  // namespace
+
+TEST(EntityStoreTest, AddCreatesDefaultComponents) {
+    EntityStore store;
+    const auto entity = store.add();
+
+    ASSERT_TRUE(store.isAlive(entity));
+    ASSERT_EQ(store.size(), 1u);
+    EXPECT_EQ(store.indexOf(entity), 0u);
+    for (const auto component : { Component::positionX, Component::positionY, Component::positionZ, Component::rotationX, Component::rotationY, Component::rotationZ, Component::phase }) {
+        EXPECT_EQ(store.values(component)[0], 0.0f);
+    }
+    for (const auto component : { Component::rotationW, Component::scaleX, Component::scaleY, Component::scaleZ, Component::radius }) {
+        EXPECT_EQ(store.values(component)[0], 1.0f);
+    }
+}
+
+TEST(EntityStoreTest, RemoveMovesLastEntityIntoHole) {
+    EntityStore store;
+    std::vector<Entity> entities;
+    for (int i = 0; i < 5; ++i) {
+        entities.push_back(store.add());
+        setComponents(store, entities.back(), static_cast<float>(i));
+    }
+
+    // 先頭を削除すると末尾が先頭に移り、コンポーネントも一緒に移る
+    ASSERT_TRUE(store.remove(entities[0]));
+    EXPECT_EQ(store.size(), 4u);
+    EXPECT_EQ(store.indexOf(entities[4]), 0u);
+    EXPECT_EQ(store.entities()[0], entities[4]);
+    for (uint32_t component = 0; component < static_cast<uint32_t>(Component::count); ++component) {
+        EXPECT_EQ(store.values(static_cast<Component>(component))[0], 4.0f + static_cast<float>(component) * 0.01f);
+        EXPECT_EQ(store.values(static_cast<Component>(component)).size(), 4u);
+    }
+
+    // 末尾の削除は何も移さない
+    ASSERT_TRUE(store.remove(entities[3]));
+    EXPECT_EQ(store.indexOf(entities[1]), 1u);
+    EXPECT_EQ(store.indexOf(entities[2]), 2u);
+    EXPECT_EQ(store.values(Component::positionX)[2], 2.0f);
+}
+
+TEST(EntityStoreTest, StaleHandlesStayInvalidAfterSlotReuse) {
+    EntityStore store;
+    const auto first = store.add();
+    ASSERT_TRUE(store.remove(first));
+    EXPECT_FALSE(store.isAlive(first));
+    EXPECT_FALSE(store.remove(first));
+    EXPECT_EQ(store.indexOf(first), EntityStore::invalidIndex);
+
+    // スロットは再利用されるが世代が違うので、古いハンドルは新しいエンティティを指さない
+    const auto second = store.add();
+    EXPECT_EQ(second.index_, first.index_);
+    EXPECT_NE(second.generation_, first.generation_);
+    EXPECT_FALSE(store.isAlive(first));
+    EXPECT_TRUE(store.isAlive(second));
+
+    // 範囲外のスロットも無効
+    EXPECT_FALSE(store.isAlive(Entity{ 100, 0 }));
+    EXPECT_FALSE(store.isAlive(Entity{}));
+}
+
+TEST(EntityStoreTest, ClearInvalidatesAllHandles) {
+    EntityStore store;
+    store.reserve(8);
+    std::vector<Entity> entities;
+    for (int i = 0; i < 8; ++i) {
+        entities.push_back(store.add());
+    }
+    store.clear();
+
+    EXPECT_EQ(store.size(), 0u);
+    EXPECT_TRUE(store.values(Component::positionX).empty());
+    for (const auto entity : entities) {
+        EXPECT_FALSE(store.isAlive(entity));
+    }
+
+    // 追加し直したエンティティは以前のハンドルと一致しない
+    for (int i = 0; i < 8; ++i) {
+        const auto entity = store.add();
+        EXPECT_EQ(std::count(entities.begin(), entities.end(), entity), 0);
+    }
+}
+
+TEST(EntityStoreTest, RandomChurnKeepsHandlesAndArraysConsistent) {
+    EntityStore store;
+    std::vector<std::pair<Entity, float>> live;
+    std::mt19937 random(5);
+
+    for (int step = 0; step < 20000; ++step) {
+        if (live.empty() || random() % 3 != 0) {
+            const auto entity = store.add();
+            const auto value = static_cast<float>(step);
+            setComponents(store, entity, value);
+            live.emplace_back(entity, value);
+        } else {
+            const auto index = random() % live.size();
+            ASSERT_TRUE(store.remove(live[index].first));
+            live[index] = live.back();
+            live.pop_back();
+        }
+    }
+
+    // 全てのハンドルが自分のコンポーネントを指し、配列は隙間なく詰まっている
+    ASSERT_EQ(store.size(), live.size());
+    for (const auto& [entity, value] : live) {
+        const auto index = store.indexOf(entity);
+        ASSERT_LT(index, store.size());
+        EXPECT_EQ(store.entities()[index], entity);
+        EXPECT_EQ(store.values(Component::phase)[index], value + static_cast<float>(Component::phase) * 0.01f);
+    }
+}
+
+TEST(EntityStoreTest, BatchTransformOfStoreMatchesScalarOnEveryPath) {
+    std::mt19937 random(9);
+
+    // SIMD の幅で割り切れない数も含め、削除で詰め直した配列をそのまま入力にする
+    for (const auto count : { 1u, 3u, 4u, 5u, 7u, 8u, 9u, 13u, 31u, 64u, 1001u }) {
+        EntityStore store;
+        std::vector<Entity> entities;
+        for (uint32_t i = 0; i < count + count / 2; ++i) {
+            entities.push_back(store.add());
+        }
+        for (uint32_t i = 0; i < count / 2; ++i) {
+            ASSERT_TRUE(store.remove(entities[i * 2]));
+        }
+        ASSERT_EQ(store.size(), count);
+        randomizeTransforms(store, random);
+
+        const auto source = TransformBatch::source(store);
+        std::vector<float> expected(count * matrixSize);
+        TransformBatch::compose(source, count, expected.data(), matrixSize * sizeof(float), TransformBatch::Path::scalar);
+
+        // 演算の順序は全ての命令セットで同じなので、結果はビット単位で一致する
+        for (const auto path : availablePaths()) {
+            std::vector<float> actual(count * matrixSize, -1.0f);
+            TransformBatch::compose(source, count, actual.data(), matrixSize * sizeof(float), path);
+            EXPECT_EQ(actual, expected) << "count " << count << ", path " << static_cast<int>(path);
+        }
+    }
+}
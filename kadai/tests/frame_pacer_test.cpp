@@ -0,0 +1,229 @@
+// フレームの開始時刻を決めるクラスのテスト
+// 実時間の代わりに、垂直同期と Present を模した時計で FramePacer を動かす
+
+#include "frame_pacer.h"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <random>
+
+namespace {
+    constexpr uint64_t millisecond = 1'000'000;             // 1 ミリ秒（ナノ秒）
+    constexpr uint64_t refresh60 = 16'666'667;              // 60Hz のリフレッシュ間隔（ナノ秒）
+    constexpr uint64_t refresh144 = 6'944'444;              // 144Hz のリフレッシュ間隔（ナノ秒）
+    constexpr uint64_t firstVblank = 1'000 * millisecond;   // 最初の垂直同期の時刻（0 は FramePacer が未計測として扱う）
+    constexpr int      warmupFrames = 120;                  // 推定が落ち着くまでのフレーム数
+    constexpr int      measureFrames = 600;                 // 計測するフレーム数
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	垂直同期と Present を模した時計
+     * 最大遅延 1 の待機可能なスワップチェインと同じく、提出したフレームが表示される垂直同期で次の待ちが返る
+     */
+    class SimulatedPresentClock {
+    public:
+        //---------------------------------------------------------------------------------
+        /**
+         * @brief    コンストラクタ
+         * @param	refreshInterval	ディスプレイのリフレッシュ間隔（ナノ秒）
+         */
+        explicit SimulatedPresentClock(uint64_t refreshInterval)
+            : refreshInterval_(refreshInterval) {}
+
+        //---------------------------------------------------------------------------------
+        /**
+         * @brief	待機可能なスワップチェインの待ちが返る時刻を取得する
+         * @return	時刻（ナノ秒）
+         */
+        [[nodiscard]] uint64_t readyTime() const {
+            return readyTime_;
+        }
+
+        //---------------------------------------------------------------------------------
+        /**
+         * @brief	フレームを処理して Present する
+         * 処理を終えた後の最初の垂直同期で表示し、その時刻を次の待ちが返る時刻にする
+         * @param	startTime	入力を読んでフレームを始めた時刻（ナノ秒）
+         * @param	work		フレームの処理時間（ナノ秒）
+         * @return	Present が返った時刻（ナノ秒）
+         */
+        uint64_t present(uint64_t startTime, uint64_t work) {
+            const auto presentTime = startTime + work;
+            const auto scanout = nextVblank(presentTime);
+            framesPerVblank_ = static_cast<int>((scanout - readyTime_ + refreshInterval_ / 2) / refreshInterval_);
+            latency_ = scanout - startTime;
+            readyTime_ = scanout;
+            return presentTime;
+        }
+
+        //---------------------------------------------------------------------------------
+        /**
+         * @brief	最後のフレームの、入力を読んでから表示されるまでの時間を取得する
+         * @return	時間（ナノ秒）
+         */
+        [[nodiscard]] uint64_t latency() const {
+            return latency_;
+        }
+
+        //---------------------------------------------------------------------------------
+        /**
+         * @brief	最後のフレームが、前のフレームから何回目の垂直同期で表示されたかを取得する
+         * @return	1 なら間に合った
+         */
+        [[nodiscard]] int framesPerVblank() const {
+            return framesPerVblank_;
+        }
+
+    private:
+        //---------------------------------------------------------------------------------
+        /**
+         * @brief	指定した時刻以降の最初の垂直同期の時刻を取得する
+         * @param	time	時刻（ナノ秒）
+         * @return	垂直同期の時刻（ナノ秒）
+         */
+        [[nodiscard]] uint64_t nextVblank(uint64_t time) const {
+            const auto count = (time - firstVblank + refreshInterval_ - 1) / refreshInterval_;
+            return firstVblank + count * refreshInterval_;
+        }
+
+        uint64_t refreshInterval_{};         /// リフレッシュ間隔（ナノ秒）
+        uint64_t readyTime_ = firstVblank;   /// 次の待ちが返る時刻（ナノ秒）
+        uint64_t latency_{};                 /// 最後のフレームの入力から表示までの時間（ナノ秒）
+        int      framesPerVblank_{};         /// 最後のフレームの表示までに経過した垂直同期の数
+    };
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	計測の結果
+     */
+    struct SimulationResult {
+        double averageLatency_{};  /// 入力から表示までの平均時間（ミリ秒）
+        int    missedVblanks_{};   /// 次の垂直同期に間に合わなかったフレームの数
+    };
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	処理時間が一様に揺れるフレームを流し、落ち着いた後の遅延を計測する
+     * @param	pacer		動かす FramePacer
+     * @param	clock		時計
+     * @param	minWork		フレームの処理時間の最小値（ナノ秒）
+     * @param	maxWork		フレームの処理時間の最大値（ナノ秒）
+     * @return	計測の結果
+     */
+    [[nodiscard]] SimulationResult simulate(FramePacer& pacer, SimulatedPresentClock& clock, uint64_t minWork, uint64_t maxWork) {
+        std::mt19937_64 random(11);
+        std::uniform_int_distribution<uint64_t> workDistribution(minWork, maxWork);
+
+        SimulationResult result;
+        uint64_t totalLatency = 0;
+        for (int frame = 0; frame < warmupFrames + measureFrames; ++frame) {
+            const auto ready = clock.readyTime();
+            const auto start = pacer.beginFrame(ready);
+            EXPECT_GE(start, ready);
+            pacer.endFrame(start, clock.present(start, workDistribution(random)));
+
+            if (frame >= warmupFrames) {
+                totalLatency += clock.latency();
+                result.missedVblanks_ += clock.framesPerVblank() > 1 ? 1 : 0;
+            }
+        }
+        result.averageLatency_ = static_cast<double>(totalLatency) / measureFrames / millisecond;
+        return result;
+    }
+}  // namespace
+
+TEST(FramePacerTest, ThroughputStartsAsSoonAsReady) {
+    FramePacer pacer;
+    pacer.setMode(FramePacer::Mode::throughput);
+    SimulatedPresentClock clock(refresh60);
+
+    const auto result = simulate(pacer, clock, 3 * millisecond, 6 * millisecond);
+
+    // 待ちが返った直後に入力を読むので、表示までほぼ一フレーム分かかる
+    EXPECT_NEAR(result.averageLatency_, refresh60 / 1e6, 0.01);
+    EXPECT_EQ(result.missedVblanks_, 0);
+    EXPECT_EQ(pacer.missedFrames(), 0u);
+}
+
+TEST(FramePacerTest, LowLatencyDelaysStartWithoutMissingVblanks) {
+    FramePacer pacer;
+    ASSERT_EQ(pacer.mode(), FramePacer::Mode::lowLatency);
+    SimulatedPresentClock clock(refresh60);
+
+    const auto result = simulate(pacer, clock, 3 * millisecond, 6 * millisecond);
+
+    // 最大の処理時間と余裕の分だけ前に始めるので、遅延は半分以下になる
+    EXPECT_LT(result.averageLatency_, 8.0);
+    EXPECT_GT(result.averageLatency_, 6.0);
+    EXPECT_EQ(result.missedVblanks_, 0);
+    EXPECT_LE(pacer.predictedWork(), 6 * millisecond);
+    EXPECT_GT(pacer.predictedWork(), 5 * millisecond);
+}
+
+TEST(FramePacerTest, TracksRefreshIntervalOfTheDisplay) {
+    FramePacer pacer;
+    SimulatedPresentClock clock(refresh144);
+
+    const auto result = simulate(pacer, clock, 1 * millisecond, 2 * millisecond);
+
+    // 初期値の 60Hz から 144Hz に追従し、間に合わない分は最初の数フレームだけ
+    EXPECT_NEAR(static_cast<double>(pacer.refreshInterval()), static_cast<double>(refresh144), 0.01 * millisecond);
+    EXPECT_EQ(result.missedVblanks_, 0);
+    EXPECT_LT(result.averageLatency_, refresh144 / 1e6);
+}
+
+TEST(FramePacerTest, RecoversAfterWorkSpike) {
+    FramePacer pacer;
+    SimulatedPresentClock clock(refresh60);
+    (void)simulate(pacer, clock, 4 * millisecond, 4 * millisecond);
+    ASSERT_EQ(pacer.missedFrames(), 0u);
+
+    // 予測より長いフレームは遅れて始めた分だけ垂直同期を逃す
+    auto start = pacer.beginFrame(clock.readyTime());
+    pacer.endFrame(start, clock.present(start, 10 * millisecond));
+    EXPECT_EQ(clock.framesPerVblank(), 2);
+    EXPECT_EQ(pacer.predictedWork(), 10 * millisecond);
+
+    // 逃したことは次の待ちの間隔で分かり、その後は長い処理時間に合わせて早めに始める
+    for (int frame = 0; frame < 10; ++frame) {
+        start = pacer.beginFrame(clock.readyTime());
+        pacer.endFrame(start, clock.present(start, 10 * millisecond));
+        EXPECT_EQ(clock.framesPerVblank(), 1) << "frame " << frame;
+    }
+    EXPECT_EQ(pacer.missedFrames(), 1u);
+
+    // リフレッシュ間隔の推定は逃したフレームの間隔に引きずられない
+    EXPECT_NEAR(static_cast<double>(pacer.refreshInterval()), static_cast<double>(refresh60), 0.01 * millisecond);
+}
+
+TEST(FramePacerTest, StartsImmediatelyWhenWorkExceedsInterval) {
+    FramePacer pacer;
+    SimulatedPresentClock clock(refresh60);
+
+    for (int frame = 0; frame < 30; ++frame) {
+        const auto ready = clock.readyTime();
+        const auto start = pacer.beginFrame(ready);
+        if (frame > 0) {
+            EXPECT_EQ(start, ready) << "frame " << frame;
+        }
+        pacer.endFrame(start, clock.present(start, 20 * millisecond));
+    }
+    EXPECT_GT(pacer.missedFrames(), 0u);
+}
+
+TEST(FramePacerTest, PredictedWorkHoldsPeakAndDecaysSlowly) {
+    FramePacer pacer;
+    pacer.endFrame(0, 8 * millisecond);
+    EXPECT_EQ(pacer.predictedWork(), 8 * millisecond);
+
+    // 短くなった時は差の 1/32 ずつ下がる
+    pacer.endFrame(0, 4 * millisecond);
+    EXPECT_EQ(pacer.predictedWork(), 8 * millisecond - 4 * millisecond / 32);
+
+    // 長くなった時はすぐに合わせる
+    pacer.endFrame(0, 9 * millisecond);
+    EXPECT_EQ(pacer.predictedWork(), 9 * millisecond);
+
+    // Present が始めた時刻より前に返っても負にはならない
+    pacer.endFrame(10 * millisecond, 5 * millisecond);
+    EXPECT_LT(pacer.predictedWork(), 9 * millisecond);
+}
@@ -0,0 +1,225 @@
+// フレーム時間の統計クラスのテスト
+
+#include "frame_statistics.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    using Metric = FrameStatistics::Metric;
+
+    constexpr double binWidth = FrameStatistics::binWidth;  // パーセンタイルの誤差の上限（ミリ秒）
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	パーセンタイルが正しい値から区間の幅以内の上にあることを確かめる
+     * @param	actual		求めたパーセンタイル（ミリ秒）
+     * @param	expected	並べ替えて求めた正しい値（ミリ秒）
+     */
+    void expectWithinBin(double actual, double expected) {
+        EXPECT_GE(actual, expected - 1e-9);
+        EXPECT_LE(actual, expected + binWidth + 1e-9);
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	並べ替えた値から、小さい方から数えて割合に達した値を求める
+     * @param	values		値（並べ替え済み）
+     * @param	percentile	割合（0 〜 1）
+     * @return	値
+     */
+    [[nodiscard]] double exactPercentile(const std::vector<double>& values, double percentile) {
+        const auto rank = std::max<size_t>(static_cast<size_t>(std::ceil(percentile * values.size())), 1);
+        return values[rank - 1];
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	ファイルの行を読む
+     * @param	path	ファイルのパス
+     * @return	行の並び
+     */
+    [[nodiscard]] std::vector<std::string> readLines(const std::filesystem::path& path) {
+        std::ifstream file(path);
+        std::vector<std::string> lines;
+        for (std::string line; std::getline(file, line);) {
+            lines.push_back(line);
+        }
+        return lines;
+    }
+}  // namespace
+
+TEST(FrameStatisticsTest, EmptyTrackSummarizesToZero) {
+    FrameStatistics statistics;
+    const auto summary = statistics.summary(Metric::cpuFrame);
+    EXPECT_EQ(summary.count_, 0u);
+    EXPECT_EQ(summary.average_, 0.0);
+    EXPECT_EQ(summary.p99_, 0.0);
+    EXPECT_EQ(summary.max_, 0.0);
+}
+
+TEST(FrameStatisticsTest, PercentilesOfKnownDistribution) {
+    // 1 〜 100 ミリ秒を一つずつ、順番を混ぜて記録する
+    std::vector<double> values;
+    for (int i = 1; i <= 100; ++i) {
+        values.push_back(static_cast<double>(i));
+    }
+    auto shuffled = values;
+    std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(3));
+
+    FrameStatistics statistics;
+    for (const auto value : shuffled) {
+        statistics.record(Metric::presentInterval, value);
+    }
+
+    const auto summary = statistics.summary(Metric::presentInterval);
+    EXPECT_EQ(summary.count_, 100u);
+    EXPECT_DOUBLE_EQ(summary.average_, 50.5);
+    expectWithinBin(summary.p50_, 50.0);
+    expectWithinBin(summary.p95_, 95.0);
+    expectWithinBin(summary.p99_, 99.0);
+    EXPECT_EQ(summary.max_, 100.0);
+
+    // 他の種類には影響しない
+    EXPECT_EQ(statistics.summary(Metric::cpuFrame).count_, 0u);
+}
+
+TEST(FrameStatisticsTest, PercentilesStayWithinOneBinIncludingBinEdges) {
+    // 区間の境界ちょうどの値と、境界から僅かにずれた値を混ぜる
+    std::mt19937 random(8);
+    std::uniform_int_distribution<int> edge(0, 1000);
+    std::uniform_real_distribution<double> jitter(-1e-7, 1e-7);
+
+    for (int trial = 0; trial < 50; ++trial) {
+        FrameStatistics statistics;
+        std::vector<double> values;
+        for (int i = 0; i < 257; ++i) {
+            auto value = edge(random) * binWidth;
+            if (i % 3 == 0) {
+                value = std::max(value + jitter(random), 0.0);
+            }
+            values.push_back(value);
+            statistics.record(Metric::cpuFrame, value);
+        }
+        std::sort(values.begin(), values.end());
+
+        const auto summary = statistics.summary(Metric::cpuFrame);
+        expectWithinBin(summary.p50_, exactPercentile(values, 0.50));
+        expectWithinBin(summary.p95_, exactPercentile(values, 0.95));
+        expectWithinBin(summary.p99_, exactPercentile(values, 0.99));
+
+        // 区間の上端で返しても、実際の最大値は超えない
+        EXPECT_LE(summary.p99_, summary.max_);
+        EXPECT_EQ(summary.max_, values.back());
+    }
+}
+
+TEST(FrameStatisticsTest, LongFramesAreClampedIntoLastBin) {
+    FrameStatistics statistics;
+
+    // ヒストグラムの範囲を超える時間は最後の区間に入り、その区間のパーセンタイルは最大値になる
+    for (int i = 0; i < 98; ++i) {
+        statistics.record(Metric::cpuFrame, 10.0);
+    }
+    statistics.record(Metric::cpuFrame, 250.0);
+    statistics.record(Metric::cpuFrame, 500.0);
+
+    auto summary = statistics.summary(Metric::cpuFrame);
+    expectWithinBin(summary.p95_, 10.0);
+    EXPECT_EQ(summary.p99_, 500.0);
+    EXPECT_EQ(summary.max_, 500.0);
+    EXPECT_DOUBLE_EQ(summary.average_, (98 * 10.0 + 250.0 + 500.0) / 100.0);
+
+    // 負の時間は 0 として記録する
+    statistics.reset();
+    statistics.record(Metric::fenceWait, -3.0);
+    summary = statistics.summary(Metric::fenceWait);
+    EXPECT_EQ(summary.count_, 1u);
+    EXPECT_EQ(summary.max_, 0.0);
+    EXPECT_EQ(summary.p50_, 0.0);
+}
+
+TEST(FrameStatisticsTest, ResetDiscardsEveryTrack) {
+    FrameStatistics statistics;
+    for (uint32_t i = 0; i < static_cast<uint32_t>(Metric::count); ++i) {
+        statistics.record(static_cast<Metric>(i), 5.0);
+        statistics.record(static_cast<Metric>(i), 40.0);
+    }
+    statistics.reset();
+
+    for (uint32_t i = 0; i < static_cast<uint32_t>(Metric::count); ++i) {
+        const auto summary = statistics.summary(static_cast<Metric>(i));
+        EXPECT_EQ(summary.count_, 0u);
+        EXPECT_EQ(summary.max_, 0.0);
+        EXPECT_EQ(summary.stutters_, 0u);
+    }
+
+    // 直近の平均も捨てるので、リセット後の最初の一回はスタッターにならない
+    statistics.record(Metric::cpuFrame, 40.0);
+    statistics.record(Metric::cpuFrame, 5.0);
+    EXPECT_EQ(statistics.summary(Metric::cpuFrame).stutters_, 0u);
+    EXPECT_EQ(statistics.summary(Metric::cpuFrame).max_, 40.0);
+}
+
+TEST(FrameStatisticsTest, CountsStuttersOnlyForFrameTimes) {
+    FrameStatistics statistics;
+
+    // 一定のフレームの中の、直近の平均の倍を超えるフレームだけをスタッターとする
+    for (int i = 0; i < 30; ++i) {
+        statistics.record(Metric::cpuFrame, 8.0);
+        statistics.record(Metric::presentInterval, 16.7);
+    }
+    statistics.record(Metric::cpuFrame, 15.0);
+    statistics.record(Metric::cpuFrame, 20.0);
+    statistics.record(Metric::presentInterval, 50.0);
+    EXPECT_EQ(statistics.summary(Metric::cpuFrame).stutters_, 1u);
+    EXPECT_EQ(statistics.summary(Metric::presentInterval).stutters_, 1u);
+
+    // GPU の完了待ちは 0 が続いた後の僅かな待ちや長い待ちでもスタッターとしない
+    for (int i = 0; i < 100; ++i) {
+        statistics.record(Metric::fenceWait, i % 10 == 0 ? 0.3 : 0.0);
+    }
+    statistics.record(Metric::fenceWait, 12.0);
+    EXPECT_EQ(statistics.summary(Metric::fenceWait).stutters_, 0u);
+    EXPECT_EQ(statistics.summary(Metric::fenceWait).max_, 12.0);
+}
+
+TEST(FrameStatisticsTest, AppendCsvWritesHeaderOnce) {
+    const auto path = std::filesystem::temp_directory_path() / "kadai_frame_statistics_test.csv";
+    std::filesystem::remove(path);
+
+    FrameStatistics statistics;
+    statistics.record(Metric::cpuFrame, 4.0);
+    ASSERT_TRUE(statistics.appendCsv(path, 1.0));
+    statistics.record(Metric::cpuFrame, 6.0);
+    ASSERT_TRUE(statistics.appendCsv(path, 2.0));
+
+    // 見出しは最初の一回だけで、集計毎に時間の種類の数だけ行が増える
+    const auto lines = readLines(path);
+    const auto metricCount = static_cast<size_t>(Metric::count);
+    ASSERT_EQ(lines.size(), 1 + metricCount * 2);
+    EXPECT_EQ(lines[0], "time,metric,count,average_ms,p50_ms,p95_ms,p99_ms,max_ms,stutters");
+    EXPECT_EQ(std::count(lines.begin(), lines.end(), lines[0]), 1);
+    EXPECT_EQ(lines[1].rfind("1,cpu_frame,1,4,", 0), 0u) << lines[1];
+    EXPECT_EQ(lines[1 + metricCount].rfind("2,cpu_frame,2,5,", 0), 0u) << lines[1 + metricCount];
+    for (size_t i = 1; i < lines.size(); ++i) {
+        EXPECT_EQ(std::count(lines[i].begin(), lines[i].end(), ','), 8) << lines[i];
+    }
+
+    // 空のファイルには見出しから書く
+    std::ofstream(path, std::ios::trunc).close();
+    ASSERT_TRUE(statistics.appendCsv(path, 3.0));
+    EXPECT_EQ(readLines(path).front(), lines[0]);
+
+    // 書き込めない場所は失敗を返す（デバッグビルドではアサートで止まる）
+#if defined(NDEBUG)
+    EXPECT_FALSE(statistics.appendCsv(std::filesystem::temp_directory_path() / "kadai_missing_directory" / "statistics.csv", 4.0));
+#endif
+    std::filesystem::remove(path);
+}
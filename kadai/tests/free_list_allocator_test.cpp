@@ -0,0 +1,160 @@
+// フリーリストアロケータクラスのテスト
+
+#include "free_list_allocator.h"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+TEST(FreeListAllocatorTest, AllocatesFirstFit) {
+    FreeListAllocator allocator;
+    allocator.initialize(1000);
+
+    EXPECT_EQ(allocator.allocate(100), 0u);
+    EXPECT_EQ(allocator.allocate(200), 100u);
+    EXPECT_EQ(allocator.allocate(300), 300u);
+    EXPECT_EQ(allocator.freeSize(), 400u);
+    EXPECT_EQ(allocator.largestFreeBlock(), 400u);
+    EXPECT_EQ(allocator.capacity(), 1000u);
+}
+
+TEST(FreeListAllocatorTest, AlignmentPaddingStaysFree) {
+    FreeListAllocator allocator;
+    allocator.initialize(1024);
+
+    EXPECT_EQ(allocator.allocate(10), 0u);
+    EXPECT_EQ(allocator.allocate(100, 64), 64u);
+
+    // アライメントで空いた [10, 64) は後の小さな確保で使われる
+    EXPECT_EQ(allocator.freeSize(), 1024u - 110u);
+    EXPECT_EQ(allocator.allocate(54), 10u);
+}
+
+TEST(FreeListAllocatorTest, FailsWhenFull) {
+    FreeListAllocator allocator;
+    allocator.initialize(256);
+
+    EXPECT_EQ(allocator.allocate(0), FreeListAllocator::invalidOffset);
+    EXPECT_EQ(allocator.allocate(257), FreeListAllocator::invalidOffset);
+    EXPECT_EQ(allocator.allocate(256), 0u);
+    EXPECT_EQ(allocator.allocate(1), FreeListAllocator::invalidOffset);
+    EXPECT_EQ(allocator.freeSize(), 0u);
+    EXPECT_EQ(allocator.largestFreeBlock(), 0u);
+
+    allocator.free(0, 256);
+    EXPECT_EQ(allocator.allocate(256), 0u);
+}
+
+TEST(FreeListAllocatorTest, EmptyAllocatorRejectsEverything) {
+    FreeListAllocator allocator;
+    allocator.initialize(0);
+
+    EXPECT_EQ(allocator.allocate(1), FreeListAllocator::invalidOffset);
+    EXPECT_EQ(allocator.largestFreeBlock(), 0u);
+}
+
+TEST(FreeListAllocatorTest, CoalescesWithPreviousAndNext) {
+    FreeListAllocator allocator;
+    allocator.initialize(400);
+
+    const auto a = allocator.allocate(100);
+    const auto b = allocator.allocate(100);
+    const auto c = allocator.allocate(100);
+    const auto d = allocator.allocate(100);
+    ASSERT_EQ(allocator.freeSize(), 0u);
+
+    // 前と結合
+    allocator.free(a, 100);
+    allocator.free(b, 100);
+    EXPECT_EQ(allocator.largestFreeBlock(), 200u);
+
+    // 後と結合
+    allocator.free(d, 100);
+    EXPECT_EQ(allocator.largestFreeBlock(), 200u);
+
+    // 前後の両方と結合して一つに戻る
+    allocator.free(c, 100);
+    EXPECT_EQ(allocator.largestFreeBlock(), 400u);
+    EXPECT_EQ(allocator.allocate(400), 0u);
+}
+
+TEST(FreeListAllocatorTest, FragmentationPreventsLargeAllocation) {
+    FreeListAllocator allocator;
+    allocator.initialize(1000);
+
+    std::vector<uint64_t> offsets;
+    for (int i = 0; i < 10; ++i) {
+        offsets.push_back(allocator.allocate(100));
+    }
+
+    // 一つ置きに解放すると合計は 500 空くが、連続した空きは 100 しかない
+    for (size_t i = 0; i < offsets.size(); i += 2) {
+        allocator.free(offsets[i], 100);
+    }
+    EXPECT_EQ(allocator.freeSize(), 500u);
+    EXPECT_EQ(allocator.largestFreeBlock(), 100u);
+    EXPECT_EQ(allocator.allocate(101), FreeListAllocator::invalidOffset);
+    EXPECT_EQ(allocator.allocate(100), 0u);
+
+    // 間を埋めていた範囲を解放すると結合されて大きな確保が通る
+    allocator.free(offsets[1], 100);
+    allocator.free(offsets[3], 100);
+    EXPECT_EQ(allocator.largestFreeBlock(), 400u);
+    EXPECT_EQ(allocator.allocate(400), 100u);
+}
+
+TEST(FreeListAllocatorTest, RandomAllocateFreeKeepsRangesDisjoint) {
+    constexpr uint64_t capacity = 1 << 20;
+    FreeListAllocator allocator;
+    allocator.initialize(capacity);
+
+    struct Range {
+        uint64_t offset_{};
+        uint64_t size_{};
+    };
+    std::vector<Range> live;
+    std::vector<uint8_t> owner(capacity / 16, 0);  // 16 バイト単位の使用状況
+
+    std::mt19937 random(2024);
+    std::uniform_int_distribution<uint64_t> sizeDistribution(1, 1024);
+    std::uniform_int_distribution<uint32_t> alignmentShift(4, 8);
+
+    uint64_t usedSize = 0;
+    for (int step = 0; step < 20000; ++step) {
+        if (live.empty() || random() % 3 != 0) {
+            // 16 バイト単位で扱えるように、サイズもアライメントも 16 の倍数にする
+            const auto size = sizeDistribution(random) * 16;
+            const auto alignment = uint64_t{ 1 } << alignmentShift(random);
+            const auto offset = allocator.allocate(size, alignment);
+            if (offset == FreeListAllocator::invalidOffset) {
+                continue;
+            }
+            ASSERT_EQ(offset % alignment, 0u);
+            ASSERT_LE(offset + size, capacity);
+            for (auto i = offset / 16; i < (offset + size) / 16; ++i) {
+                ASSERT_EQ(owner[i], 0) << "overlap at " << i * 16;
+                owner[i] = 1;
+            }
+            live.push_back({ offset, size });
+            usedSize += size;
+        } else {
+            const auto index = random() % live.size();
+            const auto range = live[index];
+            live[index] = live.back();
+            live.pop_back();
+            allocator.free(range.offset_, range.size_);
+            for (auto i = range.offset_ / 16; i < (range.offset_ + range.size_) / 16; ++i) {
+                owner[i] = 0;
+            }
+            usedSize -= range.size_;
+        }
+        ASSERT_EQ(allocator.freeSize(), capacity - usedSize);
+    }
+
+    // 全て解放すると一つの空き範囲に戻る
+    for (const auto& range : live) {
+        allocator.free(range.offset_, range.size_);
+    }
+    EXPECT_EQ(allocator.freeSize(), capacity);
+    EXPECT_EQ(allocator.largestFreeBlock(), capacity);
+}
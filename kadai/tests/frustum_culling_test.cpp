@@ -0,0 +1,301 @@
+// 視錐台カリングクラスのテスト
+// SSE・AVX2 の判定と端数を一つずつ判定する部分が、スカラーの判定と同じ位置の並びを返すことを確かめる
+
+#include "frustum_culling.h"
+#include "simd_paths.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numbers>
+#include <random>
+#include <vector>
+
+namespace {
+    constexpr float    nearZ = 1.0f;                    // 透視投影の近い面
+    constexpr float    farZ = 100.0f;                   // 透視投影の遠い面
+    constexpr float    boxExtent = 10.0f;               // 箱型の視錐台の x, y の範囲（±）
+    constexpr uint32_t untouched = 0xffffffffu;         // 書き込まれていない場所の目印
+    constexpr float    notANumber = std::numeric_limits<float>::quiet_NaN();  // 比較できない値
+    constexpr float    infinity = std::numeric_limits<float>::infinity();     // 無限大
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	成分毎に分かれた境界球の配列
+     */
+    struct Spheres {
+        std::vector<float> values_[7];  /// 中心 xyz、拡大率 xyz、半径の順
+
+        //---------------------------------------------------------------------------------
+        /**
+         * @brief	境界球を一つ追加する
+         * @param	x		中心の x
+         * @param	y		中心の y
+         * @param	z		中心の z
+         * @param	radius	拡大前の半径
+         * @param	scaleX	拡大率の x
+         * @param	scaleY	拡大率の y
+         * @param	scaleZ	拡大率の z
+         */
+        void add(float x, float y, float z, float radius, float scaleX = 1.0f, float scaleY = 1.0f, float scaleZ = 1.0f) {
+            const float values[7] = { x, y, z, scaleX, scaleY, scaleZ, radius };
+            for (size_t k = 0; k < 7; ++k) {
+                values_[k].push_back(values[k]);
+            }
+        }
+
+        //---------------------------------------------------------------------------------
+        /**
+         * @brief	判定に渡す境界球の配列を取得する
+         * @param	offset	先頭から飛ばす数（SIMD の読み込み位置をずらす）
+         * @return	境界球の配列
+         */
+        [[nodiscard]] FrustumCulling::Bounds bounds(size_t offset = 0) const {
+            return {
+                values_[0].data() + offset, values_[1].data() + offset, values_[2].data() + offset,
+                values_[3].data() + offset, values_[4].data() + offset, values_[5].data() + offset,
+                values_[6].data() + offset,
+            };
+        }
+
+        //---------------------------------------------------------------------------------
+        /**
+         * @brief	境界球の数を取得する
+         * @return	数
+         */
+        [[nodiscard]] size_t size() const {
+            return values_[0].size();
+        }
+    };
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	-10 <= x, y <= 10、1 <= z <= 100 の箱型の視錐台を作る
+     * 平面の係数が 0 と ±1 なので、距離は丸めなしで求まる
+     * @return	視錐台
+     */
+    [[nodiscard]] FrustumCulling::Frustum boxFrustum() {
+        return { {
+            { 1.0f, 0.0f, 0.0f, boxExtent },   // 左
+            { -1.0f, 0.0f, 0.0f, boxExtent },  // 右
+            { 0.0f, 1.0f, 0.0f, boxExtent },   // 下
+            { 0.0f, -1.0f, 0.0f, boxExtent },  // 上
+            { 0.0f, 0.0f, 1.0f, -nearZ },      // 近
+            { 0.0f, 0.0f, -1.0f, farZ },       // 遠
+        } };
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	左手座標系の透視投影行列を作る（XMMatrixPerspectiveFovLH と同じ形）
+     * @param	matrix	書き込み先
+     */
+    void perspective(float (&matrix)[4][4]) {
+        const auto yScale = 1.0f / std::tan(std::numbers::pi_v<float> / 6.0f);
+        const auto xScale = yScale / (16.0f / 9.0f);
+        const auto range = farZ / (farZ - nearZ);
+        const float values[4][4] = {
+            { xScale, 0.0f, 0.0f, 0.0f },
+            { 0.0f, yScale, 0.0f, 0.0f },
+            { 0.0f, 0.0f, range, 1.0f },
+            { 0.0f, 0.0f, -range * nearZ, 0.0f },
+        };
+        for (size_t r = 0; r < 4; ++r) {
+            for (size_t c = 0; c < 4; ++c) {
+                matrix[r][c] = values[r][c];
+            }
+        }
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	透視投影の視錐台の境界付近に、拡大率や半径がばらばらな境界球を乱数で並べる
+     * @param	count	境界球の数
+     * @param	seed	乱数の種
+     * @return	境界球の配列
+     */
+    [[nodiscard]] Spheres makeSpheres(size_t count, uint32_t seed) {
+        std::mt19937 random(seed);
+        std::uniform_real_distribution<float> lateral(-80.0f, 80.0f);
+        std::uniform_real_distribution<float> depth(-10.0f, 120.0f);
+        std::uniform_real_distribution<float> scale(-3.0f, 3.0f);
+        std::uniform_real_distribution<float> radius(0.0f, 5.0f);
+
+        Spheres spheres;
+        for (size_t i = 0; i < count; ++i) {
+            spheres.add(lateral(random), lateral(random), depth(random), radius(random), scale(random), scale(random), scale(random));
+        }
+        return spheres;
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	判定して見える位置の並びを取得する
+     * 書き込み先の後ろに目印を置き、count を超えて書き込んでいないことも確かめる
+     * @param	frustum	視錐台
+     * @param	bounds	境界球の配列
+     * @param	count	境界球の数
+     * @param	path	命令セット
+     * @return	見える位置の並び
+     */
+    [[nodiscard]] std::vector<uint32_t> cull(const FrustumCulling::Frustum& frustum, const FrustumCulling::Bounds& bounds, size_t count, TransformBatch::Path path) {
+        std::vector<uint32_t> visible(count + 8, untouched);
+        const auto visibleCount = FrustumCulling::cull(frustum, bounds, count, visible.data(), path);
+        for (size_t i = count; i < visible.size(); ++i) {
+            EXPECT_EQ(visible[i], untouched) << pathName(path) << " count " << count;
+        }
+        visible.resize(visibleCount);
+        return visible;
+    }
+}  // namespace
+
+TEST(FrustumCullingTest, ExtractsNormalizedInwardPlanes) {
+    float matrix[4][4];
+    perspective(matrix);
+    const auto frustum = FrustumCulling::extractFrustum(matrix);
+
+    for (const auto& plane : frustum.planes_) {
+        EXPECT_NEAR(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2], 1.0f, 1e-5f);
+    }
+
+    // 近い面は z = near、遠い面は z = far を内向きに見る
+    EXPECT_NEAR(frustum.planes_[4][2], 1.0f, 1e-5f);
+    EXPECT_NEAR(frustum.planes_[4][3], -nearZ, 1e-4f);
+    EXPECT_NEAR(frustum.planes_[5][2], -1.0f, 1e-5f);
+    EXPECT_NEAR(frustum.planes_[5][3], farZ, 1e-2f);
+
+    // 左右と上下の平面は原点（視点）を通る
+    for (size_t p = 0; p < 4; ++p) {
+        EXPECT_NEAR(frustum.planes_[p][3], 0.0f, 1e-6f) << "plane " << p;
+    }
+
+    Spheres spheres;
+    spheres.add(0.0f, 0.0f, 10.0f, 0.5f);     // 正面
+    spheres.add(0.0f, 0.0f, -5.0f, 0.5f);     // 後ろ
+    spheres.add(0.0f, 0.0f, 150.0f, 0.5f);    // 遠い面の外
+    spheres.add(100.0f, 0.0f, 10.0f, 0.5f);   // 右の外
+    spheres.add(0.0f, -100.0f, 10.0f, 0.5f);  // 下の外
+    spheres.add(0.0f, 0.0f, 0.5f, 1.0f);      // 近い面に掛かる
+    EXPECT_EQ(cull(frustum, spheres.bounds(), spheres.size(), TransformBatch::Path::scalar), (std::vector<uint32_t>{ 0, 5 }));
+}
+
+TEST(FrustumCullingTest, SimdPathsMatchScalarForEveryTailLength) {
+    float matrix[4][4];
+    perspective(matrix);
+    const auto frustum = FrustumCulling::extractFrustum(matrix);
+
+    // AVX2 の 8 個、SSE の 4 個、一つずつの端数の全ての組み合わせを通る数と、大きな数
+    std::vector<size_t> counts;
+    for (size_t count = 0; count <= 8 * 3 + 7; ++count) {
+        counts.push_back(count);
+    }
+    counts.push_back(1003);
+
+    for (const auto count : counts) {
+        const auto spheres = makeSpheres(count + 1, static_cast<uint32_t>(count) + 200);
+
+        // 読み込み位置が 16 バイト境界に揃っていない場合も含める
+        for (const size_t offset : { 0u, 1u }) {
+            const auto length = count + 1 - offset;
+            const auto expected = cull(frustum, spheres.bounds(offset), length, TransformBatch::Path::scalar);
+            for (const auto path : availablePaths()) {
+                EXPECT_EQ(cull(frustum, spheres.bounds(offset), length, path), expected) << pathName(path) << " count " << length << " offset " << offset;
+            }
+        }
+    }
+}
+
+TEST(FrustumCullingTest, SpheresStraddlingPlanesAreVisible) {
+    const auto frustum = boxFrustum();
+
+    // 全ての平面について、外側に半径ちょうどまで離れた球（接する）、僅かに内側・外側の球、中心が平面上の球を並べる
+    // 平面毎に 4 個なので、SIMD の一回の判定に接する球と外れる球が混ざる
+    Spheres spheres;
+    std::vector<uint32_t> expected;
+    const float radius = 2.0f;
+    const float outside = boxExtent + radius;
+    const float outsideNear = nearZ - radius;
+    const float outsideFar = farZ + radius;
+    const float centers[6][3] = {
+        { -outside, 0.0f, 50.0f },
+        { outside, 0.0f, 50.0f },
+        { 0.0f, -outside, 50.0f },
+        { 0.0f, outside, 50.0f },
+        { 0.0f, 0.0f, outsideNear },
+        { 0.0f, 0.0f, outsideFar },
+    };
+    for (size_t p = 0; p < 6; ++p) {
+        const auto normal = frustum.planes_[p];
+        for (const auto shift : { 0.0f, 0.25f, -0.25f, radius }) {
+            // 法線の向き（内側）に shift だけ動かす
+            const auto x = centers[p][0] + normal[0] * shift;
+            const auto y = centers[p][1] + normal[1] * shift;
+            const auto z = centers[p][2] + normal[2] * shift;
+            if (shift >= 0.0f) {
+                expected.push_back(static_cast<uint32_t>(spheres.size()));
+            }
+            spheres.add(x, y, z, radius);
+        }
+    }
+
+    // 8 個の角の外側で、どの平面にも半径ちょうどで接する球も見える
+    spheres.add(-outside, -outside, outsideNear, radius);
+    expected.push_back(static_cast<uint32_t>(spheres.size() - 1));
+    spheres.add(outside, outside, outsideFar + 0.5f, radius);
+
+    for (const auto path : availablePaths()) {
+        EXPECT_EQ(cull(frustum, spheres.bounds(), spheres.size(), path), expected) << pathName(path);
+    }
+}
+
+TEST(FrustumCullingTest, RadiusUsesLargestAbsoluteScale) {
+    const auto frustum = boxFrustum();
+
+    // 視錐台の左に 4 離れた半径 1 の球は、拡大率のいずれかの軸の絶対値が 4 以上なら掛かる
+    Spheres spheres;
+    const auto x = -boxExtent - 4.0f;
+    spheres.add(x, 0.0f, 50.0f, 1.0f, 4.0f, 1.0f, 1.0f);
+    spheres.add(x, 0.0f, 50.0f, 1.0f, 1.0f, -4.0f, 1.0f);
+    spheres.add(x, 0.0f, 50.0f, 1.0f, 0.5f, 0.5f, -5.0f);
+    spheres.add(x, 0.0f, 50.0f, 1.0f, 3.5f, -3.5f, 3.5f);
+    spheres.add(x, 0.0f, 50.0f, 1.0f, -3.0f, 1.0f, 2.0f);
+    spheres.add(x, 0.0f, 50.0f, 4.0f, 0.0f, 0.0f, 0.0f);
+    spheres.add(0.0f, 0.0f, 50.0f, 1.0f, 0.0f, 0.0f, 0.0f);
+    spheres.add(x, 0.0f, 50.0f, 2.0f, -2.0f, -2.0f, -2.0f);
+
+    const std::vector<uint32_t> expected = { 0, 1, 2, 6, 7 };
+    for (const auto path : availablePaths()) {
+        EXPECT_EQ(cull(frustum, spheres.bounds(), spheres.size(), path), expected) << pathName(path);
+    }
+}
+
+TEST(FrustumCullingTest, NonFiniteValuesAreHandledAlikeOnEveryPath) {
+    const auto frustum = boxFrustum();
+
+    // NaN や無限大を、中心・拡大率・半径のそれぞれに、SIMD の各レーンと端数の位置で入れる
+    Spheres spheres;
+    const float specials[] = { notANumber, infinity, -infinity };
+    for (const auto special : specials) {
+        for (size_t k = 0; k < 7; ++k) {
+            float values[7] = { 0.0f, 0.0f, 50.0f, 1.0f, 1.0f, 1.0f, 1.0f };
+            values[k] = special;
+            spheres.add(values[0], values[1], values[2], values[6], values[3], values[4], values[5]);
+            spheres.add(0.0f, 0.0f, 50.0f, 1.0f);
+        }
+    }
+
+    const auto expected = cull(frustum, spheres.bounds(), spheres.size(), TransformBatch::Path::scalar);
+    for (size_t i = 0; i < spheres.size(); i += 2) {
+        // 中心が NaN の球は見えないものとして扱う
+        if (std::isnan(spheres.values_[0][i]) || std::isnan(spheres.values_[1][i]) || std::isnan(spheres.values_[2][i])) {
+            EXPECT_EQ(std::count(expected.begin(), expected.end(), static_cast<uint32_t>(i)), 0) << "sphere " << i;
+        }
+    }
+    for (const auto path : availablePaths()) {
+        for (size_t count = 0; count <= spheres.size(); ++count) {
+            const auto reference = cull(frustum, spheres.bounds(), count, TransformBatch::Path::scalar);
+            ASSERT_EQ(cull(frustum, spheres.bounds(), count, path), reference) << pathName(path) << " count " << count;
+        }
+    }
+}
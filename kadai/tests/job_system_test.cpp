@@ -0,0 +1,236 @@
+// ジョブシステムクラスのテスト
+// 依存関係・継続・カウンターの再利用・盗み・終了を、ジョブの数を多くして繰り返し確かめる
+
+#include "job_system.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace {
+    constexpr uint32_t threadCount = 4;  // 呼び出し元のスレッドを含むスレッドの数
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	フラグが立つまで他のスレッドに譲りながら待つ
+     * @param	flag	待つフラグ
+     */
+    void spinUntil(const std::atomic<bool>& flag) {
+        while (!flag.load(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+    }
+}  // namespace
+
+TEST(JobSystemTest, DependencyChainsRunInOrder) {
+    JobSystem jobSystem;
+    ASSERT_TRUE(jobSystem.create(threadCount));
+
+    // 独立した鎖を並べて積み、前のジョブの実行中に次のジョブを登録する競合も起こす
+    constexpr size_t chainCount = 8;
+    constexpr size_t chainLength = 500;
+    std::vector<std::vector<size_t>> orders(chainCount);
+    std::vector<std::vector<JobSystem::Counter>> counters(chainCount);
+    for (auto& chain : counters) {
+        chain = std::vector<JobSystem::Counter>(chainLength);
+    }
+
+    for (size_t step = 0; step < chainLength; ++step) {
+        for (size_t chain = 0; chain < chainCount; ++chain) {
+            auto function = [&orders, chain, step] { orders[chain].push_back(step); };
+            if (step == 0) {
+                jobSystem.run(function, counters[chain][step]);
+            } else {
+                jobSystem.run(function, counters[chain][step], counters[chain][step - 1]);
+            }
+        }
+    }
+
+    // 最後のジョブが終われば、鎖の全てのジョブが順に終わっている
+    for (size_t chain = 0; chain < chainCount; ++chain) {
+        jobSystem.wait(counters[chain].back());
+        ASSERT_EQ(orders[chain].size(), chainLength) << "chain " << chain;
+        for (size_t step = 0; step < chainLength; ++step) {
+            ASSERT_EQ(orders[chain][step], step) << "chain " << chain;
+        }
+        for (auto& counter : counters[chain]) {
+            EXPECT_TRUE(counter.isDone());
+        }
+    }
+}
+
+TEST(JobSystemTest, ContinuationsFanOutAfterDependencyCompletes) {
+    JobSystem jobSystem;
+    ASSERT_TRUE(jobSystem.create(threadCount));
+
+    // 解放されるまで終わらないジョブを門にする（呼び出し元は待たないのでワーカーが実行する）
+    std::atomic<bool> released{};
+    JobSystem::Counter gate;
+    jobSystem.run([&released] { spinUntil(released); }, gate);
+
+    constexpr uint32_t fanOut = 256;
+    std::atomic<uint32_t> started{};
+    JobSystem::Counter branches;
+    for (uint32_t i = 0; i < fanOut; ++i) {
+        jobSystem.run([&started] { started.fetch_add(1, std::memory_order_relaxed); }, branches, gate);
+    }
+
+    // 全ての枝の完了を待つジョブは、枝が全て終わった後に一度だけ実行される
+    std::atomic<uint32_t> startedAtJoin{};
+    std::atomic<uint32_t> joins{};
+    JobSystem::Counter join;
+    jobSystem.run([&] {
+        startedAtJoin = started.load();
+        joins.fetch_add(1);
+    }, join, branches);
+
+    // 門が開くまではどの枝もキューに積まれない
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(started.load(), 0u);
+    EXPECT_FALSE(branches.isDone());
+    EXPECT_FALSE(join.isDone());
+
+    released.store(true, std::memory_order_release);
+    jobSystem.wait(join);
+    EXPECT_EQ(started.load(), fanOut);
+    EXPECT_EQ(startedAtJoin.load(), fanOut);
+    EXPECT_EQ(joins.load(), 1u);
+    EXPECT_TRUE(gate.isDone());
+    EXPECT_TRUE(branches.isDone());
+}
+
+TEST(JobSystemTest, CountersCanBeReusedAfterWait) {
+    JobSystem jobSystem;
+    ASSERT_TRUE(jobSystem.create(threadCount));
+
+    // 同じカウンターを、単独のジョブ・範囲の分割・依存先として何度も使い回す
+    JobSystem::Counter counter;
+    JobSystem::Counter dependent;
+    std::vector<uint32_t> items(1000);
+    for (uint32_t round = 1; round <= 300; ++round) {
+        std::atomic<uint32_t> singles{};
+        for (int i = 0; i < 10; ++i) {
+            jobSystem.run([&singles] { singles.fetch_add(1, std::memory_order_relaxed); }, counter);
+        }
+        jobSystem.parallelFor(items.size(), 16, [&items, round](size_t begin, size_t end) {
+            for (auto i = begin; i < end; ++i) {
+                items[i] = round;
+            }
+        }, counter);
+
+        std::atomic<uint32_t> observed{};
+        jobSystem.run([&] { observed = singles.load(); }, dependent, counter);
+        jobSystem.wait(dependent);
+
+        // 前の周回で完了したカウンターに、前の周回の継続や数が残っていない
+        ASSERT_TRUE(counter.isDone()) << "round " << round;
+        ASSERT_EQ(observed.load(), 10u) << "round " << round;
+        ASSERT_TRUE(std::all_of(items.begin(), items.end(), [round](uint32_t item) { return item == round; })) << "round " << round;
+    }
+}
+
+TEST(JobSystemTest, IdleWorkersStealFromBusyQueue) {
+    JobSystem jobSystem;
+    ASSERT_TRUE(jobSystem.create(threadCount));
+
+    // 呼び出し元は wait を呼ばずに完了を待つので、0 番のキューのジョブは盗まれなければ終わらない
+    constexpr size_t jobCount = 2000;
+    const auto mainThread = std::this_thread::get_id();
+    std::vector<std::atomic<uint32_t>> executions(jobCount);
+    std::atomic<uint32_t> onMainThread{};
+    JobSystem::Counter counter;
+    for (size_t i = 0; i < jobCount; ++i) {
+        jobSystem.run([&, i] {
+            executions[i].fetch_add(1, std::memory_order_relaxed);
+            if (std::this_thread::get_id() == mainThread) {
+                onMainThread.fetch_add(1, std::memory_order_relaxed);
+            }
+        }, counter);
+    }
+    while (!counter.isDone()) {
+        std::this_thread::yield();
+    }
+
+    EXPECT_EQ(onMainThread.load(), 0u);
+    for (size_t i = 0; i < jobCount; ++i) {
+        ASSERT_EQ(executions[i].load(), 1u) << "job " << i;
+    }
+}
+
+TEST(JobSystemTest, EveryJobRunsOnceUnderStealContention) {
+    JobSystem jobSystem;
+    ASSERT_TRUE(jobSystem.create(threadCount));
+
+    // 各スレッドが自分のキューに積みながら取り出し、同時に他のスレッドから盗まれる
+    constexpr size_t parentCount = 64;
+    constexpr size_t childCount = 64;
+    std::vector<std::atomic<uint32_t>> executions(parentCount * childCount);
+    std::vector<JobSystem::Counter> children(parentCount);
+    JobSystem::Counter parents;
+    for (size_t parent = 0; parent < parentCount; ++parent) {
+        jobSystem.run([&, parent] {
+            for (size_t child = 0; child < childCount; ++child) {
+                const auto index = parent * childCount + child;
+                jobSystem.run([&executions, index] { executions[index].fetch_add(1, std::memory_order_relaxed); }, children[parent]);
+            }
+
+            // ジョブの中で待つ間も他のジョブを実行するので、スレッドの数より多く入れ子にしても止まらない
+            jobSystem.wait(children[parent]);
+        }, parents);
+    }
+    jobSystem.wait(parents);
+
+    for (size_t i = 0; i < executions.size(); ++i) {
+        ASSERT_EQ(executions[i].load(), 1u) << "job " << i;
+    }
+
+    // 範囲の分割も、盗まれた範囲を含めて全ての位置をちょうど一度ずつ処理する
+    std::vector<std::atomic<uint32_t>> items(100'003);
+    JobSystem::Counter counter;
+    jobSystem.parallelFor(items.size(), 1, [&items](size_t begin, size_t end) {
+        for (auto i = begin; i < end; ++i) {
+            items[i].fetch_add(1, std::memory_order_relaxed);
+        }
+    }, counter);
+    jobSystem.wait(counter);
+    for (size_t i = 0; i < items.size(); ++i) {
+        ASSERT_EQ(items[i].load(), 1u) << "item " << i;
+    }
+}
+
+TEST(JobSystemTest, ShutsDownWithIdleWorkers) {
+    // ジョブを一度も積まずに破棄する
+    for (int i = 0; i < 50; ++i) {
+        JobSystem jobSystem;
+        ASSERT_TRUE(jobSystem.create(8));
+    }
+
+    // ジョブを終えて眠った直後や眠る途中のワーカーを、繰り返し終了させる
+    for (int i = 0; i < 200; ++i) {
+        JobSystem jobSystem;
+        ASSERT_TRUE(jobSystem.create(threadCount));
+        std::atomic<uint32_t> count{};
+        JobSystem::Counter counter;
+        jobSystem.parallelFor(64, 1, [&count](size_t begin, size_t end) {
+            count.fetch_add(static_cast<uint32_t>(end - begin), std::memory_order_relaxed);
+        }, counter);
+        jobSystem.wait(counter);
+        ASSERT_EQ(count.load(), 64u);
+        if (i % 50 == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    }
+
+    // 作成し直したジョブシステムでも、呼び出し元が 0 番のスレッドとして働く
+    JobSystem jobSystem;
+    ASSERT_TRUE(jobSystem.create(1));
+    EXPECT_EQ(jobSystem.threadCount(), 1u);
+    bool executed = false;
+    JobSystem::Counter counter;
+    jobSystem.run([&executed] { executed = true; }, counter);
+    jobSystem.wait(counter);
+    EXPECT_TRUE(executed);
+}
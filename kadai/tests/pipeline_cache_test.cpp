@@ -0,0 +1,224 @@
+// パイプラインキャッシュファイルクラスとパイプラインハッシュクラスのテスト
+
+#include "pipeline_cache_file.h"
+#include "pipeline_hasher.h"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+    constexpr uint64_t adapterIdentity = 0x0123456789abcdefull;  // アダプタとドライバから作る値の代わり
+    constexpr uint64_t otherIdentity = 0xfedcba9876543210ull;    // ドライバを更新した後の値の代わり
+    constexpr size_t   versionOffset = 4;                        // ヘッダ内のバージョンの位置
+    constexpr size_t   footerSize = 8;                           // フッタ（チェックサム）のサイズ
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	文字列をブロブとして登録する
+     * @param	file	登録先
+     * @param	key		キー
+     * @param	text	ブロブの中身
+     */
+    void storeText(PipelineCacheFile& file, uint64_t key, const std::string& text) {
+        file.store(key, text.data(), text.size());
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	登録されているブロブを文字列として取り出す
+     * @param	file	取り出し元
+     * @param	key		キー
+     * @return	ブロブの中身、無い場合は空文字列
+     */
+    [[nodiscard]] std::string findText(const PipelineCacheFile& file, uint64_t key) {
+        const auto* blob = file.find(key);
+        return blob ? std::string(blob->begin(), blob->end()) : std::string{};
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	エントリを二つ持つファイルの内容を作る
+     * @param	identity	アダプタとドライバの識別値
+     * @return	シリアライズしたバイト列
+     */
+    [[nodiscard]] std::vector<uint8_t> makeSerialized(uint64_t identity) {
+        PipelineCacheFile file;
+        file.reset(identity);
+        storeText(file, 2, "pixel");
+        storeText(file, 1, "vertex");
+        std::vector<uint8_t> data;
+        file.serialize(data);
+        return data;
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	フッタのチェックサムを計算し直す
+     * 中身を書き換えた上でチェックサムだけは正しいファイルを作るのに使う
+     * @param	data	書き換えるバイト列
+     */
+    void rewriteChecksum(std::vector<uint8_t>& data) {
+        const auto bodySize = data.size() - footerSize;
+        const auto checksum = PipelineHasher::hashBytes(data.data(), bodySize);
+        std::memcpy(data.data() + bodySize, &checksum, sizeof(checksum));
+    }
+}  // namespace
+
+TEST(PipelineHasherTest, MatchesFnv1aReferenceValues) {
+    // キーは実行を跨いで使うので、アルゴリズムが変わっていないことを既知の値で確かめる
+    EXPECT_EQ(PipelineHasher::hashBytes(nullptr, 0), PipelineHasher::offsetBasis);
+    EXPECT_EQ(PipelineHasher::hashBytes("a", 1), 0xaf63dc4c8601ec8cull);
+    EXPECT_EQ(PipelineHasher::hashBytes("foobar", 6), 0x85944171f73967e8ull);
+}
+
+TEST(PipelineHasherTest, IncrementalMatchesOneShot) {
+    PipelineHasher hasher;
+    hasher.addBytes("foo", 3);
+    hasher.addBytes("bar", 3);
+    EXPECT_EQ(hasher.value(), PipelineHasher::hashBytes("foobar", 6));
+
+    const uint32_t value = 0x11223344;
+    PipelineHasher valueHasher;
+    valueHasher.add(value);
+    EXPECT_EQ(valueHasher.value(), PipelineHasher::hashBytes(&value, sizeof(value)));
+}
+
+TEST(PipelineHasherTest, StringsKeepTheirBoundaries) {
+    PipelineHasher first;
+    first.addString("ab");
+    first.addString("c");
+    PipelineHasher second;
+    second.addString("a");
+    second.addString("bc");
+    EXPECT_NE(first.value(), second.value());
+
+    PipelineHasher null;
+    null.addString(nullptr);
+    PipelineHasher empty;
+    empty.addString("");
+    EXPECT_NE(null.value(), empty.value());
+}
+
+TEST(PipelineCacheFileTest, SerializeIsStableRegardlessOfInsertionOrder) {
+    PipelineCacheFile file;
+    file.reset(adapterIdentity);
+    storeText(file, 1, "vertex");
+    storeText(file, 2, "pixel");
+    std::vector<uint8_t> data;
+    file.serialize(data);
+
+    // 同じ内容なら登録順に関わらず同じバイト列になる
+    EXPECT_EQ(data, makeSerialized(adapterIdentity));
+}
+
+TEST(PipelineCacheFileTest, RoundTripsEntries) {
+    const auto data = makeSerialized(adapterIdentity);
+
+    PipelineCacheFile file;
+    ASSERT_TRUE(file.deserialize(data.data(), data.size(), adapterIdentity));
+    EXPECT_EQ(file.entryCount(), 2u);
+    EXPECT_EQ(findText(file, 1), "vertex");
+    EXPECT_EQ(findText(file, 2), "pixel");
+    EXPECT_EQ(file.find(3), nullptr);
+    EXPECT_FALSE(file.dirty());
+}
+
+TEST(PipelineCacheFileTest, RejectsTruncatedData) {
+    const auto data = makeSerialized(adapterIdentity);
+
+    // どこで切れていても読み込まず、空のキャッシュになる
+    for (size_t size = 0; size < data.size(); ++size) {
+        PipelineCacheFile file;
+        EXPECT_FALSE(file.deserialize(data.data(), size, adapterIdentity)) << "size " << size;
+        EXPECT_EQ(file.entryCount(), 0u);
+    }
+    PipelineCacheFile file;
+    EXPECT_FALSE(file.deserialize(nullptr, data.size(), adapterIdentity));
+}
+
+TEST(PipelineCacheFileTest, RejectsCorruptedBytes) {
+    const auto data = makeSerialized(adapterIdentity);
+
+    // 一バイトでも壊れていればチェックサムで弾く
+    for (size_t i = 0; i < data.size(); ++i) {
+        auto corrupted = data;
+        corrupted[i] ^= 0x5a;
+        PipelineCacheFile file;
+        EXPECT_FALSE(file.deserialize(corrupted.data(), corrupted.size(), adapterIdentity)) << "byte " << i;
+        EXPECT_EQ(file.entryCount(), 0u);
+    }
+}
+
+TEST(PipelineCacheFileTest, RejectsInconsistentEntrySizes) {
+    // チェックサムは正しいが、エントリのサイズが範囲外を指しているファイル
+    auto data = makeSerialized(adapterIdentity);
+    const auto blobSizeOffset = size_t{ 24 + 8 };  // ヘッダの直後、最初のエントリのキーの後ろ
+    const uint64_t hugeSize = ~uint64_t{ 0 };
+    std::memcpy(data.data() + blobSizeOffset, &hugeSize, sizeof(hugeSize));
+    rewriteChecksum(data);
+
+    PipelineCacheFile file;
+    EXPECT_FALSE(file.deserialize(data.data(), data.size(), adapterIdentity));
+    EXPECT_EQ(file.entryCount(), 0u);
+}
+
+TEST(PipelineCacheFileTest, DriverChangeFallsBackToRecompile) {
+    const auto data = makeSerialized(adapterIdentity);
+
+    // ドライバが変わったファイルは使わず、全てのパイプラインがキャッシュミス（再コンパイル）になる
+    PipelineCacheFile file;
+    EXPECT_FALSE(file.deserialize(data.data(), data.size(), otherIdentity));
+    EXPECT_EQ(file.entryCount(), 0u);
+    EXPECT_EQ(file.find(1), nullptr);
+
+    // 再コンパイルしたブロブは新しい識別値で保存され、次回からはヒットする
+    storeText(file, 1, "recompiled");
+    std::vector<uint8_t> rewritten;
+    file.serialize(rewritten);
+    PipelineCacheFile reloaded;
+    ASSERT_TRUE(reloaded.deserialize(rewritten.data(), rewritten.size(), otherIdentity));
+    EXPECT_EQ(findText(reloaded, 1), "recompiled");
+    EXPECT_FALSE(reloaded.deserialize(rewritten.data(), rewritten.size(), adapterIdentity));
+}
+
+TEST(PipelineCacheFileTest, FormatVersionChangeFallsBackToRecompile) {
+    auto data = makeSerialized(adapterIdentity);
+    const auto nextVersion = PipelineCacheFile::version + 1;
+    std::memcpy(data.data() + versionOffset, &nextVersion, sizeof(nextVersion));
+    rewriteChecksum(data);
+
+    PipelineCacheFile file;
+    EXPECT_FALSE(file.deserialize(data.data(), data.size(), adapterIdentity));
+    EXPECT_EQ(file.entryCount(), 0u);
+}
+
+TEST(PipelineCacheFileTest, SavesAndLoadsFile) {
+    const auto path = std::filesystem::temp_directory_path() / "kadai_pipeline_cache_test.bin";
+    std::filesystem::remove(path);
+
+    // 初回起動時はファイルが無い
+    PipelineCacheFile file;
+    EXPECT_FALSE(file.load(path, adapterIdentity));
+    EXPECT_EQ(file.entryCount(), 0u);
+
+    storeText(file, 7, "blob");
+    EXPECT_TRUE(file.dirty());
+    ASSERT_TRUE(file.save(path));
+    EXPECT_FALSE(file.dirty());
+    EXPECT_FALSE(std::filesystem::exists(path.string() + ".tmp"));
+
+    PipelineCacheFile loaded;
+    ASSERT_TRUE(loaded.load(path, adapterIdentity));
+    EXPECT_EQ(findText(loaded, 7), "blob");
+
+    // 途中で切れたファイルは読み込まない
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+    EXPECT_FALSE(loaded.load(path, adapterIdentity));
+    EXPECT_EQ(loaded.entryCount(), 0u);
+
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,499 @@
+// プロファイラクラスのテスト
+// プロファイラはプロセスで一つなので、他のテストの区間が混ざっても良いようにトラックは固有の名前で探す
+
+#include "profiler.h"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	JSON の値
+     * オブジェクトはキーの並びと値の並びを同じ順に持つ
+     */
+    struct JsonValue {
+        enum class Type {
+            null,
+            boolean,
+            number,
+            string,
+            array,
+            object,
+        };
+
+        Type                     type_{};     /// 値の種類
+        bool                     boolean_{};  /// 真偽値
+        double                   number_{};   /// 数値
+        std::string              string_{};   /// 文字列
+        std::vector<std::string> keys_{};     /// オブジェクトのキー
+        std::vector<JsonValue>   values_{};   /// 配列の要素、またはオブジェクトの値
+
+        //---------------------------------------------------------------------------------
+        /**
+         * @brief	オブジェクトのメンバーを探す
+         * @param	key		キー
+         * @return	値（無い場合は nullptr）
+         */
+        [[nodiscard]] const JsonValue* find(const std::string& key) const {
+            for (size_t i = 0; i < keys_.size(); ++i) {
+                if (keys_[i] == key) {
+                    return &values_[i];
+                }
+            }
+            return nullptr;
+        }
+    };
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	JSON の構文解析クラス
+     * 書き出したトレースを確かめるためのもので、規格に沿わない入力は失敗にする
+     */
+    class JsonParser final {
+    public:
+        //---------------------------------------------------------------------------------
+        /**
+         * @brief	文字列全体を一つの値として解析する
+         * @param	text	JSON の文字列
+         * @param	value	解析した値
+         * @return	解析の成否（値の後に空白以外が残っている場合も失敗）
+         */
+        [[nodiscard]] static bool parse(const std::string& text, JsonValue& value) {
+            JsonParser parser(text);
+            if (!parser.parseValue(value)) {
+                return false;
+            }
+            parser.skipSpaces();
+            return parser.position_ == text.size();
+        }
+
+    private:
+        //---------------------------------------------------------------------------------
+        /**
+         * @brief    コンストラクタ
+         * @param	text	JSON の文字列
+         */
+        explicit JsonParser(const std::string& text)
+            : text_(text) {
+        }
+
+        //---------------------------------------------------------------------------------
+        /**
+         * @brief	空白を読み飛ばす
+         */
+        void skipSpaces() {
+            while (position_ < text_.size() && (text_[position_] == ' ' || text_[position_] == '\t' || text_[position_] == '\n' || text_[position_] == '\r')) {
+                ++position_;
+            }
+        }
+
+        //---------------------------------------------------------------------------------
+        /**
+         * @brief	空白を読み飛ばしてから、次の文字が期待した文字なら読み進める
+         * @param	c	期待する文字
+         * @return	読み進めたか
+         */
+        [[nodiscard]] bool consume(char c) {
+            skipSpaces();
+            if (position_ < text_.size() && text_[position_] == c) {
+                ++position_;
+                return true;
+            }
+            return false;
+        }
+
+        //---------------------------------------------------------------------------------
+        /**
+         * @brief	決まった綴りの語（true / false / null）を読む
+         * @param	word	語
+         * @return	読めたか
+         */
+        [[nodiscard]] bool consumeWord(const char* word) {
+            const std::string expected(word);
+            if (text_.compare(position_, expected.size(), expected) != 0) {
+                return false;
+            }
+            position_ += expected.size();
+            return true;
+        }
+
+        //---------------------------------------------------------------------------------
+        /**
+         * @brief	値を読む
+         * @param	value	読んだ値
+         * @return	解析の成否
+         */
+        [[nodiscard]] bool parseValue(JsonValue& value) {
+            skipSpaces();
+            if (position_ >= text_.size()) {
+                return false;
+            }
+            switch (text_[position_]) {
+            case '{':
+                return parseObject(value);
+            case '[':
+                return parseArray(value);
+            case '"':
+                value.type_ = JsonValue::Type::string;
+                return parseString(value.string_);
+            case 't':
+                value.type_ = JsonValue::Type::boolean;
+                value.boolean_ = true;
+                return consumeWord("true");
+            case 'f':
+                value.type_ = JsonValue::Type::boolean;
+                return consumeWord("false");
+            case 'n':
+                value.type_ = JsonValue::Type::null;
+                return consumeWord("null");
+            default:
+                return parseNumber(value);
+            }
+        }
+
+        //---------------------------------------------------------------------------------
+        /**
+         * @brief	オブジェクトを読む
+         * @param	value	読んだ値
+         * @return	解析の成否
+         */
+        [[nodiscard]] bool parseObject(JsonValue& value) {
+            value.type_ = JsonValue::Type::object;
+            ++position_;
+            if (consume('}')) {
+                return true;
+            }
+            do {
+                skipSpaces();
+                std::string key;
+                JsonValue member;
+                if (!parseString(key) || !consume(':') || !parseValue(member)) {
+                    return false;
+                }
+                value.keys_.push_back(std::move(key));
+                value.values_.push_back(std::move(member));
+            } while (consume(','));
+            return consume('}');
+        }
+
+        //---------------------------------------------------------------------------------
+        /**
+         * @brief	配列を読む
+         * @param	value	読んだ値
+         * @return	解析の成否
+         */
+        [[nodiscard]] bool parseArray(JsonValue& value) {
+            value.type_ = JsonValue::Type::array;
+            ++position_;
+            if (consume(']')) {
+                return true;
+            }
+            do {
+                JsonValue element;
+                if (!parseValue(element)) {
+                    return false;
+                }
+                value.values_.push_back(std::move(element));
+            } while (consume(','));
+            return consume(']');
+        }
+
+        //---------------------------------------------------------------------------------
+        /**
+         * @brief	文字列を読む
+         * エスケープされていない制御文字は規格に沿わないので失敗にする
+         * @param	text	読んだ文字列（u エスケープは UTF-8 に直す）
+         * @return	解析の成否
+         */
+        [[nodiscard]] bool parseString(std::string& text) {
+            if (position_ >= text_.size() || text_[position_] != '"') {
+                return false;
+            }
+            ++position_;
+            while (position_ < text_.size()) {
+                const auto c = text_[position_++];
+                if (c == '"') {
+                    return true;
+                }
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    return false;
+                }
+                if (c != '\\') {
+                    text += c;
+                    continue;
+                }
+                if (position_ >= text_.size()) {
+                    return false;
+                }
+                switch (text_[position_++]) {
+                case '"':  text += '"';  break;
+                case '\\': text += '\\'; break;
+                case '/':  text += '/';  break;
+                case 'b':  text += '\b'; break;
+                case 'f':  text += '\f'; break;
+                case 'n':  text += '\n'; break;
+                case 'r':  text += '\r'; break;
+                case 't':  text += '\t'; break;
+                case 'u': {
+                    if (position_ + 4 > text_.size()) {
+                        return false;
+                    }
+                    const auto digits = text_.substr(position_, 4);
+                    char* end = nullptr;
+                    const auto code = std::strtoul(digits.c_str(), &end, 16);
+                    if (end != digits.c_str() + 4) {
+                        return false;
+                    }
+                    position_ += 4;
+                    if (code < 0x80) {
+                        text += static_cast<char>(code);
+                    } else if (code < 0x800) {
+                        text += static_cast<char>(0xc0 | (code >> 6));
+                        text += static_cast<char>(0x80 | (code & 0x3f));
+                    } else {
+                        text += static_cast<char>(0xe0 | (code >> 12));
+                        text += static_cast<char>(0x80 | ((code >> 6) & 0x3f));
+                        text += static_cast<char>(0x80 | (code & 0x3f));
+                    }
+                    break;
+                }
+                default:
+                    return false;
+                }
+            }
+            return false;
+        }
+
+        //---------------------------------------------------------------------------------
+        /**
+         * @brief	数値を読む
+         * @param	value	読んだ値
+         * @return	解析の成否
+         */
+        [[nodiscard]] bool parseNumber(JsonValue& value) {
+            const auto* begin = text_.c_str() + position_;
+            char* end = nullptr;
+            value.type_ = JsonValue::Type::number;
+            value.number_ = std::strtod(begin, &end);
+            if (end == begin) {
+                return false;
+            }
+            position_ += static_cast<size_t>(end - begin);
+            return true;
+        }
+
+    private:
+        const std::string& text_;        /// 解析する文字列
+        size_t             position_{};  /// 次に読む位置
+    };
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	トレースを書き出して読み直す
+     * @param	fileName	一時ディレクトリに作るファイルの名前
+     * @param	text		書き出した文字列
+     * @param	trace		解析したトレース
+     */
+    void exportTrace(const char* fileName, std::string& text, JsonValue& trace) {
+        const auto path = std::filesystem::temp_directory_path() / fileName;
+        ASSERT_TRUE(Profiler::instance().exportChromeTrace(path));
+        std::ostringstream stream;
+        stream << std::ifstream(path).rdbuf();
+        text = stream.str();
+        std::filesystem::remove(path);
+
+        ASSERT_TRUE(JsonParser::parse(text, trace));
+        ASSERT_EQ(trace.type_, JsonValue::Type::object);
+        const auto* events = trace.find("traceEvents");
+        ASSERT_NE(events, nullptr);
+        ASSERT_EQ(events->type_, JsonValue::Type::array);
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	名前を付けたトラックのスレッド番号を探す
+     * @param	trace	トレース
+     * @param	name	トラックの名前
+     * @return	見つかったトラックのスレッド番号の並び（名前が固有なら一つ）
+     */
+    [[nodiscard]] std::vector<double> findTracks(const JsonValue& trace, const std::string& name) {
+        std::vector<double> ids;
+        for (const auto& event : trace.find("traceEvents")->values_) {
+            const auto* phase = event.find("ph");
+            const auto* args = event.find("args");
+            if (phase && phase->string_ == "M" && args && args->find("name") && args->find("name")->string_ == name) {
+                ids.push_back(event.find("tid")->number_);
+            }
+        }
+        return ids;
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	トラックに記録された区間を書き出された順に集める
+     * @param	trace	トレース
+     * @param	id		トラックのスレッド番号
+     * @return	区間の並び
+     */
+    [[nodiscard]] std::vector<const JsonValue*> trackEvents(const JsonValue& trace, double id) {
+        std::vector<const JsonValue*> events;
+        for (const auto& event : trace.find("traceEvents")->values_) {
+            const auto* phase = event.find("ph");
+            if (phase && phase->string_ == "X" && event.find("tid")->number_ == id) {
+                events.push_back(&event);
+            }
+        }
+        return events;
+    }
+}  // namespace
+
+TEST(ProfilerTest, RingBufferKeepsNewestEvents) {
+    // 一周と少し記録すると、最初の 100 個が上書きされて残りの eventCapacity 個だけが書き出される
+    constexpr uint64_t overflow = 100;
+    constexpr uint64_t recordCount = Profiler::eventCapacity + overflow;
+    std::thread([] {
+        auto& profiler = Profiler::instance();
+        profiler.setThreadName("ProfilerTest Ring");
+        const auto base = Profiler::now();
+        for (uint64_t i = 0; i < recordCount; ++i) {
+            // 何番目の区間かを長さ（ナノ秒）で表す
+            profiler.record("Ring", base + i * 1000, base + i * 1000 + i);
+        }
+    }).join();
+
+    std::string text;
+    JsonValue trace;
+    ASSERT_NO_FATAL_FAILURE(exportTrace("kadai_profiler_ring_test.json", text, trace));
+    const auto ids = findTracks(trace, "ProfilerTest Ring");
+    ASSERT_EQ(ids.size(), 1u);
+
+    const auto events = trackEvents(trace, ids[0]);
+    ASSERT_EQ(events.size(), Profiler::eventCapacity);
+    for (size_t i = 0; i < events.size(); ++i) {
+        const auto index = overflow + i;
+        ASSERT_DOUBLE_EQ(events[i]->find("dur")->number_, static_cast<double>(index) / 1000.0) << "event " << i;
+        if (i != 0) {
+            ASSERT_NEAR(events[i]->find("ts")->number_ - events[i - 1]->find("ts")->number_, 1.0, 1e-6) << "event " << i;
+        }
+    }
+}
+
+TEST(ProfilerTest, EachThreadGetsItsOwnTrack) {
+    // スレッド毎に別のトラックが作られ、区間は記録したスレッドのトラックにだけ入る
+    constexpr const char* threadNames[] = {
+        "ProfilerTest Worker 0",
+        "ProfilerTest Worker 1",
+        "ProfilerTest Worker 2",
+        "ProfilerTest Worker 3",
+    };
+    std::vector<std::thread> threads;
+    for (const auto* name : threadNames) {
+        threads.emplace_back([name] {
+            auto& profiler = Profiler::instance();
+            profiler.setThreadName(name);
+            for (int i = 0; i < 3; ++i) {
+                ProfileScope scope("ProfilerTest Work");
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // GPU の区間は呼び出したスレッドではなく GPU のトラックに入る
+    const auto now = Profiler::now();
+    Profiler::instance().recordGpu("ProfilerTest Gpu", now, now + 1000);
+
+    std::string text;
+    JsonValue trace;
+    ASSERT_NO_FATAL_FAILURE(exportTrace("kadai_profiler_tracks_test.json", text, trace));
+
+    std::vector<double> ids;
+    for (const auto* name : threadNames) {
+        const auto found = findTracks(trace, name);
+        ASSERT_EQ(found.size(), 1u) << name;
+        for (const auto id : ids) {
+            EXPECT_NE(found[0], id) << name;
+        }
+        ids.push_back(found[0]);
+
+        const auto events = trackEvents(trace, found[0]);
+        ASSERT_EQ(events.size(), 3u) << name;
+        for (const auto* event : events) {
+            EXPECT_EQ(event->find("name")->string_, "ProfilerTest Work");
+            EXPECT_EQ(event->find("pid")->number_, 1.0);
+        }
+    }
+
+    const auto gpu = findTracks(trace, "GPU");
+    ASSERT_EQ(gpu.size(), 1u);
+    size_t gpuEvents = 0;
+    for (const auto& event : trace.find("traceEvents")->values_) {
+        if (event.find("name")->string_ == "ProfilerTest Gpu") {
+            EXPECT_EQ(event.find("tid")->number_, gpu[0]);
+            ++gpuEvents;
+        }
+    }
+    EXPECT_EQ(gpuEvents, 1u);
+}
+
+TEST(ProfilerTest, TimesAreWrittenInMicroseconds) {
+    // ナノ秒で記録した時刻は、小数点以下三桁までのマイクロ秒で書き出される
+    std::thread([] {
+        auto& profiler = Profiler::instance();
+        profiler.setThreadName("ProfilerTest Units");
+        const auto base = Profiler::now();
+        profiler.record("Short", base, base + 2'500);
+        profiler.record("Later", base + 10'000'000, base + 11'000'001);
+    }).join();
+
+    std::string text;
+    JsonValue trace;
+    ASSERT_NO_FATAL_FAILURE(exportTrace("kadai_profiler_units_test.json", text, trace));
+    EXPECT_EQ(trace.find("displayTimeUnit")->string_, "ms");
+    const auto ids = findTracks(trace, "ProfilerTest Units");
+    ASSERT_EQ(ids.size(), 1u);
+
+    const auto events = trackEvents(trace, ids[0]);
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_EQ(events[0]->find("name")->string_, "Short");
+    EXPECT_DOUBLE_EQ(events[0]->find("dur")->number_, 2.5);
+    EXPECT_GE(events[0]->find("ts")->number_, 0.0);
+    EXPECT_EQ(events[1]->find("name")->string_, "Later");
+    EXPECT_DOUBLE_EQ(events[1]->find("dur")->number_, 1000.001);
+    EXPECT_NEAR(events[1]->find("ts")->number_ - events[0]->find("ts")->number_, 10'000.0, 1e-6);
+}
+
+TEST(ProfilerTest, NamesAreEscaped) {
+    // 引用符・バックスラッシュ・制御文字を含む名前も、JSON として読み直すと元の名前に戻る
+    static constexpr const char eventName[] = "Quote\" Backslash\\ Newline\n Tab\t Control\x01 Escape\x1b End";
+    std::thread([] {
+        auto& profiler = Profiler::instance();
+        profiler.setThreadName("ProfilerTest \"Escape\\Track\"\n");
+        const auto now = Profiler::now();
+        profiler.record(eventName, now, now + 1000);
+    }).join();
+
+    std::string text;
+    JsonValue trace;
+    ASSERT_NO_FATAL_FAILURE(exportTrace("kadai_profiler_escape_test.json", text, trace));
+    const auto ids = findTracks(trace, "ProfilerTest \"Escape\\Track\"\n");
+    ASSERT_EQ(ids.size(), 1u);
+
+    const auto events = trackEvents(trace, ids[0]);
+    ASSERT_EQ(events.size(), 1u);
+    EXPECT_EQ(events[0]->find("name")->string_, eventName);
+
+    // ファイルには改行以外の制御文字がそのまま書かれない
+    for (const auto c : text) {
+        EXPECT_TRUE(c == '\n' || static_cast<unsigned char>(c) >= 0x20) << "control character " << static_cast<int>(c);
+    }
+    EXPECT_NE(text.find("Control\\u0001 Escape\\u001b End"), std::string::npos);
+}
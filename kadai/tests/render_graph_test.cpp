@@ -0,0 +1,296 @@
+// レンダーグラフクラスのテスト
+
+#include "render_graph.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <vector>
+
+namespace {
+    // D3D12_RESOURCE_STATES と同じ値
+    constexpr RenderGraph::ResourceState common = 0x0;
+    constexpr RenderGraph::ResourceState vertexAndConstantBuffer = 0x1;
+    constexpr RenderGraph::ResourceState renderTarget = 0x4;
+    constexpr RenderGraph::ResourceState unorderedAccess = 0x8;
+    constexpr RenderGraph::ResourceState depthWrite = 0x10;
+    constexpr RenderGraph::ResourceState nonPixelShaderResource = 0x40;
+    constexpr RenderGraph::ResourceState pixelShaderResource = 0x80;
+    constexpr RenderGraph::ResourceState copySource = 0x800;
+    constexpr RenderGraph::ResourceState present = 0x0;
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	コンパイル済みのパスの実行順を取得する
+     * @param	graph	コンパイル済みのグラフ
+     * @return	実行順に並べたパスの識別子
+     */
+    [[nodiscard]] std::vector<RenderGraph::PassHandle> executionOrder(const RenderGraph& graph) {
+        std::vector<RenderGraph::PassHandle> order;
+        for (const auto& compiled : graph.compiledPasses()) {
+            order.push_back(compiled.pass_);
+        }
+        return order;
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	実行順の中での位置を取得する
+     * @param	order	実行順
+     * @param	pass	パスの識別子
+     * @return	位置
+     */
+    [[nodiscard]] size_t positionOf(const std::vector<RenderGraph::PassHandle>& order, RenderGraph::PassHandle pass) {
+        return static_cast<size_t>(std::find(order.begin(), order.end(), pass) - order.begin());
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	コンパイル済みのパスを探す
+     * @param	graph	コンパイル済みのグラフ
+     * @param	pass	パスの識別子
+     * @return	コンパイル済みのパス
+     */
+    [[nodiscard]] const RenderGraph::CompiledPass& compiledPass(const RenderGraph& graph, RenderGraph::PassHandle pass) {
+        const auto& passes = graph.compiledPasses();
+        return *std::find_if(passes.begin(), passes.end(), [pass](const RenderGraph::CompiledPass& compiled) { return compiled.pass_ == pass; });
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	バリアの並びに指定した遷移が含まれているか調べる
+     * @param	barriers	バリアの並び
+     * @param	expected	探す遷移
+     * @return	含まれていれば true
+     */
+    [[nodiscard]] bool containsBarrier(const std::vector<RenderGraph::Barrier>& barriers, const RenderGraph::Barrier& expected) {
+        return std::any_of(barriers.begin(), barriers.end(), [&expected](const RenderGraph::Barrier& barrier) {
+            return barrier.resource_ == expected.resource_ && barrier.before_ == expected.before_ && barrier.after_ == expected.after_;
+        });
+    }
+}  // namespace
+
+TEST(RenderGraphTest, CullsPassesWhoseOutputIsNeverUsed) {
+    RenderGraph graph;
+    const auto backBuffer = graph.importResource(present, present);
+    const auto unused = graph.createResource(common);
+    const auto intermediate = graph.createResource(common);
+
+    const auto deadEnd = graph.addPass({});
+    graph.write(deadEnd, unused, unorderedAccess);
+
+    // 削除されるパスだけが読むリソースを書くパスも削除される
+    const auto feedsDeadEnd = graph.addPass({});
+    graph.write(feedsDeadEnd, intermediate, renderTarget);
+    const auto readsIntermediate = graph.addPass({});
+    graph.read(readsIntermediate, intermediate, pixelShaderResource);
+    graph.write(readsIntermediate, unused, renderTarget);
+
+    const auto draw = graph.addPass({});
+    graph.write(draw, backBuffer, renderTarget);
+
+    graph.compile();
+    EXPECT_EQ(executionOrder(graph), std::vector<RenderGraph::PassHandle>{ draw });
+}
+
+TEST(RenderGraphTest, KeepsProducersOfImportedResourcesAndSideEffects) {
+    RenderGraph graph;
+    const auto backBuffer = graph.importResource(present, present);
+    const auto shadowMap = graph.createResource(common);
+    const auto scratch = graph.createResource(common);
+
+    const auto shadow = graph.addPass({});
+    graph.write(shadow, shadowMap, depthWrite);
+    const auto readback = graph.addPass({}, true);
+    graph.write(readback, scratch, unorderedAccess);
+    const auto lighting = graph.addPass({});
+    graph.read(lighting, shadowMap, pixelShaderResource);
+    graph.write(lighting, backBuffer, renderTarget);
+
+    graph.compile();
+    const auto order = executionOrder(graph);
+    ASSERT_EQ(order.size(), 3u);
+    EXPECT_LT(positionOf(order, shadow), positionOf(order, lighting));
+    EXPECT_NE(positionOf(order, readback), order.size());
+}
+
+TEST(RenderGraphTest, OverwrittenResultIsCulled) {
+    RenderGraph graph;
+    const auto backBuffer = graph.importResource(present, present);
+
+    // 後のパスが読まずに上書きするので、最初の書き込みは不要
+    const auto first = graph.addPass({});
+    graph.write(first, backBuffer, renderTarget);
+    const auto second = graph.addPass({});
+    graph.write(second, backBuffer, renderTarget);
+
+    graph.compile();
+    EXPECT_EQ(executionOrder(graph), std::vector<RenderGraph::PassHandle>{ second });
+}
+
+TEST(RenderGraphTest, OrderRespectsReadAfterWriteAndWriteAfterRead) {
+    RenderGraph graph;
+    const auto backBuffer = graph.importResource(present, present);
+    const auto buffer = graph.importResource(common, common);
+
+    const auto produce = graph.addPass({});
+    graph.write(produce, buffer, unorderedAccess);
+    const auto consume = graph.addPass({});
+    graph.read(consume, buffer, nonPixelShaderResource);
+    graph.write(consume, backBuffer, renderTarget);
+    const auto overwrite = graph.addPass({});
+    graph.write(overwrite, buffer, unorderedAccess);
+
+    graph.compile();
+    const auto order = executionOrder(graph);
+    ASSERT_EQ(order.size(), 3u);
+    EXPECT_LT(positionOf(order, produce), positionOf(order, consume));
+    EXPECT_LT(positionOf(order, consume), positionOf(order, overwrite));
+}
+
+TEST(RenderGraphTest, InterleavesIndependentChains) {
+    RenderGraph graph;
+    const auto outputA = graph.importResource(common, common);
+    const auto outputB = graph.importResource(common, common);
+    const auto a = graph.createResource(common);
+    const auto b = graph.createResource(common);
+
+    const auto writeA = graph.addPass({});
+    graph.write(writeA, a, unorderedAccess);
+    const auto readA = graph.addPass({});
+    graph.read(readA, a, nonPixelShaderResource);
+    graph.write(readA, outputA, unorderedAccess);
+    const auto writeB = graph.addPass({});
+    graph.write(writeB, b, unorderedAccess);
+    const auto readB = graph.addPass({});
+    graph.read(readB, b, nonPixelShaderResource);
+    graph.write(readB, outputB, unorderedAccess);
+
+    // 依存するパス同士の間に別の鎖のパスが入る
+    graph.compile();
+    EXPECT_EQ(executionOrder(graph), (std::vector<RenderGraph::PassHandle>{ writeA, writeB, readA, readB }));
+}
+
+TEST(RenderGraphTest, EmitsTransitionsOnlyWhenStateChanges) {
+    RenderGraph graph;
+    const auto backBuffer = graph.importResource(present, present);
+    const auto color = graph.createResource(renderTarget);
+
+    const auto draw = graph.addPass({});
+    graph.write(draw, color, renderTarget);
+    const auto post = graph.addPass({});
+    graph.read(post, color, pixelShaderResource);
+    graph.write(post, backBuffer, renderTarget);
+
+    graph.compile();
+    ASSERT_EQ(graph.compiledPasses().size(), 2u);
+
+    // color は最初から RENDER_TARGET なので描画前のバリアは要らない
+    EXPECT_TRUE(compiledPass(graph, draw).barriers_.empty());
+
+    const auto& postBarriers = compiledPass(graph, post).barriers_;
+    ASSERT_EQ(postBarriers.size(), 2u);
+    EXPECT_TRUE(containsBarrier(postBarriers, { color, renderTarget, pixelShaderResource }));
+    EXPECT_TRUE(containsBarrier(postBarriers, { backBuffer, present, renderTarget }));
+
+    ASSERT_EQ(graph.finalBarriers().size(), 1u);
+    EXPECT_TRUE(containsBarrier(graph.finalBarriers(), { backBuffer, renderTarget, present }));
+}
+
+TEST(RenderGraphTest, MergesConsecutiveReadsIntoOneBarrier) {
+    RenderGraph graph;
+    const auto outputA = graph.importResource(common, common);
+    const auto outputB = graph.importResource(common, common);
+    const auto texture = graph.createResource(common);
+
+    const auto produce = graph.addPass({});
+    graph.write(produce, texture, unorderedAccess);
+    const auto readInPixelShader = graph.addPass({});
+    graph.read(readInPixelShader, texture, pixelShaderResource);
+    graph.write(readInPixelShader, outputA, unorderedAccess);
+    const auto readInComputeShader = graph.addPass({});
+    graph.read(readInComputeShader, texture, nonPixelShaderResource);
+    graph.read(readInComputeShader, texture, copySource);
+    graph.write(readInComputeShader, outputB, unorderedAccess);
+
+    graph.compile();
+    const auto order = executionOrder(graph);
+    ASSERT_EQ(order.size(), 3u);
+
+    // 最初の読み込みで後続の読み込みステートをまとめて遷移し、読み込み同士の間にはバリアを入れない
+    const auto readState = pixelShaderResource | nonPixelShaderResource | copySource;
+    const auto& firstRead = graph.compiledPasses()[1];
+    const auto& secondRead = graph.compiledPasses()[2];
+    const auto isTexture = [texture](const RenderGraph::Barrier& barrier) { return barrier.resource_ == texture; };
+
+    ASSERT_EQ(std::count_if(firstRead.barriers_.begin(), firstRead.barriers_.end(), isTexture), 1);
+    const auto merged = *std::find_if(firstRead.barriers_.begin(), firstRead.barriers_.end(), isTexture);
+    EXPECT_EQ(merged.before_, unorderedAccess);
+    EXPECT_EQ(merged.after_, readState);
+    EXPECT_EQ(std::count_if(secondRead.barriers_.begin(), secondRead.barriers_.end(), isTexture), 0);
+}
+
+TEST(RenderGraphTest, WriteAfterReadsStartsNewReadGroup) {
+    RenderGraph graph;
+    const auto outputA = graph.importResource(common, common);
+    const auto outputB = graph.importResource(common, common);
+    const auto buffer = graph.importResource(vertexAndConstantBuffer, vertexAndConstantBuffer);
+
+    const auto readFirst = graph.addPass({});
+    graph.read(readFirst, buffer, vertexAndConstantBuffer);
+    graph.write(readFirst, outputA, unorderedAccess);
+    const auto update = graph.addPass({});
+    graph.write(update, buffer, unorderedAccess);
+    const auto readSecond = graph.addPass({});
+    graph.read(readSecond, buffer, nonPixelShaderResource);
+    graph.write(readSecond, outputB, unorderedAccess);
+
+    graph.compile();
+    EXPECT_EQ(executionOrder(graph), (std::vector<RenderGraph::PassHandle>{ readFirst, update, readSecond }));
+
+    // 最初の読み込みは初期ステートのまま使えるので、バリアは書き込みとその後の読み込みの前だけ
+    const auto isBuffer = [buffer](const RenderGraph::Barrier& barrier) { return barrier.resource_ == buffer; };
+    const auto countFor = [&](RenderGraph::PassHandle pass) {
+        const auto& barriers = compiledPass(graph, pass).barriers_;
+        return std::count_if(barriers.begin(), barriers.end(), isBuffer);
+    };
+    EXPECT_EQ(countFor(readFirst), 0);
+    EXPECT_EQ(countFor(update), 1);
+    EXPECT_EQ(countFor(readSecond), 1);
+
+    // 出力先も含めて、外部リソースは全て元のステートへ戻す
+    EXPECT_EQ(graph.finalBarriers().size(), 3u);
+    EXPECT_TRUE(containsBarrier(graph.finalBarriers(), { buffer, nonPixelShaderResource, vertexAndConstantBuffer }));
+    EXPECT_TRUE(containsBarrier(graph.finalBarriers(), { outputA, unorderedAccess, common }));
+}
+
+TEST(RenderGraphTest, ResetClearsCompiledState) {
+    RenderGraph graph;
+    const auto backBuffer = graph.importResource(present, present);
+    const auto draw = graph.addPass({});
+    graph.write(draw, backBuffer, renderTarget);
+    graph.compile();
+    ASSERT_FALSE(graph.compiledPasses().empty());
+
+    graph.reset();
+    EXPECT_TRUE(graph.compiledPasses().empty());
+    EXPECT_TRUE(graph.finalBarriers().empty());
+}
+
+TEST(RenderGraphTest, ExecuteRunsPassCallbackInCompiledOrder) {
+    RenderGraph graph;
+    const auto backBuffer = graph.importResource(present, present);
+    const auto color = graph.createResource(common);
+
+    std::vector<int> executed;
+    const auto post = graph.addPass([&executed] { executed.push_back(1); });
+    const auto draw = graph.addPass([&executed] { executed.push_back(0); });
+    graph.read(post, color, pixelShaderResource);
+    graph.write(post, backBuffer, renderTarget);
+    graph.write(draw, color, renderTarget);
+
+    // 宣言順では post が先だが、draw の書き込みより前なので post は初期内容を読むだけで draw は削除される
+    graph.compile();
+    for (const auto& compiled : graph.compiledPasses()) {
+        graph.execute(compiled.pass_);
+    }
+    EXPECT_EQ(executed, std::vector<int>{ 1 });
+}
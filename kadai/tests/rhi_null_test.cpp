@@ -0,0 +1,315 @@
+// ヌルデバイスクラスのテスト
+
+#include "rhi_null.h"
+#include "scene_pass.h"
+#include <gtest/gtest.h>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace {
+    constexpr uint32_t width = 64;         // バックバッファの幅
+    constexpr uint32_t height = 64;        // バックバッファの高さ
+    constexpr uint32_t bufferCount = 2;    // バックバッファの数
+    constexpr uint32_t latency = 2;        // GPU が遅れるシグナルの数
+    constexpr uint64_t bufferSize = 4096;  // テストで使うバッファのサイズ
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	シーン描画パスの記録に必要なバッファ一式
+     */
+    struct SceneBuffers {
+        std::unique_ptr<RhiBuffer> camera_{};     /// カメラの定数バッファ
+        std::unique_ptr<RhiBuffer> instances_{};  /// インスタンスデータ
+        std::unique_ptr<RhiBuffer> vertices_{};   /// 頂点バッファ
+        std::unique_ptr<RhiBuffer> indices_{};    /// インデックスバッファ
+    };
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	シーン描画パスの記録に必要なバッファを作成する
+     * @param	device	作成するデバイス
+     * @return	作成したバッファ
+     */
+    [[nodiscard]] SceneBuffers createSceneBuffers(RhiNullDevice& device) {
+        SceneBuffers buffers;
+        buffers.camera_ = device.createBuffer(RhiHeapType::upload, 256);
+        buffers.instances_ = device.createBuffer(RhiHeapType::upload, bufferSize);
+        buffers.vertices_ = device.createBuffer(RhiHeapType::gpu, bufferSize);
+        buffers.indices_ = device.createBuffer(RhiHeapType::gpu, bufferSize);
+        return buffers;
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	全ての描画で共通の設定を作る
+     * @param	target	描画先
+     * @param	buffers	使うバッファ
+     * @return	共通の設定
+     */
+    [[nodiscard]] ScenePass::Frame makeFrame(RhiTexture& target, const SceneBuffers& buffers) {
+        ScenePass::Frame frame;
+        frame.renderTarget_ = &target;
+        frame.viewport_ = { 0.0f, 0.0f, static_cast<float>(width), static_cast<float>(height) };
+        frame.scissor_ = { 0, 0, static_cast<int32_t>(width), static_cast<int32_t>(height) };
+        frame.camera_ = buffers.camera_->gpuAddress();
+        frame.instances_ = buffers.instances_->gpuAddress();
+        frame.vertexBuffer_ = { buffers.vertices_->gpuAddress(), static_cast<uint32_t>(bufferSize), 28 };
+        frame.indexBuffer_ = { buffers.indices_->gpuAddress(), static_cast<uint32_t>(bufferSize), 2 };
+        return frame;
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	一つのコマンドリストを提出してシグナルする
+     * @param	device		提出するデバイス
+     * @param	commandList	記録を終えたコマンドリスト
+     * @param	fence		シグナルするフェンス
+     * @param	value		シグナルする値
+     */
+    void submit(RhiNullDevice& device, RhiCommandList& commandList, RhiFence& fence, uint64_t value) {
+        RhiCommandList* const lists[] = { &commandList };
+        auto& queue = device.queue(RhiQueueType::graphics);
+        queue.execute(lists);
+        queue.signal(fence, value);
+    }
+}  // namespace
+
+TEST(RhiNullDeviceTest, ScenePassRecordsBindingsOncePerList) {
+    RhiNullDevice device;
+    ASSERT_TRUE(device.create(width, height, bufferCount, latency));
+    auto buffers = createSceneBuffers(device);
+    auto fence = device.createFence();
+    auto commandList = device.createCommandList(RhiQueueType::graphics);
+
+    const RhiNullPipeline opaque(1);
+    const RhiNullPipeline alphaTest(2);
+    const std::array draws = {
+        ScenePass::Draw{ &opaque, 36, 0, 0, 0, 10 },
+        ScenePass::Draw{ &opaque, 6, 36, 24, 10, 5 },
+        ScenePass::Draw{ &alphaTest, 3, 42, 28, 15, 1 },
+    };
+
+    commandList->reset();
+    ScenePass::record(*commandList, makeFrame(device.swapChain().backBuffer(0), buffers), draws);
+    commandList->close();
+    submit(device, *commandList, *fence, 1);
+
+    const auto statistics = device.statistics();
+    EXPECT_EQ(statistics.drawCount_, 3u);
+    EXPECT_EQ(statistics.instanceCount_, 16u);
+    EXPECT_EQ(statistics.indexCount_, 36u * 10 + 6u * 5 + 3u);
+    EXPECT_EQ(statistics.pipelineChangeCount_, 2u);  // 同じパイプラインが続く間は切り替えない
+    // 描画先・カメラ・インスタンス・頂点・インデックスが一度ずつと、描画毎のルート定数
+    EXPECT_EQ(statistics.bindingCount_, 5u + draws.size());
+    EXPECT_EQ(statistics.errorCount_, 0u) << device.lastError();
+}
+
+TEST(RhiNullDeviceTest, EmptyScenePassRecordsNothing) {
+    RhiNullDevice device;
+    ASSERT_TRUE(device.create(width, height, bufferCount, latency));
+    auto buffers = createSceneBuffers(device);
+    auto fence = device.createFence();
+    auto commandList = device.createCommandList(RhiQueueType::graphics);
+
+    commandList->reset();
+    ScenePass::record(*commandList, makeFrame(device.swapChain().backBuffer(0), buffers), {});
+    commandList->close();
+    submit(device, *commandList, *fence, 1);
+
+    const auto statistics = device.statistics();
+    EXPECT_EQ(statistics.bindingCount_, 0u);
+    EXPECT_EQ(statistics.commandListCount_, 1u);
+    EXPECT_EQ(statistics.errorCount_, 0u);
+}
+
+TEST(RhiNullDeviceTest, FrameLoopWithLatencyHasNoErrors) {
+    RhiNullDevice device;
+    ASSERT_TRUE(device.create(width, height, bufferCount, latency));
+    auto buffers = createSceneBuffers(device);
+    auto fence = device.createFence();
+    std::array<std::unique_ptr<RhiCommandList>, bufferCount> commandLists;
+    for (auto& commandList : commandLists) {
+        commandList = device.createCommandList(RhiQueueType::graphics);
+    }
+
+    const RhiNullPipeline pipeline(1);
+    const std::array draws = { ScenePass::Draw{ &pipeline, 3, 0, 0, 0, 1 } };
+    const float clearColor[4] = { 0.2f, 0.2f, 0.2f, 1.0f };
+    constexpr uint64_t frameCount = 10;
+    for (uint64_t frame = 1; frame <= frameCount; ++frame) {
+        // バックバッファの数だけ前のフレームの完了を待ってからコマンドリストを使い回す
+        if (frame > bufferCount) {
+            fence->wait(frame - bufferCount);
+        }
+
+        auto& swapChain = device.swapChain();
+        auto& backBuffer = swapChain.backBuffer(swapChain.currentIndex());
+        auto& commandList = *commandLists[frame % bufferCount];
+        commandList.reset();
+        commandList.barrier(backBuffer, RhiState::present, RhiState::renderTarget);
+        commandList.clearRenderTarget(backBuffer, clearColor);
+        ScenePass::record(commandList, makeFrame(backBuffer, buffers), draws);
+        commandList.barrier(backBuffer, RhiState::renderTarget, RhiState::present);
+        commandList.close();
+        submit(device, commandList, *fence, frame);
+        swapChain.present(1);
+
+        // GPU はシグナル latency 回分だけ遅れている
+        EXPECT_EQ(fence->completedValue(), frame > latency ? frame - latency : 0);
+    }
+
+    const auto statistics = device.statistics();
+    EXPECT_EQ(statistics.errorCount_, 0u) << device.lastError();
+    EXPECT_EQ(statistics.lifetimeErrorCount_, 0u);
+    EXPECT_EQ(statistics.presentCount_, frameCount);
+    EXPECT_EQ(statistics.barrierCount_, 2 * frameCount);
+    EXPECT_EQ(statistics.drawCount_, frameCount);
+    EXPECT_EQ(device.swapChain().currentIndex(), frameCount % bufferCount);
+
+    device.flush();
+    EXPECT_EQ(fence->completedValue(), frameCount);
+}
+
+TEST(RhiNullDeviceTest, DetectsBarrierStateMismatch) {
+    RhiNullDevice device;
+    ASSERT_TRUE(device.create(width, height, bufferCount, 0));
+    auto fence = device.createFence();
+    auto commandList = device.createCommandList(RhiQueueType::graphics);
+    auto& backBuffer = device.swapChain().backBuffer(0);
+
+    // バックバッファは表示のステートから始まるので、コピー元からの遷移は食い違う
+    commandList->reset();
+    commandList->barrier(backBuffer, RhiState::copySource, RhiState::renderTarget);
+    commandList->close();
+    submit(device, *commandList, *fence, 1);
+    EXPECT_EQ(device.statistics().errorCount_, 1u);
+
+    // 食い違っても遷移後のステートは適用されるので、表示の前に戻し忘れると検出する
+    device.swapChain().present(0);
+    EXPECT_EQ(device.statistics().errorCount_, 2u);
+}
+
+TEST(RhiNullDeviceTest, DetectsDestroyingResourcesInUse) {
+    RhiNullDevice device;
+    ASSERT_TRUE(device.create(width, height, bufferCount, latency));
+    auto buffers = createSceneBuffers(device);
+    auto fence = device.createFence();
+    auto commandList = device.createCommandList(RhiQueueType::graphics);
+    const RhiNullPipeline pipeline(1);
+    const std::array draws = { ScenePass::Draw{ &pipeline, 3, 0, 0, 0, 1 } };
+
+    commandList->reset();
+    ScenePass::record(*commandList, makeFrame(device.swapChain().backBuffer(0), buffers), draws);
+    commandList->close();
+    submit(device, *commandList, *fence, 1);
+    ASSERT_EQ(fence->completedValue(), 0u);
+
+    // フェンスが到達する前に破棄すると検出する
+    buffers.instances_.reset();
+    EXPECT_EQ(device.statistics().lifetimeErrorCount_, 1u);
+
+    // 到達を待ってから破棄すれば問題ない
+    fence->wait(1);
+    EXPECT_EQ(fence->completedValue(), 1u);
+    buffers.camera_.reset();
+    EXPECT_EQ(device.statistics().lifetimeErrorCount_, 1u);
+    EXPECT_EQ(device.statistics().fenceWaitCount_, 1u);
+}
+
+TEST(RhiNullDeviceTest, DetectsReferencesToDestroyedBuffers) {
+    RhiNullDevice device;
+    ASSERT_TRUE(device.create(width, height, bufferCount, 0));
+    auto buffers = createSceneBuffers(device);
+    auto fence = device.createFence();
+    auto commandList = device.createCommandList(RhiQueueType::graphics);
+    const auto frame = makeFrame(device.swapChain().backBuffer(0), buffers);
+
+    // GPU アドレスは再利用されないので、破棄したバッファを指すアドレスは提出時に分かる
+    buffers.instances_.reset();
+    const RhiNullPipeline pipeline(1);
+    const std::array draws = { ScenePass::Draw{ &pipeline, 3, 0, 0, 0, 1 } };
+    commandList->reset();
+    ScenePass::record(*commandList, frame, draws);
+    commandList->close();
+    submit(device, *commandList, *fence, 1);
+
+    EXPECT_EQ(device.statistics().errorCount_, 1u);
+    EXPECT_EQ(device.resolve(frame.instances_, 1), nullptr);
+}
+
+TEST(RhiNullDeviceTest, DetectsCommandsOutsideRecordingAndIncompleteDraws) {
+    RhiNullDevice device;
+    ASSERT_TRUE(device.create(width, height, bufferCount, 0));
+    auto fence = device.createFence();
+    auto commandList = device.createCommandList(RhiQueueType::graphics);
+
+    // 作成直後は記録を終えた状態
+    commandList->setViewport({});
+    commandList->reset();
+    commandList->drawIndexedInstanced(3, 1, 0, 0, 0);  // パイプラインもバッファも未設定
+    commandList->close();
+    submit(device, *commandList, *fence, 1);
+
+    const auto statistics = device.statistics();
+    EXPECT_EQ(statistics.errorCount_, 2u);
+    EXPECT_EQ(statistics.drawCount_, 0u);
+
+    // 記録中のコマンドリストの提出も検出する
+    commandList->reset();
+    submit(device, *commandList, *fence, 2);
+    EXPECT_EQ(device.statistics().errorCount_, 3u);
+
+    // 記録中のままのリセットも次の提出で報告する
+    commandList->reset();
+    commandList->close();
+    submit(device, *commandList, *fence, 3);
+    EXPECT_EQ(device.statistics().errorCount_, 4u);
+}
+
+TEST(RhiNullDeviceTest, DetectsWaitsForUnsignaledValues) {
+    RhiNullDevice device;
+    ASSERT_TRUE(device.create(width, height, bufferCount, latency));
+    auto fence = device.createFence();
+    auto& queue = device.queue(RhiQueueType::copy);
+
+    queue.signal(*fence, 1);
+    queue.wait(*fence, 1);  // シグナル済みなら GPU 側で待てる
+    EXPECT_EQ(device.statistics().errorCount_, 0u);
+
+    queue.wait(*fence, 2);  // シグナルされていない値を待つと GPU が止まる
+    EXPECT_EQ(device.statistics().errorCount_, 1u);
+
+    fence->wait(2);  // CPU でも同じ
+    EXPECT_EQ(device.statistics().errorCount_, 2u);
+    EXPECT_EQ(fence->completedValue(), 1u);
+}
+
+TEST(RhiNullDeviceTest, ResolvesAddressesWithinBuffers) {
+    RhiNullDevice device;
+    ASSERT_TRUE(device.create(width, height, bufferCount, 0));
+    auto first = device.createBuffer(RhiHeapType::upload, 100);
+    auto second = device.createBuffer(RhiHeapType::upload, 100);
+
+    // GPU アドレスは重ならず、アライメントされている
+    EXPECT_EQ(first->gpuAddress() % RhiNullDevice::addressAlignment, 0u);
+    EXPECT_GE(second->gpuAddress(), first->gpuAddress() + first->size());
+
+    auto* data = static_cast<uint8_t*>(first->map());
+    ASSERT_NE(data, nullptr);
+    data[10] = 42;
+    first->unmap();
+
+    const auto* resolved = device.resolve(first->gpuAddress() + 10, 90);
+    ASSERT_NE(resolved, nullptr);
+    EXPECT_EQ(*resolved, 42);
+    EXPECT_EQ(device.resolve(first->gpuAddress() + 10, 91), nullptr);
+    EXPECT_EQ(device.resolve(first->gpuAddress() + 100, 1), nullptr);
+    EXPECT_EQ(device.resolve(RhiNullDevice::baseAddress - 1, 1), nullptr);
+
+    EXPECT_EQ(device.liveResourceCount(), 2u + bufferCount);
+    first.reset();
+    second.reset();
+    EXPECT_EQ(device.liveResourceCount(), size_t{ bufferCount });
+}
@@ -0,0 +1,200 @@
+// リングアロケータクラスのテスト
+
+#include "ring_allocator.h"
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <deque>
+#include <random>
+#include <vector>
+
+namespace {
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	確保した領域
+     */
+    struct Range {
+        uint64_t begin_{};       /// 先頭のオフセット
+        uint64_t end_{};         /// 終端のオフセット
+        uint64_t fenceValue_{};  /// 区切ったフレームのフェンス値（区切る前は 0）
+    };
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	二つの領域が重なっているか調べる
+     * @param	a	領域
+     * @param	b	領域
+     * @return	重なっていれば true
+     */
+    [[nodiscard]] bool overlaps(const Range& a, const Range& b) noexcept {
+        return a.begin_ < b.end_ && b.begin_ < a.end_;
+    }
+}  // namespace
+
+TEST(RingAllocatorTest, AllocatesSequentiallyWithAlignment) {
+    RingAllocator allocator;
+    allocator.initialize(1024);
+
+    EXPECT_EQ(allocator.allocate(10, 1), 0u);
+    EXPECT_EQ(allocator.allocate(16, 256), 256u);
+    EXPECT_EQ(allocator.allocate(1, 4), 272u);
+    EXPECT_EQ(allocator.usedSize(), 273u);
+}
+
+TEST(RingAllocatorTest, RejectsZeroAndOversizedRequests) {
+    RingAllocator allocator;
+    allocator.initialize(1024);
+
+    EXPECT_EQ(allocator.allocate(0, 1), RingAllocator::invalidOffset);
+    EXPECT_EQ(allocator.allocate(1025, 1), RingAllocator::invalidOffset);
+    EXPECT_EQ(allocator.usedSize(), 0u);
+}
+
+TEST(RingAllocatorTest, FailsWhenFullUntilReleased) {
+    RingAllocator allocator;
+    allocator.initialize(1024);
+
+    EXPECT_EQ(allocator.allocate(1024, 1), 0u);
+    EXPECT_EQ(allocator.allocate(1, 1), RingAllocator::invalidOffset);
+    allocator.finishFrame(1);
+    EXPECT_EQ(allocator.oldestFenceValue(), 1u);
+
+    allocator.release(0);
+    EXPECT_EQ(allocator.allocate(1, 1), RingAllocator::invalidOffset);
+
+    allocator.release(1);
+    EXPECT_EQ(allocator.usedSize(), 0u);
+    EXPECT_EQ(allocator.oldestFenceValue(), 0u);
+    EXPECT_EQ(allocator.allocate(1024, 1), 0u);
+}
+
+TEST(RingAllocatorTest, WrapsAroundAndCountsWastedTail) {
+    RingAllocator allocator;
+    allocator.initialize(1024);
+
+    EXPECT_EQ(allocator.allocate(512, 1), 0u);
+    allocator.finishFrame(1);
+    EXPECT_EQ(allocator.allocate(384, 1), 512u);
+    allocator.finishFrame(2);
+    allocator.release(1);
+
+    // 末尾には 128 しか残っていないので先頭へ折り返す
+    EXPECT_EQ(allocator.allocate(256, 1), 0u);
+    EXPECT_EQ(allocator.usedSize(), 384u + 128u + 256u);
+
+    // 折り返した後は [head, tail) だけが空き
+    EXPECT_EQ(allocator.allocate(256, 1), 256u);
+    EXPECT_EQ(allocator.allocate(1, 1), RingAllocator::invalidOffset);
+    allocator.finishFrame(3);
+
+    allocator.release(3);
+    EXPECT_EQ(allocator.usedSize(), 0u);
+}
+
+TEST(RingAllocatorTest, ReleasesSeveralFramesAtOnce) {
+    RingAllocator allocator;
+    allocator.initialize(1024);
+
+    for (uint64_t fenceValue = 1; fenceValue <= 4; ++fenceValue) {
+        EXPECT_NE(allocator.allocate(200, 1), RingAllocator::invalidOffset);
+        allocator.finishFrame(fenceValue);
+    }
+    EXPECT_EQ(allocator.usedSize(), 800u);
+
+    allocator.release(3);
+    EXPECT_EQ(allocator.usedSize(), 200u);
+    EXPECT_EQ(allocator.oldestFenceValue(), 4u);
+
+    allocator.release(4);
+    EXPECT_EQ(allocator.usedSize(), 0u);
+}
+
+TEST(RingAllocatorTest, EmptyFramesAreNotRecorded) {
+    RingAllocator allocator;
+    allocator.initialize(1024);
+
+    allocator.finishFrame(1);
+    allocator.finishFrame(2);
+    EXPECT_EQ(allocator.oldestFenceValue(), 0u);
+
+    EXPECT_EQ(allocator.allocate(100, 1), 0u);
+    allocator.finishFrame(3);
+    allocator.finishFrame(4);
+    EXPECT_EQ(allocator.oldestFenceValue(), 3u);
+    allocator.release(4);
+    EXPECT_EQ(allocator.oldestFenceValue(), 0u);
+}
+
+TEST(RingAllocatorTest, EmptyFrameDoesNotRewindTailOverLiveAllocation) {
+    RingAllocator allocator;
+    allocator.initialize(4096);
+
+    // 空のフレームが古い終端を持ったまま残ると、解放した時に末尾が戻って使用中の領域を貸し出してしまう
+    ASSERT_EQ(allocator.allocate(256, 1), 0u);
+    allocator.finishFrame(1);
+    allocator.finishFrame(2);
+    allocator.release(1);
+
+    const auto b = allocator.allocate(1024, 1);
+    ASSERT_NE(b, RingAllocator::invalidOffset);
+    allocator.release(2);
+
+    const auto c = allocator.allocate(3072, 1);
+    const auto d = allocator.allocate(256, 1);
+
+    const Range live{ b, b + 1024 };
+    if (c != RingAllocator::invalidOffset) {
+        EXPECT_FALSE(overlaps(live, { c, c + 3072 }));
+    }
+    if (d != RingAllocator::invalidOffset) {
+        EXPECT_FALSE(overlaps(live, { d, d + 256 }));
+    }
+}
+
+TEST(RingAllocatorTest, RandomFramesNeverOverlapLiveAllocations) {
+    constexpr uint64_t capacity = 64 * 1024;
+    RingAllocator allocator;
+    allocator.initialize(capacity);
+
+    std::mt19937_64 random(12345);
+    std::uniform_int_distribution<uint64_t> sizeDistribution(1, capacity / 8);
+    std::uniform_int_distribution<uint32_t> countDistribution(0, 6);
+    std::uniform_int_distribution<uint32_t> alignmentShift(0, 8);
+    std::uniform_int_distribution<uint32_t> latency(0, 3);
+
+    std::vector<Range> live;
+    uint64_t completedFenceValue = 0;
+    for (uint64_t fenceValue = 1; fenceValue <= 5000; ++fenceValue) {
+        // 空のフレームも混ぜる
+        const auto count = countDistribution(random);
+        for (uint32_t i = 0; i < count; ++i) {
+            const auto size = sizeDistribution(random);
+            const auto alignment = uint64_t{ 1 } << alignmentShift(random);
+            const auto offset = allocator.allocate(size, alignment);
+            if (offset == RingAllocator::invalidOffset) {
+                continue;
+            }
+            ASSERT_EQ(offset % alignment, 0u);
+            ASSERT_LE(offset + size, capacity);
+
+            const Range range{ offset, offset + size };
+            for (const auto& other : live) {
+                ASSERT_FALSE(overlaps(range, other)) << "frame " << fenceValue << ": [" << range.begin_ << ", " << range.end_ << ") overlaps [" << other.begin_ << ", " << other.end_ << ")";
+            }
+            live.push_back(range);
+        }
+        for (auto& range : live) {
+            if (range.fenceValue_ == 0) {
+                range.fenceValue_ = fenceValue;
+            }
+        }
+        allocator.finishFrame(fenceValue);
+
+        // GPU は数フレーム遅れて進む
+        completedFenceValue = std::max(completedFenceValue, fenceValue - std::min<uint64_t>(fenceValue, latency(random)));
+        allocator.release(completedFenceValue);
+        std::erase_if(live, [completedFenceValue](const Range& range) { return range.fenceValue_ <= completedFenceValue; });
+    }
+
+    allocator.release(UINT64_MAX);
+    EXPECT_EQ(allocator.usedSize(), 0u);
+}
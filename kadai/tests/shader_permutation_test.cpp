@@ -0,0 +1,74 @@
+// シェーダバリエーションクラスのテスト
+
+#include "shader_permutation.h"
+#include <gtest/gtest.h>
+#include <cstdint>
+
+TEST(ShaderPermutationTest, FeatureBitsAreDistinct) {
+    // 機能ビットは重ならず、全ての組み合わせがキーの範囲に収まる
+    const ShaderKey features[] = { ShaderFeature::instancing, ShaderFeature::vertexColor, ShaderFeature::fog, ShaderFeature::alphaTest };
+    ShaderKey combined = ShaderFeature::none;
+    for (const auto feature : features) {
+        EXPECT_EQ(feature & (feature - 1), 0u) << "feature " << feature << " is not a single bit";
+        EXPECT_EQ(combined & feature, 0u);
+        combined |= feature;
+    }
+    EXPECT_EQ(combined, ShaderFeature::all);
+    EXPECT_EQ(ShaderVariantRegistry::keyCount, size_t{ ShaderFeature::all } + 1);
+}
+
+TEST(ShaderPermutationTest, HasShaderFeatureRequiresAllBits) {
+    constexpr auto key = ShaderFeature::instancing | ShaderFeature::fog;
+    static_assert(hasShaderFeature(key, ShaderFeature::instancing));
+    static_assert(!hasShaderFeature(key, ShaderFeature::vertexColor));
+    static_assert(!hasShaderFeature(key, ShaderFeature::instancing | ShaderFeature::vertexColor));
+    static_assert(hasShaderFeature(key, ShaderFeature::none));
+}
+
+TEST(ShaderVariantRegistryTest, NumbersKeysInRegistrationOrder) {
+    ShaderVariantRegistry registry;
+    EXPECT_EQ(registry.size(), 0u);
+
+    const auto first = ShaderFeature::instancing | ShaderFeature::vertexColor;
+    const auto second = ShaderFeature::alphaTest;
+    EXPECT_EQ(registry.add(first), 0u);
+    EXPECT_EQ(registry.add(second), 1u);
+    EXPECT_EQ(registry.add(ShaderFeature::none), 2u);
+    EXPECT_EQ(registry.size(), 3u);
+
+    EXPECT_EQ(registry.find(first), 0u);
+    EXPECT_EQ(registry.find(second), 1u);
+    EXPECT_EQ(registry.find(ShaderFeature::none), 2u);
+    EXPECT_EQ(registry.key(0), first);
+    EXPECT_EQ(registry.key(1), second);
+    EXPECT_EQ(registry.key(2), ShaderFeature::none);
+}
+
+TEST(ShaderVariantRegistryTest, AddingTheSameKeyKeepsItsIndex) {
+    ShaderVariantRegistry registry;
+    EXPECT_EQ(registry.add(ShaderFeature::fog), 0u);
+    EXPECT_EQ(registry.add(ShaderFeature::instancing), 1u);
+    EXPECT_EQ(registry.add(ShaderFeature::fog), 0u);
+    EXPECT_EQ(registry.size(), 2u);
+}
+
+TEST(ShaderVariantRegistryTest, UnregisteredKeysAreNotFound) {
+    ShaderVariantRegistry registry;
+    (void)registry.add(ShaderFeature::fog);
+
+    EXPECT_EQ(registry.find(ShaderFeature::alphaTest), ShaderVariantRegistry::invalidIndex);
+    EXPECT_EQ(registry.find(static_cast<ShaderKey>(ShaderVariantRegistry::keyCount)), ShaderVariantRegistry::invalidIndex);
+    EXPECT_EQ(registry.find(UINT32_MAX), ShaderVariantRegistry::invalidIndex);
+}
+
+TEST(ShaderVariantRegistryTest, RegistersEveryKey) {
+    // ビルド時には全てのキーのバリエーションを作るので、全てを登録できること
+    ShaderVariantRegistry registry;
+    for (ShaderKey key = 0; key < ShaderVariantRegistry::keyCount; ++key) {
+        EXPECT_EQ(registry.add(key), key);
+    }
+    EXPECT_EQ(registry.size(), ShaderVariantRegistry::keyCount);
+    for (ShaderKey key = 0; key < ShaderVariantRegistry::keyCount; ++key) {
+        EXPECT_EQ(registry.key(registry.find(key)), key);
+    }
+}
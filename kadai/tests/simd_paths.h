@@ -0,0 +1,35 @@
+// SIMD の命令セットを切り替えるテストの共通処理
+// スカラー・SSE・AVX2 の結果を比べるテストは、ここで取得した命令セットを全て試す
+
+#pragma once
+
+#include "transform_batch.h"
+#include <vector>
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	この CPU で使える命令セットを全て取得する
+ * @return	命令セットの並び（scalar が先頭）
+ */
+[[nodiscard]] inline std::vector<TransformBatch::Path> availablePaths() {
+    std::vector<TransformBatch::Path> paths = { TransformBatch::Path::scalar, TransformBatch::Path::sse };
+    if (TransformBatch::bestPath() == TransformBatch::Path::avx2) {
+        paths.push_back(TransformBatch::Path::avx2);
+    }
+    return paths;
+}
+
+//---------------------------------------------------------------------------------
+/**
+ * @brief	命令セットの名前を取得する
+ * @param	path	命令セット
+ * @return	名前
+ */
+[[nodiscard]] inline const char* pathName(TransformBatch::Path path) {
+    switch (path) {
+        case TransformBatch::Path::scalar: return "scalar";
+        case TransformBatch::Path::sse: return "sse";
+        case TransformBatch::Path::avx2: return "avx2";
+    }
+    return "unknown";
+}
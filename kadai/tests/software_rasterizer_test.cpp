@@ -0,0 +1,440 @@
+// ソフトウェアラスタライザクラスのテスト
+// シーン描画パスをヌルデバイスとソフトウェアラスタライザのコマンドリストで記録し、正解画像と比べる
+
+#include "rhi_null.h"
+#include "rhi_software.h"
+#include "scene_pass.h"
+#include "shader_permutation.h"
+#include "software_rasterizer.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <numbers>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace {
+    constexpr uint32_t width = 160;              // 描画先の幅
+    constexpr uint32_t height = 120;             // 描画先の高さ
+    constexpr uint32_t vertexStride = 28;        // 一頂点のサイズ（位置 float3 + 色 float4）
+    constexpr uint64_t bufferSize = 64 * 1024;   // 各バッファのサイズ
+    constexpr int      channelTolerance = 2;     // 画素の各成分の許容誤差（コンパイラによる浮動小数点の差）
+    constexpr double   mismatchTolerance = 0.002;  // 許容誤差を超えてよい画素の割合（三角形の辺の丸めの差）
+    constexpr float    clearColor[4] = { 0.2f, 0.2f, 0.2f, 1.0f };  // 背景のクリア色
+
+    const auto referenceImage = std::filesystem::path(KADAI_TEST_DATA_DIR) / "software_rasterizer_scene.ppm";  // 正解画像
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	頂点（MeshPool::Vertex と同じ並び）
+     */
+    struct Vertex {
+        float position_[3]{};  /// 位置
+        float color_[4]{};     /// 色
+    };
+    static_assert(sizeof(Vertex) == vertexStride);
+
+    /// 四角形（0 ～ 3）と三角形（4 ～ 6）の頂点
+    constexpr Vertex meshVertices[] = {
+        { { -1.0f, -1.0f, 0.0f }, { 1.0f, 0.0f, 0.0f, 1.0f } },
+        { { -1.0f, 1.0f, 0.0f }, { 0.0f, 1.0f, 0.0f, 1.0f } },
+        { { 1.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f, 1.0f } },
+        { { 1.0f, -1.0f, 0.0f }, { 1.0f, 1.0f, 1.0f, 1.0f } },
+        { { 0.0f, 1.0f, 0.0f }, { 1.0f, 1.0f, 0.0f, 1.0f } },
+        { { 1.0f, -1.0f, 0.0f }, { 0.0f, 1.0f, 1.0f, 1.0f } },
+        { { -1.0f, -1.0f, 0.0f }, { 1.0f, 0.0f, 1.0f, 1.0f } },
+    };
+
+    /// 四角形（0 ～ 5）と三角形（6 ～ 8、頂点 4 からの相対）のインデックス
+    constexpr uint16_t meshIndices[] = { 0, 1, 2, 0, 2, 3, 0, 1, 2 };
+
+    constexpr uint32_t quadStartIndex = 0;     // 四角形の先頭インデックス
+    constexpr uint32_t quadIndexCount = 6;     // 四角形のインデックス数
+    constexpr uint32_t triangleStartIndex = 6; // 三角形の先頭インデックス
+    constexpr uint32_t triangleIndexCount = 3; // 三角形のインデックス数
+    constexpr int32_t  triangleBaseVertex = 4; // 三角形の先頭頂点
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	単位行列を作る
+     * @return	単位行列
+     */
+    [[nodiscard]] std::array<float, 16> identity() {
+        return { 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f };
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	ワールド行列を作る（転置済み、シェーダに渡す形）
+     * z 軸回りに回してから x 軸回りに回し、拡大して平行移動する
+     * @param	x, y, z		位置
+     * @param	scale		拡大率
+     * @param	rollDegree	z 軸回りの回転（度）
+     * @param	pitchDegree	x 軸回りの回転（度）
+     * @return	ワールド行列
+     */
+    [[nodiscard]] std::array<float, 16> world(float x, float y, float z, float scale, float rollDegree, float pitchDegree = 0.0f) {
+        const auto roll = rollDegree * std::numbers::pi_v<float> / 180.0f;
+        const auto pitch = pitchDegree * std::numbers::pi_v<float> / 180.0f;
+        const auto cr = std::cos(roll);
+        const auto sr = std::sin(roll);
+        const auto cp = std::cos(pitch);
+        const auto sp = std::sin(pitch);
+        // 列ベクトルに左から掛ける形: T * S * Rx * Rz
+        return {
+            scale * cr,      -scale * sr,      0.0f,        x,
+            scale * cp * sr, scale * cp * cr,  -scale * sp, y,
+            scale * sp * sr, scale * sp * cr,  scale * cp,  z,
+            0.0f,            0.0f,             0.0f,        1.0f,
+        };
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	左手系の透視射影行列を作る（転置済み、XMMatrixPerspectiveFovLH と同じ変換）
+     * @param	fovY		縦の視野角（度）
+     * @param	aspect		アスペクト比
+     * @param	nearZ		手前のクリップ面
+     * @param	farZ		奥のクリップ面
+     * @return	射影行列
+     */
+    [[nodiscard]] std::array<float, 16> perspective(float fovY, float aspect, float nearZ, float farZ) {
+        const auto yScale = 1.0f / std::tan(fovY * std::numbers::pi_v<float> / 360.0f);
+        const auto xScale = yScale / aspect;
+        const auto range = farZ / (farZ - nearZ);
+        return {
+            xScale, 0.0f,   0.0f,  0.0f,
+            0.0f,   yScale, 0.0f,  0.0f,
+            0.0f,   0.0f,   range, -nearZ * range,
+            0.0f,   0.0f,   1.0f,  0.0f,
+        };
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	インスタンスデータを作る
+     * @param	matrix	ワールド行列
+     * @param	r, g, b, a	ポリゴンの色
+     * @return	インスタンスデータ
+     */
+    [[nodiscard]] SoftwareRasterizer::InstanceData instance(const std::array<float, 16>& matrix, float r, float g, float b, float a) {
+        SoftwareRasterizer::InstanceData data{};
+        std::memcpy(data.world_, matrix.data(), sizeof(data.world_));
+        data.color_[0] = r;
+        data.color_[1] = g;
+        data.color_[2] = b;
+        data.color_[3] = a;
+        return data;
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	ヌルデバイスとソフトウェアラスタライザで一フレームを描画する環境
+     * アプリケーションと同じく、ScenePass で記録したコマンドをコマンドリストに渡す
+     */
+    class SoftwareRenderer {
+    public:
+        //---------------------------------------------------------------------------------
+        /**
+         * @brief	デバイスとバッファとラスタライザを作成する
+         * @param	threadCount	ラスタライズに使うスレッドの数
+         * @return	生成の成否
+         */
+        [[nodiscard]] bool create(uint32_t threadCount) {
+            if (!device_.create(width, height, 1, 0) || !rasterizer_.create(width, height, threadCount)) {
+                return false;
+            }
+            camera_ = device_.createBuffer(RhiHeapType::upload, sizeof(SoftwareRasterizer::CameraData));
+            instances_ = device_.createBuffer(RhiHeapType::upload, bufferSize);
+            vertices_ = device_.createBuffer(RhiHeapType::upload, bufferSize);
+            indices_ = device_.createBuffer(RhiHeapType::upload, bufferSize);
+            commandList_ = std::make_unique<RhiSoftwareCommandList>(device_, rasterizer_);
+
+            std::memcpy(vertices_->map(), meshVertices, sizeof(meshVertices));
+            vertices_->unmap();
+            std::memcpy(indices_->map(), meshIndices, sizeof(meshIndices));
+            indices_->unmap();
+            return camera_ && instances_ && vertices_ && indices_;
+        }
+
+        //---------------------------------------------------------------------------------
+        /**
+         * @brief	カメラを設定する
+         * @param	view		ビュー行列（転置済み）
+         * @param	projection	射影行列（転置済み）
+         */
+        void setCamera(const std::array<float, 16>& view, const std::array<float, 16>& projection) {
+            SoftwareRasterizer::CameraData camera{};
+            std::memcpy(camera.view_, view.data(), sizeof(camera.view_));
+            std::memcpy(camera.projection_, projection.data(), sizeof(camera.projection_));
+            std::memcpy(camera_->map(), &camera, sizeof(camera));
+            camera_->unmap();
+        }
+
+        //---------------------------------------------------------------------------------
+        /**
+         * @brief	インスタンスデータを設定する
+         * @param	instances	フレームの全インスタンスデータ
+         */
+        void setInstances(const std::vector<SoftwareRasterizer::InstanceData>& instances) {
+            std::memcpy(instances_->map(), instances.data(), instances.size() * sizeof(SoftwareRasterizer::InstanceData));
+            instances_->unmap();
+        }
+
+        //---------------------------------------------------------------------------------
+        /**
+         * @brief	一フレームを描画する
+         * @param	draws	描画（パイプラインは pipeline で取得したもの）
+         * @param	scissor	シザー矩形
+         */
+        void render(std::span<const ScenePass::Draw> draws, const RhiRect& scissor = { 0, 0, width, height }) {
+            auto& backBuffer = device_.swapChain().backBuffer(0);
+
+            ScenePass::Frame frame;
+            frame.renderTarget_ = &backBuffer;
+            frame.viewport_ = { 0.0f, 0.0f, static_cast<float>(width), static_cast<float>(height) };
+            frame.scissor_ = scissor;
+            frame.camera_ = camera_->gpuAddress();
+            frame.instances_ = instances_->gpuAddress();
+            frame.vertexBuffer_ = { vertices_->gpuAddress(), static_cast<uint32_t>(bufferSize), vertexStride };
+            frame.indexBuffer_ = { indices_->gpuAddress(), static_cast<uint32_t>(bufferSize), 2 };
+
+            commandList_->reset();
+            commandList_->clearRenderTarget(backBuffer, clearColor);
+            ScenePass::record(*commandList_, frame, draws);
+            commandList_->close();
+        }
+
+        //---------------------------------------------------------------------------------
+        /**
+         * @brief	シェーダのバリエーションのパイプラインを取得する
+         * @param	key	シェーダのバリエーションのキー
+         * @return	パイプライン
+         */
+        [[nodiscard]] const RhiPipeline* pipeline(ShaderKey key) {
+            if (!pipelines_[key]) {
+                pipelines_[key] = std::make_unique<RhiNullPipeline>(key);
+            }
+            return pipelines_[key].get();
+        }
+
+        //---------------------------------------------------------------------------------
+        /**
+         * @brief	ラスタライザを取得する
+         * @return	ラスタライザ
+         */
+        [[nodiscard]] SoftwareRasterizer& rasterizer() {
+            return rasterizer_;
+        }
+
+    private:
+        RhiNullDevice                           device_;                                           /// バッファを置くヌルデバイス
+        SoftwareRasterizer                      rasterizer_;                                       /// 描画先
+        std::unique_ptr<RhiBuffer>              camera_{};                                         /// カメラの定数バッファ
+        std::unique_ptr<RhiBuffer>              instances_{};                                      /// インスタンスデータ
+        std::unique_ptr<RhiBuffer>              vertices_{};                                       /// 頂点バッファ
+        std::unique_ptr<RhiBuffer>              indices_{};                                        /// インデックスバッファ
+        std::unique_ptr<RhiSoftwareCommandList> commandList_{};                                    /// 記録先
+        std::array<std::unique_ptr<RhiNullPipeline>, ShaderVariantRegistry::keyCount> pipelines_{};  /// バリエーション毎のパイプライン
+    };
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	比較用のシーンを描画する
+     * 全てのバリエーションの機能、インスタンシング、重なりのブレンド、手前のクリップ面との交差を含める
+     * @param	renderer	描画する環境
+     */
+    void renderReferenceScene(SoftwareRenderer& renderer) {
+        renderer.setCamera(identity(), perspective(60.0f, static_cast<float>(width) / height, 0.1f, 100.0f));
+
+        std::vector<SoftwareRasterizer::InstanceData> instances;
+        std::vector<ScenePass::Draw> draws;
+
+        // 頂点色付きの四角形を並べる（インスタンシング）
+        const auto opaque = renderer.pipeline(ShaderFeature::instancing | ShaderFeature::vertexColor);
+        draws.push_back({ opaque, quadIndexCount, quadStartIndex, 0, static_cast<uint32_t>(instances.size()), 3 });
+        instances.push_back(instance(world(-2.2f, 1.0f, 6.0f, 0.8f, 0.0f), 1.0f, 1.0f, 1.0f, 1.0f));
+        instances.push_back(instance(world(0.0f, 1.0f, 6.0f, 0.8f, 30.0f), 1.0f, 1.0f, 1.0f, 1.0f));
+        instances.push_back(instance(world(2.2f, 1.0f, 6.0f, 0.8f, 45.0f, 50.0f), 1.0f, 1.0f, 1.0f, 1.0f));
+
+        // 奥に向かって霧がかかる三角形
+        const auto fog = renderer.pipeline(ShaderFeature::instancing | ShaderFeature::vertexColor | ShaderFeature::fog);
+        draws.push_back({ fog, triangleIndexCount, triangleStartIndex, triangleBaseVertex, static_cast<uint32_t>(instances.size()), 4 });
+        // 見かけの大きさが揃うよう、奥の三角形ほど大きくして横に並べる
+        const std::array fogDepths = { 6.0f, 16.0f, 30.0f, 45.0f };
+        for (size_t i = 0; i < fogDepths.size(); ++i) {
+            const auto z = fogDepths[i];
+            instances.push_back(instance(world((-0.7f + 0.35f * i) * z, -0.1f * z, z, 0.1f * z, 180.0f), 1.0f, 1.0f, 1.0f, 1.0f));
+        }
+
+        // アルファテストで一つ目は捨てられ、二つ目は半透明で重なる
+        const auto alphaTest = renderer.pipeline(ShaderFeature::instancing | ShaderFeature::alphaTest);
+        draws.push_back({ alphaTest, quadIndexCount, quadStartIndex, 0, static_cast<uint32_t>(instances.size()), 2 });
+        instances.push_back(instance(world(1.6f, -1.2f, 5.0f, 0.7f, 10.0f), 1.0f, 0.0f, 0.0f, 0.4f));
+        instances.push_back(instance(world(2.2f, -1.6f, 5.0f, 0.7f, -10.0f), 0.0f, 0.5f, 1.0f, 0.8f));
+
+        // インスタンシングなしで、手前のクリップ面を横切る三角形を左下に半透明で重ねる
+        const auto single = renderer.pipeline(ShaderFeature::vertexColor);
+        draws.push_back({ single, triangleIndexCount, triangleStartIndex, triangleBaseVertex, static_cast<uint32_t>(instances.size()), 1 });
+        instances.push_back(instance(world(-0.5f, -0.35f, 0.6f, 0.6f, 180.0f, -80.0f), 1.0f, 1.0f, 1.0f, 0.5f));
+
+        renderer.setInstances(instances);
+        renderer.render(draws);
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	画素を PPM（RGB）で保存する
+     * @param	path	保存先
+     * @param	pixels	R8G8B8A8 の画素
+     */
+    void writePpm(const std::filesystem::path& path, const std::vector<uint32_t>& pixels) {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << "P6\n" << width << ' ' << height << "\n255\n";
+        for (const auto pixel : pixels) {
+            const char rgb[3] = { static_cast<char>(pixel & 0xff), static_cast<char>((pixel >> 8) & 0xff), static_cast<char>((pixel >> 16) & 0xff) };
+            file.write(rgb, sizeof(rgb));
+        }
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	PPM（RGB）を読み込む
+     * @param	path	読み込むファイル
+     * @param	pixels	R8G8B8A8 の画素（アルファは 255）
+     * @return	読み込めて大きさが描画先と同じ場合は true
+     */
+    [[nodiscard]] bool readPpm(const std::filesystem::path& path, std::vector<uint32_t>& pixels) {
+        std::ifstream file(path, std::ios::binary);
+        std::string magic;
+        uint32_t fileWidth = 0;
+        uint32_t fileHeight = 0;
+        uint32_t maxValue = 0;
+        if (!(file >> magic >> fileWidth >> fileHeight >> maxValue) || magic != "P6" || fileWidth != width || fileHeight != height || maxValue != 255) {
+            return false;
+        }
+        file.get();  // ヘッダの後の改行
+
+        pixels.assign(static_cast<size_t>(width) * height, 0);
+        for (auto& pixel : pixels) {
+            unsigned char rgb[3];
+            if (!file.read(reinterpret_cast<char*>(rgb), sizeof(rgb))) {
+                return false;
+            }
+            pixel = rgb[0] | (rgb[1] << 8) | (rgb[2] << 16) | 0xff000000u;
+        }
+        return true;
+    }
+}  // namespace
+
+TEST(SoftwareRasterizerTest, MatchesReferenceImage) {
+    SoftwareRenderer renderer;
+    ASSERT_TRUE(renderer.create(4));
+    renderReferenceScene(renderer);
+
+    std::vector<uint32_t> actual;
+    renderer.rasterizer().copyPixels(actual);
+
+    // 描画処理を意図して変えた場合は KADAI_UPDATE_REFERENCE=1 で実行して正解画像を作り直す
+    if (std::getenv("KADAI_UPDATE_REFERENCE")) {
+        writePpm(referenceImage, actual);
+        GTEST_SKIP() << "updated " << referenceImage;
+    }
+
+    std::vector<uint32_t> expected;
+    ASSERT_TRUE(readPpm(referenceImage, expected)) << "cannot read " << referenceImage;
+
+    // 表示に使う RGB だけを比べる
+    size_t mismatchCount = 0;
+    int    maxDifference = 0;
+    for (size_t i = 0; i < actual.size(); ++i) {
+        int difference = 0;
+        for (int shift = 0; shift < 24; shift += 8) {
+            difference = std::max(difference, std::abs(static_cast<int>((actual[i] >> shift) & 0xff) - static_cast<int>((expected[i] >> shift) & 0xff)));
+        }
+        maxDifference = std::max(maxDifference, difference);
+        mismatchCount += difference > channelTolerance ? 1 : 0;
+    }
+
+    const auto allowed = static_cast<size_t>(static_cast<double>(actual.size()) * mismatchTolerance);
+    if (mismatchCount > allowed) {
+        // 差分を確認できるよう、実際の画像をテストの作業ディレクトリに残す
+        writePpm("software_rasterizer_scene.actual.ppm", actual);
+    }
+    EXPECT_LE(mismatchCount, allowed) << "max channel difference " << maxDifference;
+}
+
+TEST(SoftwareRasterizerTest, ResultDoesNotDependOnThreadCount) {
+    std::vector<uint32_t> reference;
+    for (const auto threadCount : { 1u, 2u, 3u, 8u }) {
+        SoftwareRenderer renderer;
+        ASSERT_TRUE(renderer.create(threadCount));
+        renderReferenceScene(renderer);
+
+        std::vector<uint32_t> pixels;
+        renderer.rasterizer().copyPixels(pixels);
+        if (reference.empty()) {
+            reference = pixels;
+        } else {
+            EXPECT_EQ(pixels, reference) << threadCount << " threads";
+        }
+    }
+}
+
+TEST(SoftwareRasterizerTest, SharedEdgesAreRasterizedOnce) {
+    SoftwareRenderer renderer;
+    ASSERT_TRUE(renderer.create(2));
+
+    // 射影なしで、ピクセルの境界にぴったり合う 40 x 30 ピクセルの四角形を描く
+    renderer.setCamera(identity(), identity());
+    const auto halfWidth = 20.0f / (width / 2);
+    const auto halfHeight = 15.0f / (height / 2);
+    auto matrix = identity();
+    matrix[0] = halfWidth;
+    matrix[5] = halfHeight;
+    renderer.setInstances({ instance(matrix, 1.0f, 1.0f, 1.0f, 1.0f) });
+    const std::array draws = { ScenePass::Draw{ renderer.pipeline(ShaderFeature::instancing), quadIndexCount, quadStartIndex, 0, 0, 1 } };
+    renderer.render(draws);
+
+    // 左上ルールにより、対角線上の画素も一度だけ書き込まれる
+    auto& rasterizer = renderer.rasterizer();
+    EXPECT_EQ(rasterizer.statistics().pixelCount_, 40u * 30u);
+    EXPECT_EQ(rasterizer.pixel(width / 2 - 20, height / 2 - 15), 0xffffffffu);
+    EXPECT_EQ(rasterizer.pixel(width / 2 + 19, height / 2 + 14), 0xffffffffu);
+    EXPECT_NE(rasterizer.pixel(width / 2 - 21, height / 2), 0xffffffffu);
+    EXPECT_NE(rasterizer.pixel(width / 2 + 20, height / 2), 0xffffffffu);
+}
+
+TEST(SoftwareRasterizerTest, ScissorAndAlphaTestLimitWrites) {
+    SoftwareRenderer renderer;
+    ASSERT_TRUE(renderer.create(2));
+    renderer.setCamera(identity(), identity());
+
+    // 画面全体を覆う四角形を二つ。一つ目はアルファテストで全て捨てられる
+    renderer.setInstances({ instance(identity(), 1.0f, 0.0f, 0.0f, 0.25f), instance(identity(), 0.0f, 1.0f, 0.0f, 1.0f) });
+    const auto pipeline = renderer.pipeline(ShaderFeature::alphaTest);
+    const std::array draws = {
+        ScenePass::Draw{ pipeline, quadIndexCount, quadStartIndex, 0, 0, 1 },
+        ScenePass::Draw{ pipeline, quadIndexCount, quadStartIndex, 0, 1, 1 },
+    };
+    renderer.render(draws, { 10, 20, 50, 40 });
+
+    auto& rasterizer = renderer.rasterizer();
+    EXPECT_EQ(rasterizer.statistics().pixelCount_, 40u * 20u);
+    EXPECT_EQ(rasterizer.pixel(10, 20), 0xff00ff00u);
+    EXPECT_EQ(rasterizer.pixel(49, 39), 0xff00ff00u);
+
+    // シザー矩形の外はクリア色のまま
+    const auto background = rasterizer.pixel(0, 0);
+    EXPECT_EQ(rasterizer.pixel(9, 20), background);
+    EXPECT_EQ(rasterizer.pixel(50, 39), background);
+    EXPECT_EQ(rasterizer.pixel(10, 40), background);
+}
@@ -0,0 +1,230 @@
+// ワールド行列の一括計算クラスのテスト
+
+#include "simd_paths.h"
+#include "transform_batch.h"
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace {
+    constexpr size_t matrixSize = 16;        // 行列一つの float の数
+    constexpr float  tolerance = 1e-4f;      // 倍精度で計算した行列との許容誤差
+    constexpr float  untouched = -12345.0f;  // 書き込まれていない場所の目印
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	成分毎に分かれた入力の配列
+     */
+    struct Transforms {
+        std::vector<float> values_[10];  /// 座標 xyz、回転 xyzw、拡大率 xyz の順
+
+        //---------------------------------------------------------------------------------
+        /**
+         * @brief	計算に渡す入力の配列を取得する
+         * @return	入力の配列
+         */
+        [[nodiscard]] TransformBatch::Source source() const {
+            return {
+                values_[0].data(), values_[1].data(), values_[2].data(),
+                values_[3].data(), values_[4].data(), values_[5].data(), values_[6].data(),
+                values_[7].data(), values_[8].data(), values_[9].data(),
+            };
+        }
+    };
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	乱数で入力を作る（回転は単位クォータニオン、拡大率は負や軸毎に違う値も含む）
+     * @param	count	オブジェクトの数
+     * @param	seed	乱数の種
+     * @return	入力の配列
+     */
+    [[nodiscard]] Transforms makeTransforms(size_t count, uint32_t seed) {
+        std::mt19937 random(seed);
+        std::uniform_real_distribution<float> distribution(-3.0f, 3.0f);
+
+        Transforms transforms;
+        for (auto& values : transforms.values_) {
+            values.resize(count);
+        }
+        for (size_t i = 0; i < count; ++i) {
+            float q[4] = { distribution(random), distribution(random), distribution(random), distribution(random) };
+            const auto length = std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+            for (size_t k = 0; k < 3; ++k) {
+                transforms.values_[k][i] = distribution(random) * 10.0f;
+                transforms.values_[7 + k][i] = distribution(random);
+            }
+            for (size_t k = 0; k < 4; ++k) {
+                transforms.values_[3 + k][i] = q[k] / length;
+            }
+        }
+        return transforms;
+    }
+
+    //---------------------------------------------------------------------------------
+    /**
+     * @brief	拡大 → 回転 → 移動の行列を倍精度で掛けて、転置した形で求める
+     * 計算対象とは別の方法（行列の積）で求めた正解
+     * @param	transforms	入力の配列
+     * @param	i			入力の位置
+     * @param	matrix		書き込み先（float 16 個）
+     */
+    void referenceMatrix(const Transforms& transforms, size_t i, float* matrix) {
+        const double x = transforms.values_[3][i];
+        const double y = transforms.values_[4][i];
+        const double z = transforms.values_[5][i];
+        const double w = transforms.values_[6][i];
+        const double rotation[3][3] = {
+            { 1 - 2 * (y * y + z * z), 2 * (x * y + z * w), 2 * (x * z - y * w) },
+            { 2 * (x * y - z * w), 1 - 2 * (x * x + z * z), 2 * (y * z + x * w) },
+            { 2 * (x * z + y * w), 2 * (y * z - x * w), 1 - 2 * (x * x + y * y) },
+        };
+
+        // 行ベクトルに右から掛ける形の行 r は scale[r] * rotation[r]、最後の行が移動
+        double world[4][4]{};
+        for (size_t r = 0; r < 3; ++r) {
+            for (size_t c = 0; c < 3; ++c) {
+                world[r][c] = transforms.values_[7 + r][i] * rotation[r][c];
+            }
+            world[3][r] = transforms.values_[r][i];
+        }
+        world[3][3] = 1.0;
+
+        // シェーダーに渡す形（転置）にする
+        for (size_t r = 0; r < 4; ++r) {
+            for (size_t c = 0; c < 4; ++c) {
+                matrix[r * 4 + c] = static_cast<float>(world[c][r]);
+            }
+        }
+    }
+}  // namespace
+
+TEST(TransformBatchTest, EveryPathMatchesReference) {
+    const auto transforms = makeTransforms(64, 1);
+    const auto source = transforms.source();
+
+    std::vector<float> expected(64 * matrixSize);
+    for (size_t i = 0; i < 64; ++i) {
+        referenceMatrix(transforms, i, expected.data() + i * matrixSize);
+    }
+
+    for (const auto path : availablePaths()) {
+        std::vector<float> actual(64 * matrixSize);
+        TransformBatch::compose(source, 64, actual.data(), matrixSize * sizeof(float), path);
+        for (size_t i = 0; i < actual.size(); ++i) {
+            ASSERT_NEAR(actual[i], expected[i], tolerance) << pathName(path) << " element " << i;
+        }
+    }
+}
+
+TEST(TransformBatchTest, SimdPathsMatchScalarForEveryTailLength) {
+    // AVX2 の 8 個、SSE の 4 個、一つずつの端数の全ての組み合わせを通る数
+    for (size_t count = 0; count <= 8 * 3 + 7; ++count) {
+        const auto transforms = makeTransforms(count, static_cast<uint32_t>(count) + 100);
+        const auto source = transforms.source();
+
+        std::vector<float> expected(count * matrixSize);
+        TransformBatch::compose(source, count, expected.data(), matrixSize * sizeof(float), TransformBatch::Path::scalar);
+
+        // 演算の順序は全ての命令セットで同じなので、結果はビット単位で一致する
+        for (const auto path : availablePaths()) {
+            std::vector<float> actual(count * matrixSize + matrixSize, untouched);
+            TransformBatch::compose(source, count, actual.data(), matrixSize * sizeof(float), path);
+            EXPECT_TRUE(std::equal(expected.begin(), expected.end(), actual.begin())) << pathName(path) << " count " << count;
+
+            // 最後の行列の後ろには書き込まない
+            for (size_t i = count * matrixSize; i < actual.size(); ++i) {
+                ASSERT_EQ(actual[i], untouched) << pathName(path) << " count " << count;
+            }
+        }
+    }
+}
+
+TEST(TransformBatchTest, WritesWithStrideAndLeavesGapsUntouched) {
+    // インスタンスバッファと同じく、行列の後ろに色などの別のデータが並ぶ
+    constexpr size_t stride = (matrixSize + 5) * sizeof(float);
+    constexpr size_t floatsPerElement = stride / sizeof(float);
+    constexpr size_t count = 21;
+    const auto transforms = makeTransforms(count, 7);
+
+    std::vector<float> expected(count * matrixSize);
+    TransformBatch::compose(transforms.source(), count, expected.data(), matrixSize * sizeof(float), TransformBatch::Path::scalar);
+
+    for (const auto path : availablePaths()) {
+        std::vector<float> actual(count * floatsPerElement, untouched);
+        TransformBatch::compose(transforms.source(), count, actual.data(), stride, path);
+        for (size_t i = 0; i < count; ++i) {
+            for (size_t k = 0; k < floatsPerElement; ++k) {
+                const auto value = actual[i * floatsPerElement + k];
+                if (k < matrixSize) {
+                    ASSERT_EQ(value, expected[i * matrixSize + k]) << pathName(path) << " matrix " << i;
+                } else {
+                    ASSERT_EQ(value, untouched) << pathName(path) << " matrix " << i;
+                }
+            }
+        }
+    }
+}
+
+TEST(TransformBatchTest, IndexedComposeMatchesGatheredInput) {
+    constexpr size_t sourceCount = 200;
+    const auto transforms = makeTransforms(sourceCount, 3);
+
+    // 飛び飛びで重複もある位置の並び（カリング後の見える位置の代わり）
+    std::mt19937 random(4);
+    for (const auto count : { 1u, 5u, 8u, 15u, 29u, 100u }) {
+        std::vector<uint32_t> indices(count);
+        for (auto& index : indices) {
+            index = static_cast<uint32_t>(random() % sourceCount);
+        }
+
+        std::vector<float> expected(count * matrixSize);
+        for (size_t i = 0; i < count; ++i) {
+            const std::vector<uint32_t> single = { indices[i] };
+            TransformBatch::compose(transforms.source(), single, expected.data() + i * matrixSize, matrixSize * sizeof(float), TransformBatch::Path::scalar);
+        }
+
+        for (const auto path : availablePaths()) {
+            std::vector<float> actual(count * matrixSize, untouched);
+            TransformBatch::compose(transforms.source(), indices, actual.data(), matrixSize * sizeof(float), path);
+            EXPECT_EQ(actual, expected) << pathName(path) << " count " << count;
+        }
+    }
+
+    // 全ての位置を順に並べた場合は、位置の並びを使わない計算と一致する
+    std::vector<uint32_t> all(sourceCount);
+    std::iota(all.begin(), all.end(), 0u);
+    for (const auto path : availablePaths()) {
+        std::vector<float> direct(sourceCount * matrixSize);
+        std::vector<float> indexed(sourceCount * matrixSize);
+        TransformBatch::compose(transforms.source(), sourceCount, direct.data(), matrixSize * sizeof(float), path);
+        TransformBatch::compose(transforms.source(), all, indexed.data(), matrixSize * sizeof(float), path);
+        EXPECT_EQ(indexed, direct) << pathName(path);
+    }
+}
+
+TEST(TransformBatchTest, IdentityTransformGivesIdentityMatrix) {
+    Transforms transforms;
+    const float defaults[10] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f };
+    for (size_t k = 0; k < 10; ++k) {
+        transforms.values_[k].assign(9, defaults[k]);
+    }
+    transforms.values_[0][8] = 5.0f;
+
+    for (const auto path : availablePaths()) {
+        std::vector<float> actual(9 * matrixSize);
+        TransformBatch::compose(transforms.source(), 9, actual.data(), matrixSize * sizeof(float), path);
+        for (size_t i = 0; i < 9; ++i) {
+            const auto* matrix = actual.data() + i * matrixSize;
+            for (size_t k = 0; k < matrixSize; ++k) {
+                // 移動は転置後の 4 列目に入る
+                const auto expected = (k % 5 == 0) ? 1.0f : (i == 8 && k == 3) ? 5.0f : 0.0f;
+                EXPECT_EQ(matrix[k], expected) << pathName(path) << " matrix " << i << " element " << k;
+            }
+        }
+    }
+}